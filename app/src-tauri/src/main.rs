@@ -9,7 +9,7 @@ mod protocol;
 
 use serde::{Deserialize, Serialize};
 use tauri::Manager;
-use crate::protocol::{VersionInfo, WalletStatus};
+use crate::protocol::{Curve, VersionInfo, WalletStatus};
 
 /// Status da wallet estendido para UI (inclui estados de conexão)
 #[derive(Debug, Clone, Serialize, Deserialize, PartialEq)]
@@ -56,18 +56,64 @@ async fn lock_wallet() -> Result<(), String> {
     usb::lock().await
 }
 
+/// Comando: Trocar passphrase BIP-39 (wallet oculta)
+#[tauri::command]
+async fn set_passphrase(passphrase: String) -> Result<(), String> {
+    usb::set_passphrase(&passphrase).await
+}
+
+/// Comando: Backup SLIP-39 (partes soletradas)
+#[tauri::command]
+async fn backup_slip39(pin: String, threshold: u8, count: u8) -> Result<Vec<String>, String> {
+    usb::backup_slip39(&pin, threshold, count).await
+}
+
+/// Comando: Exportar backup cifrado (registros em hex)
+#[tauri::command]
+async fn backup_export(pin: String, passphrase: String) -> Result<Vec<String>, String> {
+    usb::backup_export(&pin, &passphrase).await
+}
+
+/// Comando: Importar backup cifrado
+#[tauri::command]
+async fn backup_import(records: Vec<String>, passphrase: String, pin: String) -> Result<(), String> {
+    usb::backup_import(&records, &passphrase, &pin).await
+}
+
 /// Comando: Obter endereço
 #[tauri::command]
 async fn get_address(account_index: u32) -> Result<String, String> {
     usb::get_address(account_index).await
 }
 
+/// Comando: Obter faixa de endereços
+#[tauri::command]
+async fn get_addresses(account_index: u32, start: u32, count: u32) -> Result<Vec<String>, String> {
+    usb::get_addresses(account_index, start, count).await
+}
+
 /// Comando: Assinar transação
 #[tauri::command]
 async fn sign_transaction(account_index: u32, to_address: String, amount: u64, fee: u64) -> Result<String, String> {
     usb::sign_transaction(account_index, &to_address, amount, fee).await
 }
 
+/// Comando: Assinar lote de hashes (entradas: conta, hash em hex)
+#[tauri::command]
+async fn sign_batch(secp256k1: bool, entries: Vec<(u32, String)>) -> Result<Vec<String>, String> {
+    let curve = if secp256k1 { Curve::Secp256k1 } else { Curve::Ed25519 };
+    let mut parsed = Vec::with_capacity(entries.len());
+    for (account, hash_hex) in entries {
+        let hash: [u8; 32] = hex::decode(&hash_hex)
+            .ok()
+            .and_then(|h| h.try_into().ok())
+            .ok_or("Invalid hash")?;
+        parsed.push((account, hash));
+    }
+    let signatures = usb::sign_batch(curve, &parsed).await?;
+    Ok(signatures.iter().map(hex::encode).collect())
+}
+
 fn main() {
     tauri::Builder::default()
         .plugin(tauri_plugin_shell::init())
@@ -78,8 +124,14 @@ fn main() {
             create_wallet,
             unlock_wallet,
             lock_wallet,
+            set_passphrase,
+            backup_slip39,
+            backup_export,
+            backup_import,
             get_address,
+            get_addresses,
             sign_transaction,
+            sign_batch,
         ])
         .run(tauri::generate_context!())
         .expect("error while running tauri application");
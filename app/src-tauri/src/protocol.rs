@@ -3,6 +3,7 @@
 //! Protocolo de comunicação seguro entre App e Hardware
 
 use serde::{Deserialize, Serialize};
+use unicode_normalization::UnicodeNormalization;
 
 /// Frame format
 /// [SOF (0xAA)][LEN][CMD][DATA...][CRC16-LO][CRC16-HI]
@@ -19,9 +20,15 @@ pub enum Command {
     CreateWallet = 0x10,
     Unlock = 0x11,
     Lock = 0x12,
+    BackupSlip39 = 0x13,
+    BackupExport = 0x14,
+    BackupImport = 0x15,
+    SetPassphrase = 0x16,
     GetAddress = 0x20,
     SignTransaction = 0x21,
     VerifySignature = 0x22,
+    GetAddresses = 0x23,
+    SignConfirm = 0x24,
     // Session management
     InitSession = 0x30,
     CloseSession = 0x31,
@@ -39,6 +46,16 @@ pub enum Status {
     InvalidPin = 0x05,
     InvalidSignature = 0x06,
     SessionExpired = 0x07,
+    RngFailure = 0x08,
+    Denied = 0x09,
+}
+
+/// Curva de assinatura (wallet_curve_t no firmware)
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[repr(u8)]
+pub enum Curve {
+    Ed25519 = 0,
+    Secp256k1 = 1,
 }
 
 /// Version info
@@ -123,6 +140,8 @@ pub fn parse_response(frame: &[u8]) -> Result<(Status, Vec<u8>), &'static str> {
         0x05 => Status::InvalidPin,
         0x06 => Status::InvalidSignature,
         0x07 => Status::SessionExpired,
+        0x08 => Status::RngFailure,
+        0x09 => Status::Denied,
         _ => Status::Error,
     };
     
@@ -131,6 +150,207 @@ pub fn parse_response(frame: &[u8]) -> Result<(Status, Vec<u8>), &'static str> {
     Ok((status, data))
 }
 
+/// Tamanho do primeiro frame completo em `buf` (descarta lixo antes do SOF)
+///
+/// Retorna `(início, tamanho)` ou `None` se ainda faltam bytes.
+pub fn find_frame(buf: &[u8]) -> Option<(usize, usize)> {
+    let start = buf.iter().position(|&b| b == SOF)?;
+    let len = *buf.get(start + 1)? as usize;
+    let total = 2 + len + 2;
+    if buf.len() - start < total {
+        return None;
+    }
+    Some((start, total))
+}
+
+/// Máximo de endereços por GetAddresses (GET_ADDRESSES_MAX_COUNT no firmware)
+pub const GET_ADDRESSES_MAX_COUNT: u8 = 64;
+
+/// Payload de GetAddresses: [conta LE32][papel][início LE32][quantidade]
+pub fn get_addresses_request(account_index: u32, role: u8, start: u32, count: u8) -> Vec<u8> {
+    let mut data = Vec::with_capacity(10);
+    data.extend_from_slice(&account_index.to_le_bytes());
+    data.push(role);
+    data.extend_from_slice(&start.to_le_bytes());
+    data.push(count);
+    data
+}
+
+/// Entrada de resposta de GetAddresses: [índice LE32][endereço]
+pub fn parse_address_entry(data: &[u8]) -> Result<(u32, String), &'static str> {
+    if data.len() < 5 {
+        return Err("Address entry too short");
+    }
+    let index = u32::from_le_bytes([data[0], data[1], data[2], data[3]]);
+    let address = std::str::from_utf8(&data[4..]).map_err(|_| "Invalid address encoding")?;
+    Ok((index, address.to_string()))
+}
+
+/// Entradas de lote por frame SignTransaction (frame de 256 bytes)
+pub const SIGN_ENTRIES_PER_FRAME: usize = 6;
+/// Máximo de entradas por lote (WALLET_SIGN_BATCH_MAX no firmware)
+pub const SIGN_BATCH_MAX: usize = 64;
+/// Prazo da confirmação no botão (CONFIRM_TIMEOUT_MS no firmware)
+pub const CONFIRM_TIMEOUT_MS: u64 = 30_000;
+
+/// Payloads SignTransaction de um lote: [flags][curva][N x (conta LE32, hash 32)]
+///
+/// O primeiro frame marca o início de um lote novo (flags bit 0).
+pub fn sign_batch_requests(curve: Curve, entries: &[(u32, [u8; 32])]) -> Vec<Vec<u8>> {
+    entries
+        .chunks(SIGN_ENTRIES_PER_FRAME)
+        .enumerate()
+        .map(|(i, chunk)| {
+            let mut data = Vec::with_capacity(2 + chunk.len() * 36);
+            data.push(if i == 0 { 0x01 } else { 0x00 });
+            data.push(curve as u8);
+            for (account, hash) in chunk {
+                data.extend_from_slice(&account.to_le_bytes());
+                data.extend_from_slice(hash);
+            }
+            data
+        })
+        .collect()
+}
+
+/// Entrada de resposta de SignConfirm: [índice da entrada][assinatura 64]
+pub fn parse_signature_entry(data: &[u8]) -> Result<(usize, [u8; 64]), &'static str> {
+    if data.len() != 65 {
+        return Err("Invalid signature entry");
+    }
+    let mut signature = [0u8; 64];
+    signature.copy_from_slice(&data[1..]);
+    Ok((data[0] as usize, signature))
+}
+
+/// Lista de palavras SLIP-39 (a mesma embutida no firmware)
+const SLIP39_WORDLIST: &str = include_str!("../../../firmware/tools/slip39_english.txt");
+
+/// Payload de BackupSlip39: [threshold][partes][PIN]
+pub fn backup_slip39_request(threshold: u8, count: u8, pin: &[u8]) -> Vec<u8> {
+    let mut data = Vec::with_capacity(2 + pin.len());
+    data.push(threshold);
+    data.push(count);
+    data.extend_from_slice(pin);
+    data
+}
+
+/// Entrada de resposta de BackupSlip39: [índice][palavras][N x índice LE16],
+/// soletrada como mnemonic
+pub fn parse_share_entry(data: &[u8]) -> Result<(u8, String), &'static str> {
+    if data.len() < 2 || data.len() != 2 + 2 * data[1] as usize {
+        return Err("Invalid share entry");
+    }
+    let words: Vec<&str> = SLIP39_WORDLIST.split_whitespace().collect();
+    let mnemonic = data[2..]
+        .chunks(2)
+        .map(|c| words.get(u16::from_le_bytes([c[0], c[1]]) as usize).copied())
+        .collect::<Option<Vec<&str>>>()
+        .ok_or("Invalid share word")?
+        .join(" ");
+    Ok((data[0], mnemonic))
+}
+
+/// Backup cifrado em pedaços (WALLET_BACKUP_* no firmware)
+/// Cabeçalho: [versão][t LE32][m LE32][lanes LE32][salt 16][prefixo 7]
+/// Pedaço: [flags][índice LE16][cifrado <= BACKUP_CHUNK][tag 16]
+pub const BACKUP_VERSION: u8 = 1;
+pub const BACKUP_HEADER_SIZE: usize = 36;
+pub const BACKUP_CHUNK: usize = 128;
+pub const BACKUP_CHUNK_OVERHEAD: usize = 19;
+pub const BACKUP_MAX_PASSPHRASE: usize = 128;
+const BACKUP_FLAG_LAST: u8 = 0x01;
+
+/// Passphrase em NFKD, como o BIP-39 exige
+///
+/// O firmware usa os bytes UTF-8 como chegam; normalizar aqui faz a mesma
+/// passphrase digitada em outro teclado ou sistema dar a mesma wallet.
+pub fn normalize_passphrase(passphrase: &str) -> String {
+    passphrase.nfkd().collect()
+}
+
+/// Payload de BackupExport: [tamanho da passphrase][passphrase][PIN]
+pub fn backup_export_request(passphrase: &[u8], pin: &[u8]) -> Result<Vec<u8>, &'static str> {
+    if passphrase.is_empty() || passphrase.len() > BACKUP_MAX_PASSPHRASE {
+        return Err("Invalid backup passphrase");
+    }
+    let mut data = Vec::with_capacity(1 + passphrase.len() + pin.len());
+    data.push(passphrase.len() as u8);
+    data.extend_from_slice(passphrase);
+    data.extend_from_slice(pin);
+    Ok(data)
+}
+
+/// Payload de BackupImport, início: [0][tamanho][passphrase][cabeçalho]
+pub fn backup_import_begin_request(passphrase: &[u8], header: &[u8]) -> Result<Vec<u8>, &'static str> {
+    if passphrase.is_empty() || passphrase.len() > BACKUP_MAX_PASSPHRASE {
+        return Err("Invalid backup passphrase");
+    }
+    let mut data = Vec::with_capacity(2 + passphrase.len() + header.len());
+    data.push(0x00);
+    data.push(passphrase.len() as u8);
+    data.extend_from_slice(passphrase);
+    data.extend_from_slice(header);
+    Ok(data)
+}
+
+/// Payload de BackupImport, pedaço: [1][pedaço]
+pub fn backup_import_chunk_request(record: &[u8]) -> Vec<u8> {
+    let mut data = Vec::with_capacity(1 + record.len());
+    data.push(0x01);
+    data.extend_from_slice(record);
+    data
+}
+
+/// Payload de BackupImport, conclusão: [2][PIN novo]
+pub fn backup_import_finish_request(pin: &[u8]) -> Vec<u8> {
+    let mut data = Vec::with_capacity(1 + pin.len());
+    data.push(0x02);
+    data.extend_from_slice(pin);
+    data
+}
+
+/// Confere a estrutura do backup registro a registro, enquanto chega
+///
+/// Sem a passphrase o app não abre os pedaços: confere versão, ordem,
+/// tamanhos e o fim marcado. A autenticidade o device confere pedaço a
+/// pedaço na importação (pedaço trocado, repetido ou cortado não autentica).
+#[derive(Debug, Default)]
+pub struct BackupReader {
+    header: bool,
+    next_index: u16,
+    finished: bool,
+}
+
+impl BackupReader {
+    /// Aceita o próximo registro; Ok(true) depois do último pedaço
+    pub fn push(&mut self, record: &[u8]) -> Result<bool, &'static str> {
+        if self.finished {
+            return Err("Backup record after the last chunk");
+        }
+        if !self.header {
+            if record.len() != BACKUP_HEADER_SIZE || record[0] != BACKUP_VERSION {
+                return Err("Unsupported backup header");
+            }
+            self.header = true;
+            return Ok(false);
+        }
+        if record.len() < BACKUP_CHUNK_OVERHEAD || record.len() > BACKUP_CHUNK_OVERHEAD + BACKUP_CHUNK {
+            return Err("Invalid backup chunk size");
+        }
+        if u16::from_le_bytes([record[1], record[2]]) != self.next_index {
+            return Err("Out of order backup chunk");
+        }
+        self.next_index = self.next_index.checked_add(1).ok_or("Backup too long")?;
+        self.finished = record[0] & BACKUP_FLAG_LAST != 0;
+        Ok(self.finished)
+    }
+
+    pub fn is_finished(&self) -> bool {
+        self.finished
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -167,5 +387,140 @@ mod tests {
         assert!(result.is_ok());
         let (status, _data) = result.unwrap();
         assert_eq!(status, Status::Ok);
+
+        // PIN inválido e recusa no botão não se confundem
+        for (code, want) in [(0x05, Status::InvalidPin), (0x09, Status::Denied)] {
+            response[2] = code;
+            let crc = crc16(&response[1..len - 2]);
+            response[len - 2] = (crc & 0xFF) as u8;
+            response[len - 1] = (crc >> 8) as u8;
+            assert_eq!(parse_response(&response).unwrap().0, want);
+        }
+    }
+
+    #[test]
+    fn test_normalize_passphrase() {
+        // "é" composto e decomposto, ligadura "ﬁ": mesma passphrase
+        assert_eq!(normalize_passphrase("caf\u{e9}"), "cafe\u{301}");
+        assert_eq!(normalize_passphrase("cafe\u{301}"), "cafe\u{301}");
+        assert_eq!(normalize_passphrase("\u{fb01}m"), "fim");
+        assert_eq!(normalize_passphrase("TREZOR"), "TREZOR");
+    }
+
+    #[test]
+    fn test_find_frame_stream() {
+        // Dois frames de GetAddresses colados, precedidos de lixo
+        let mut entry = 7u32.to_le_bytes().to_vec();
+        entry.extend_from_slice(b"addr1qx");
+        let mut one = build_frame(Command::Ping, &entry);
+        one[2] = Status::Ok as u8;
+        let crc = crc16(&one[1..one.len() - 2]);
+        let n = one.len();
+        one[n - 2] = (crc & 0xFF) as u8;
+        one[n - 1] = (crc >> 8) as u8;
+
+        let mut stream = vec![0x00, 0x13];
+        stream.extend_from_slice(&one);
+        stream.extend_from_slice(&one[..4]);
+
+        let (start, total) = find_frame(&stream).unwrap();
+        assert_eq!((start, total), (2, one.len()));
+        let (status, data) = parse_response(&stream[start..start + total]).unwrap();
+        assert_eq!(status, Status::Ok);
+        assert_eq!(parse_address_entry(&data).unwrap(), (7, "addr1qx".to_string()));
+
+        // Segundo frame ainda incompleto
+        assert!(find_frame(&stream[start + total..]).is_none());
+    }
+
+    #[test]
+    fn test_sign_batch_requests() {
+        let entries: Vec<(u32, [u8; 32])> = (0..13).map(|i| (i % 2, [i as u8; 32])).collect();
+        let frames = sign_batch_requests(Curve::Ed25519, &entries);
+        assert_eq!(frames.len(), 3);
+        assert_eq!(frames[0][0], 0x01);
+        assert_eq!(frames[1][0], 0x00);
+        assert_eq!(frames[0].len(), 2 + 6 * 36);
+        assert_eq!(frames[2].len(), 2 + 36);
+        assert_eq!(&frames[2][2..6], &0u32.to_le_bytes());
+        // Cabe no frame do firmware: SOF LEN CMD DATA CRC
+        assert!(frames.iter().all(|f| f.len() + 5 <= MAX_FRAME_SIZE));
+    }
+
+    #[test]
+    fn test_get_addresses_request() {
+        let data = get_addresses_request(1, 0, 0x0102_0304, 20);
+        assert_eq!(data, vec![1, 0, 0, 0, 0, 4, 3, 2, 1, 20]);
+    }
+
+    #[test]
+    fn test_parse_share_entry() {
+        // Vetor do SLIP-0039: "duckling enlarge academic academic ..."
+        let indices: [u16; 20] = [
+            248, 288, 0, 0, 17, 753, 521, 840, 372, 497, 155, 670, 192, 448, 297, 249, 23, 173,
+            196, 496,
+        ];
+        let mut data = vec![3, 20];
+        for i in indices {
+            data.extend_from_slice(&i.to_le_bytes());
+        }
+        let (index, mnemonic) = parse_share_entry(&data).unwrap();
+        assert_eq!(index, 3);
+        assert!(mnemonic.starts_with("duckling enlarge academic academic agency"));
+        assert!(mnemonic.ends_with("critical decision keyboard"));
+        assert_eq!(mnemonic.split(' ').count(), 20);
+
+        assert!(parse_share_entry(&data[..data.len() - 1]).is_err());
+        data[2] = 0xFF;
+        data[3] = 0x03; // 1023 é válido
+        assert!(parse_share_entry(&data).is_ok());
+        data[3] = 0x04; // 1279 não
+        assert!(parse_share_entry(&data).is_err());
+    }
+
+    #[test]
+    fn test_backup_slip39_request() {
+        assert_eq!(backup_slip39_request(2, 3, b"1234"), vec![2, 3, b'1', b'2', b'3', b'4']);
+    }
+
+    #[test]
+    fn test_backup_requests() {
+        assert_eq!(backup_export_request(b"pw", b"12").unwrap(), vec![2, b'p', b'w', b'1', b'2']);
+        assert!(backup_export_request(b"", b"12").is_err());
+        assert!(backup_export_request(&[b'x'; 129], b"12").is_err());
+        let header = [BACKUP_VERSION; BACKUP_HEADER_SIZE];
+        let begin = backup_import_begin_request(b"pw", &header).unwrap();
+        assert_eq!(&begin[..4], &[0, 2, b'p', b'w']);
+        assert_eq!(begin.len(), 4 + BACKUP_HEADER_SIZE);
+        assert_eq!(backup_import_chunk_request(&[9, 8]), vec![1, 9, 8]);
+        assert_eq!(backup_import_finish_request(b"12"), vec![2, b'1', b'2']);
+    }
+
+    #[test]
+    fn test_backup_reader() {
+        let mut header = [0u8; BACKUP_HEADER_SIZE];
+        header[0] = BACKUP_VERSION;
+        let chunk = |flags: u8, index: u16, len: usize| {
+            let mut r = vec![flags];
+            r.extend_from_slice(&index.to_le_bytes());
+            r.resize(BACKUP_CHUNK_OVERHEAD + len, 0);
+            r
+        };
+
+        let mut reader = BackupReader::default();
+        assert_eq!(reader.push(&header), Ok(false));
+        assert_eq!(reader.push(&chunk(0, 0, BACKUP_CHUNK)), Ok(false));
+        assert_eq!(reader.push(&chunk(1, 1, 33)), Ok(true));
+        assert!(reader.is_finished());
+        assert!(reader.push(&chunk(1, 2, 1)).is_err());
+
+        let mut reader = BackupReader::default();
+        assert!(reader.push(&header[..35]).is_err());
+        let mut reader = BackupReader::default();
+        reader.push(&header).unwrap();
+        assert!(reader.push(&chunk(0, 1, 16)).is_err());
+        let mut reader = BackupReader::default();
+        reader.push(&header).unwrap();
+        assert!(reader.push(&chunk(0, 0, BACKUP_CHUNK + 1)).is_err());
     }
 }
@@ -2,7 +2,7 @@
 //!
 //! Comunicação serial com LibreCrypt Wallet hardware
 
-use crate::protocol::{self, Command, Status, VersionInfo, WalletStatus};
+use crate::protocol::{self, Command, Curve, Status, VersionInfo, WalletStatus};
 use crate::AppWalletStatus;
 use serialport::SerialPort;
 use std::io::{Read, Write};
@@ -12,6 +12,15 @@ use std::time::Duration;
 /// Porta serial global
 static PORT: Mutex<Option<Box<dyn SerialPort>>> = Mutex::new(None);
 
+/// Timeout de leitura padrão da porta
+const PORT_TIMEOUT: Duration = Duration::from_millis(1000);
+/// Resposta de SignConfirm: o device espera o botão por até
+/// CONFIRM_TIMEOUT_MS antes do primeiro frame
+const CONFIRM_READ_TIMEOUT: Duration = Duration::from_millis(protocol::CONFIRM_TIMEOUT_MS + 5000);
+/// Resposta de comandos com Argon2id antes do primeiro frame: a exportação
+/// de backup confere o PIN e deriva a chave do backup (~0,5 s cada)
+const KDF_READ_TIMEOUT: Duration = Duration::from_millis(5000);
+
 /// Procura dispositivo LibreCrypt conectado
 fn find_device() -> Option<String> {
     let ports = serialport::available_ports().ok()?;
@@ -40,7 +49,7 @@ fn connect() -> Result<(), String> {
     }
 
     let port = serialport::new(&port_name, 115200)
-        .timeout(Duration::from_millis(1000))
+        .timeout(PORT_TIMEOUT)
         .open()
         .map_err(|e| format!("Failed to open port: {}", e))?;
     
@@ -92,6 +101,34 @@ fn send_command(cmd: Command, data: &[u8]) -> Result<Vec<u8>, String> {
     Ok(payload)
 }
 
+/// Lê o próximo frame completo da porta, guardando o excesso em `pending`
+fn read_frame(port: &mut Box<dyn SerialPort>, pending: &mut Vec<u8>) -> Result<(Status, Vec<u8>), String> {
+    let mut raw_buffer = [0u8; 512];
+    loop {
+        if let Some((start, total)) = protocol::find_frame(pending) {
+            let frame: Vec<u8> = pending.drain(..start + total).skip(start).collect();
+            return protocol::parse_response(&frame).map_err(|e| e.to_string());
+        }
+        let n = port.read(&mut raw_buffer).map_err(|e| format!("Read error: {}", e))?;
+        if n == 0 {
+            return Err("No response".to_string());
+        }
+        pending.extend_from_slice(&raw_buffer[..n]);
+    }
+}
+
+/// Como read_frame, com outro timeout só para este frame
+fn read_frame_timeout(
+    port: &mut Box<dyn SerialPort>,
+    pending: &mut Vec<u8>,
+    timeout: Duration,
+) -> Result<(Status, Vec<u8>), String> {
+    port.set_timeout(timeout).map_err(|e| format!("Port error: {}", e))?;
+    let result = read_frame(port, pending);
+    port.set_timeout(PORT_TIMEOUT).map_err(|e| format!("Port error: {}", e))?;
+    result
+}
+
 /// Verifica se dispositivo está conectado
 pub async fn is_device_connected() -> Result<bool, String> {
     if find_device().is_some() {
@@ -169,6 +206,18 @@ pub async fn unlock(pin: &str) -> Result<bool, String> {
     Ok(true)
 }
 
+/// Troca a passphrase BIP-39 (wallet oculta); "" volta à wallet sem
+/// passphrase. A primeira troca para cada passphrase leva uma derivação de
+/// seed; as recentes voltam da cache do device.
+pub async fn set_passphrase(passphrase: &str) -> Result<(), String> {
+    let passphrase = protocol::normalize_passphrase(passphrase);
+    if passphrase.as_bytes().contains(&0) {
+        return Err("Passphrase must not contain NUL".to_string());
+    }
+    send_command(Command::SetPassphrase, passphrase.as_bytes())?;
+    Ok(())
+}
+
 /// Bloqueia wallet
 pub async fn lock() -> Result<(), String> {
     send_command(Command::Lock, &[])?;
@@ -182,6 +231,201 @@ pub async fn get_address(account_index: u32) -> Result<String, String> {
     String::from_utf8(response).map_err(|_| "Invalid address encoding".to_string())
 }
 
+/// Obtém endereços consecutivos da conta (papel externo) em um só comando
+///
+/// O firmware responde com um frame por endereço; faixas maiores que
+/// GET_ADDRESSES_MAX_COUNT são pedidas em várias rodadas.
+pub async fn get_addresses(account_index: u32, start: u32, count: u32) -> Result<Vec<String>, String> {
+    let mut port_guard = PORT.lock().map_err(|_| "Lock error")?;
+    let port = port_guard.as_mut().ok_or("Not connected")?;
+
+    let mut addresses = Vec::with_capacity(count as usize);
+    let mut pending = Vec::new();
+    let end = start.checked_add(count).ok_or("Invalid range")?;
+
+    while (addresses.len() as u32) < count {
+        let next = start + addresses.len() as u32;
+        let batch = (end - next).min(protocol::GET_ADDRESSES_MAX_COUNT as u32) as u8;
+        let data = protocol::get_addresses_request(account_index, 0, next, batch);
+
+        let _ = port.clear(serialport::ClearBuffer::Input);
+        pending.clear();
+        port.write_all(&protocol::build_frame(Command::GetAddresses, &data))
+            .map_err(|e| format!("Write error: {}", e))?;
+
+        for i in 0..batch as u32 {
+            let (status, payload) = read_frame(port, &mut pending)?;
+            if status != Status::Ok {
+                return Err(format!("Device returned status: {:?}", status));
+            }
+            let (index, address) = protocol::parse_address_entry(&payload)?;
+            if index != next + i {
+                return Err("Out of order address".to_string());
+            }
+            addresses.push(address);
+        }
+    }
+
+    Ok(addresses)
+}
+
+/// Gera o backup SLIP-39 da wallet: `count` partes, `threshold` restauram
+///
+/// O firmware confere o PIN de novo e responde com um frame por parte
+/// (índices de palavras); as partes voltam soletradas, em ordem de índice.
+pub async fn backup_slip39(pin: &str, threshold: u8, count: u8) -> Result<Vec<String>, String> {
+    let mut port_guard = PORT.lock().map_err(|_| "Lock error")?;
+    let port = port_guard.as_mut().ok_or("Not connected")?;
+    let mut pending = Vec::new();
+    let _ = port.clear(serialport::ClearBuffer::Input);
+
+    let data = protocol::backup_slip39_request(threshold, count, pin.as_bytes());
+    port.write_all(&protocol::build_frame(Command::BackupSlip39, &data))
+        .map_err(|e| format!("Write error: {}", e))?;
+
+    let mut shares: Vec<Option<String>> = vec![None; count as usize];
+    for _ in 0..count {
+        let (status, payload) = read_frame(port, &mut pending)?;
+        if status != Status::Ok {
+            return Err(format!("Device returned status: {:?}", status));
+        }
+        let (index, mnemonic) = protocol::parse_share_entry(&payload)?;
+        *shares.get_mut(index as usize).ok_or("Invalid share index")? = Some(mnemonic);
+    }
+
+    shares.into_iter().map(|s| s.ok_or_else(|| "Missing share".to_string())).collect()
+}
+
+/// Exporta o backup cifrado da wallet: cabeçalho e pedaços, em hex
+///
+/// O firmware confere o PIN de novo e responde com um frame por registro;
+/// cada um é conferido ao chegar e o fim só vale com o último pedaço.
+pub async fn backup_export(pin: &str, passphrase: &str) -> Result<Vec<String>, String> {
+    let passphrase = protocol::normalize_passphrase(passphrase);
+    let data = protocol::backup_export_request(passphrase.as_bytes(), pin.as_bytes())?;
+
+    let mut port_guard = PORT.lock().map_err(|_| "Lock error")?;
+    let port = port_guard.as_mut().ok_or("Not connected")?;
+    let mut pending = Vec::new();
+    let _ = port.clear(serialport::ClearBuffer::Input);
+
+    port.write_all(&protocol::build_frame(Command::BackupExport, &data))
+        .map_err(|e| format!("Write error: {}", e))?;
+
+    let mut reader = protocol::BackupReader::default();
+    let mut records = Vec::new();
+    while !reader.is_finished() {
+        // Os dois Argon2id vêm antes do cabeçalho
+        let (status, payload) = if records.is_empty() {
+            read_frame_timeout(port, &mut pending, KDF_READ_TIMEOUT)?
+        } else {
+            read_frame(port, &mut pending)?
+        };
+        if status != Status::Ok {
+            return Err(format!("Device returned status: {:?}", status));
+        }
+        reader.push(&payload)?;
+        records.push(hex::encode(&payload));
+    }
+
+    Ok(records)
+}
+
+/// Importa um backup cifrado num device sem wallet, com PIN novo
+///
+/// A estrutura é conferida inteira antes de enviar; o device confere cada
+/// pedaço ao receber e recusa já no primeiro se a passphrase não confere.
+pub async fn backup_import(records: &[String], passphrase: &str, pin: &str) -> Result<(), String> {
+    let records = records
+        .iter()
+        .map(|r| hex::decode(r).map_err(|_| "Invalid backup encoding".to_string()))
+        .collect::<Result<Vec<Vec<u8>>, String>>()?;
+    let mut reader = protocol::BackupReader::default();
+    for record in &records {
+        reader.push(record)?;
+    }
+    if !reader.is_finished() {
+        return Err("Incomplete backup".to_string());
+    }
+
+    let passphrase = protocol::normalize_passphrase(passphrase);
+    let mut requests = vec![protocol::backup_import_begin_request(passphrase.as_bytes(), &records[0])?];
+    requests.extend(records[1..].iter().map(|r| protocol::backup_import_chunk_request(r)));
+    requests.push(protocol::backup_import_finish_request(pin.as_bytes()));
+
+    let mut port_guard = PORT.lock().map_err(|_| "Lock error")?;
+    let port = port_guard.as_mut().ok_or("Not connected")?;
+    let mut pending = Vec::new();
+    let _ = port.clear(serialport::ClearBuffer::Input);
+
+    let last = requests.len() - 1;
+    for (i, data) in requests.into_iter().enumerate() {
+        port.write_all(&protocol::build_frame(Command::BackupImport, &data))
+            .map_err(|e| format!("Write error: {}", e))?;
+        // Início deriva a chave do backup; conclusão calibra e deriva o PIN
+        let (status, _) = if i == 0 || i == last {
+            read_frame_timeout(port, &mut pending, KDF_READ_TIMEOUT)?
+        } else {
+            read_frame(port, &mut pending)?
+        };
+        if status != Status::Ok {
+            return Err(format!("Device returned status: {:?}", status));
+        }
+    }
+
+    Ok(())
+}
+
+/// Assina um lote de hashes com uma única confirmação
+///
+/// Envia as entradas em frames SignTransaction, recebe o digest do lote e
+/// confirma com ele; o firmware devolve um frame por assinatura, agrupado
+/// por conta. Chamar só depois que o usuário aprovou o lote na interface.
+pub async fn sign_batch(curve: Curve, entries: &[(u32, [u8; 32])]) -> Result<Vec<[u8; 64]>, String> {
+    if entries.is_empty() || entries.len() > protocol::SIGN_BATCH_MAX {
+        return Err("Invalid batch size".to_string());
+    }
+
+    let mut port_guard = PORT.lock().map_err(|_| "Lock error")?;
+    let port = port_guard.as_mut().ok_or("Not connected")?;
+    let mut pending = Vec::new();
+    let _ = port.clear(serialport::ClearBuffer::Input);
+
+    let mut digest = Vec::new();
+    for data in protocol::sign_batch_requests(curve, entries) {
+        port.write_all(&protocol::build_frame(Command::SignTransaction, &data))
+            .map_err(|e| format!("Write error: {}", e))?;
+        let (status, payload) = read_frame(port, &mut pending)?;
+        if status != Status::NeedConfirm || payload.len() != 33 {
+            return Err(format!("Device returned status: {:?}", status));
+        }
+        digest = payload[1..].to_vec();
+    }
+
+    port.write_all(&protocol::build_frame(Command::SignConfirm, &digest))
+        .map_err(|e| format!("Write error: {}", e))?;
+
+    let mut signatures: Vec<Option<[u8; 64]>> = vec![None; entries.len()];
+    for i in 0..entries.len() {
+        // O primeiro frame só vem depois da confirmação no botão
+        let (status, payload) = if i == 0 {
+            read_frame_timeout(port, &mut pending, CONFIRM_READ_TIMEOUT)?
+        } else {
+            read_frame(port, &mut pending)?
+        };
+        if status == Status::Denied {
+            return Err("Batch not confirmed on the device".to_string());
+        }
+        if status != Status::Ok {
+            return Err(format!("Device returned status: {:?}", status));
+        }
+        let (entry, signature) = protocol::parse_signature_entry(&payload)?;
+        *signatures.get_mut(entry).ok_or("Invalid signature entry")? = Some(signature);
+    }
+
+    signatures.into_iter().map(|s| s.ok_or_else(|| "Missing signature".to_string())).collect()
+}
+
 /// Assina transação
 pub async fn sign_transaction(account_index: u32, to_address: &str, amount: u64, fee: u64) -> Result<String, String> {
     // Serializar dados da transação para envio ao hardware
@@ -0,0 +1,29 @@
+/**
+ * Benchmarks no host: bench_run sobre a flash simulada
+ *
+ * Uso: librecrypt_bench [arquivo da flash]
+ */
+
+#include "bench.h"
+#include "flash_nor.h"
+#include "librecipher.h"
+#include "usb_protocol.h"
+#include "wallet.h"
+#include <stdio.h>
+
+int main(int argc, char **argv) {
+  const char *path = argc > 1 ? argv[1] : "bench_flash.bin";
+
+  // Flash apagada a cada execução: o bench exige device sem wallet
+  remove(path);
+  if (!flash_nor_sim_open(path, PICO_FLASH_SIZE_BYTES)) {
+    fprintf(stderr, "flash simulada: não abriu %s\n", path);
+    return 1;
+  }
+  librecipher_init();
+  wallet_init();
+  usb_protocol_init();
+  bench_run();
+  flash_nor_sim_close();
+  return 0;
+}
@@ -0,0 +1,24 @@
+/**
+ * Plataforma do build de host: relógio e ID de placa do SDK
+ */
+
+#include "pico/stdlib.h"
+#include "pico/unique_id.h"
+#include <time.h>
+
+uint64_t time_us_64(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+void sleep_ms(uint32_t ms) {
+  struct timespec ts = {ms / 1000, (long)(ms % 1000) * 1000000L};
+  nanosleep(&ts, NULL);
+}
+
+void pico_get_unique_board_id(pico_unique_board_id_t *id) {
+  for (int i = 0; i < PICO_UNIQUE_BOARD_ID_SIZE_BYTES; i++) {
+    id->id[i] = (uint8_t)(0xE6 + i);
+  }
+}
@@ -0,0 +1,21 @@
+/**
+ * pico/stdlib.h para o build de host (LIBRECIPHER_HOST)
+ *
+ * Só o que o código portável usa; as implementações ficam em
+ * host/platform.c.
+ */
+
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PICO_ERROR_TIMEOUT -1
+
+static inline void tight_loop_contents(void) {}
+
+uint64_t time_us_64(void);
+void sleep_ms(uint32_t ms);
+
+#endif // HOST_PICO_STDLIB_H
@@ -0,0 +1,162 @@
+/**
+ * Vetores do HMAC-DRBG (SP 800-90A, HMAC-SHA256)
+ *
+ * - NIST CAVP HMAC_DRBG SHA-256, sem reseed nem prediction resistance,
+ *   COUNT 0: dois generates de 1024 bits, confere o segundo
+ * - fonte determinística do host (entropy_test_source) com a
+ *   personalização de librecipher_random: reseed automático após
+ *   DRBG_RESEED_INTERVAL chamadas, pedido cortado em DRBG_MAX_REQUEST,
+ *   reseed explícito com entrada adicional. Esperados de uma
+ *   implementação Python independente
+ * - fonte em falha: nada é gerado
+ */
+
+#include "drbg.h"
+#include "sha256.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <string.h>
+
+// CAVP: EntropyInput || Nonce (48 bytes = DRBG_SEED_SIZE)
+static const char CAVP_SEED[] =
+    "ca851911349384bffe89de1cbdc46e6831e44d34a4fb935ee285dd14b71a7488"
+    "659ba96c601dc69fc902940805ec0ca8";
+static const char CAVP_RETURNED[] =
+    "e528e9abf2dece54d47c7e75e5fe302149f817ea9fb4bee6f4199697d04d5b89"
+    "d54fbb978a15b5c443c9ec21036d2460b6f73ebad0dc2aba6e624abf07745bc1"
+    "07694bb7547bb0995f70de25d6b29e2d3011bb19d27676c07162c8b5ccde0668"
+    "961df86803482cb37ed6d5c0bb8d50cf1f50d476aa0458bdaba806f48be9dcb8";
+
+// Fonte determinística, semente 00 01 .. 1f
+static const char FIRST_32[] =
+    "08c050fc4d8e05166c5c2299e50dc16467e8cf2d599ea1392c3e957a9635deae";
+// SHA-256 das 1025 saídas de 32 bytes (a última depois do reseed)
+static const char INTERVAL_DIGEST[] =
+    "bf6ed088d2857d520cada70ff7fcd93cb54038a71d68aea28b346a2d2546d262";
+// SHA-256 de um pedido de 150000 bytes (três pedaços internos)
+static const char LARGE_DIGEST[] =
+    "69e01f81209e370e30d5313ecb751d7d71ef727ce41402a3b1c3d2d8c25c8b3d";
+// 50 bytes depois de drbg_reseed(..., "reseed-additional")
+static const char AFTER_RESEED[] =
+    "597c23589ec35ab360d344c045ff7cec038df40e1b748858081acc76a69774cb"
+    "4e40d94a39f15293213357558035a072c4d5";
+
+#define LARGE_REQUEST 150000
+
+// Fonte com um buffer fixo; recusa quando ele acaba
+typedef struct {
+  const uint8_t *data;
+  size_t len;
+} fixed_source_t;
+
+static bool fixed_source(uint8_t *buf, size_t len, void *ctx) {
+  fixed_source_t *src = (fixed_source_t *)ctx;
+  if (len > src->len) {
+    return false;
+  }
+  memcpy(buf, src->data, len);
+  src->data += len;
+  src->len -= len;
+  return true;
+}
+
+static void test_cavp(void) {
+  uint8_t seed[DRBG_SEED_SIZE];
+  uint8_t out[128];
+  fixed_source_t src = {seed, sizeof(seed)};
+  drbg_ctx_t ctx;
+
+  hex_decode(seed, CAVP_SEED, sizeof(seed));
+  expect(drbg_init(&ctx, fixed_source, &src, NULL, 0), "CAVP: init");
+  expect(drbg_generate(&ctx, out, sizeof(out)), "CAVP: generate 1");
+  expect(drbg_generate(&ctx, out, sizeof(out)), "CAVP: generate 2");
+  expect_hex(out, CAVP_RETURNED, sizeof(out), "CAVP: ReturnedBits");
+  drbg_clear(&ctx);
+}
+
+static void test_host_source(void) {
+  static const uint8_t personalization[] = "LibreCipher-DRBG";
+  static const uint8_t additional[] = "reseed-additional";
+  static uint8_t large[LARGE_REQUEST];
+  entropy_test_source_t src = {.counter = 0};
+  uint8_t out[50], digest[32];
+  sha256_ctx_t sha;
+  drbg_ctx_t ctx;
+
+  for (int i = 0; i < 32; i++) {
+    src.seed[i] = (uint8_t)i;
+  }
+  expect(drbg_init(&ctx, entropy_test_source, &src, personalization,
+                   sizeof(personalization) - 1),
+         "host: init");
+
+  // 1025 chamadas: a última passa do intervalo e re-semeia antes
+  sha256_init(&sha);
+  for (int i = 0; i <= DRBG_RESEED_INTERVAL; i++) {
+    expect(drbg_generate(&ctx, out, 32), "host: generate");
+    if (i == 0) {
+      expect_hex(out, FIRST_32, 32, "host: primeira saída");
+    }
+    sha256_update(&sha, out, 32);
+  }
+  sha256_final(&sha, digest);
+  expect_hex(digest, INTERVAL_DIGEST, 32, "host: saídas do intervalo");
+  expect(ctx.reseed_count == 1 && ctx.reseed_counter == 2,
+         "host: reseed automático");
+
+  // Acima de DRBG_MAX_REQUEST: um generate interno por pedaço
+  _Static_assert(LARGE_REQUEST > 2 * DRBG_MAX_REQUEST,
+                 "large request must span three chunks");
+  expect(drbg_generate(&ctx, large, sizeof(large)), "host: pedido grande");
+  sha256_hash(large, sizeof(large), digest);
+  expect_hex(digest, LARGE_DIGEST, 32, "host: pedido grande");
+  expect(ctx.reseed_counter == 5, "host: pedaços do pedido grande");
+
+  expect(drbg_reseed(&ctx, additional, sizeof(additional) - 1),
+         "host: reseed explícito");
+  expect(drbg_generate(&ctx, out, sizeof(out)), "host: generate");
+  expect_hex(out, AFTER_RESEED, sizeof(out), "host: saída após reseed");
+
+  expect(ctx.reseed_count == 2 && src.counter == 4,
+         "host: entropia consumida");
+  expect(ctx.bytes_generated ==
+             32ull * (DRBG_RESEED_INTERVAL + 1) + LARGE_REQUEST + sizeof(out),
+         "host: bytes gerados");
+  drbg_clear(&ctx);
+}
+
+static void test_source_failure(void) {
+  uint8_t seed[DRBG_SEED_SIZE] = {0};
+  uint8_t out[32];
+  fixed_source_t src = {seed, sizeof(seed) - 1};
+  drbg_ctx_t ctx;
+
+  // Semente incompleta: não instancia, não gera
+  expect(!drbg_init(&ctx, fixed_source, &src, NULL, 0), "falha: init aceito");
+  expect(!drbg_generate(&ctx, out, sizeof(out)), "falha: gerou sem semente");
+
+  // Reseed obrigatório sem entropia: recusa em vez de passar do intervalo
+  src.data = seed;
+  src.len = sizeof(seed);
+  expect(drbg_init(&ctx, fixed_source, &src, NULL, 0), "falha: init");
+  for (int i = 0; i < DRBG_RESEED_INTERVAL; i++) {
+    drbg_generate(&ctx, out, sizeof(out));
+  }
+  expect(!drbg_generate(&ctx, out, sizeof(out)),
+         "falha: gerou após o intervalo sem reseed");
+
+  drbg_clear(&ctx);
+  expect(!drbg_generate(&ctx, out, sizeof(out)), "falha: gerou após clear");
+}
+
+int main(void) {
+  test_cavp();
+  test_host_source();
+  test_source_failure();
+
+  if (!g_ok) {
+    return 1;
+  }
+  printf("drbg: ok\n");
+  return 0;
+}
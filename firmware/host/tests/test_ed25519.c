@@ -0,0 +1,174 @@
+/**
+ * Vetores do Ed25519 (RFC 8032 7.1)
+ *
+ * - TEST 1, 2, 3 e SHA(abc): chave pública e assinatura exatas, também
+ *   pela chave expandida; verificação direta e pelo contexto da chave
+ * - S não canônico (S + L) recusado; R, S, mensagem ou chave alterados
+ *   recusados, com ed25519_verify e ed25519_verify_ctx sempre de acordo
+ * - tabela gerada das chaves do fabricante (o build de host usa a chave
+ *   do TEST 1) verifica como o contexto calculado em tempo de execução
+ */
+
+#include "bootloader.h"
+#include "ed25519.h"
+#include "sha512.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+  const char *seed, *public_key, *message, *signature;
+} ed_vector_t;
+
+// SHA(abc): a mensagem é SHA-512("abc"), montada em test_vectors
+static const ed_vector_t VECTORS[] = {
+    {"9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60",
+     "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a", "",
+     "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e06522490155"
+     "5fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b"},
+    {"4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb",
+     "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c", "72",
+     "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da"
+     "085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00"},
+    {"c5aa8df43f9f837bedb7442f31dcb7b166d38535076f094b85ce3a2e0b4458f7",
+     "fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025",
+     "af82",
+     "6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac"
+     "18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a"},
+    {"833fe62409237b9d62ec77587520911e9a759cec1d19755b7da901b96dca3d42",
+     "ec172b93ad5e563bf4932c70e1245034c35467ef2efd4d64ebf819683467e2bf",
+     NULL,
+     "dc2a4459e7369633a52b1bf277839a00201009a3efbf3ecb69bea2186c26b589"
+     "09351fc9ac90b3ecfdfbc7c66431e0303dca179c138ac17ad9bef1177331a704"},
+};
+#define VECTOR_COUNT (sizeof(VECTORS) / sizeof(VECTORS[0]))
+
+// Ordem do subgrupo, little-endian
+static const uint8_t L[32] = {0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58,
+                              0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+                              0,    0,    0,    0,    0,    0,    0,    0,
+                              0,    0,    0,    0,    0,    0,    0,    0x10};
+
+// As duas verificações dão o mesmo veredito; devolve o de ed25519_verify
+static bool verify_both(const uint8_t signature[64], const uint8_t *message,
+                        size_t len, const uint8_t public_key[32],
+                        const ed25519_pubkey_ctx_t *ctx, size_t vector) {
+  bool plain = ed25519_verify(signature, message, len, public_key);
+  bool cached = ed25519_verify_ctx(signature, message, len, ctx);
+
+  expect_vector(plain == cached, "ed25519_verify_ctx diverge", vector);
+  return plain;
+}
+
+static void test_vectors(void) {
+  ed25519_keypair_t keypair;
+  ed25519_expanded_key_t expanded;
+  ed25519_pubkey_ctx_t ctx;
+  uint8_t seed[32], public_key[32], message[65], signature[64];
+  uint8_t got[64], bad[64], other[32];
+
+  for (size_t i = 0; i < VECTOR_COUNT; i++) {
+    const ed_vector_t *v = &VECTORS[i];
+    size_t len;
+
+    hex_decode(seed, v->seed, 32);
+    hex_decode(public_key, v->public_key, 32);
+    hex_decode(signature, v->signature, 64);
+    if (v->message != NULL) {
+      len = strlen(v->message) / 2;
+      hex_decode(message, v->message, len);
+    } else {
+      len = 64;
+      sha512_hash((const uint8_t *)"abc", 3, message);
+    }
+
+    ed25519_create_keypair(seed, &keypair);
+    expect_vector(memcmp(keypair.public_key, public_key, 32) == 0,
+                  "chave pública", i);
+    ed25519_sign(got, message, len, keypair.secret_key);
+    expect_vector(memcmp(got, signature, 64) == 0, "assinatura", i);
+
+    ed25519_expand_key(&expanded, keypair.secret_key);
+    ed25519_sign_expanded(got, message, len, &expanded);
+    expect_vector(memcmp(got, signature, 64) == 0,
+                  "assinatura (chave expandida)", i);
+    ed25519_expanded_key_clear(&expanded);
+
+    if (!ed25519_pubkey_ctx_init(&ctx, public_key)) {
+      expect_vector(false, "contexto da chave recusado", i);
+      continue;
+    }
+    expect_vector(verify_both(signature, message, len, public_key, &ctx, i),
+                  "verificação", i);
+
+    // S + L: mesmo valor mod L, codificação não canônica
+    memcpy(bad, signature, 64);
+    unsigned carry = 0;
+    for (int k = 0; k < 32; k++) {
+      carry += bad[32 + k] + L[k];
+      bad[32 + k] = (uint8_t)carry;
+      carry >>= 8;
+    }
+    expect_vector(carry == 0 && !verify_both(bad, message, len, public_key,
+                                             &ctx, i),
+                  "S não canônico aceito", i);
+
+    memcpy(bad, signature, 64);
+    bad[0] ^= 0x01;
+    expect_vector(!verify_both(bad, message, len, public_key, &ctx, i),
+                  "R alterado aceito", i);
+    memcpy(bad, signature, 64);
+    bad[40] ^= 0x01;
+    expect_vector(!verify_both(bad, message, len, public_key, &ctx, i),
+                  "S alterado aceito", i);
+    message[len] = 0x00;
+    expect_vector(!verify_both(signature, message, len + 1, public_key, &ctx,
+                               i),
+                  "mensagem alterada aceita", i);
+
+    // Assinatura de outro vetor com esta chave
+    hex_decode(other, VECTORS[(i + 1) % VECTOR_COUNT].public_key, 32);
+    expect_vector(!ed25519_verify(signature, message, len, other),
+                  "chave errada aceita", i);
+  }
+}
+
+// Chave de teste do RFC 8032 na tabela do build de host
+static void test_vendor_table(void) {
+  ed25519_pubkey_ctx_t ctx;
+  uint8_t public_key[32], signature[64];
+  size_t found = 0;
+
+  hex_decode(public_key, VECTORS[0].public_key, 32);
+  hex_decode(signature, VECTORS[0].signature, 64);
+  expect(ed25519_pubkey_ctx_init(&ctx, public_key), "TEST 1: contexto");
+
+  for (size_t k = 0; k < bootloader_vendor_key_count; k++) {
+    const ed25519_pubkey_ctx_t *table = &bootloader_vendor_keys[k];
+    if (memcmp(table->public_key, public_key, 32) != 0) {
+      continue;
+    }
+    found++;
+    expect(ed25519_verify_ctx(signature, NULL, 0, table),
+           "tabela: TEST 1 recusado");
+    signature[63] ^= 0x01;
+    expect(!ed25519_verify_ctx(signature, NULL, 0, table) &&
+               !ed25519_verify_ctx(signature, NULL, 0, &ctx),
+           "tabela: assinatura alterada aceita");
+    signature[63] ^= 0x01;
+  }
+  if (found == 0) {
+    printf("tabela do fabricante sem a chave do TEST 1: pulado\n");
+  }
+}
+
+int main(void) {
+  test_vectors();
+  test_vendor_table();
+
+  if (!g_ok) {
+    return 1;
+  }
+  printf("ed25519: %u vetores, ok\n", (unsigned)VECTOR_COUNT);
+  return 0;
+}
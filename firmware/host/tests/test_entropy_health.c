@@ -0,0 +1,155 @@
+/**
+ * Testes de saúde da fonte de entropia (SP 800-90B 4.4) com o oscilador
+ * simulado
+ *
+ * - ruidoso: nenhuma falha em muitas janelas; o pool enche e serve
+ * - travado: repetition count falha ainda no teste de partida, antes de
+ *   qualquer bloco
+ * - enviesado: adaptive proportion falha
+ * Uma falha fica travada: pool apagado, coleta parada, fonte recusando,
+ * até o reset.
+ *
+ * Uso: test_entropy_health [bytes brutos do caso ruidoso]
+ */
+
+#include "entropy.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool all_zero(const uint8_t *buf, size_t len) {
+  uint8_t acc = 0;
+  for (size_t i = 0; i < len; i++) {
+    acc |= buf[i];
+  }
+  return acc == 0;
+}
+
+// Falha travada: nada mais é testado nem servido até o reset
+static void expect_latched(uint8_t flag, const char *mode) {
+  entropy_health_t before, after;
+  uint8_t buf[ENTROPY_BLOCK_SIZE];
+  char what[96];
+
+  entropy_health_get(&before);
+  snprintf(what, sizeof(what), "%s: falha esperada (0x%02x) não travou",
+           mode, flag);
+  expect((before.failures & flag) != 0, what);
+
+  entropy_pool_harvest(4 * ENTROPY_RAW_PER_BLOCK);
+  snprintf(what, sizeof(what), "%s: fonte serviu após falha", mode);
+  expect(!entropy_default_source(buf, sizeof(buf), NULL), what);
+  snprintf(what, sizeof(what), "%s: pool não vazio", mode);
+  expect(entropy_pool_level() == 0 && !entropy_available(1), what);
+
+  entropy_health_get(&after);
+  snprintf(what, sizeof(what), "%s: coleta continuou após falha", mode);
+  expect(after.raw_bits == before.raw_bits, what);
+  snprintf(what, sizeof(what), "%s: falhas mudaram após travar", mode);
+  expect(after.failures == before.failures, what);
+}
+
+static void test_noisy(uint32_t raw_bytes) {
+  entropy_health_t health;
+  uint8_t buf[ENTROPY_POOL_SIZE + 16];
+
+  entropy_sim_reset(ENTROPY_SIM_NOISY);
+
+  // Bits de partida só exercitam os testes
+  entropy_pool_harvest(ENTROPY_STARTUP_BITS / 8);
+  entropy_health_get(&health);
+  expect(health.startup_done, "ruidoso: partida não concluída");
+  expect(entropy_pool_level() == 0, "ruidoso: bloco antes da partida");
+
+  entropy_pool_harvest(ENTROPY_POOL_BLOCKS * ENTROPY_RAW_PER_BLOCK);
+  expect(entropy_pool_level() == ENTROPY_POOL_SIZE, "ruidoso: pool não encheu");
+
+  // Pool cheio e mais: o resto é colhido em primeiro plano
+  expect(entropy_default_source(buf, sizeof(buf), NULL),
+         "ruidoso: fonte recusou");
+  expect(!all_zero(buf, sizeof(buf)), "ruidoso: saída nula");
+
+  // Muitas janelas sem falso positivo
+  for (uint32_t done = 0; done < raw_bytes; done += ENTROPY_RAW_PER_BLOCK) {
+    entropy_pool_harvest(ENTROPY_RAW_PER_BLOCK);
+    expect(entropy_default_source(buf, ENTROPY_BLOCK_SIZE, NULL),
+           "ruidoso: fonte recusou");
+  }
+  entropy_health_get(&health);
+  expect(health.failures == 0, "ruidoso: falso positivo");
+  expect(health.apt_windows >= raw_bytes * 8 / ENTROPY_APT_WINDOW,
+         "ruidoso: janelas APT não avançaram");
+  expect(health.apt_max_count < ENTROPY_APT_CUTOFF,
+         "ruidoso: contagem APT acima do corte");
+
+  printf("ruidoso: %u bits, %u janelas, maior contagem APT %u/%u\n",
+         (unsigned)health.raw_bits, (unsigned)health.apt_windows,
+         (unsigned)health.apt_max_count, (unsigned)ENTROPY_APT_CUTOFF);
+}
+
+static void test_stuck(void) {
+  entropy_health_t health;
+
+  entropy_sim_reset(ENTROPY_SIM_STUCK);
+  entropy_pool_harvest(ENTROPY_RAW_PER_BLOCK);
+
+  entropy_health_get(&health);
+  expect(health.failures == ENTROPY_HEALTH_RCT, "travado: RCT não disparou");
+  expect(!health.startup_done, "travado: passou do teste de partida");
+  // Corte em ENTROPY_RCT_CUTOFF bits repetidos; a coleta confere as falhas
+  // a cada lote de ENTROPY_HARVEST_BYTES
+  _Static_assert(ENTROPY_RCT_CUTOFF <= ENTROPY_HARVEST_BYTES * 8,
+                 "RCT cutoff spans more than one harvest batch");
+  expect(health.raw_bits <= ENTROPY_HARVEST_BYTES * 8, "travado: RCT demorou");
+  expect_latched(ENTROPY_HEALTH_RCT, "travado");
+
+  printf("travado: RCT após %u bits\n", (unsigned)health.raw_bits);
+}
+
+static void test_biased(void) {
+  entropy_health_t health;
+
+  entropy_sim_reset(ENTROPY_SIM_BIASED);
+  // ~85% de uns passa do corte já na primeira janela
+  entropy_pool_harvest(4 * ENTROPY_APT_WINDOW / 8);
+
+  entropy_health_get(&health);
+  expect((health.failures & ENTROPY_HEALTH_APT) != 0,
+         "enviesado: APT não disparou");
+  expect(health.raw_bits <= 2 * ENTROPY_APT_WINDOW, "enviesado: APT demorou");
+  expect_latched(ENTROPY_HEALTH_APT, "enviesado");
+
+  printf("enviesado: falhas 0x%02x após %u bits\n", (unsigned)health.failures,
+         (unsigned)health.raw_bits);
+}
+
+// Só o reset destrava; a fonte volta a servir
+static void test_reset_clears(void) {
+  uint8_t buf[ENTROPY_BLOCK_SIZE];
+
+  entropy_sim_reset(ENTROPY_SIM_STUCK);
+  entropy_pool_harvest(ENTROPY_RAW_PER_BLOCK);
+  expect(entropy_health_failures() != 0, "reset: travado não falhou");
+
+  entropy_sim_reset(ENTROPY_SIM_NOISY);
+  expect(entropy_health_failures() == 0, "reset: falha não limpa");
+  expect(entropy_default_source(buf, sizeof(buf), NULL),
+         "reset: fonte não voltou");
+}
+
+int main(int argc, char **argv) {
+  uint32_t raw_bytes = argc > 1 ? (uint32_t)atoi(argv[1]) : 1u << 20;
+
+  entropy_pool_start();
+  test_noisy(raw_bytes);
+  test_stuck();
+  test_biased();
+  test_reset_clears();
+
+  if (!g_ok) {
+    return 1;
+  }
+  printf("entropia: ok\n");
+  return 0;
+}
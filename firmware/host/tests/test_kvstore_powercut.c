@@ -0,0 +1,175 @@
+/**
+ * Fuzz de corte de energia do kvstore sobre a flash simulada
+ *
+ * Puts, deletes e erases ociosos aleatórios; de vez em quando a energia
+ * cai depois de um número aleatório de bytes programados e o store é
+ * remontado. Invariantes:
+ * - todo valor confirmado sobrevive; a operação interrompida vale inteira
+ *   ou não vale
+ * - sem corte armado, um put sempre passa (o store nunca trava, por mais
+ *   que o GC tenha sido interrompido)
+ *
+ * Uso: test_kvstore_powercut [setores] [sementes] [iterações] [ids]
+ */
+
+#include "flash_nor.h"
+#include "kvstore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FLASH_PATH "kvstore_powercut.bin"
+#define FLASH_SIZE (64 * FLASH_NOR_SECTOR_SIZE)
+#define STORE_BASE (16 * FLASH_NOR_SECTOR_SIZE)
+#define MAX_KEYS KVSTORE_MAX_KEYS
+
+// Valor esperado de um id: versão (semente do conteúdo) e tamanho; len 0
+// = ausente
+typedef struct {
+  uint32_t version;
+  size_t len;
+} expected_t;
+
+static uint32_t g_rng;
+static uint32_t g_keys = MAX_KEYS; // ids em uso (dados vivos)
+
+static uint32_t rng_next(void) {
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 17;
+  g_rng ^= g_rng << 5;
+  return g_rng;
+}
+
+static void fill_value(uint8_t *value, uint16_t id, const expected_t *e) {
+  for (size_t i = 0; i < e->len; i++) {
+    value[i] = (uint8_t)(e->version * 131 + id * 17 + i);
+  }
+}
+
+static bool value_matches(kvstore_t *kv, uint16_t id, const expected_t *e) {
+  uint8_t got[KVSTORE_MAX_VALUE];
+  uint8_t want[KVSTORE_MAX_VALUE];
+
+  size_t len = kvstore_get(kv, id, got, sizeof(got));
+  if (len != e->len) {
+    return false;
+  }
+  fill_value(want, id, e);
+  return memcmp(got, want, len) == 0;
+}
+
+static const uint8_t g_key[32] = {0x4B, 0x56};
+
+static bool remount(kvstore_t *kv, uint32_t sectors) {
+  flash_nor_sim_close();
+  return flash_nor_sim_open(FLASH_PATH, FLASH_SIZE) &&
+         kvstore_mount(kv, STORE_BASE, sectors, g_key);
+}
+
+static void report(const char *what, const kvstore_t *kv, uint32_t sectors,
+                   uint32_t seed, uint32_t iter) {
+  printf("FALHOU: %s (%u setores, semente %u, iteração %u: livres %u, "
+         "head_offset %u, gc_offset %u)\n",
+         what, (unsigned)sectors, (unsigned)seed, (unsigned)iter,
+         (unsigned)kvstore_free_sectors(kv), (unsigned)kv->head_offset,
+         (unsigned)kv->gc_offset);
+}
+
+static bool run(uint32_t sectors, uint32_t seed, uint32_t iterations,
+                uint32_t *cuts) {
+  static kvstore_t kv;
+  expected_t expected[MAX_KEYS] = {{0}};
+  uint8_t value[KVSTORE_MAX_VALUE];
+  uint32_t version = 0;
+
+  g_rng = seed * 2654435761u + 1;
+  remove(FLASH_PATH);
+  if (!remount(&kv, sectors) || !kvstore_format(&kv)) {
+    printf("FALHOU: montagem inicial\n");
+    return false;
+  }
+
+  for (uint32_t iter = 0; iter < iterations; iter++) {
+    uint32_t r = rng_next();
+    bool cut = r % 23 == 0;
+    uint16_t id = (uint16_t)(rng_next() % g_keys);
+    expected_t next = {++version, 0};
+
+    if (cut) {
+      flash_nor_sim_power_cut(rng_next() % 1200);
+    }
+
+    bool ok;
+    switch (rng_next() % 10) {
+    case 0:
+      ok = kvstore_delete(&kv, id);
+      break;
+    case 1:
+      flash_nor_erase_step();
+      ok = true;
+      next = expected[id];
+      break;
+    default:
+      next.len = 1 + rng_next() % KVSTORE_MAX_VALUE;
+      fill_value(value, id, &next);
+      ok = kvstore_put(&kv, id, value, next.len);
+      break;
+    }
+
+    if (!cut) {
+      if (!ok) {
+        report("operação sem corte recusada (store travado)", &kv, sectors,
+               seed, iter);
+        return false;
+      }
+      expected[id] = next;
+      if (rng_next() % 61 == 0 && !remount(&kv, sectors)) {
+        report("remontagem", &kv, sectors, seed, iter);
+        return false;
+      }
+    } else {
+      // Energia de volta: vale o valor anterior ou o novo, nada mais
+      (*cuts)++;
+      if (!remount(&kv, sectors)) {
+        report("remontagem após corte", &kv, sectors, seed, iter);
+        return false;
+      }
+      if (value_matches(&kv, id, &next)) {
+        expected[id] = next;
+      } else if (!value_matches(&kv, id, &expected[id])) {
+        report("valor perdido no corte", &kv, sectors, seed, iter);
+        return false;
+      }
+    }
+
+    for (uint16_t k = 0; k < g_keys; k++) {
+      if ((cut || k == id) && !value_matches(&kv, k, &expected[k])) {
+        report("valor confirmado diferente", &kv, sectors, seed, iter);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  uint32_t sectors = argc > 1 ? (uint32_t)atoi(argv[1]) : 8;
+  uint32_t seeds = argc > 2 ? (uint32_t)atoi(argv[2]) : 8;
+  uint32_t iterations = argc > 3 ? (uint32_t)atoi(argv[3]) : 20000;
+  uint32_t cuts = 0;
+
+  if (argc > 4) {
+    g_keys = (uint32_t)atoi(argv[4]);
+  }
+
+  for (uint32_t seed = 1; seed <= seeds; seed++) {
+    if (!run(sectors, seed, iterations, &cuts)) {
+      return 1;
+    }
+  }
+  printf("kvstore, %u setores: %u sementes x %u iterações, %u cortes, ok\n",
+         (unsigned)sectors, (unsigned)seeds, (unsigned)iterations,
+         (unsigned)cuts);
+  remove(FLASH_PATH);
+  return 0;
+}
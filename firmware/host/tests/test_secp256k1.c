@@ -0,0 +1,219 @@
+/**
+ * Vetores do secp256k1 (ECDSA, RFC 6979, low-S)
+ *
+ * Vetores gerados por uma implementação Python independente (aritmética
+ * afim em inteiros, RFC 6979 com HMAC-SHA256); o primeiro é o conhecido
+ * d = 1, SHA-256("Satoshi Nakamoto"). Para cada um: chave pública,
+ * assinatura exata, verificação rápida e por double-and-add. Depois os
+ * casos de recusa e a conta única da wallet.
+ *
+ * Uso: test_secp256k1 [arquivo da flash]
+ */
+
+#include "flash_nor.h"
+#include "librecipher.h"
+#include "secp256k1.h"
+#include "test_util.h"
+#include "wallet.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+  const char *secret, *hash, *public_key, *signature;
+} k1_vector_t;
+
+static const k1_vector_t VECTORS[] = {
+    {"0000000000000000000000000000000000000000000000000000000000000001",
+     "a0dc65ffca799873cbea0ac274015b9526505daaaed385155425f7337704883e",
+     "0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798",
+     "934b1ea10a4b3c1757e2b0c017d0b6143ce3c9a7e6a4a49860d7a6ab210ee3d8"
+     "2442ce9d2b916064108014783e923ec36b49743e2ffa1c4496f01a512aafd9e5"},
+    // d = n - 1
+    {"fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364140",
+     "a0dc65ffca799873cbea0ac274015b9526505daaaed385155425f7337704883e",
+     "0379be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798",
+     "fd567d121db66e382991534ada77a6bd3106f0a1098c231e47993447cd6af2d0"
+     "6b39cd0eb1bc8603e159ef5c20a5c8ad685a45b06ce9bebed3f153d10d93bed5"},
+    // Chave da RFC 6979 A.2.5, SHA-256("sample")
+    {"c9afa9d845ba75166b5c215767b1d6934e50c3db36e89b127b8a622b120f6721",
+     "af2bdbe1aa9b6ec1e2ade1d694f41fc71a831d0268e9891562113d8a62add1bf",
+     "032c8c31fc9f990c6b55e3865a184a4ce50e09481f2eaeb3e60ec1cea13a6ae645",
+     "432310e32cb80eb6503a26ce83cc165c783b870845fb8aad6d970889fcd7a6c8"
+     "530128b6b81c548874a6305d93ed071ca6e05074d85863d4056ce89b02bfab69"},
+    // Hash acima de n (reduzido no bits2octets)
+    {"0000000000000000000000000000000000000000000000000000000000000003",
+     "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+     "02f9308a019258c31049344f85f89d5229b531c845836f99b08601f113bce036f9",
+     "80c3bb67a6c5c84f966787347ed61e0e71e9a572e5085ea784ae43a9c2d35571"
+     "4f641a58c1b0b300bc09fe739be2f56aa4b1a6372b24b09f37037f13c01a826e"},
+    // Hash nulo
+    {"b4a77d127f53c505bcf216249c9ffffb4f4c6e7fa548609c18552baca5b21ed7",
+     "0000000000000000000000000000000000000000000000000000000000000000",
+     "0336ac9bd12bd15a409db005b703d1cd4c1c92a63e2244baa6eea49d00f6053ea5",
+     "96ca6988025a83596df2ae6ec3573deb9ec67ea84657e5fcb526678ece2153fe"
+     "0db6dbaf73690f0ab247074f8a325e6d10c13c311dbbb9e4ede92ede07dee2a6"},
+};
+#define VECTOR_COUNT (sizeof(VECTORS) / sizeof(VECTORS[0]))
+
+// Ordem do grupo, big-endian
+static const char N_HEX[] =
+    "fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141";
+
+// s' = n - s (big-endian), a assinatura high-S equivalente
+static void negate_s(uint8_t s[32]) {
+  uint8_t n[32];
+  int borrow = 0;
+
+  hex_decode(n, N_HEX, sizeof(n));
+  for (int i = 31; i >= 0; i--) {
+    int d = n[i] - s[i] - borrow;
+    borrow = d < 0;
+    s[i] = (uint8_t)d;
+  }
+}
+
+static void test_vectors(void) {
+  uint8_t secret[32], hash[32], public_key[33], signature[64];
+  uint8_t got_key[33], got_sig[64], naive_key[33], other[64];
+
+  for (size_t i = 0; i < VECTOR_COUNT; i++) {
+    const k1_vector_t *v = &VECTORS[i];
+    hex_decode(secret, v->secret, 32);
+    hex_decode(hash, v->hash, 32);
+    hex_decode(public_key, v->public_key, 33);
+    hex_decode(signature, v->signature, 64);
+
+    expect_vector(secp256k1_get_public_key(got_key, secret) &&
+                      memcmp(got_key, public_key, 33) == 0,
+                  "chave pública", i);
+    expect_vector(secp256k1_get_public_key_naive(naive_key, secret) &&
+                      memcmp(naive_key, public_key, 33) == 0,
+                  "chave pública (double-and-add)", i);
+    expect_vector(secp256k1_sign(got_sig, hash, secret) &&
+                      memcmp(got_sig, signature, 64) == 0,
+                  "assinatura", i);
+    expect_vector(secp256k1_verify(signature, hash, public_key, 33),
+                  "verificação", i);
+    expect_vector(secp256k1_verify_naive(signature, hash, public_key, 33),
+                  "verificação (double-and-add)", i);
+
+    // High-S continua válida na verificação
+    memcpy(other, signature, 64);
+    negate_s(other + 32);
+    expect_vector(secp256k1_verify(other, hash, public_key, 33),
+                  "high-S recusada", i);
+
+    // Hash alterado, chave de outro vetor
+    hash[31] ^= 0x01;
+    expect_vector(!secp256k1_verify(signature, hash, public_key, 33),
+                  "hash alterado aceito", i);
+    expect_vector(!secp256k1_verify_naive(signature, hash, public_key, 33),
+                  "hash alterado aceito (double-and-add)", i);
+    hash[31] ^= 0x01;
+    hex_decode(other, VECTORS[(i + 2) % VECTOR_COUNT].public_key, 33);
+    expect_vector(!secp256k1_verify(signature, hash, other, 33),
+                  "chave errada aceita", i);
+  }
+}
+
+static void test_rejects(void) {
+  uint8_t hash[32], public_key[33], signature[64], bad[64], out[64];
+
+  hex_decode(hash, VECTORS[2].hash, 32);
+  hex_decode(public_key, VECTORS[2].public_key, 33);
+  hex_decode(signature, VECTORS[2].signature, 64);
+
+  // Chaves secretas fora de [1, n)
+  memset(bad, 0, 32);
+  expect(!secp256k1_seckey_verify(bad) && !secp256k1_sign(out, hash, bad),
+         "chave secreta 0 aceita");
+  hex_decode(bad, N_HEX, 32);
+  expect(!secp256k1_seckey_verify(bad) && !secp256k1_sign(out, hash, bad),
+         "chave secreta n aceita");
+
+  // r = 0, s = 0, s = n
+  memcpy(bad, signature, 64);
+  memset(bad, 0, 32);
+  expect(!secp256k1_verify(bad, hash, public_key, 33), "r = 0 aceito");
+  memcpy(bad, signature, 64);
+  memset(bad + 32, 0, 32);
+  expect(!secp256k1_verify(bad, hash, public_key, 33), "s = 0 aceito");
+  hex_decode(bad + 32, N_HEX, 32);
+  expect(!secp256k1_verify(bad, hash, public_key, 33), "s = n aceito");
+
+  // Chave pública: prefixo inválido, tamanho errado
+  memcpy(bad, public_key, 33);
+  bad[0] = 0x05;
+  expect(!secp256k1_verify(signature, hash, bad, 33), "prefixo 0x05 aceito");
+  expect(!secp256k1_verify(signature, hash, public_key, 32),
+         "chave de 32 bytes aceita");
+}
+
+// Sem árvore HD secp256k1: só a conta 0 assina
+static uint32_t g_sink_calls;
+
+static void count_sink(size_t entry, const uint8_t *signature, void *ctx) {
+  (void)entry;
+  (void)signature;
+  (void)ctx;
+  g_sink_calls++;
+}
+
+static void test_wallet_account(const char *flash_path) {
+  static const uint8_t pin[] = "123456";
+  wallet_sign_request_t requests[2];
+  uint8_t hash[32] = {0x42}, signature[64];
+
+  remove(flash_path);
+  if (!flash_nor_sim_open(flash_path, PICO_FLASH_SIZE_BYTES)) {
+    printf("FALHOU: flash simulada não abriu %s\n", flash_path);
+    g_ok = false;
+    return;
+  }
+  librecipher_init();
+  wallet_init();
+  if (!wallet_restore("legal winner thank year wave sausage worth useful "
+                      "legal winner thank yellow",
+                      pin, sizeof(pin) - 1)) {
+    printf("FALHOU: wallet_restore\n");
+    g_ok = false;
+    flash_nor_sim_close();
+    return;
+  }
+
+  expect(wallet_sign_transaction(hash, 0, WALLET_CURVE_SECP256K1, signature),
+         "conta 0 recusada");
+  expect(!wallet_sign_transaction(hash, 1, WALLET_CURVE_SECP256K1, signature),
+         "conta 1 aceita");
+
+  requests[0].account_index = 0;
+  requests[1].account_index = 1;
+  memcpy(requests[0].hash, hash, 32);
+  memcpy(requests[1].hash, hash, 32);
+  g_sink_calls = 0;
+  expect(!wallet_sign_batch(requests, 2, WALLET_CURVE_SECP256K1, count_sink,
+                            NULL) &&
+             g_sink_calls == 0,
+         "lote com conta 1 aceito ou assinado em parte");
+  requests[1].account_index = 0;
+  expect(wallet_sign_batch(requests, 2, WALLET_CURVE_SECP256K1, count_sink,
+                           NULL) &&
+             g_sink_calls == 2,
+         "lote da conta 0 recusado");
+
+  wallet_wipe();
+  flash_nor_sim_close();
+  remove(flash_path);
+}
+
+int main(int argc, char **argv) {
+  test_vectors();
+  test_rejects();
+  test_wallet_account(argc > 1 ? argv[1] : "secp256k1_flash.bin");
+
+  if (!g_ok) {
+    return 1;
+  }
+  printf("secp256k1: %u vetores, ok\n", (unsigned)VECTOR_COUNT);
+  return 0;
+}
@@ -0,0 +1,259 @@
+/**
+ * SLIP-39 e a aritmética GF(256) por trás dele
+ *
+ * - vetores do SLIP-0039 (passphrase "TREZOR"): 1 de 1, 2 de 3, checksum
+ *   inválido, parte sozinha de um 2 de 3
+ * - gf256.c (constant-time, bitsliced) contra uma referência byte a byte
+ *   (multiplicação por deslocamentos, inverso por busca): todos os
+ *   produtos e inversos, interpolação com 1 a 16 pontos
+ * - dividir e recuperar: 8 de 16 com subconjuntos diferentes, 7 de 16
+ *   recusado, passphrase errada dá outro segredo, ida e volta pelo
+ *   mnemonic
+ *
+ * Uso: test_slip39 [interpolações aleatórias]
+ */
+
+#include "gf256.h"
+#include "librecipher.h"
+#include "slip39.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============ Vetores da spec ============
+
+static const char SINGLE[] =
+    "duckling enlarge academic academic agency result length solution "
+    "fridge kidney coal piece deal husband erode duke ajar critical "
+    "decision keyboard";
+static const char SINGLE_MS[] = "bb54aac4b89dc868ba37d9cc21b2cece";
+// Mesma parte com a última palavra trocada
+static const char BAD_CHECKSUM[] =
+    "duckling enlarge academic academic agency result length solution "
+    "fridge kidney coal piece deal husband erode duke ajar critical "
+    "decision kidney";
+static const char *const PAIR[2] = {
+    "shadow pistol academic always adequate wildlife fancy gross oasis "
+    "cylinder mustang wrist rescue view short owner flip making coding "
+    "armed",
+    "shadow pistol academic acid actress prayer class unknown daughter "
+    "sweater depict flip twice unkind craft early superior advocate "
+    "guest smoking"};
+static const char PAIR_MS[] = "b43ceb7e57a0ea8766221624d01b0864";
+
+static void test_spec_vectors(void) {
+  slip39_share_t shares[2];
+  uint8_t secret[SLIP39_MAX_SECRET];
+  size_t secret_len = 0;
+
+  expect(slip39_share_from_mnemonic(SINGLE, &shares[0]) &&
+             slip39_combine(shares, 1, "TREZOR", secret, &secret_len) &&
+             secret_len == 16,
+         "spec: 1 de 1");
+  expect_hex(secret, SINGLE_MS, 16, "spec: segredo 1 de 1");
+
+  expect(!slip39_share_from_mnemonic(BAD_CHECKSUM, &shares[0]),
+         "spec: checksum inválido aceito");
+
+  expect(slip39_share_from_mnemonic(PAIR[0], &shares[0]) &&
+             slip39_share_from_mnemonic(PAIR[1], &shares[1]) &&
+             slip39_combine(shares, 2, "TREZOR", secret, &secret_len) &&
+             secret_len == 16,
+         "spec: 2 de 3");
+  expect_hex(secret, PAIR_MS, 16, "spec: segredo 2 de 3");
+  expect(!slip39_combine(shares, 1, "TREZOR", secret, &secret_len),
+         "spec: 1 parte de um 2 de 3 aceita");
+}
+
+// ============ GF(256) contra a referência ============
+
+static uint32_t g_rng = 0x9E3779B9;
+
+static uint32_t rng_next(void) {
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 17;
+  g_rng ^= g_rng << 5;
+  return g_rng;
+}
+
+// Produto por deslocamentos e reduções módulo 0x11B
+static uint8_t ref_mul(uint8_t a, uint8_t b) {
+  uint8_t p = 0;
+  while (b != 0) {
+    if (b & 1) {
+      p ^= a;
+    }
+    a = (uint8_t)((a << 1) ^ ((a & 0x80) ? 0x1B : 0));
+    b >>= 1;
+  }
+  return p;
+}
+
+static uint8_t ref_inv(uint8_t a) {
+  for (int b = 1; b < 256; b++) {
+    if (ref_mul(a, (uint8_t)b) == 1) {
+      return (uint8_t)b;
+    }
+  }
+  return 0;
+}
+
+// Lagrange byte a byte
+static void ref_interpolate(const uint8_t *xs, uint8_t ys[][32],
+                            size_t count, uint8_t x, uint8_t out[32]) {
+  memset(out, 0, 32);
+  for (size_t j = 0; j < count; j++) {
+    uint8_t num = 1, den = 1;
+    for (size_t m = 0; m < count; m++) {
+      if (m != j) {
+        num = ref_mul(num, x ^ xs[m]);
+        den = ref_mul(den, xs[j] ^ xs[m]);
+      }
+    }
+    uint8_t c = ref_mul(num, ref_inv(den));
+    for (int k = 0; k < 32; k++) {
+      out[k] ^= ref_mul(c, ys[j][k]);
+    }
+  }
+}
+
+static void test_field(void) {
+  bool mul_ok = true, inv_ok = gf256_inv(0) == 0;
+
+  for (int a = 0; a < 256; a++) {
+    for (int b = 0; b < 256; b++) {
+      mul_ok &= gf256_mul((uint8_t)a, (uint8_t)b) ==
+                ref_mul((uint8_t)a, (uint8_t)b);
+    }
+  }
+  for (int a = 1; a < 256; a++) {
+    inv_ok &= gf256_inv((uint8_t)a) == ref_inv((uint8_t)a);
+  }
+  expect(mul_ok, "gf256_mul difere da referência");
+  expect(inv_ok, "gf256_inv difere da referência");
+}
+
+static void test_interpolate(uint32_t rounds) {
+  static uint8_t ys[GF256_MAX_POINTS][32];
+  static gf256_vector_t sliced[GF256_MAX_POINTS];
+  uint8_t xs[GF256_MAX_POINTS], fast[32], slow[32];
+  gf256_vector_t v;
+  bool ok = true;
+
+  for (uint32_t r = 0; r < rounds && ok; r++) {
+    size_t count = 1 + r % GF256_MAX_POINTS;
+    // x distintos: uma permutação parcial a partir de um deslocamento
+    uint8_t base = (uint8_t)rng_next(), step = (uint8_t)(rng_next() | 1);
+    for (size_t j = 0; j < count; j++) {
+      xs[j] = (uint8_t)(base + step * j);
+      for (int k = 0; k < 32; k++) {
+        ys[j][k] = (uint8_t)rng_next();
+      }
+      gf256_vector_load(&sliced[j], ys[j], 32);
+    }
+    uint8_t x = (uint8_t)rng_next();
+
+    ok = gf256_interpolate(xs, sliced, count, x, &v);
+    gf256_vector_store(&v, fast, 32);
+    ref_interpolate(xs, ys, count, x, slow);
+    ok = ok && memcmp(fast, slow, 32) == 0;
+
+    // Num dos pontos dados volta o próprio valor
+    size_t j = r % count;
+    ok = ok && gf256_interpolate(xs, sliced, count, xs[j], &v);
+    gf256_vector_store(&v, fast, 32);
+    ok = ok && memcmp(fast, ys[j], 32) == 0;
+  }
+  expect(ok, "gf256_interpolate difere da referência");
+
+  xs[1] = xs[0];
+  expect(!gf256_interpolate(xs, sliced, 2, 0, &v), "x repetido aceito");
+}
+
+// ============ Dividir e recuperar ============
+
+typedef struct {
+  slip39_share_t shares[SLIP39_MAX_SHARES];
+  size_t count;
+} share_set_t;
+
+static void collect_share(const slip39_share_t *share, void *ctx) {
+  share_set_t *out = ctx;
+  out->shares[out->count++] = *share;
+}
+
+static void test_round_trip(void) {
+  static share_set_t set;
+  slip39_share_t picked[8], decoded;
+  char mnemonic[SLIP39_MAX_MNEMONIC_LEN + 1];
+  uint8_t master[32], secret[SLIP39_MAX_SECRET];
+  size_t secret_len = 0;
+
+  for (size_t i = 0; i < sizeof(master); i++) {
+    master[i] = (uint8_t)rng_next();
+  }
+
+  set.count = 0;
+  expect(slip39_split(master, sizeof(master), "", 0, 8, 16, collect_share,
+                      &set) &&
+             set.count == 16,
+         "8 de 16: divisão");
+
+  // Partes seguidas, do meio e alternadas
+  static const size_t starts[] = {0, 5, 8};
+  for (size_t s = 0; s < sizeof(starts) / sizeof(starts[0]); s++) {
+    expect(slip39_combine(&set.shares[starts[s]], 8, "", secret,
+                          &secret_len) &&
+               secret_len == 32 && memcmp(secret, master, 32) == 0,
+           "8 de 16: recuperação");
+  }
+  for (size_t i = 0; i < 8; i++) {
+    picked[i] = set.shares[2 * i + 1];
+  }
+  expect(slip39_combine(picked, 8, "", secret, &secret_len) &&
+             secret_len == 32 && memcmp(secret, master, 32) == 0,
+         "8 de 16: partes ímpares");
+  expect(!slip39_combine(set.shares, 7, "", secret, &secret_len),
+         "8 de 16: 7 partes aceitas");
+
+  // Ida e volta pelo mnemonic
+  bool same = true;
+  for (size_t i = 0; i < set.count; i++) {
+    same &= slip39_share_to_mnemonic(&set.shares[i], mnemonic,
+                                     sizeof(mnemonic)) > 0 &&
+            slip39_share_from_mnemonic(mnemonic, &decoded) &&
+            memcmp(&decoded, &set.shares[i], sizeof(decoded)) == 0;
+  }
+  expect(same, "mnemonic: ida e volta");
+
+  // Passphrase errada não é detectada: recupera outro segredo
+  set.count = 0;
+  expect(slip39_split(master, 16, "TREZOR", 0, 2, 3, collect_share, &set),
+         "2 de 3: divisão");
+  expect(slip39_combine(&set.shares[1], 2, "TREZOR", secret, &secret_len) &&
+             secret_len == 16 && memcmp(secret, master, 16) == 0,
+         "2 de 3: recuperação");
+  expect(slip39_combine(&set.shares[1], 2, "trezor", secret, &secret_len) &&
+             memcmp(secret, master, 16) != 0,
+         "2 de 3: passphrase errada deu o mesmo segredo");
+
+  librecipher_secure_zero(&set, sizeof(set));
+  librecipher_secure_zero(picked, sizeof(picked));
+}
+
+int main(int argc, char **argv) {
+  uint32_t rounds = argc > 1 ? (uint32_t)atoi(argv[1]) : 2000;
+
+  librecipher_init();
+  test_spec_vectors();
+  test_field();
+  test_interpolate(rounds);
+  test_round_trip();
+
+  if (!g_ok) {
+    return 1;
+  }
+  printf("slip39: ok\n");
+  return 0;
+}
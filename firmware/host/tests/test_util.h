@@ -0,0 +1,64 @@
+/**
+ * Utilitários comuns dos testes de host
+ *
+ * Cada teste marca as falhas em g_ok e segue adiante; main devolve 1 se
+ * alguma conferência falhou.
+ */
+
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static bool g_ok = true;
+
+static inline void hex_decode(uint8_t *out, const char *hex, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    unsigned int byte;
+    sscanf(hex + 2 * i, "%2x", &byte);
+    out[i] = (uint8_t)byte;
+  }
+}
+
+static inline void expect(bool cond, const char *what) {
+  if (!cond) {
+    printf("FALHOU: %s\n", what);
+    g_ok = false;
+  }
+}
+
+// Falha com o número do vetor
+static inline void expect_vector(bool cond, const char *what, size_t vector) {
+  char msg[128];
+
+  snprintf(msg, sizeof(msg), "%s (vetor %u)", what, (unsigned)vector);
+  expect(cond, msg);
+}
+
+// Compara len bytes com o hex esperado; na falha imprime os dois
+static inline void expect_hex(const uint8_t *got, const char *want_hex,
+                              size_t len, const char *what) {
+  uint8_t want[256];
+
+  if (len > sizeof(want)) {
+    printf("FALHOU: %s (esperado de %u bytes)\n", what, (unsigned)len);
+    g_ok = false;
+    return;
+  }
+  hex_decode(want, want_hex, len);
+  if (memcmp(got, want, len) != 0) {
+    printf("FALHOU: %s\n  esperado %.*s\n  obtido   ", what, (int)(2 * len),
+           want_hex);
+    for (size_t i = 0; i < len; i++) {
+      printf("%02x", got[i]);
+    }
+    printf("\n");
+    g_ok = false;
+  }
+}
+
+#endif // TEST_UTIL_H
@@ -0,0 +1,115 @@
+/**
+ * Vetores do X25519 (RFC 7748)
+ *
+ * - 5.2: dois vetores de uma multiplicação (o segundo com o bit alto de u
+ *   ligado, que deve ser ignorado) e a iteração k, u = X25519(k, u), k
+ *   com 1 e 1000 voltas
+ * - 6.1: troca de chaves Alice/Bob completa
+ * - pontos de ordem baixa: librecipher_x25519 recusa o segredo nulo
+ */
+
+#include "ed25519.h"
+#include "librecipher.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <string.h>
+
+// RFC 7748 5.2 (iteração) e 6.1
+#define ITER_1 \
+  "422c8e7a6227d7bca1350b3e2bb7279f7897b87bb6854b783c60e80311ae3079"
+#define ITER_1000 \
+  "684cf59ba83309552800ef566f2f4d3c1c3887c49360e3875f2eb94d99532c51"
+#define ALICE_SECRET \
+  "77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a"
+#define BOB_SECRET \
+  "5dab087e624a8a4b79e17f8b83800ee66f3bb1292618b6fd1c2f8b27ff88e0eb"
+#define ALICE_PUBLIC \
+  "8520f0098930a754748b7ddcb43ef75a0dbf3a0d26381af4eba4a98eaa9b4e6a"
+#define BOB_PUBLIC \
+  "de9edb7d7b7dc1b4d35b61c2ece435373f8343c85b78674dadfc7e146f882b4f"
+#define SHARED \
+  "4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742"
+
+static void test_vectors(void) {
+  static const struct {
+    const char *scalar, *u, *out;
+  } vectors[] = {
+      {"a546e36bf0527c9d3b16154b82465edd62144c0ac1fc5a18506a2244ba449ac4",
+       "e6db6867583030db3594c1a424b15f7c726624ec26b3353b10a903a6d0ab1c4c",
+       "c3da55379de9c6908e94ea4df28d084f32eccf03491c71f754b4075577a28552"},
+      {"4b66e9d4d1b4673c5ad22691957d6af5c11b6421e0ea01d42ca4169e7918ba0d",
+       "e5210f12786811d3f4b7959d0538ae2c31dbe7106fc03c3efc4cd549c715a493",
+       "95cbde9476e8907d7aade45cb4b873f88b595a68799fa152e6f8f7647aac7957"},
+  };
+  uint8_t scalar[32], u[32], out[32];
+
+  for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+    hex_decode(scalar, vectors[i].scalar, 32);
+    hex_decode(u, vectors[i].u, 32);
+    x25519(out, scalar, u);
+    expect_hex(out, vectors[i].out, 32, "RFC 7748 5.2");
+  }
+}
+
+static void test_iterated(void) {
+  uint8_t k[32] = {9}, u[32] = {9}, out[32];
+
+  for (int i = 1; i <= 1000; i++) {
+    x25519(out, k, u);
+    memcpy(u, k, sizeof(u));
+    memcpy(k, out, sizeof(k));
+    if (i == 1) {
+      expect_hex(k, ITER_1, 32, "RFC 7748 5.2, 1 iteração");
+    }
+  }
+  expect_hex(k, ITER_1000, 32, "RFC 7748 5.2, 1000 iterações");
+}
+
+static void test_key_agreement(void) {
+  uint8_t alice[32], bob[32], alice_pub[32], bob_pub[32];
+  uint8_t alice_shared[32], bob_shared[32];
+
+  hex_decode(alice, ALICE_SECRET, 32);
+  hex_decode(bob, BOB_SECRET, 32);
+
+  x25519_base(alice_pub, alice);
+  x25519_base(bob_pub, bob);
+  expect_hex(alice_pub, ALICE_PUBLIC, 32, "RFC 7748 6.1, pública de Alice");
+  expect_hex(bob_pub, BOB_PUBLIC, 32, "RFC 7748 6.1, pública de Bob");
+
+  if (!librecipher_x25519(alice_shared, alice, bob_pub) ||
+      !librecipher_x25519(bob_shared, bob, alice_pub)) {
+    printf("FALHOU: RFC 7748 6.1, troca recusada\n");
+    g_ok = false;
+    return;
+  }
+  expect_hex(alice_shared, SHARED, 32, "RFC 7748 6.1, segredo de Alice");
+  expect_hex(bob_shared, SHARED, 32, "RFC 7748 6.1, segredo de Bob");
+}
+
+static void test_low_order(void) {
+  // u = 0 e u = 1 (ordem 1 e 4): qualquer escalar clampado dá zero
+  static const uint8_t points[][32] = {{0}, {1}};
+  uint8_t secret[32], shared[32];
+
+  memset(secret, 0x5A, sizeof(secret));
+  for (size_t i = 0; i < sizeof(points) / sizeof(points[0]); i++) {
+    if (librecipher_x25519(shared, secret, points[i])) {
+      printf("FALHOU: ponto de ordem baixa u = %u aceito\n", (unsigned)i);
+      g_ok = false;
+    }
+  }
+}
+
+int main(void) {
+  test_vectors();
+  test_iterated();
+  test_key_agreement();
+  test_low_order();
+
+  if (!g_ok) {
+    return 1;
+  }
+  printf("x25519: ok\n");
+  return 0;
+}
@@ -0,0 +1,73 @@
+/**
+ * Chunked AEAD (STREAM construction)
+ *
+ * A message too long to hold in RAM is cut into chunks, each sealed
+ * independently with AES-256-GCM under one key. Chunk i uses the nonce
+ *   prefix (7 bytes) || i (big-endian 32 bits) || last (0x00 or 0x01)
+ * so chunks cannot be reordered, dropped, duplicated or spliced from
+ * another stream, and a truncated stream is detected: it is complete only
+ * after a chunk that authenticates with last = 1.
+ *
+ * Memory is one chunk on each side, and the reader rejects at the first
+ * bad chunk. The AES key schedule and GHASH key are computed once per
+ * stream, not once per chunk.
+ */
+
+#ifndef AEAD_STREAM_H
+#define AEAD_STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "aes_gcm.h"
+
+#define AEAD_STREAM_PREFIX_SIZE 7 // Random per stream (one key, many streams)
+#define AEAD_STREAM_TAG_SIZE AES_GCM_TAG_SIZE
+
+/**
+ * Stream state (sealer or opener)
+ */
+typedef struct {
+  aes_gcm_ctx_t keyed; // Key schedule and H; IV set per chunk
+  uint8_t prefix[AEAD_STREAM_PREFIX_SIZE];
+  uint32_t counter; // Index of the next chunk
+  bool finished;    // Last chunk done: nothing more is accepted
+  bool failed;      // A chunk did not authenticate: nothing more is accepted
+} aead_stream_t;
+
+/**
+ * Start a stream
+ * @param key AES-256 key (32 bytes)
+ * @param prefix nonce prefix, never reused with the same key
+ */
+void aead_stream_init(aead_stream_t *s, const uint8_t key[32],
+                      const uint8_t prefix[AEAD_STREAM_PREFIX_SIZE]);
+
+/**
+ * Seal the next chunk
+ * @param last true for the final chunk (may be empty)
+ * @param out ciphertext, len bytes (may alias in)
+ * @return false if the stream is finished or out of chunk indices
+ */
+bool aead_stream_seal(aead_stream_t *s, const uint8_t *in, size_t len,
+                      bool last, uint8_t *out,
+                      uint8_t tag[AEAD_STREAM_TAG_SIZE]);
+
+/**
+ * Open the next chunk
+ * @param last what the sender claims; a lie fails authentication
+ * @param out plaintext, len bytes (may alias in; zeroed on failure)
+ * @return false if the chunk does not authenticate or the stream is
+ *         finished or failed
+ */
+bool aead_stream_open(aead_stream_t *s, const uint8_t *in, size_t len,
+                      bool last, const uint8_t tag[AEAD_STREAM_TAG_SIZE],
+                      uint8_t *out);
+
+/**
+ * Wipe the key schedule
+ */
+void aead_stream_clear(aead_stream_t *s);
+
+#endif // AEAD_STREAM_H
@@ -49,6 +49,15 @@ void aes256_encrypt_block(const aes_ctx_t *ctx, const uint8_t in[16],
 void aes_gcm_init(aes_gcm_ctx_t *ctx, const uint8_t key[32],
                   const uint8_t iv[12]);
 
+/**
+ * Restart an initialized context with a new IV
+ *
+ * Keeps the key schedule and H: sealing many messages under one key
+ * (aead_stream) pays for them once. The context must come from
+ * aes_gcm_init, not from a finished one (aes_gcm_finish wipes it).
+ */
+void aes_gcm_set_iv(aes_gcm_ctx_t *ctx, const uint8_t iv[12]);
+
 /**
  * Add additional authenticated data
  */
@@ -60,6 +69,13 @@ void aes_gcm_aad(aes_gcm_ctx_t *ctx, const uint8_t *aad, size_t aad_len);
 void aes_gcm_encrypt(aes_gcm_ctx_t *ctx, const uint8_t *plaintext, size_t len,
                      uint8_t *ciphertext);
 
+/**
+ * Decrypt ciphertext (the tag from aes_gcm_finish must be compared by the
+ * caller before using the plaintext)
+ */
+void aes_gcm_decrypt(aes_gcm_ctx_t *ctx, const uint8_t *ciphertext, size_t len,
+                     uint8_t *plaintext);
+
 /**
  * Finalize and get authentication tag
  */
@@ -0,0 +1,83 @@
+/**
+ * LibreCipher Argon2id Implementation
+ *
+ * Argon2id v1.3 (RFC 9106) sized for the RP2350:
+ * - Memory comes from a static arena of ARGON2_MAX_MEMORY_KIB (no heap);
+ *   the arena is wiped after every call
+ * - Lanes are computed one after another on a single core; p > 1 is
+ *   accepted for compatibility but only costs time
+ * - No secret key / associated data inputs
+ *
+ * Output is bit-identical to the reference implementation for the same
+ * parameters. argon2id_calibrate picks parameters for a target latency
+ * on the running core.
+ */
+
+#ifndef ARGON2_H
+#define ARGON2_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ARGON2_BLOCK_SIZE 1024
+#define ARGON2_SYNC_POINTS 4
+#define ARGON2_VERSION 0x13
+
+// Arena size (KiB = blocks). Override at build time to trade SRAM.
+#ifndef ARGON2_MAX_MEMORY_KIB
+#define ARGON2_MAX_MEMORY_KIB 128
+#endif
+
+#define ARGON2_MAX_LANES 4
+#define ARGON2_MIN_MEMORY_KIB (2 * ARGON2_SYNC_POINTS) // Per lane
+#define ARGON2_MAX_OUTPUT_SIZE 64
+
+/**
+ * Cost parameters, stored next to the salt of whatever they protect
+ */
+typedef struct {
+  uint32_t t_cost;     // Passes over memory (>= 1)
+  uint32_t m_cost_kib; // Memory in KiB (8 * lanes .. ARGON2_MAX_MEMORY_KIB)
+  uint32_t lanes;      // Parallelism p (1 .. ARGON2_MAX_LANES)
+} argon2_params_t;
+
+/**
+ * Microsecond clock used by the calibration
+ */
+typedef uint64_t (*argon2_clock_fn)(void);
+
+/**
+ * Check that parameters fit this build
+ */
+bool argon2_params_valid(const argon2_params_t *params);
+
+/**
+ * Argon2id
+ * @param params cost parameters
+ * @param password password (PIN)
+ * @param salt salt (>= 8 bytes)
+ * @param out output tag
+ * @param out_len output size, 4..64 bytes
+ * @return false if the parameters or sizes are invalid
+ */
+bool argon2id_hash(const argon2_params_t *params, const uint8_t *password,
+                   size_t password_len, const uint8_t *salt, size_t salt_len,
+                   uint8_t *out, size_t out_len);
+
+/**
+ * Pick parameters for a target latency on the running core
+ *
+ * Uses the whole arena if one pass fits the target (halving memory
+ * otherwise), one lane, and as many passes as the measured per-pass cost
+ * allows (at least one). Costs about a quarter of the target in trial
+ * hashes.
+ *
+ * @param params output parameters
+ * @param target_ms target latency
+ * @param clock_us microsecond clock
+ */
+void argon2id_calibrate(argon2_params_t *params, uint32_t target_ms,
+                        argon2_clock_fn clock_us);
+
+#endif // ARGON2_H
@@ -0,0 +1,16 @@
+/**
+ * Benchmarks no device
+ *
+ * Compilado só com -DLIBRECRYPT_BENCH=ON; resultados vão para o stdio USB
+ * no boot, antes do protocolo começar a atender comandos.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+/**
+ * Executa todos os benchmarks e imprime os resultados
+ */
+void bench_run(void);
+
+#endif // BENCH_H
@@ -0,0 +1,79 @@
+/**
+ * LibreCipher BIP32-Ed25519 Hierarchical Derivation
+ *
+ * Khovratovich-Law BIP32-Ed25519 (derivation scheme V2), with the Icarus
+ * master key generation used by Cardano wallets (CIP-3)
+ * - Extended private key: kL || kR || chain code, no seed hashing
+ * - Hardened and soft private child derivation
+ * - Chain code HMAC midstates computed once per child step and shared by
+ *   the Z and chain code MACs
+ */
+
+#ifndef BIP32_ED25519_H
+#define BIP32_ED25519_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ed25519.h"
+
+#define BIP32_HARDENED 0x80000000u
+#define BIP32_ED25519_XPRV_SIZE 96 // kL || kR || chain code
+
+// Icarus master key stretching (PBKDF2-HMAC-SHA512)
+#define BIP32_ED25519_ICARUS_ITERATIONS 4096
+
+/**
+ * Extended private key node
+ *
+ * public_key is kL * B; it is only needed to derive soft children and is
+ * filled on demand by bip32_ed25519_node_public (has_public).
+ */
+typedef struct {
+  uint8_t kl[32];         // Secret scalar (used unclamped after derivation)
+  uint8_t kr[32];         // Nonce prefix
+  uint8_t chain_code[32];
+  uint8_t public_key[ED25519_PUBLIC_KEY_SIZE];
+  bool has_public;
+} bip32_ed25519_node_t;
+
+/**
+ * Icarus root key from BIP-39 entropy
+ * @param root output root node (clear with bip32_ed25519_node_clear)
+ * @param entropy mnemonic entropy (16..32 bytes)
+ * @param passphrase optional passphrase (NULL for none)
+ */
+void bip32_ed25519_master_icarus(bip32_ed25519_node_t *root,
+                                 const uint8_t *entropy, size_t entropy_len,
+                                 const uint8_t *passphrase,
+                                 size_t passphrase_len);
+
+/**
+ * Compute the node's public key if not yet known
+ */
+void bip32_ed25519_node_public(bip32_ed25519_node_t *node);
+
+/**
+ * Private child derivation
+ * @param parent parent node; must have its public key for soft indices
+ * @param index child index (>= BIP32_HARDENED for hardened)
+ * @param child output node, without public key (must not alias parent)
+ * @return false if a soft index was requested without the parent public key
+ */
+bool bip32_ed25519_derive_child(const bip32_ed25519_node_t *parent,
+                                uint32_t index, bip32_ed25519_node_t *child);
+
+/**
+ * Expanded signing key of a node (computes the public key if needed)
+ * @param key output (clear with ed25519_expanded_key_clear)
+ */
+void bip32_ed25519_signing_key(bip32_ed25519_node_t *node,
+                               ed25519_expanded_key_t *key);
+
+/**
+ * Securely zero a node
+ */
+void bip32_ed25519_node_clear(bip32_ed25519_node_t *node);
+
+#endif // BIP32_ED25519_H
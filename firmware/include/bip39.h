@@ -0,0 +1,105 @@
+/**
+ * BIP-39 - Lista de palavras, validação e mnemonic para seed
+ *
+ * Lista em inglês num índice compacto gerado no build
+ * (tools/gen_bip39_index.py): busca binária direto na flash, sem cópias
+ * para a RAM.
+ */
+
+#ifndef BIP39_H
+#define BIP39_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define BIP39_WORD_COUNT 2048
+#define BIP39_MAX_WORD_LEN 8
+#define BIP39_MIN_WORDS 12
+#define BIP39_MAX_WORDS 24
+#define BIP39_MAX_ENTROPY 32
+#define BIP39_SEED_SIZE 64
+#define BIP39_ITERATIONS 2048
+#define BIP39_MAX_PASSPHRASE 256
+#define BIP39_MAX_MNEMONIC_LEN (BIP39_MAX_WORDS * (BIP39_MAX_WORD_LEN + 1) - 1)
+
+/**
+ * Índice de uma palavra completa
+ * @param word palavra em minúsculas (sem terminador obrigatório)
+ * @param len tamanho
+ * @return índice 0..2047, ou -1 se não está na lista
+ */
+int bip39_word_index(const char *word, size_t len);
+
+/**
+ * Palavras que começam com um prefixo (completar palavra)
+ *
+ * As palavras são únicas nas 4 primeiras letras: com 4 letras ou mais o
+ * resultado é 0 ou 1.
+ *
+ * @param prefix prefixo em minúsculas
+ * @param len tamanho (1..8)
+ * @param first índice da primeira palavra (válido se retorno > 0)
+ * @return quantidade de palavras; 1 = prefixo único
+ */
+size_t bip39_prefix_range(const char *prefix, size_t len, uint16_t *first);
+
+/**
+ * Soletra a palavra de um índice
+ * @param index 0..2047
+ * @param word output (BIP39_MAX_WORD_LEN + 1 bytes, com terminador)
+ * @return tamanho da palavra, 0 se índice inválido
+ */
+size_t bip39_word(uint16_t index, char *word);
+
+/**
+ * Valida mnemonic e extrai a entropia
+ *
+ * Exige a forma canônica (minúsculas, um espaço entre palavras), que é a
+ * entrada do PBKDF2 da seed.
+ *
+ * @param mnemonic 12, 15, 18, 21 ou 24 palavras
+ * @param entropy output (até BIP39_MAX_ENTROPY bytes)
+ * @param entropy_len output: 16..32 bytes
+ * @return false se alguma palavra não existe ou o checksum não confere
+ */
+bool bip39_mnemonic_to_entropy(const char *mnemonic, uint8_t *entropy,
+                               size_t *entropy_len);
+
+/**
+ * Valida mnemonic (palavras e checksum)
+ */
+bool bip39_mnemonic_check(const char *mnemonic);
+
+/**
+ * Mnemonic de uma entropia (forma canônica, inverso de
+ * bip39_mnemonic_to_entropy)
+ * @param entropy_len 16, 20, 24, 28 ou 32 bytes
+ * @param mnemonic output (BIP39_MAX_MNEMONIC_LEN + 1 comporta qualquer
+ *        tamanho)
+ * @param size capacidade de mnemonic
+ * @return tamanho sem o terminador, 0 se a entropia é inválida ou não cabe
+ */
+size_t bip39_entropy_to_mnemonic(const uint8_t *entropy, size_t entropy_len,
+                                 char *mnemonic, size_t size);
+
+/**
+ * Tamanho do índice da lista de palavras na flash (bytes)
+ */
+size_t bip39_index_size(void);
+
+/**
+ * Seed BIP-39: PBKDF2-HMAC-SHA512(mnemonic, "mnemonic" || passphrase, 2048)
+ *
+ * Mnemonic e passphrase em ASCII (a forma NFKD de palavras da lista em
+ * inglês é a própria string).
+ *
+ * @param mnemonic palavras separadas por um espaço
+ * @param passphrase passphrase opcional ("" ou NULL para nenhuma)
+ * @param seed output (64 bytes)
+ * @return false se a passphrase passar de BIP39_MAX_PASSPHRASE
+ */
+bool bip39_mnemonic_to_seed(const char *mnemonic, const char *passphrase,
+                            uint8_t seed[BIP39_SEED_SIZE]);
+
+#endif // BIP39_H
@@ -0,0 +1,47 @@
+/**
+ * LibreCipher BLAKE2b Implementation
+ *
+ * Unkeyed BLAKE2b following RFC 7693, digests of 1..64 bytes
+ * Used by Argon2id (RFC 9106)
+ */
+
+#ifndef BLAKE2B_H
+#define BLAKE2B_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BLAKE2B_BLOCK_SIZE 128
+#define BLAKE2B_MAX_DIGEST_SIZE 64
+
+typedef struct {
+  uint64_t h[8];
+  uint64_t count; // Bytes compressed (messages < 2^64 bytes)
+  uint8_t buffer[BLAKE2B_BLOCK_SIZE];
+  size_t buffer_len;
+  size_t digest_len;
+} blake2b_ctx_t;
+
+/**
+ * Initialize BLAKE2b context
+ * @param digest_len output size, 1..64 bytes
+ */
+void blake2b_init(blake2b_ctx_t *ctx, size_t digest_len);
+
+/**
+ * Update hash with data
+ */
+void blake2b_update(blake2b_ctx_t *ctx, const uint8_t *data, size_t len);
+
+/**
+ * Finalize hash and output digest (digest_len bytes)
+ */
+void blake2b_final(blake2b_ctx_t *ctx, uint8_t *digest);
+
+/**
+ * One-shot BLAKE2b
+ */
+void blake2b_hash(const uint8_t *data, size_t len, uint8_t *digest,
+                  size_t digest_len);
+
+#endif // BLAKE2B_H
@@ -11,8 +11,10 @@
 #define BOOTLOADER_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#include "ed25519.h"
 
 // Bootloader version
 #define BOOTLOADER_VERSION_MAJOR 1
@@ -33,7 +35,8 @@ typedef struct __attribute__((packed)) {
   uint32_t size;             // Firmware size in bytes
   uint32_t entry_point;      // Entry point offset
   uint8_t hash[32];          // SHA-256 hash of firmware
-  uint8_t signature[64];     // Ed25519 signature (future)
+  uint8_t signature[64];     // Ed25519 signature over SHA-256 of the header
+                             // without this field
   uint32_t rollback_counter; // Anti-rollback counter
   uint32_t flags;            // Flags (debug, etc.)
   uint8_t reserved[120];     // Reserved for future use
@@ -50,6 +53,11 @@ typedef enum {
   BOOT_STATUS_RECOVERY_MODE
 } boot_status_t;
 
+// Vendor firmware signing keys, precomputed at build time into flash
+// (tools/gen_ed25519_tables.py, LIBRECRYPT_VENDOR_PUBKEYS)
+extern const ed25519_pubkey_ctx_t bootloader_vendor_keys[];
+extern const size_t bootloader_vendor_key_count;
+
 /**
  * Initialize bootloader
  */
@@ -81,6 +89,19 @@ uint32_t bootloader_get_rollback_counter(void);
  */
 bool bootloader_update_rollback_counter(uint32_t new_counter);
 
+/**
+ * Queue the spare rollback sector for erase during idle time when the
+ * active one is nearly full, so the next update only programs. Called by
+ * the application after boot.
+ */
+void bootloader_schedule_rollback_erase(void);
+
+/**
+ * Initialize the recovery button GPIO (input, pull-up). The application
+ * calls it too: the same button confirms sensitive operations.
+ */
+void bootloader_button_init(void);
+
 /**
  * Check if recovery button is pressed
  */
@@ -0,0 +1,73 @@
+/**
+ * LibreCipher HMAC-DRBG (NIST SP 800-90A, HMAC-SHA256)
+ *
+ * Buffered CSPRNG seeded and periodically reseeded from an entropy source
+ * (entropy.h). Output costs two SHA-256 compressions per 32 bytes: the
+ * HMAC key midstates are cached and only recomputed when K changes.
+ *
+ * Zero dynamic allocation.
+ */
+
+#ifndef DRBG_H
+#define DRBG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "entropy.h"
+#include "sha256.h"
+
+#define DRBG_SEED_SIZE 48         // Entropy input + nonce at instantiation
+#define DRBG_RESEED_SIZE 32       // Entropy input per reseed
+#define DRBG_RESEED_INTERVAL 1024 // Generate calls between reseeds
+#define DRBG_MAX_REQUEST 65536    // Bytes per internal generate (2^19 bits)
+
+/**
+ * DRBG state
+ */
+typedef struct {
+  uint8_t K[32];
+  uint8_t V[32];
+  sha256_ctx_t ipad_ctx; // H(K ^ ipad) midstate
+  sha256_ctx_t opad_ctx; // H(K ^ opad) midstate
+  uint32_t reseed_counter; // Generate calls since the last (re)seed
+  uint32_t reseed_count;   // Reseeds since instantiation
+  uint64_t bytes_generated;
+  entropy_source_fn entropy;
+  void *entropy_ctx;
+  bool seeded;
+} drbg_ctx_t;
+
+/**
+ * Instantiate from the entropy source
+ * @param ctx DRBG state
+ * @param entropy entropy source callback
+ * @param entropy_ctx source state (passed to the callback)
+ * @param personalization optional personalization string
+ * @param personalization_len length
+ * @return false if the entropy source failed
+ */
+bool drbg_init(drbg_ctx_t *ctx, entropy_source_fn entropy, void *entropy_ctx,
+               const uint8_t *personalization, size_t personalization_len);
+
+/**
+ * Reseed with fresh entropy
+ * @param additional optional additional input
+ * @return false if the entropy source failed (state left unchanged)
+ */
+bool drbg_reseed(drbg_ctx_t *ctx, const uint8_t *additional,
+                 size_t additional_len);
+
+/**
+ * Generate random bytes, reseeding first when the interval is reached
+ * @return false if not seeded or a required reseed failed
+ */
+bool drbg_generate(drbg_ctx_t *ctx, uint8_t *out, size_t len);
+
+/**
+ * Securely zero the state
+ */
+void drbg_clear(drbg_ctx_t *ctx);
+
+#endif // DRBG_H
@@ -20,6 +20,7 @@
 #define ED25519_PUBLIC_KEY_SIZE 32
 #define ED25519_SECRET_KEY_SIZE 64 // seed + public key
 #define ED25519_SIGNATURE_SIZE 64
+#define X25519_KEY_SIZE 32
 
 /**
  * Key pair structure
@@ -29,6 +30,39 @@ typedef struct {
   uint8_t secret_key[ED25519_SECRET_KEY_SIZE];
 } ed25519_keypair_t;
 
+/**
+ * Expanded signing key
+ *
+ * Caches the result of hashing and clamping the seed so that repeated
+ * signatures with the same key skip the key expansion. The nonce hash
+ * H(prefix || message) is computed in full at sign time: the 32-byte
+ * prefix alone never fills a SHA-512 block, so a midstate would save no
+ * compression.
+ */
+typedef struct {
+  uint8_t scalar[32]; // Clamped secret scalar a
+  uint8_t prefix[32]; // Nonce prefix (upper half of H(seed))
+  uint8_t public_key[ED25519_PUBLIC_KEY_SIZE];
+} ed25519_expanded_key_t;
+
+// Odd multiples kept per public key (wNAF width 5: A, 3A, ..., 15A)
+#define ED25519_PUBKEY_CTX_POINTS 8
+
+/**
+ * Precomputed verification context for a fixed public key
+ *
+ * Holds the decompressed key (negated, since verification computes
+ * s*B - k*A) and its odd multiples in cached form (Y+X, Y-X, Z, 2dT),
+ * radix 2^25.5 limbs. multiples[0] is -A itself.
+ *
+ * Built once with ed25519_pubkey_ctx_init for runtime keys, or generated
+ * at build time into flash (tools/gen_ed25519_tables.py) for baked-in keys.
+ */
+typedef struct {
+  uint8_t public_key[ED25519_PUBLIC_KEY_SIZE];
+  int64_t multiples[ED25519_PUBKEY_CTX_POINTS][4][10];
+} ed25519_pubkey_ctx_t;
+
 /**
  * Generate key pair from seed
  * @param seed 32-byte random seed
@@ -40,8 +74,9 @@ void ed25519_create_keypair(const uint8_t seed[32], ed25519_keypair_t *keypair);
  * Generate key pair with random seed
  * Uses LibreCipher RNG
  * @param keypair output key pair
+ * @return false if the RNG failed its health tests (keypair untouched)
  */
-void ed25519_generate_keypair(ed25519_keypair_t *keypair);
+bool ed25519_generate_keypair(ed25519_keypair_t *keypair);
 
 /**
  * Sign message
@@ -53,6 +88,71 @@ void ed25519_generate_keypair(ed25519_keypair_t *keypair);
 void ed25519_sign(uint8_t signature[64], const uint8_t *message,
                   size_t message_len, const uint8_t secret_key[64]);
 
+/**
+ * Expand secret key for repeated signing
+ * @param key output expanded key (clear with ed25519_expanded_key_clear)
+ * @param secret_key secret key (64 bytes)
+ */
+void ed25519_expand_key(ed25519_expanded_key_t *key,
+                        const uint8_t secret_key[64]);
+
+/**
+ * Sign message with an expanded key
+ * @param signature output (64 bytes)
+ * @param message message to sign
+ * @param message_len message length
+ * @param key expanded key from ed25519_expand_key
+ */
+void ed25519_sign_expanded(uint8_t signature[64], const uint8_t *message,
+                           size_t message_len,
+                           const ed25519_expanded_key_t *key);
+
+/**
+ * Expand a raw extended key (BIP32-Ed25519 kL || kR)
+ *
+ * The scalar is used as is: no seed hashing and no clamping, since
+ * hierarchical derivation produces kL directly.
+ * @param key output expanded key (clear with ed25519_expanded_key_clear)
+ * @param scalar secret scalar kL (32 bytes)
+ * @param prefix nonce prefix kR (32 bytes)
+ * @param public_key kL * B (32 bytes)
+ */
+void ed25519_expand_extended(ed25519_expanded_key_t *key,
+                             const uint8_t scalar[32],
+                             const uint8_t prefix[32],
+                             const uint8_t public_key[32]);
+
+/**
+ * Public key of a raw scalar (A = scalar * B, no hashing or clamping)
+ * @param public_key output (32 bytes)
+ * @param scalar secret scalar (32 bytes)
+ */
+void ed25519_scalar_to_public(uint8_t public_key[32],
+                              const uint8_t scalar[32]);
+
+// Points normalized per shared inversion in ed25519_scalar_to_public_batch
+#define ED25519_BATCH_MAX 8
+
+/**
+ * Public keys of several raw scalars
+ *
+ * Same output as ed25519_scalar_to_public per scalar, but the projective
+ * Z coordinates of each chunk of ED25519_BATCH_MAX points are inverted
+ * together (Montgomery's trick): one field inversion plus three
+ * multiplications per point instead of one inversion per point.
+ * @param public_keys output (count x 32 bytes)
+ * @param scalars secret scalars (count x 32 bytes)
+ * @param count number of keys
+ */
+void ed25519_scalar_to_public_batch(uint8_t (*public_keys)[32],
+                                    const uint8_t (*scalars)[32],
+                                    size_t count);
+
+/**
+ * Securely zero an expanded key
+ */
+void ed25519_expanded_key_clear(ed25519_expanded_key_t *key);
+
 /**
  * Verify signature
  * @param signature signature to verify (64 bytes)
@@ -64,6 +164,26 @@ void ed25519_sign(uint8_t signature[64], const uint8_t *message,
 bool ed25519_verify(const uint8_t signature[64], const uint8_t *message,
                     size_t message_len, const uint8_t public_key[32]);
 
+/**
+ * Decompress a public key and build its verification context
+ * @param ctx output context (public data, no need to clear)
+ * @param public_key public key (32 bytes)
+ * @return false if the key is not a valid point encoding
+ */
+bool ed25519_pubkey_ctx_init(ed25519_pubkey_ctx_t *ctx,
+                             const uint8_t public_key[32]);
+
+/**
+ * Verify signature against a precomputed context
+ * @param signature signature to verify (64 bytes)
+ * @param message original message
+ * @param message_len message length
+ * @param ctx context from ed25519_pubkey_ctx_init or a flash table
+ * @return true if valid
+ */
+bool ed25519_verify_ctx(const uint8_t signature[64], const uint8_t *message,
+                        size_t message_len, const ed25519_pubkey_ctx_t *ctx);
+
 /**
  * Get public key from secret key
  * @param public_key output (32 bytes)
@@ -72,4 +192,22 @@ bool ed25519_verify(const uint8_t signature[64], const uint8_t *message,
 void ed25519_get_public_key(uint8_t public_key[32],
                             const uint8_t secret_key[64]);
 
+// ============ X25519 Key Agreement (RFC 7748) ============
+
+/**
+ * Scalar multiplication on Curve25519 (Montgomery ladder, constant-time)
+ * @param out output u-coordinate (32 bytes)
+ * @param scalar secret scalar (32 bytes, clamped internally)
+ * @param point input u-coordinate (32 bytes)
+ */
+void x25519(uint8_t out[32], const uint8_t scalar[32],
+            const uint8_t point[32]);
+
+/**
+ * Compute X25519 public key (scalar * base point u = 9)
+ * @param public_key output (32 bytes)
+ * @param secret_key secret key (32 bytes)
+ */
+void x25519_base(uint8_t public_key[32], const uint8_t secret_key[32]);
+
 #endif // ED25519_H
@@ -0,0 +1,68 @@
+/**
+ * Codificação de endereços - bech32/bech32m e base58/base58check
+ *
+ * - bech32: polymod por tabela (um lookup por caractere em vez de cinco
+ *   testes de bit); bytes convertidos para grupos de 5 bits em streaming,
+ *   sem buffer intermediário
+ * - base58: conversão em raiz 58^5 sobre limbs de 32 bits, por somas de
+ *   produtos com uma tabela gerada no build (tools/gen_base58_tables.py),
+ *   sem a divisão por 58 do número inteiro a cada dígito
+ *
+ * Todas as funções escrevem uma string terminada em NUL e retornam o
+ * tamanho sem o terminador, ou 0 se a entrada é inválida ou out_size não
+ * comporta o resultado.
+ */
+
+#ifndef ENCODING_H
+#define ENCODING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BASE58_MAX_INPUT 64
+#define BASE58CHECK_MAX_PAYLOAD (BASE58_MAX_INPUT - 4)
+
+// Constante final do checksum
+typedef enum {
+  BECH32_ENCODING_BECH32 = 1,           // BIP-173 (segwit v0, Cardano)
+  BECH32_ENCODING_BECH32M = 0x2bc830a3  // BIP-350 (segwit v1+)
+} bech32_encoding_t;
+
+/**
+ * Codifica bytes em bech32 (sem limite de 90 caracteres, como o Cardano)
+ * @param hrp parte legível, minúsculas ASCII 33..126
+ * @param data bytes do payload (convertidos para 5 bits com padding)
+ * @return tamanho da string
+ */
+size_t bech32_encode(char *out, size_t out_size, const char *hrp,
+                     const uint8_t *data, size_t data_len,
+                     bech32_encoding_t encoding);
+
+/**
+ * Endereço segwit (BIP-173/BIP-350): versão 0 em bech32, 1..16 em bech32m
+ * @param hrp "bc" ou "tb"
+ * @param version versão do witness (0..16)
+ * @param program programa do witness (2..40 bytes; 20 ou 32 na versão 0)
+ * @return tamanho da string
+ */
+size_t segwit_address_encode(char *out, size_t out_size, const char *hrp,
+                             uint8_t version, const uint8_t *program,
+                             size_t program_len);
+
+/**
+ * Codifica bytes em base58 (alfabeto Bitcoin)
+ * @param data até BASE58_MAX_INPUT bytes; zeros à esquerda viram '1'
+ * @return tamanho da string
+ */
+size_t base58_encode(char *out, size_t out_size, const uint8_t *data,
+                     size_t len);
+
+/**
+ * base58check: payload || SHA-256(SHA-256(payload))[0..4)
+ * @param payload versão || dados, até BASE58CHECK_MAX_PAYLOAD bytes
+ * @return tamanho da string
+ */
+size_t base58check_encode(char *out, size_t out_size, const uint8_t *payload,
+                          size_t len);
+
+#endif // ENCODING_H
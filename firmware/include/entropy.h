@@ -0,0 +1,135 @@
+/**
+ * LibreCipher Entropy Sources
+ *
+ * Raw entropy for seeding the DRBG (see drbg.h)
+ * - Device: ring oscillator (ROSC) random bit, harvested in the background
+ *   by a repeating timer into a SHA-256 conditioned pool
+ * - Online health tests (SP 800-90B 4.4) on every raw bit; a failure
+ *   latches and the source stops delivering until reset
+ * - Host (LIBRECIPHER_HOST): simulated noisy oscillator feeding the same
+ *   pool, plus a deterministic SHA-256 counter stream for DRBG tests
+ */
+
+#ifndef ENTROPY_H
+#define ENTROPY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Conditioned pool: ready blocks of SHA-256 output
+#define ENTROPY_BLOCK_SIZE 32
+#define ENTROPY_POOL_BLOCKS 4
+#define ENTROPY_POOL_SIZE (ENTROPY_BLOCK_SIZE * ENTROPY_POOL_BLOCKS)
+
+// Raw bytes conditioned into each block (credit: 0.5 bit per raw bit)
+#define ENTROPY_RAW_PER_BLOCK 64
+
+// Background harvesting: raw bytes collected per timer tick
+#define ENTROPY_HARVEST_PERIOD_US 1000
+#define ENTROPY_HARVEST_BYTES 8
+
+// Health tests for the claimed 0.5 bit/bit, false positive rate 2^-20:
+// repetition count C = 1 + ceil(20 / H), adaptive proportion
+// C = 1 + CRITBINOM(W, 2^-H, 1 - 2^-20) over binary windows of W = 1024
+#define ENTROPY_RCT_CUTOFF 41
+#define ENTROPY_APT_WINDOW 1024
+#define ENTROPY_APT_CUTOFF 793
+
+// Startup test: raw bits tested and discarded before the first block
+#define ENTROPY_STARTUP_BITS ENTROPY_APT_WINDOW
+
+// Latched health failures (entropy_health_t.failures)
+#define ENTROPY_HEALTH_RCT 0x01 // Repetition count: stuck source
+#define ENTROPY_HEALTH_APT 0x02 // Adaptive proportion: biased source
+
+/**
+ * Health test counters
+ */
+typedef struct {
+  uint32_t raw_bits;      // Raw bits tested
+  uint32_t apt_windows;   // Completed APT windows
+  uint16_t apt_max_count; // Highest APT count in a completed window
+  uint8_t failures;       // ENTROPY_HEALTH_* flags (latched)
+  bool startup_done;      // Startup bits tested, blocks may be produced
+} entropy_health_t;
+
+/**
+ * Entropy source callback
+ * @param buf output
+ * @param len bytes requested
+ * @param ctx source state
+ * @return false if the source cannot deliver (the caller must not use buf)
+ */
+typedef bool (*entropy_source_fn)(uint8_t *buf, size_t len, void *ctx);
+
+/**
+ * Start background harvesting (repeating timer on the device)
+ */
+void entropy_pool_start(void);
+
+/**
+ * Harvest raw bytes into the pool (timer callback body; host tests call
+ * it directly to simulate ticks). Does nothing once the pool is full.
+ */
+void entropy_pool_harvest(size_t raw_bytes);
+
+/**
+ * Conditioned bytes ready to be served without harvesting
+ */
+size_t entropy_pool_level(void);
+
+/**
+ * Whether len bytes can be served immediately from the pool
+ */
+bool entropy_available(size_t len);
+
+/**
+ * Read conditioned entropy: served from the pool, harvesting in the
+ * foreground only for what the pool cannot cover
+ * (matches entropy_source_fn, ctx is ignored)
+ */
+bool entropy_default_source(uint8_t *buf, size_t len, void *ctx);
+
+/**
+ * Latched ENTROPY_HEALTH_* failures (0 while the source is healthy).
+ * Once set, the pool is wiped, harvesting stops and entropy_default_source
+ * returns false; only a reset clears it.
+ */
+uint8_t entropy_health_failures(void);
+
+/**
+ * Snapshot of the health test counters
+ */
+void entropy_health_get(entropy_health_t *health);
+
+#if LIBRECIPHER_HOST
+/**
+ * Deterministic test source: SHA-256(seed || counter) blocks
+ */
+typedef struct {
+  uint8_t seed[32];
+  uint64_t counter;
+} entropy_test_source_t;
+
+/**
+ * Deterministic source for host tests (ctx is an entropy_test_source_t)
+ */
+bool entropy_test_source(uint8_t *buf, size_t len, void *ctx);
+
+/**
+ * Simulated oscillator behaviour for health test runs
+ */
+typedef enum {
+  ENTROPY_SIM_NOISY = 0, // Jittered oscillator, ~55% ones
+  ENTROPY_SIM_STUCK,     // Constant output
+  ENTROPY_SIM_BIASED,    // Jittered but ~85% ones
+} entropy_sim_mode_t;
+
+/**
+ * Reset pool, health state and simulator (stands in for a device reset)
+ */
+void entropy_sim_reset(entropy_sim_mode_t mode);
+#endif
+
+#endif // ENTROPY_H
@@ -0,0 +1,140 @@
+/**
+ * NOR Flash Access
+ *
+ * Thin layer over the QSPI flash used by persistent storage
+ * - Device: XIP reads, flash_range_program/erase with interrupts disabled
+ * - Host (LIBRECIPHER_HOST): file-backed simulator with the same rules as
+ *   the real part: 4 KB erase granularity and erase-before-write (a byte
+ *   can only be programmed while it still reads 0xFF)
+ *
+ * Offsets are relative to the start of flash. Programs may start and end
+ * anywhere: partial pages are padded with 0xFF, which leaves the bytes
+ * around them untouched, so small records can share a page.
+ *
+ * Programs are write-back: they collect in a RAM window of consecutive
+ * pages and reach flash on flash_nor_flush, when a program falls outside
+ * the window, or before any erase. Reads see pending bytes. Callers that
+ * need an ordering across a power loss flush between the two writes.
+ *
+ * Erases can also be deferred: writers queue sectors they no longer need
+ * and the main loop erases them one per idle iteration, so the foreground
+ * finds space already erased and only programs.
+ */
+
+#ifndef FLASH_NOR_H
+#define FLASH_NOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define FLASH_NOR_PAGE_SIZE 256    // Program unit
+#define FLASH_NOR_SECTOR_SIZE 4096 // Erase unit
+
+#ifndef FLASH_NOR_CACHE_PAGES
+#define FLASH_NOR_CACHE_PAGES 4 // Write-back window (1 KB of RAM)
+#endif
+
+#ifndef FLASH_NOR_ERASE_QUEUE
+#define FLASH_NOR_ERASE_QUEUE 16 // Sectors waiting for an idle erase
+#endif
+
+/**
+ * Called after a deferred erase, from the idle context
+ * @param offset the sector just erased
+ */
+typedef void (*flash_nor_erased_fn)(uint32_t offset);
+
+/**
+ * Read flash contents
+ * @return false if the range is outside the flash
+ */
+bool flash_nor_read(uint32_t offset, void *buf, size_t len);
+
+/**
+ * Program bytes into erased flash (buffered until the next flush)
+ * @return false if the range is outside the flash, a byte was programmed
+ *         twice without an erase in between (always checked against the
+ *         window, against flash on the host) or an implicit flush failed
+ */
+bool flash_nor_program(uint32_t offset, const void *data, size_t len);
+
+/**
+ * Write pending programs to flash, one call per run of dirty pages
+ * @return false if a program failed (pending bytes are dropped either way)
+ */
+bool flash_nor_flush(void);
+
+/**
+ * Erase whole sectors back to 0xFF (flushes pending programs first)
+ * @param offset sector aligned
+ * @param len multiple of FLASH_NOR_SECTOR_SIZE
+ */
+bool flash_nor_erase(uint32_t offset, size_t len);
+
+/**
+ * Check that a range reads all 0xFF (programmable without an erase)
+ */
+bool flash_nor_is_erased(uint32_t offset, size_t len);
+
+/**
+ * Queue a sector for erase during idle time
+ *
+ * A later flash_nor_erase covering the sector cancels the deferred erase
+ * (and its callback).
+ * @param offset sector aligned
+ * @param done optional callback once erased
+ * @return false if misaligned or the queue is full (the caller then
+ *         erases in the foreground when it needs the space)
+ */
+bool flash_nor_erase_later(uint32_t offset, flash_nor_erased_fn done);
+
+/**
+ * Check whether a sector is waiting for a deferred erase
+ */
+bool flash_nor_erase_pending(uint32_t offset);
+
+/**
+ * Run one deferred erase (oldest first); sectors found already erased
+ * are only dequeued
+ * @return true if the queue had work
+ */
+bool flash_nor_erase_step(void);
+
+#if LIBRECIPHER_HOST
+/**
+ * Simulator counters: flash calls, and the time the device would spend
+ * with interrupts off and XIP unavailable
+ */
+typedef struct {
+  uint32_t program_ops;
+  uint32_t pages_programmed;
+  uint32_t erase_ops;
+  uint64_t stall_us;
+} flash_nor_sim_stats_t;
+
+/**
+ * Open (or create, fully erased) the backing file of the simulated flash
+ * @param size flash size, multiple of FLASH_NOR_SECTOR_SIZE
+ */
+bool flash_nor_sim_open(const char *path, uint32_t size);
+
+/**
+ * Close the backing file (stands in for a power cycle: programs still
+ * pending in RAM are lost)
+ */
+void flash_nor_sim_close(void);
+
+/**
+ * Simulate a power loss after `bytes` more programmed bytes
+ *
+ * The program in flight stops midway (torn write) and every later program
+ * or erase fails until the next flash_nor_sim_open.
+ */
+void flash_nor_sim_power_cut(uint32_t bytes);
+
+void flash_nor_sim_get_stats(flash_nor_sim_stats_t *stats);
+void flash_nor_sim_reset_stats(void);
+#endif
+
+#endif // FLASH_NOR_H
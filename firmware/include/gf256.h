@@ -0,0 +1,83 @@
+/**
+ * LibreCipher GF(2^8) Arithmetic for Secret Sharing
+ *
+ * Field GF(2^8) modulo x^8 + x^4 + x^3 + x + 1 (0x11B, as AES and SLIP-39)
+ * - Constant time: no log/antilog tables, no secret-dependent branches or
+ *   memory indexes
+ * - Vectors of up to 32 bytes are bitsliced into eight 32-bit planes
+ *   (plane b holds bit b of every byte), so one masked XOR per plane
+ *   multiplies all 32 bytes by one bit of a scalar
+ * - Lagrange interpolation as coefficients (depend only on the public
+ *   x coordinates) applied to bitsliced share values
+ */
+
+#ifndef GF256_H
+#define GF256_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define GF256_VECTOR_SIZE 32 // Bytes per bitsliced vector
+#define GF256_MAX_POINTS 16  // Points per interpolation
+
+/**
+ * Bitsliced vector: bit b of byte k is bit k of plane[b]
+ */
+typedef struct {
+  uint32_t plane[8];
+} gf256_vector_t;
+
+/**
+ * Constant-time product
+ */
+uint8_t gf256_mul(uint8_t a, uint8_t b);
+
+/**
+ * Constant-time inverse (a^254; 0 maps to 0)
+ */
+uint8_t gf256_inv(uint8_t a);
+
+/**
+ * Bitslice bytes into a vector
+ * @param len 0 .. GF256_VECTOR_SIZE (missing bytes are zero)
+ */
+void gf256_vector_load(gf256_vector_t *v, const uint8_t *bytes, size_t len);
+
+/**
+ * Back to bytes
+ * @param len 0 .. GF256_VECTOR_SIZE
+ */
+void gf256_vector_store(const gf256_vector_t *v, uint8_t *bytes, size_t len);
+
+/**
+ * acc += c * v, for all 32 bytes at once
+ */
+void gf256_vector_mul_add(gf256_vector_t *acc, const gf256_vector_t *v,
+                          uint8_t c);
+
+/**
+ * Lane-wise product out[k] = a[k] * b[k] (out may alias a or b)
+ */
+void gf256_vector_mul(gf256_vector_t *out, const gf256_vector_t *a,
+                      const gf256_vector_t *b);
+
+/**
+ * Lagrange basis at x: f(x) = sum coeff[j] * f(xs[j])
+ * @param xs distinct x coordinates
+ * @param count 1 .. GF256_MAX_POINTS
+ * @param coeff output (count bytes)
+ * @return false if count is out of range or two x coordinates are equal
+ */
+bool gf256_lagrange(const uint8_t *xs, size_t count, uint8_t x,
+                    uint8_t *coeff);
+
+/**
+ * Value at x of the polynomial through (xs[j], ys[j])
+ * @param ys bitsliced values
+ * @return false as gf256_lagrange
+ */
+bool gf256_interpolate(const uint8_t *xs, const gf256_vector_t *ys,
+                       size_t count, uint8_t x, gf256_vector_t *out);
+
+#endif // GF256_H
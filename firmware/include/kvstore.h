@@ -0,0 +1,128 @@
+/**
+ * Log-Structured Encrypted Key-Value Store
+ *
+ * Small records (wallet state) kept on a ring of reserved flash sectors
+ * - Append-only: an update writes a new record, never rewrites a sector
+ * - Each record sealed with AES-256-GCM (librecipher_encrypt); id, length,
+ *   flags and sequence number are bound as associated data
+ * - Power-fail safe: a record counts only after its commit byte is
+ *   programmed, as a separate step after the whole record is in flash.
+ *   A torn record is skipped and appends carry on after it
+ * - Incremental garbage collection: live records of the oldest sector are
+ *   copied to the head a few at a time, then the sector is retired and
+ *   queued for an idle-time erase (flash_nor_erase_step)
+ *
+ * The latest location of every id is kept in a RAM index, so a get is a
+ * single read and a put a single append. Every sector starts with a
+ * checkpoint of that index: mounting reads the newest checkpoint and
+ * replays at most one sector of records, whatever the fill level.
+ */
+
+#ifndef KVSTORE_H
+#define KVSTORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "flash_nor.h"
+
+#define KVSTORE_MAX_VALUE 320 // Bytes per value (the sealed wallet is ~290)
+#define KVSTORE_MAX_KEYS 16   // Distinct ids (live or deleted) in RAM
+#define KVSTORE_MAX_SECTORS 32
+#define KVSTORE_MIN_SECTORS 4 // Head, oldest, two GC reserve
+#define KVSTORE_ID_MAX 0xFFFD // Higher ids are reserved (checkpoints)
+
+/**
+ * RAM index entry: where the latest record of an id lives
+ */
+typedef struct {
+  uint32_t seq;
+  uint32_t offset;
+  uint16_t id;
+  bool used;
+  bool deleted; // Latest record is a tombstone
+} kvstore_slot_t;
+
+/**
+ * Mounted store
+ */
+typedef struct {
+  uint8_t key[32];
+  uint32_t base;         // Flash offset of the first sector
+  uint32_t sector_count; // Sectors in the ring
+  // Sequence number of each sector's header, 0 while the sector is free
+  uint32_t sector_seq[KVSTORE_MAX_SECTORS];
+  uint32_t erased_mask;     // Free sectors known to be erased
+  uint32_t head;            // Sector taking appends
+  uint32_t head_offset;     // Next append inside the head sector
+  uint32_t next_seq;        // Next record sequence number
+  uint32_t next_sector_seq; // Next sector sequence number
+  uint32_t gc_offset;       // GC cursor inside the oldest sector
+  uint32_t mount_records;   // Records read by the last mount or rebuild
+  kvstore_slot_t index[KVSTORE_MAX_KEYS];
+} kvstore_t;
+
+/**
+ * Mount the store: RAM index from the newest checkpoint plus the records
+ * after it (full log replay if that checkpoint is missing or damaged)
+ * @param kv output store (clear with kvstore_unmount)
+ * @param base flash offset, sector aligned
+ * @param sector_count KVSTORE_MIN_SECTORS .. KVSTORE_MAX_SECTORS
+ * @param key record sealing key (32 bytes)
+ * @return false on invalid geometry
+ */
+bool kvstore_mount(kvstore_t *kv, uint32_t base, uint32_t sector_count,
+                   const uint8_t key[32]);
+
+/**
+ * Rebuild the RAM index by replaying the whole log, ignoring checkpoints
+ * (recovery, and the reference for mount time)
+ */
+void kvstore_rebuild(kvstore_t *kv);
+
+/**
+ * Forget the mounted state and wipe the sealing key
+ */
+void kvstore_unmount(kvstore_t *kv);
+
+/**
+ * Store a value (replaces the previous one)
+ * @param id key, 0 .. KVSTORE_ID_MAX
+ * @param len 1 .. KVSTORE_MAX_VALUE
+ * @return false if the store is full of live data, the RNG failed or the
+ *         flash write failed (the previous value stays current)
+ */
+bool kvstore_put(kvstore_t *kv, uint16_t id, const void *value, size_t len);
+
+/**
+ * Read a value
+ * @param size capacity of value
+ * @return value length, 0 if absent, too large for value or not authentic
+ */
+size_t kvstore_get(kvstore_t *kv, uint16_t id, void *value, size_t size);
+
+/**
+ * Delete a value (appends a tombstone)
+ * @return true if the id is now absent
+ */
+bool kvstore_delete(kvstore_t *kv, uint16_t id);
+
+/**
+ * Erase every sector of the store and remount it empty
+ */
+bool kvstore_format(kvstore_t *kv);
+
+/**
+ * One bounded unit of garbage collection: copy at most one live record
+ * out of the oldest sector, or retire it once nothing live is left
+ * @return true if there was work to do
+ */
+bool kvstore_gc_step(kvstore_t *kv);
+
+/**
+ * Free sectors (not holding any record)
+ */
+uint32_t kvstore_free_sectors(const kvstore_t *kv);
+
+#endif // KVSTORE_H
@@ -35,9 +35,17 @@ void librecipher_secure_zero(void *ptr, size_t len);
 int librecipher_secure_compare(const uint8_t *a, const uint8_t *b, size_t len);
 
 /**
- * Gerador de números aleatórios (TRNG)
+ * Gerador de números aleatórios (HMAC-DRBG semeado pelo TRNG, ver drbg.h)
+ * @return false se a fonte de entropia falhou nos testes de saúde (buf zerado)
  */
-void librecipher_random(uint8_t *buf, size_t len);
+bool librecipher_random(uint8_t *buf, size_t len);
+
+/**
+ * Estado dos testes de saúde do TRNG (SP 800-90B)
+ * @return false após falha (travada até reset); nenhuma chave nova deve ser
+ *         gerada
+ */
+bool librecipher_rng_healthy(void);
 
 /**
  * SHA-256 Hash
@@ -51,6 +59,19 @@ void librecipher_hmac_sha256(const uint8_t *key, size_t key_len,
                              const uint8_t *data, size_t data_len,
                              uint8_t *mac);
 
+// Saída máxima do HKDF-Expand por rótulo (255 blocos)
+#define LIBRECIPHER_KDF_MAX_OUTPUT (255 * LIBRECIPHER_HASH_SIZE)
+
+/**
+ * Rótulo de derivação: uma chave de saída por info
+ */
+typedef struct {
+  const uint8_t *info;
+  size_t info_len;
+  uint8_t *output;
+  size_t output_len; // <= LIBRECIPHER_KDF_MAX_OUTPUT
+} librecipher_kdf_label_t;
+
 /**
  * Key Derivation (HKDF)
  */
@@ -58,6 +79,18 @@ void librecipher_kdf(const uint8_t *password, size_t password_len,
                      const uint8_t *salt, size_t salt_len, const uint8_t *info,
                      size_t info_len, uint8_t *output, size_t output_len);
 
+/**
+ * Várias chaves do mesmo segredo (HKDF): um Extract, um Expand por rótulo
+ *
+ * O PRK e seus midstates de HMAC são calculados uma vez; o info entra no
+ * hash direto do buffer do chamador, sem cópia nem limite de tamanho.
+ * Cada saída é idêntica a librecipher_kdf com o mesmo info.
+ */
+void librecipher_kdf_multi(const uint8_t *password, size_t password_len,
+                           const uint8_t *salt, size_t salt_len,
+                           const librecipher_kdf_label_t *labels,
+                           size_t label_count);
+
 /**
  * AES-256-GCM Encrypt
  * @return true se sucesso
@@ -105,4 +138,16 @@ bool librecipher_ed25519_verify(const uint8_t *signature,
                                 const uint8_t *message, size_t message_len,
                                 const uint8_t *public_key);
 
+// ============ X25519 Key Agreement ============
+
+/**
+ * X25519 Diffie-Hellman (RFC 7748)
+ * @param shared_secret output 32 bytes
+ * @param secret_key our 32-byte secret
+ * @param peer_public_key peer's 32-byte public key
+ * @return false if the result is all-zero (low-order peer point)
+ */
+bool librecipher_x25519(uint8_t *shared_secret, const uint8_t *secret_key,
+                        const uint8_t *peer_public_key);
+
 #endif // LIBRECIPHER_H
@@ -0,0 +1,37 @@
+/**
+ * LibreCipher PBKDF2-HMAC-SHA512 / PBKDF2-HMAC-SHA256
+ *
+ * PBKDF2 (RFC 8018) with HMAC-SHA512, used by the BIP-39 mnemonic-to-seed
+ * step (2048 iterations), and with HMAC-SHA256 for the SLIP-39 Feistel
+ * rounds
+ * - ipad/opad midstates computed once per call
+ * - Each iteration is exactly two compressions on fixed-layout word
+ *   blocks: no HMAC re-keying, no byte serialization
+ */
+
+#ifndef PBKDF2_H
+#define PBKDF2_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * PBKDF2-HMAC-SHA512
+ * @param password password (any length; hashed first if > 128 bytes)
+ * @param salt salt
+ * @param iterations iteration count (>= 1)
+ * @param out derived key
+ * @param out_len derived key size
+ */
+void pbkdf2_hmac_sha512(const uint8_t *password, size_t password_len,
+                        const uint8_t *salt, size_t salt_len,
+                        uint32_t iterations, uint8_t *out, size_t out_len);
+
+/**
+ * PBKDF2-HMAC-SHA256 (same contract as pbkdf2_hmac_sha512)
+ */
+void pbkdf2_hmac_sha256(const uint8_t *password, size_t password_len,
+                        const uint8_t *salt, size_t salt_len,
+                        uint32_t iterations, uint8_t *out, size_t out_len);
+
+#endif // PBKDF2_H
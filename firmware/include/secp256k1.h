@@ -0,0 +1,73 @@
+/**
+ * secp256k1 ECDSA Implementation
+ *
+ * SEC 1 ECDSA over y^2 = x^3 + 7 (mod 2^256 - 2^32 - 977)
+ * - Signing: constant-time k*G from a precomputed flash table,
+ *   RFC 6979 deterministic nonces, low-S normalized output
+ * - Verification: variable-time (public data only), GLV endomorphism
+ *   with interleaved wNAF
+ *
+ * Zero dynamic allocation. Signatures are compact r || s (big-endian).
+ */
+
+#ifndef SECP256K1_H
+#define SECP256K1_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Key and signature sizes
+#define SECP256K1_SECRET_KEY_SIZE 32
+#define SECP256K1_PUBLIC_KEY_SIZE 33 // Compressed (0x02/0x03 || x)
+#define SECP256K1_SIGNATURE_SIZE 64  // r || s
+
+/**
+ * Check that a secret key is a valid scalar (1 <= d < n)
+ */
+bool secp256k1_seckey_verify(const uint8_t secret_key[32]);
+
+/**
+ * Compute compressed public key
+ * @param public_key output (33 bytes)
+ * @param secret_key secret key (32 bytes)
+ * @return false if the secret key is invalid
+ */
+bool secp256k1_get_public_key(uint8_t public_key[33],
+                              const uint8_t secret_key[32]);
+
+/**
+ * Sign a 32-byte message hash (RFC 6979 nonce, low-S)
+ * @param signature output r || s (64 bytes)
+ * @param hash message hash (32 bytes)
+ * @param secret_key secret key (32 bytes)
+ * @return false if the secret key is invalid
+ */
+bool secp256k1_sign(uint8_t signature[64], const uint8_t hash[32],
+                    const uint8_t secret_key[32]);
+
+/**
+ * Verify signature
+ * @param signature r || s (64 bytes); high-S is accepted
+ * @param hash message hash (32 bytes)
+ * @param public_key compressed (33 bytes) or uncompressed (65 bytes)
+ * @param public_key_len 33 or 65
+ * @return true if valid
+ */
+bool secp256k1_verify(const uint8_t signature[64], const uint8_t hash[32],
+                      const uint8_t *public_key, size_t public_key_len);
+
+#if LIBRECRYPT_BENCH
+/**
+ * Reference versions for bench_run: plain double-and-add (one doubling per
+ * bit, one addition per set bit) over the same field code, no tables, GLV
+ * or wNAF. Variable-time; never used for signing.
+ */
+bool secp256k1_get_public_key_naive(uint8_t public_key[33],
+                                    const uint8_t secret_key[32]);
+bool secp256k1_verify_naive(const uint8_t signature[64],
+                            const uint8_t hash[32], const uint8_t *public_key,
+                            size_t public_key_len);
+#endif
+
+#endif // SECP256K1_H
@@ -41,4 +41,10 @@ void sha256_final(sha256_ctx_t *ctx, uint8_t *digest);
  */
 void sha256_hash(const uint8_t *data, size_t len, uint8_t *digest);
 
+/**
+ * Raw compression function on a block already loaded as big-endian words
+ * (for fixed-layout callers such as PBKDF2)
+ */
+void sha256_compress(uint32_t state[8], const uint32_t block[16]);
+
 #endif // SHA256_H
@@ -0,0 +1,50 @@
+/**
+ * LibreCipher SHA-512 Implementation
+ *
+ * Constant-time SHA-512 following FIPS 180-4
+ * Used by Ed25519 (RFC 8032)
+ */
+
+#ifndef SHA512_H
+#define SHA512_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHA512_BLOCK_SIZE 128
+#define SHA512_DIGEST_SIZE 64
+
+typedef struct {
+  uint64_t state[8];
+  uint64_t count; // Bytes absorbed (messages < 2^61 bytes)
+  uint8_t buffer[SHA512_BLOCK_SIZE];
+} sha512_ctx_t;
+
+/**
+ * Initialize SHA-512 context
+ */
+void sha512_init(sha512_ctx_t *ctx);
+
+/**
+ * Update hash with data
+ */
+void sha512_update(sha512_ctx_t *ctx, const uint8_t *data, size_t len);
+
+/**
+ * Finalize hash and output digest (64 bytes)
+ */
+void sha512_final(sha512_ctx_t *ctx, uint8_t *digest);
+
+/**
+ * One-shot SHA-512
+ */
+void sha512_hash(const uint8_t *data, size_t len, uint8_t *digest);
+
+/**
+ * Raw compression function on a block already loaded as big-endian words
+ * (for fixed-layout callers such as PBKDF2). W is clobbered: it holds the
+ * message schedule on return.
+ */
+void sha512_compress(uint64_t state[8], uint64_t W[16]);
+
+#endif // SHA512_H
@@ -0,0 +1,140 @@
+/**
+ * SLIP-39 - Backup da seed em partes (Shamir)
+ *
+ * O segredo (16 a 32 bytes) é cifrado com a passphrase por uma Feistel de
+ * 4 rodadas de PBKDF2-HMAC-SHA256 e dividido em partes: qualquer
+ * `threshold` delas recupera o segredo, menos que isso não revela nada.
+ * Cada parte é um mnemonic de 20 (16 bytes) a 33 (32 bytes) palavras da
+ * lista SLIP-39, com checksum RS1024.
+ *
+ * Divisão e recuperação usam a aritmética GF(256) constant-time e
+ * bitsliced de gf256.h. A lista de palavras é um índice compacto gerado no
+ * build (tools/gen_slip39_index.py), como a do BIP-39.
+ */
+
+#ifndef SLIP39_H
+#define SLIP39_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SLIP39_WORD_COUNT 1024
+#define SLIP39_MAX_WORD_LEN 8
+#define SLIP39_MIN_SECRET 16
+#define SLIP39_MAX_SECRET 32
+#define SLIP39_MAX_SHARES 16 // Partes por grupo e grupos
+#define SLIP39_MIN_WORDS 20
+#define SLIP39_MAX_WORDS 33
+#define SLIP39_MAX_MNEMONIC_LEN                                                \
+  (SLIP39_MAX_WORDS * (SLIP39_MAX_WORD_LEN + 1) - 1)
+#define SLIP39_MAX_PASSPHRASE 256
+#define SLIP39_BASE_ITERATIONS 10000 // PBKDF2 total da Feistel com expoente 0
+
+/**
+ * Parte decodificada
+ */
+typedef struct {
+  uint16_t identifier;        // 15 bits, igual em todas as partes
+  bool extendable;            // Salt da Feistel independe do identificador
+  uint8_t iteration_exponent; // PBKDF2: (10000 << e) iterações no total
+  uint8_t group_index;
+  uint8_t group_threshold;
+  uint8_t group_count;
+  uint8_t member_index;
+  uint8_t member_threshold;
+  uint8_t value_len;
+  uint8_t value[SLIP39_MAX_SECRET];
+} slip39_share_t;
+
+/**
+ * Recebe cada parte gerada por slip39_split, em ordem de índice
+ */
+typedef void (*slip39_share_sink_t)(const slip39_share_t *share, void *ctx);
+
+/**
+ * Índice de uma palavra completa
+ * @return índice 0..1023, ou -1 se não está na lista
+ */
+int slip39_word_index(const char *word, size_t len);
+
+/**
+ * Palavras que começam com um prefixo (únicas nas 4 primeiras letras)
+ * @return quantidade de palavras; first vale se retorno > 0
+ */
+size_t slip39_prefix_range(const char *prefix, size_t len, uint16_t *first);
+
+/**
+ * Soletra a palavra de um índice
+ * @param word output (SLIP39_MAX_WORD_LEN + 1 bytes, com terminador)
+ * @return tamanho da palavra, 0 se índice inválido
+ */
+size_t slip39_word(uint16_t index, char *word);
+
+/**
+ * Codifica uma parte como índices de palavras (com checksum)
+ * @param words output (SLIP39_MAX_WORDS)
+ * @return quantidade de palavras, 0 se a parte é inválida
+ */
+size_t slip39_share_to_words(const slip39_share_t *share, uint16_t *words);
+
+/**
+ * Decodifica índices de palavras
+ * @return false se o checksum, o padding ou os campos não conferem
+ */
+bool slip39_share_from_words(const uint16_t *words, size_t count,
+                             slip39_share_t *share);
+
+/**
+ * Parte como mnemonic (palavras separadas por um espaço)
+ * @param size capacidade (SLIP39_MAX_MNEMONIC_LEN + 1 comporta qualquer
+ *        parte)
+ * @return tamanho sem o terminador, 0 se inválida ou não cabe
+ */
+size_t slip39_share_to_mnemonic(const slip39_share_t *share, char *mnemonic,
+                                size_t size);
+
+/**
+ * Mnemonic para parte (forma canônica: minúsculas, um espaço entre
+ * palavras)
+ */
+bool slip39_share_from_mnemonic(const char *mnemonic, slip39_share_t *share);
+
+/**
+ * Divide um segredo em partes de um grupo (1 de 1 grupo)
+ *
+ * As partes saem com identificador aleatório e a flag extendable.
+ * @param len SLIP39_MIN_SECRET .. SLIP39_MAX_SECRET, par
+ * @param passphrase ASCII imprimível ("" ou NULL para nenhuma)
+ * @param iteration_exponent 0..15
+ * @param threshold 1..count (1 exige count = 1)
+ * @param count 1..SLIP39_MAX_SHARES
+ * @param sink chamado uma vez por parte (a parte é zerada em seguida)
+ * @return false se os parâmetros são inválidos ou o RNG falhou (o sink
+ *         não é chamado)
+ */
+bool slip39_split(const uint8_t *secret, size_t len, const char *passphrase,
+                  uint8_t iteration_exponent, uint8_t threshold,
+                  uint8_t count, slip39_share_sink_t sink, void *ctx);
+
+/**
+ * Recupera o segredo de partes de um ou mais grupos
+ *
+ * Exige exatamente group_threshold grupos, cada um com exatamente o
+ * member_threshold do grupo, como a implementação de referência.
+ * @param secret output (SLIP39_MAX_SECRET)
+ * @param secret_len output
+ * @return false se as partes não são do mesmo segredo, faltam partes ou o
+ *         digest não confere (passphrase errada não é detectada: dá outro
+ *         segredo)
+ */
+bool slip39_combine(const slip39_share_t *shares, size_t count,
+                    const char *passphrase, uint8_t *secret,
+                    size_t *secret_len);
+
+/**
+ * Tamanho do índice da lista de palavras na flash (bytes)
+ */
+size_t slip39_index_size(void);
+
+#endif // SLIP39_H
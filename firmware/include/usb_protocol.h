@@ -6,6 +6,7 @@
 #define USB_PROTOCOL_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 
@@ -17,8 +18,14 @@ typedef enum {
   CMD_CREATE_WALLET = 0x10,
   CMD_UNLOCK = 0x11,
   CMD_LOCK = 0x12,
+  CMD_BACKUP_SLIP39 = 0x13, // Backup em partes: um frame de resposta por parte
+  CMD_BACKUP_EXPORT = 0x14, // Backup cifrado: cabeçalho e um frame por pedaço
+  CMD_BACKUP_IMPORT = 0x15, // Backup cifrado: início, pedaços e conclusão
+  CMD_SET_PASSPHRASE = 0x16, // Passphrase BIP-39: troca de wallet oculta
   CMD_GET_ADDRESS = 0x20,
-  CMD_SIGN_TX = 0x21,
+  CMD_SIGN_TX = 0x21,        // Acumula entradas de um lote de assinatura
+  CMD_GET_ADDRESSES = 0x23, // Faixa: um frame de resposta por endereço
+  CMD_SIGN_CONFIRM = 0x24,  // Confirma o lote: um frame por assinatura
 } usb_command_t;
 
 // Status de resposta
@@ -28,8 +35,17 @@ typedef enum {
   STATUS_INVALID_CMD = 0x02,
   STATUS_LOCKED = 0x03,
   STATUS_NEED_CONFIRM = 0x04,
+  // 0x05-0x07: PIN inválido, assinatura inválida, sessão expirada (app)
+  STATUS_RNG_FAILURE = 0x08, // TRNG reprovado nos testes de saúde
+  STATUS_DENIED = 0x09,      // Sem confirmação no botão do device
 } usb_status_t;
 
+/**
+ * Destino dos bytes de resposta
+ */
+typedef void (*usb_protocol_writer_t)(const uint8_t *data, size_t len,
+                                      void *ctx);
+
 /**
  * Inicializa protocolo USB
  */
@@ -37,7 +53,40 @@ void usb_protocol_init(void);
 
 /**
  * Task de processamento USB (chamar no loop principal)
+ *
+ * Lê de uma vez o que o CDC do TinyUSB já recebeu (tud_cdc_read) para um
+ * anel e despacha todos os frames completos: uma volta do loop por lote de
+ * comandos, não por byte.
+ * @return true se recebeu dados ou há um frame pela metade; false quando
+ *         ocioso (hora de trabalho em background, como erases da flash)
+ */
+bool usb_protocol_task(void);
+
+/**
+ * Processa um frame completo [SOF][LEN][CMD][DATA][CRC16]
+ *
+ * O que usb_protocol_task faz ao fechar um frame; exposto para medir o
+ * protocolo sem o USB (benchmark).
+ * @return false se o frame é malformado ou o CRC não confere (ignorado)
+ */
+bool usb_protocol_process_frame(const uint8_t *frame, size_t len);
+
+/**
+ * Desvia as respostas para outro destino (NULL volta ao stdio USB)
+ */
+void usb_protocol_set_writer(usb_protocol_writer_t writer, void *ctx);
+
+#if LIBRECIPHER_HOST
+/**
+ * CDC emulado: bytes vindos do app, lidos pelas próximas usb_protocol_task
+ * @return false se não cabem no buffer do simulador
+ */
+bool usb_protocol_sim_feed(const uint8_t *data, size_t len);
+
+/**
+ * Resposta do botão simulado às próximas confirmações (padrão: recusa)
  */
-void usb_protocol_task(void);
+void usb_protocol_sim_confirm(bool accept);
+#endif
 
 #endif // USB_PROTOCOL_H
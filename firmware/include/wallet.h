@@ -9,6 +9,38 @@
 #include <stddef.h>
 #include <stdint.h>
 
+// Latência alvo do Argon2id do PIN (calibrada em wallet_create)
+#define WALLET_PIN_KDF_TARGET_MS 500
+
+// Caminho HD CIP-1852: m/1852'/1815'/conta'/papel/índice
+#define WALLET_HD_PURPOSE 1852
+#define WALLET_HD_COIN_TYPE 1815 // ADA
+#define WALLET_HD_ROLE_EXTERNAL 0 // Endereços de recebimento
+#define WALLET_HD_ROLE_INTERNAL 1 // Troco
+#define WALLET_HD_ROLE_STAKING 2  // Chave de stake
+
+// Endereço base Cardano (CIP-19): hash da chave de pagamento .../conta'/0/0
+// e da chave de stake .../conta'/2/0. Rede 1 = mainnet ("addr"), 0 = testnet
+#define WALLET_CARDANO_NETWORK_ID 1
+#define WALLET_ADDRESS_MAX_LEN 109 // "addr_test" + 1 + 92 + 6 + NUL
+
+// Entradas do cache LRU de chaves públicas/endereços (zerado no lock)
+#ifndef WALLET_ADDRESS_CACHE_SIZE
+#define WALLET_ADDRESS_CACHE_SIZE 16
+#endif
+
+// Wallets ocultas (passphrase BIP-39) mantidas prontas na sessão, além da
+// wallet sem passphrase; cifradas em RAM e zeradas no lock. A passphrase é
+// usada byte a byte: o app a envia em UTF-8 NFKD, como o BIP-39 pede
+#ifndef WALLET_PASSPHRASE_CACHE_SIZE
+#define WALLET_PASSPHRASE_CACHE_SIZE 4
+#endif
+
+// Setores no fim da flash reservados ao armazenamento da wallet (kvstore)
+#ifndef WALLET_STORE_SECTORS
+#define WALLET_STORE_SECTORS 8
+#endif
+
 // Status da wallet
 typedef enum {
   WALLET_STATUS_UNINITIALIZED = 0,
@@ -16,11 +48,77 @@ typedef enum {
   WALLET_STATUS_UNLOCKED
 } wallet_status_t;
 
+// Contadores do cache de endereços (por consulta; zerados no init)
+typedef struct {
+  uint32_t hits;
+  uint32_t misses;
+} wallet_cache_stats_t;
+
+// Recebe cada endereço de wallet_get_addresses, em ordem de índice
+typedef void (*wallet_address_sink_t)(uint32_t address_index,
+                                      const char *address, size_t len,
+                                      void *ctx);
+
+// Backup SLIP-39: PBKDF2 da Feistel com (10000 << exp) iterações
+#define WALLET_SLIP39_ITERATION_EXP 1
+#define WALLET_SLIP39_MAX_INPUT 16 // Partes aceitas por restauração
+
+// Recebe cada parte de wallet_backup_slip39: índices das palavras na lista
+// SLIP-39 (o app soletra)
+typedef void (*wallet_share_sink_t)(uint8_t share_index, const uint16_t *words,
+                                    size_t count, void *ctx);
+
+// Backup cifrado: segredos da wallet em pedaços AES-256-GCM (STREAM, ver
+// aead_stream.h) com chave Argon2id da passphrase de backup.
+// Cabeçalho: [versão][t LE32][m LE32][lanes LE32][salt 16][prefixo 7]
+// Pedaço: [flags][índice LE16][cifrado <= WALLET_BACKUP_CHUNK][tag 16]
+#define WALLET_BACKUP_VERSION 1
+#define WALLET_BACKUP_HEADER_SIZE 36
+#define WALLET_BACKUP_CHUNK 128 // Bytes de texto por pedaço (cabe num frame)
+#define WALLET_BACKUP_CHUNK_OVERHEAD 19
+#define WALLET_BACKUP_FLAG_LAST 0x01
+#define WALLET_BACKUP_MAX_PASSPHRASE 128
+// Passadas do Argon2id aceitas num cabeçalho importado: o calibrado no
+// RP2350 fica bem abaixo; acima disso o import só prenderia o device
+#define WALLET_BACKUP_MAX_T_COST 1024
+
+// Recebe o cabeçalho e depois cada pedaço de wallet_backup_export
+typedef void (*wallet_backup_sink_t)(const uint8_t *record, size_t len,
+                                     void *ctx);
+
+// Curva de assinatura
+typedef enum {
+  WALLET_CURVE_ED25519 = 0,  // Cardano e afins
+  WALLET_CURVE_SECP256K1 = 1 // Bitcoin/Ethereum (ECDSA, r || s low-S)
+} wallet_curve_t;
+
+// Máximo de entradas por lote de assinatura
+#define WALLET_SIGN_BATCH_MAX 64
+
+// Entrada de lote de assinatura: hash de 32 bytes e conta que assina
+typedef struct {
+  uint32_t account_index;
+  uint8_t hash[32];
+} wallet_sign_request_t;
+
+// Recebe cada assinatura de wallet_sign_batch com o índice da entrada
+typedef void (*wallet_signature_sink_t)(size_t entry, const uint8_t *signature,
+                                        void *ctx);
+
 /**
  * Inicializa o módulo de wallet
+ *
+ * Monta o armazenamento na flash: com uma wallet salva, o status passa a
+ * WALLET_STATUS_LOCKED.
  */
 void wallet_init(void);
 
+/**
+ * Apaga a wallet salva na flash e volta ao estado de fábrica
+ * @return false se o erase da flash falhou
+ */
+bool wallet_wipe(void);
+
 /**
  * Retorna status atual da wallet
  */
@@ -30,9 +128,11 @@ wallet_status_t wallet_get_status(void);
  * Cria nova wallet com seed gerada internamente
  * @param pin PIN do usuário (hash)
  * @param pin_len Tamanho do PIN
+ * @param passphrase passphrase BIP-39 da sessão (NULL ou "" = nenhuma)
  * @return true se sucesso
  */
-bool wallet_create(const uint8_t *pin, size_t pin_len);
+bool wallet_create(const uint8_t *pin, size_t pin_len,
+                   const char *passphrase);
 
 /**
  * Restaura wallet de mnemonic
@@ -42,11 +142,94 @@ bool wallet_create(const uint8_t *pin, size_t pin_len);
  */
 bool wallet_restore(const char *mnemonic, const uint8_t *pin, size_t pin_len);
 
+/**
+ * Restaura wallet de partes SLIP-39 (backup de wallet_backup_slip39 ou de
+ * outra carteira com entropia BIP-39 de 16 a 32 bytes)
+ * @param shares mnemonics das partes (forma canônica)
+ * @param count 1..WALLET_SLIP39_MAX_INPUT
+ * @param passphrase passphrase do SLIP-39 (NULL para nenhuma)
+ * @return false se as partes não bastam, não conferem ou o segredo não é
+ *         entropia BIP-39
+ */
+bool wallet_restore_slip39(const char *const *shares, size_t count,
+                           const char *passphrase, const uint8_t *pin,
+                           size_t pin_len);
+
+/**
+ * Gera o backup SLIP-39 da wallet: `count` partes, `threshold` delas
+ * restauram
+ *
+ * A seed nunca sai inteira: o sink recebe uma parte por vez.
+ * @param pin PIN do usuário (conferido de novo)
+ * @param threshold 1..count (1 exige count = 1)
+ * @param count 1..16
+ * @return false se bloqueada, PIN errado, parâmetros inválidos ou falha do
+ *         RNG (o sink não é chamado)
+ */
+bool wallet_backup_slip39(const uint8_t *pin, size_t pin_len,
+                          uint8_t threshold, uint8_t count,
+                          wallet_share_sink_t sink, void *ctx);
+
+/**
+ * Exporta os segredos da wallet como backup cifrado
+ *
+ * O sink recebe o cabeçalho e depois os pedaços em ordem, o último com
+ * WALLET_BACKUP_FLAG_LAST; nenhum buffer do tamanho do backup é montado.
+ * @param pin PIN do usuário (conferido de novo)
+ * @param passphrase passphrase do backup (1..WALLET_BACKUP_MAX_PASSPHRASE)
+ * @return false se bloqueada, PIN errado, passphrase inválida ou falha do
+ *         RNG (o sink não é chamado)
+ */
+bool wallet_backup_export(const uint8_t *pin, size_t pin_len,
+                          const uint8_t *passphrase, size_t passphrase_len,
+                          wallet_backup_sink_t sink, void *ctx);
+
+/**
+ * Começa a importar um backup cifrado (só sem wallet)
+ *
+ * Deriva a chave do backup; os pedaços chegam em
+ * wallet_backup_import_chunk. Descarta uma importação em andamento.
+ * @return false se não há como ler o cabeçalho (versão, parâmetros, mais
+ *         de WALLET_BACKUP_MAX_T_COST passadas) ou já existe wallet
+ */
+bool wallet_backup_import_begin(const uint8_t *header, size_t header_len,
+                                const uint8_t *passphrase,
+                                size_t passphrase_len);
+
+/**
+ * Importa o próximo pedaço (conferido na hora)
+ * @return false se fora de ordem, grande demais ou não autêntico
+ *         (passphrase errada falha já no primeiro); a importação é
+ *         descartada
+ */
+bool wallet_backup_import_chunk(const uint8_t *record, size_t len);
+
+/**
+ * Conclui a importação: sela os segredos com o novo PIN e grava
+ * @return false se o backup não chegou inteiro (faltou o último pedaço) ou
+ *         a gravação falhou; em qualquer caso a importação termina
+ */
+bool wallet_backup_import_finish(const uint8_t *pin, size_t pin_len);
+
 /**
  * Desbloqueia wallet com PIN
- * @return true se PIN correto
+ * @param passphrase passphrase BIP-39 (NULL ou "" = nenhuma); cada
+ *        passphrase abre outra wallet, sem nada gravado sobre ela
+ * @return true se PIN correto (e a passphrase aceita; senão fica
+ *         bloqueada)
  */
-bool wallet_unlock(const uint8_t *pin, size_t pin_len);
+bool wallet_unlock(const uint8_t *pin, size_t pin_len,
+                   const char *passphrase);
+
+/**
+ * Troca a passphrase BIP-39 com a wallet desbloqueada
+ *
+ * A primeira vez de cada passphrase refaz a seed (PBKDF2); as últimas
+ * WALLET_PASSPHRASE_CACHE_SIZE voltam direto da cache, e "" sempre.
+ * @return false se bloqueada, passphrase longa demais ou wallet sem
+ *         entropia selada (só "" existe)
+ */
+bool wallet_set_passphrase(const char *passphrase);
 
 /**
  * Bloqueia wallet
@@ -56,21 +239,81 @@ void wallet_lock(void);
 /**
  * Assina transação
  * @param tx_hash Hash da transação (32 bytes)
- * @param account_index Índice da conta BIP-44
+ * @param account_index Índice da conta (Ed25519: m/1852'/1815'/conta'/0/0;
+ *        secp256k1: só 0, chave única)
+ * @param curve Curva de assinatura
  * @param signature Output (64 bytes)
- * @return true se sucesso
+ * @return true se sucesso; false se bloqueada ou conta inexistente
  */
 bool wallet_sign_transaction(const uint8_t *tx_hash, uint32_t account_index,
-                             uint8_t *signature);
+                             wallet_curve_t curve, uint8_t *signature);
 
 /**
- * Obtém endereço público
+ * Assina um lote de hashes
+ *
+ * As entradas são agrupadas por conta: cada chave é derivada e expandida
+ * uma vez por lote, mesmo com contas intercaladas. As assinaturas saem
+ * agrupadas por conta, não na ordem do lote (o sink recebe o índice).
+ * @param requests Entradas (até WALLET_SIGN_BATCH_MAX)
+ * @param count Quantidade de entradas
+ * @param curve Curva de todas as entradas
+ * @param sink Chamado uma vez por assinatura
+ * @return false se bloqueada ou lote inválido (secp256k1: alguma conta
+ *         diferente de 0, recusado sem assinar nada); se uma conta falha no
+ *         meio do lote, as assinaturas já entregues continuam válidas
+ */
+bool wallet_sign_batch(const wallet_sign_request_t *requests, size_t count,
+                       wallet_curve_t curve, wallet_signature_sink_t sink,
+                       void *ctx);
+
+/**
+ * Obtém chave pública Ed25519 de m/1852'/1815'/conta'/papel/índice
+ *
+ * Chaves já pedidas saem do cache LRU; nas demais, os nós da conta e do
+ * último papel ficam em cache até o lock e índices seguidos custam um
+ * passo de derivação.
+ * @param account_index Índice da conta (< 2^31, derivado hardened)
+ * @param role Papel (WALLET_HD_ROLE_*)
+ * @param address_index Índice do endereço (< 2^31)
+ * @param public_key Output (32 bytes)
+ * @return true se sucesso (wallet desbloqueada, índices válidos)
+ */
+bool wallet_get_public_key(uint32_t account_index, uint32_t role,
+                           uint32_t address_index, uint8_t *public_key);
+
+/**
+ * Obtém endereço público (base Cardano, bech32)
+ *
+ * Endereço e chaves ficam no cache LRU: pedidos repetidos não derivam nem
+ * codificam de novo.
  * @param account_index Índice da conta
- * @param address Output
+ * @param address Output (WALLET_ADDRESS_MAX_LEN comporta qualquer rede)
  * @param address_len Tamanho máximo
- * @return tamanho do endereço
+ * @return tamanho do endereço, 0 se bloqueada ou buffer pequeno
  */
 size_t wallet_get_address(uint32_t account_index, char *address,
                           size_t address_len);
 
+/**
+ * Obtém os endereços base Cardano de uma faixa de índices
+ *
+ * Para descoberta de contas (gap limit): cada índice custa um passo de
+ * derivação e as chaves públicas de cada lote compartilham uma inversão.
+ * Os endereços são entregues ao sink à medida que cada lote fica pronto.
+ * @param account_index Índice da conta
+ * @param role Papel (WALLET_HD_ROLE_EXTERNAL ou _INTERNAL)
+ * @param start Primeiro índice
+ * @param count Quantidade (start + count <= 2^31)
+ * @param sink Chamado uma vez por endereço
+ * @return false se bloqueada ou faixa inválida (sink não é chamado)
+ */
+bool wallet_get_addresses(uint32_t account_index, uint32_t role,
+                          uint32_t start, uint32_t count,
+                          wallet_address_sink_t sink, void *ctx);
+
+/**
+ * Lê os contadores de acerto/falta do cache de endereços
+ */
+void wallet_get_cache_stats(wallet_cache_stats_t *stats);
+
 #endif // WALLET_H
@@ -0,0 +1,46 @@
+/**
+ * Índice compacto de lista de palavras (BIP-39, SLIP-39)
+ *
+ * Tabelas geradas no build (tools/gen_bip39_index.py): entradas em ordem
+ * alfabética agrupadas pela primeira letra, busca binária direto na flash.
+ * Exige palavras de 3 a 8 letras, únicas nas 4 primeiras.
+ */
+
+#ifndef WORDLIST_H
+#define WORDLIST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define WORDLIST_MAX_WORD_LEN 8
+
+typedef struct {
+  const uint16_t *letter_start; // 27 posições: início de cada letra + fim
+  const uint32_t *entries;
+  const char *suffixes;
+  uint16_t count;
+} wordlist_t;
+
+/**
+ * Palavras que começam com um prefixo
+ * @param len tamanho (1..8)
+ * @param first índice da primeira palavra (válido se retorno > 0)
+ * @return quantidade de palavras (0 ou 1 com 4 letras ou mais)
+ */
+size_t wordlist_prefix_range(const wordlist_t *list, const char *prefix,
+                             size_t len, uint16_t *first);
+
+/**
+ * Índice de uma palavra completa
+ * @return índice, ou -1 se não está na lista
+ */
+int wordlist_index(const wordlist_t *list, const char *word, size_t len);
+
+/**
+ * Soletra a palavra de um índice
+ * @param word output (WORDLIST_MAX_WORD_LEN + 1 bytes, com terminador)
+ * @return tamanho da palavra, 0 se índice inválido
+ */
+size_t wordlist_word(const wordlist_t *list, uint16_t index, char *word);
+
+#endif // WORDLIST_H
@@ -0,0 +1,1386 @@
+/**
+ * Benchmarks no device - Implementação
+ *
+ * Cada seção mede uma primitiva no core real com time_us_64 e imprime uma
+ * linha por configuração.
+ */
+
+#include "bench.h"
+#include "aead_stream.h"
+#include "aes_gcm.h"
+#include "argon2.h"
+#include "bip32_ed25519.h"
+#include "bip39.h"
+#include "drbg.h"
+#include "ed25519.h"
+#include "encoding.h"
+#include "gf256.h"
+#include "kvstore.h"
+#include "librecipher.h"
+#include "pbkdf2.h"
+#include "pico/stdlib.h"
+#include "secp256k1.h"
+#include "sha512.h"
+#include "slip39.h"
+#include "usb_protocol.h"
+#include "wallet.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============ Argon2id (PIN) ============
+
+static void bench_argon2(void) {
+  static const uint8_t pin[] = "123456";
+  static const uint8_t salt[32] = {0};
+  uint8_t out[32];
+
+  printf("[bench] Argon2id (arena %u KiB)\n", ARGON2_MAX_MEMORY_KIB);
+
+  // Custo por bloco e por passada em cada tamanho de memória
+  for (uint32_t m = ARGON2_MIN_MEMORY_KIB; m <= ARGON2_MAX_MEMORY_KIB;
+       m *= 2) {
+    argon2_params_t params = {1, m, 1};
+    uint64_t start = time_us_64();
+    argon2id_hash(&params, pin, sizeof(pin) - 1, salt, sizeof(salt), out,
+                  sizeof(out));
+    uint64_t one = time_us_64() - start;
+
+    params.t_cost = 2;
+    start = time_us_64();
+    argon2id_hash(&params, pin, sizeof(pin) - 1, salt, sizeof(salt), out,
+                  sizeof(out));
+    uint64_t two = time_us_64() - start;
+
+    printf("[bench]   m=%3lu KiB: t=1 %7llu us, passada %7llu us\n",
+           (unsigned long)m, (unsigned long long)one,
+           (unsigned long long)(two > one ? two - one : 0));
+  }
+
+  // Calibração para o alvo do PIN e latência real resultante
+  argon2_params_t params;
+  uint64_t start = time_us_64();
+  argon2id_calibrate(&params, WALLET_PIN_KDF_TARGET_MS, time_us_64);
+  uint64_t calibration = time_us_64() - start;
+
+  start = time_us_64();
+  argon2id_hash(&params, pin, sizeof(pin) - 1, salt, sizeof(salt), out,
+                sizeof(out));
+  uint64_t unlock = time_us_64() - start;
+
+  printf("[bench]   alvo %u ms: t=%lu m=%lu p=%lu, unlock %llu ms "
+         "(calibração %llu ms)\n",
+         WALLET_PIN_KDF_TARGET_MS, (unsigned long)params.t_cost,
+         (unsigned long)params.m_cost_kib, (unsigned long)params.lanes,
+         (unsigned long long)(unlock / 1000),
+         (unsigned long long)(calibration / 1000));
+}
+
+// ============ PBKDF2-HMAC-SHA512 (BIP-39) ============
+
+// HMAC-SHA512 completo, chave reprocessada a cada chamada
+static void naive_hmac_sha512(const uint8_t *key, size_t key_len,
+                              const uint8_t *data, size_t data_len,
+                              uint8_t mac[64]) {
+  uint8_t pad[SHA512_BLOCK_SIZE];
+  uint8_t inner[SHA512_DIGEST_SIZE];
+  sha512_ctx_t ctx;
+
+  memset(pad, 0, sizeof(pad));
+  memcpy(pad, key, key_len); // key_len <= 128 aqui
+  for (size_t i = 0; i < sizeof(pad); i++)
+    pad[i] ^= 0x36;
+  sha512_init(&ctx);
+  sha512_update(&ctx, pad, sizeof(pad));
+  sha512_update(&ctx, data, data_len);
+  sha512_final(&ctx, inner);
+
+  for (size_t i = 0; i < sizeof(pad); i++)
+    pad[i] ^= 0x36 ^ 0x5c;
+  sha512_init(&ctx);
+  sha512_update(&ctx, pad, sizeof(pad));
+  sha512_update(&ctx, inner, sizeof(inner));
+  sha512_final(&ctx, mac);
+}
+
+// PBKDF2 de referência: um HMAC completo por iteração (um bloco de saída)
+static void naive_pbkdf2(const uint8_t *password, size_t password_len,
+                         const uint8_t *salt, size_t salt_len,
+                         uint32_t iterations, uint8_t out[64]) {
+  uint8_t block[128];
+  uint8_t u[64];
+
+  memcpy(block, salt, salt_len);
+  block[salt_len] = 0;
+  block[salt_len + 1] = 0;
+  block[salt_len + 2] = 0;
+  block[salt_len + 3] = 1;
+  naive_hmac_sha512(password, password_len, block, salt_len + 4, u);
+  memcpy(out, u, sizeof(u));
+
+  for (uint32_t j = 1; j < iterations; j++) {
+    naive_hmac_sha512(password, password_len, u, sizeof(u), u);
+    for (int i = 0; i < 64; i++)
+      out[i] ^= u[i];
+  }
+}
+
+static void bench_pbkdf2(void) {
+  static const char mnemonic[] =
+      "abandon abandon abandon abandon abandon abandon abandon abandon "
+      "abandon abandon abandon about";
+  static const uint8_t salt[] = "mnemonic";
+  uint8_t fast[64];
+  uint8_t naive[64];
+
+  printf("[bench] PBKDF2-HMAC-SHA512 (%u iterações)\n", BIP39_ITERATIONS);
+
+  uint64_t start = time_us_64();
+  bip39_mnemonic_to_seed(mnemonic, NULL, fast);
+  uint64_t fast_us = time_us_64() - start;
+
+  start = time_us_64();
+  naive_pbkdf2((const uint8_t *)mnemonic, sizeof(mnemonic) - 1, salt,
+               sizeof(salt) - 1, BIP39_ITERATIONS, naive);
+  uint64_t naive_us = time_us_64() - start;
+
+  printf("[bench]   midstates %llu us, ingênuo %llu us, %s\n",
+         (unsigned long long)fast_us, (unsigned long long)naive_us,
+         memcmp(fast, naive, sizeof(fast)) == 0 ? "iguais" : "DIFERENTES");
+}
+
+// ============ Lista BIP-39 ============
+
+static void bench_bip39(void) {
+  // Referência: lista plana varrida com strcmp (na RAM, o que ainda
+  // favorece a varredura frente à flash XIP)
+  static char flat[BIP39_WORD_COUNT][BIP39_MAX_WORD_LEN + 1];
+  for (uint16_t i = 0; i < BIP39_WORD_COUNT; i++) {
+    bip39_word(i, flat[i]);
+  }
+
+  printf("[bench] Lista BIP-39: índice %u bytes na flash\n",
+         (unsigned)bip39_index_size());
+
+  uint32_t errors = 0;
+  uint64_t start = time_us_64();
+  for (uint16_t i = 0; i < BIP39_WORD_COUNT; i++) {
+    errors += bip39_word_index(flat[i], strlen(flat[i])) != i;
+  }
+  uint64_t index_us = time_us_64() - start;
+
+  start = time_us_64();
+  for (uint16_t i = 0; i < BIP39_WORD_COUNT; i++) {
+    int found = -1;
+    for (int j = 0; j < BIP39_WORD_COUNT && found < 0; j++) {
+      if (strcmp(flat[i], flat[j]) == 0)
+        found = j;
+    }
+    errors += found != i;
+  }
+  uint64_t scan_us = time_us_64() - start;
+
+  static const char mnemonic[] =
+      "legal winner thank year wave sausage worth useful legal winner "
+      "thank yellow";
+  start = time_us_64();
+  bool valid = bip39_mnemonic_check(mnemonic);
+  uint64_t check_us = time_us_64() - start;
+
+  printf("[bench]   %u buscas: índice %llu us, strcmp linear %llu us, "
+         "erros %lu\n",
+         BIP39_WORD_COUNT, (unsigned long long)index_us,
+         (unsigned long long)scan_us, (unsigned long)errors);
+  printf("[bench]   validar 12 palavras: %llu us (%s)\n",
+         (unsigned long long)check_us, valid ? "ok" : "FALHOU");
+}
+
+// ============ SLIP-39 ============
+
+#define BENCH_GF_REPS 200
+
+// Comparação de tempo: tabelas log/antilog (gerador 3), índices dependem
+// dos dados
+static uint8_t gf_exp[510];
+static uint8_t gf_log[256];
+
+static void naive_gf_init(void) {
+  uint8_t x = 1;
+  for (int i = 0; i < 255; i++) {
+    gf_exp[i] = gf_exp[i + 255] = x;
+    gf_log[x] = (uint8_t)i;
+    x ^= (uint8_t)((x << 1) ^ ((x & 0x80) ? 0x1B : 0)); // x * 3
+  }
+}
+
+static uint8_t naive_gf_mul(uint8_t a, uint8_t b) {
+  if (a == 0 || b == 0)
+    return 0;
+  return gf_exp[gf_log[a] + gf_log[b]];
+}
+
+static void naive_interpolate(const uint8_t *xs, uint8_t ys[][32],
+                              size_t count, uint8_t x, uint8_t out[32]) {
+  memset(out, 0, 32);
+  for (size_t j = 0; j < count; j++) {
+    uint8_t num = 1, den = 1;
+    for (size_t m = 0; m < count; m++) {
+      if (m != j) {
+        num = naive_gf_mul(num, x ^ xs[m]);
+        den = naive_gf_mul(den, xs[j] ^ xs[m]);
+      }
+    }
+    uint8_t c = naive_gf_mul(num, gf_exp[255 - gf_log[den]]);
+    for (int k = 0; k < 32; k++) {
+      out[k] ^= naive_gf_mul(c, ys[j][k]);
+    }
+  }
+}
+
+typedef struct {
+  slip39_share_t shares[SLIP39_MAX_SHARES];
+  size_t count;
+} bench_shares_t;
+
+static void collect_share(const slip39_share_t *share, void *ctx) {
+  bench_shares_t *out = ctx;
+  out->shares[out->count++] = *share;
+}
+
+// Corretude (vetores da spec, referência do GF, ida e volta) em
+// host/tests/test_slip39.c; aqui só os tempos
+static void bench_slip39(void) {
+  static bench_shares_t set;
+  uint8_t secret[SLIP39_MAX_SECRET];
+  size_t secret_len = 0;
+
+  printf("[bench] SLIP-39: índice %u bytes na flash\n",
+         (unsigned)slip39_index_size());
+
+  // Kernel: 16 pontos de 32 bytes, bitsliced vs tabelas
+  static uint8_t ys[GF256_MAX_POINTS][32];
+  static gf256_vector_t sliced[GF256_MAX_POINTS];
+  uint8_t xs[GF256_MAX_POINTS];
+  uint8_t fast[32], naive[32];
+  gf256_vector_t v;
+
+  naive_gf_init();
+  for (int j = 0; j < GF256_MAX_POINTS; j++) {
+    xs[j] = (uint8_t)j;
+    librecipher_random(ys[j], 32);
+    gf256_vector_load(&sliced[j], ys[j], 32);
+  }
+
+  uint64_t start = time_us_64();
+  for (int r = 0; r < BENCH_GF_REPS; r++) {
+    gf256_interpolate(xs, sliced, GF256_MAX_POINTS, (uint8_t)(200 + r % 50),
+                      &v);
+  }
+  uint64_t sliced_us = time_us_64() - start;
+  gf256_vector_store(&v, fast, 32);
+
+  start = time_us_64();
+  for (int r = 0; r < BENCH_GF_REPS; r++) {
+    naive_interpolate(xs, ys, GF256_MAX_POINTS, (uint8_t)(200 + r % 50),
+                      naive);
+  }
+  uint64_t naive_us = time_us_64() - start;
+
+  printf("[bench]   interpolação 16 x 32 bytes: bitsliced %llu us, "
+         "tabelas %llu us\n",
+         (unsigned long long)(sliced_us / BENCH_GF_REPS),
+         (unsigned long long)(naive_us / BENCH_GF_REPS));
+
+  // Tempo independe dos dados: valores zero contra aleatórios
+  memset(sliced, 0, sizeof(sliced));
+  start = time_us_64();
+  for (int r = 0; r < BENCH_GF_REPS; r++) {
+    gf256_interpolate(xs, sliced, GF256_MAX_POINTS, (uint8_t)(200 + r % 50),
+                      &v);
+  }
+  uint64_t zero_us = time_us_64() - start;
+  printf("[bench]   bitsliced com valores zero: %llu us\n",
+         (unsigned long long)(zero_us / BENCH_GF_REPS));
+
+  // Ciclo completo, 32 bytes, 8 de 16, expoente 0 (Feistel domina)
+  uint8_t master[32];
+  librecipher_random(master, sizeof(master));
+  set.count = 0;
+  start = time_us_64();
+  bool ok = slip39_split(master, sizeof(master), "", 0, 8, 16, collect_share,
+                         &set);
+  uint64_t split_us = time_us_64() - start;
+
+  start = time_us_64();
+  ok = ok && slip39_combine(&set.shares[5], 8, "", secret, &secret_len);
+  uint64_t combine_us = time_us_64() - start;
+
+  printf("[bench]   8 de 16 partes (32 bytes): dividir %llu us, "
+         "recuperar %llu us%s\n",
+         (unsigned long long)split_us, (unsigned long long)combine_us,
+         ok ? "" : " (FALHOU)");
+
+  librecipher_secure_zero(&set, sizeof(set));
+  librecipher_secure_zero(master, sizeof(master));
+  librecipher_secure_zero(secret, sizeof(secret));
+}
+
+// ============ BIP32-Ed25519 (CIP-1852) ============
+
+#define BENCH_HD_ADDRESSES 20
+
+// Caminho completo m/1852'/1815'/0'/0/index a partir da raiz
+static void hd_full_path(const bip32_ed25519_node_t *root, uint32_t index,
+                         uint8_t public_key[32]) {
+  bip32_ed25519_node_t a, b;
+
+  bip32_ed25519_derive_child(root, WALLET_HD_PURPOSE | BIP32_HARDENED, &a);
+  bip32_ed25519_derive_child(&a, WALLET_HD_COIN_TYPE | BIP32_HARDENED, &b);
+  bip32_ed25519_derive_child(&b, 0 | BIP32_HARDENED, &a);
+  bip32_ed25519_node_public(&a);
+  bip32_ed25519_derive_child(&a, WALLET_HD_ROLE_EXTERNAL, &b);
+  bip32_ed25519_node_public(&b);
+  bip32_ed25519_derive_child(&b, index, &a);
+  bip32_ed25519_node_public(&a);
+  memcpy(public_key, a.public_key, 32);
+}
+
+static void bench_hd(void) {
+  static const uint8_t entropy[16] = {0x46, 0xe6, 0x23, 0x70};
+  bip32_ed25519_node_t root, account, role, leaf;
+  uint8_t full[32];
+  uint32_t errors = 0;
+
+  printf("[bench] BIP32-Ed25519: %u endereços m/1852'/1815'/0'/0/i\n",
+         BENCH_HD_ADDRESSES);
+
+  uint64_t start = time_us_64();
+  bip32_ed25519_master_icarus(&root, entropy, sizeof(entropy), NULL, 0);
+  uint64_t root_us = time_us_64() - start;
+
+  start = time_us_64();
+  for (uint32_t i = 0; i < BENCH_HD_ADDRESSES; i++) {
+    hd_full_path(&root, i, full);
+  }
+  uint64_t full_us = time_us_64() - start;
+
+  // Nós da conta e do papel memorizados: um passo por endereço
+  bip32_ed25519_derive_child(&root, WALLET_HD_PURPOSE | BIP32_HARDENED, &leaf);
+  bip32_ed25519_derive_child(&leaf, WALLET_HD_COIN_TYPE | BIP32_HARDENED,
+                             &role);
+  bip32_ed25519_derive_child(&role, 0 | BIP32_HARDENED, &account);
+  bip32_ed25519_node_public(&account);
+  bip32_ed25519_derive_child(&account, WALLET_HD_ROLE_EXTERNAL, &role);
+  bip32_ed25519_node_public(&role);
+
+  start = time_us_64();
+  for (uint32_t i = 0; i < BENCH_HD_ADDRESSES; i++) {
+    bip32_ed25519_derive_child(&role, i, &leaf);
+    bip32_ed25519_node_public(&leaf);
+  }
+  uint64_t cached_us = time_us_64() - start;
+
+  // Última folha confere com o caminho completo
+  errors += memcmp(full, leaf.public_key, 32) != 0;
+
+  printf("[bench]   raiz Icarus %llu us\n", (unsigned long long)root_us);
+  printf("[bench]   por endereço: caminho completo %llu us, com cache "
+         "%llu us, erros %lu\n",
+         (unsigned long long)(full_us / BENCH_HD_ADDRESSES),
+         (unsigned long long)(cached_us / BENCH_HD_ADDRESSES),
+         (unsigned long)errors);
+}
+
+// ============ X25519 (handshake de sessão) ============
+
+#define BENCH_X25519_HANDSHAKES 8
+
+// Um lado do InitSession: par efêmero e segredo com a chave do app
+static void bench_x25519(void) {
+  uint8_t app_secret[32], app_public[32];
+  uint8_t secret[32], public_key[32], shared[32], app_shared[32];
+  uint32_t errors = 0;
+
+  printf("[bench] X25519: %u handshakes (par efêmero + DH)\n",
+         BENCH_X25519_HANDSHAKES);
+
+  memset(app_secret, 0xA7, sizeof(app_secret));
+  x25519_base(app_public, app_secret);
+
+  uint64_t keygen_us = 0, dh_us = 0;
+  for (uint32_t i = 0; i < BENCH_X25519_HANDSHAKES; i++) {
+    memset(secret, (int)(i + 1), sizeof(secret));
+
+    uint64_t start = time_us_64();
+    x25519_base(public_key, secret);
+    keygen_us += time_us_64() - start;
+
+    start = time_us_64();
+    errors += !librecipher_x25519(shared, secret, app_public);
+    dh_us += time_us_64() - start;
+
+    // O app chega ao mesmo segredo
+    librecipher_x25519(app_shared, app_secret, public_key);
+    errors += memcmp(shared, app_shared, sizeof(shared)) != 0;
+  }
+
+  printf("[bench]   por handshake %llu us (par %llu us, DH %llu us), "
+         "erros %lu\n",
+         (unsigned long long)((keygen_us + dh_us) / BENCH_X25519_HANDSHAKES),
+         (unsigned long long)(keygen_us / BENCH_X25519_HANDSHAKES),
+         (unsigned long long)(dh_us / BENCH_X25519_HANDSHAKES),
+         (unsigned long)errors);
+
+  librecipher_secure_zero(secret, sizeof(secret));
+  librecipher_secure_zero(shared, sizeof(shared));
+  librecipher_secure_zero(app_shared, sizeof(app_shared));
+}
+
+// ============ secp256k1 (ECDSA) ============
+
+#define BENCH_K1_ROUNDS 8
+
+static void bench_secp256k1(void) {
+  uint8_t secret[32], public_key[33], naive_key[33];
+  uint8_t hash[32], signature[64];
+  uint64_t gen_us = 0, gen_naive_us = 0, sign_us = 0;
+  uint64_t verify_us = 0, verify_naive_us = 0;
+  uint32_t errors = 0;
+
+  printf("[bench] secp256k1: tabela + GLV vs double-and-add, %u chaves\n",
+         BENCH_K1_ROUNDS);
+
+  for (uint32_t i = 0; i < BENCH_K1_ROUNDS; i++) {
+    memset(secret, (int)(0x31 + i), sizeof(secret));
+    memset(hash, (int)(0xC0 + i), sizeof(hash));
+
+    uint64_t start = time_us_64();
+    errors += !secp256k1_get_public_key(public_key, secret);
+    gen_us += time_us_64() - start;
+
+    start = time_us_64();
+    errors += !secp256k1_get_public_key_naive(naive_key, secret);
+    gen_naive_us += time_us_64() - start;
+    errors += memcmp(public_key, naive_key, sizeof(public_key)) != 0;
+
+    start = time_us_64();
+    errors += !secp256k1_sign(signature, hash, secret);
+    sign_us += time_us_64() - start;
+
+    start = time_us_64();
+    errors += !secp256k1_verify(signature, hash, public_key, 33);
+    verify_us += time_us_64() - start;
+
+    start = time_us_64();
+    errors += !secp256k1_verify_naive(signature, hash, public_key, 33);
+    verify_naive_us += time_us_64() - start;
+  }
+
+  printf("[bench]   k*G %llu us (double-and-add %llu us), assinatura "
+         "%llu us\n",
+         (unsigned long long)(gen_us / BENCH_K1_ROUNDS),
+         (unsigned long long)(gen_naive_us / BENCH_K1_ROUNDS),
+         (unsigned long long)(sign_us / BENCH_K1_ROUNDS));
+  printf("[bench]   verificação %llu us (double-and-add %llu us), "
+         "erros %lu\n",
+         (unsigned long long)(verify_us / BENCH_K1_ROUNDS),
+         (unsigned long long)(verify_naive_us / BENCH_K1_ROUNDS),
+         (unsigned long)errors);
+
+  librecipher_secure_zero(secret, sizeof(secret));
+}
+
+// ============ RNG (DRBG vs fonte bruta) ============
+
+#define BENCH_RNG_SOURCE_BYTES 1024
+#define BENCH_RNG_BYTES (64 * 1024)
+
+static uint64_t bench_kib_per_s(uint64_t bytes, uint64_t us) {
+  return us == 0 ? 0 : bytes * 1000000ull / 1024 / us;
+}
+
+// Antes: cada byte vindo direto do ROSC pelo condicionador. Depois: o
+// HMAC-DRBG, só re-semeado pelo ROSC
+static void bench_rng(void) {
+  static uint8_t buf[4096];
+  drbg_ctx_t drbg;
+  uint32_t errors = 0;
+
+  printf("[bench] RNG: KB/s da fonte de entropia vs HMAC-DRBG\n");
+
+  uint64_t start = time_us_64();
+  for (uint32_t done = 0; done < BENCH_RNG_SOURCE_BYTES; done += 32)
+    errors += !entropy_default_source(buf, 32, NULL);
+  uint64_t source_us = time_us_64() - start;
+
+  errors += !drbg_init(&drbg, entropy_default_source, NULL, NULL, 0);
+
+  start = time_us_64();
+  for (uint32_t done = 0; done < BENCH_RNG_BYTES; done += 32)
+    errors += !drbg_generate(&drbg, buf, 32);
+  uint64_t drbg_small_us = time_us_64() - start;
+
+  start = time_us_64();
+  for (uint32_t done = 0; done < BENCH_RNG_BYTES; done += sizeof(buf))
+    errors += !drbg_generate(&drbg, buf, sizeof(buf));
+  uint64_t drbg_large_us = time_us_64() - start;
+
+  start = time_us_64();
+  for (uint32_t done = 0; done < BENCH_RNG_BYTES; done += 32)
+    errors += !librecipher_random(buf, 32);
+  uint64_t random_us = time_us_64() - start;
+
+  printf("[bench]   fonte bruta %llu KB/s, erros %lu\n",
+         (unsigned long long)bench_kib_per_s(BENCH_RNG_SOURCE_BYTES,
+                                             source_us),
+         (unsigned long)errors);
+  printf("[bench]   drbg_generate 32 B %llu KB/s, 4 KB %llu KB/s, "
+         "librecipher_random 32 B %llu KB/s\n",
+         (unsigned long long)bench_kib_per_s(BENCH_RNG_BYTES, drbg_small_us),
+         (unsigned long long)bench_kib_per_s(BENCH_RNG_BYTES, drbg_large_us),
+         (unsigned long long)bench_kib_per_s(BENCH_RNG_BYTES, random_us));
+
+  drbg_clear(&drbg);
+  librecipher_secure_zero(buf, sizeof(buf));
+}
+
+// ============ HKDF com vários rótulos ============
+
+#define BENCH_KDF_ROUNDS 100
+
+static void bench_kdf(void) {
+  static const uint8_t secret[32] = {0x0b};
+  static const char *const infos[8] = {
+      "storage-key", "storage-mac", "session-tx", "session-rx",
+      "pin-verify",  "backup-key",  "usb-auth",   "flash-index"};
+  uint8_t separate[8][32];
+  uint8_t multi[8][32];
+  librecipher_kdf_label_t labels[8];
+
+  printf("[bench] HKDF-SHA256: um Extract por rótulo vs um Extract total\n");
+
+  for (size_t count = 4; count <= 8; count += 4) {
+    for (size_t i = 0; i < count; i++) {
+      labels[i].info = (const uint8_t *)infos[i];
+      labels[i].info_len = strlen(infos[i]);
+      labels[i].output = multi[i];
+      labels[i].output_len = sizeof(multi[i]);
+    }
+
+    uint64_t start = time_us_64();
+    for (int r = 0; r < BENCH_KDF_ROUNDS; r++) {
+      for (size_t i = 0; i < count; i++) {
+        librecipher_kdf(secret, sizeof(secret), NULL, 0, labels[i].info,
+                        labels[i].info_len, separate[i], 32);
+      }
+    }
+    uint64_t separate_us = time_us_64() - start;
+
+    start = time_us_64();
+    for (int r = 0; r < BENCH_KDF_ROUNDS; r++) {
+      librecipher_kdf_multi(secret, sizeof(secret), NULL, 0, labels, count);
+    }
+    uint64_t multi_us = time_us_64() - start;
+
+    printf("[bench]   %u chaves: separado %llu us, multi %llu us, %s\n",
+           (unsigned)count,
+           (unsigned long long)(separate_us / BENCH_KDF_ROUNDS),
+           (unsigned long long)(multi_us / BENCH_KDF_ROUNDS),
+           memcmp(separate, multi, count * 32) == 0 ? "iguais"
+                                                    : "DIFERENTES");
+  }
+}
+
+// ============ Codificação de endereços ============
+
+#define BENCH_ENCODE_ROUNDS 200
+
+// base58 de livro: divide o número inteiro por 58 a cada dígito
+static size_t naive_base58(char *out, const uint8_t *data, size_t len) {
+  static const char alphabet[] =
+      "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+  uint8_t num[BASE58_MAX_INPUT];
+  uint8_t digits[BASE58_MAX_INPUT * 138 / 100 + 1];
+  size_t zeros = 0, n = 0, start = 0;
+
+  memcpy(num, data, len);
+  while (zeros < len && data[zeros] == 0)
+    zeros++;
+  start = zeros;
+  while (start < len) {
+    uint32_t rem = 0;
+    for (size_t i = start; i < len; i++) {
+      uint32_t v = (rem << 8) | num[i];
+      num[i] = (uint8_t)(v / 58);
+      rem = v % 58;
+    }
+    digits[n++] = (uint8_t)rem;
+    while (start < len && num[start] == 0)
+      start++;
+  }
+
+  memset(out, '1', zeros);
+  for (size_t i = 0; i < n; i++)
+    out[zeros + i] = alphabet[digits[n - 1 - i]];
+  out[zeros + n] = '\0';
+  return zeros + n;
+}
+
+// bech32 de referência (BIP-173): grupos de 5 bits num buffer, polymod
+// com cinco testes de bit por valor
+static void naive_bech32(char *out, const char *hrp, const uint8_t *data,
+                         size_t len) {
+  static const char charset[] = "qpzry9x8gf2tvdw0s3jn54khce6mua7l";
+  static const uint32_t gen[5] = {0x3b6a57b2, 0x26508e6d, 0x1ea119fa,
+                                  0x3d4233dd, 0x2a1462b3};
+  uint8_t values[2 * 16 + 1 + (BASE58_MAX_INPUT * 8 + 4) / 5 + 6];
+  size_t hrp_len = strlen(hrp), n = 0;
+
+  for (size_t i = 0; i < hrp_len; i++)
+    values[n++] = (uint8_t)(hrp[i] >> 5);
+  values[n++] = 0;
+  for (size_t i = 0; i < hrp_len; i++)
+    values[n++] = (uint8_t)(hrp[i] & 31);
+  size_t data_start = n;
+  uint32_t acc = 0;
+  int bits = 0;
+  for (size_t i = 0; i < len; i++) {
+    acc = (acc << 8) | data[i];
+    bits += 8;
+    while (bits >= 5) {
+      bits -= 5;
+      values[n++] = (uint8_t)((acc >> bits) & 31);
+    }
+  }
+  if (bits > 0)
+    values[n++] = (uint8_t)((acc << (5 - bits)) & 31);
+  size_t data_end = n;
+  memset(values + n, 0, 6);
+  n += 6;
+
+  uint32_t chk = 1;
+  for (size_t i = 0; i < n; i++) {
+    uint32_t top = chk >> 25;
+    chk = ((chk & 0x1ffffff) << 5) ^ values[i];
+    for (int j = 0; j < 5; j++)
+      chk ^= ((top >> j) & 1) ? gen[j] : 0;
+  }
+  chk ^= 1;
+
+  memcpy(out, hrp, hrp_len);
+  out += hrp_len;
+  *out++ = '1';
+  for (size_t i = data_start; i < data_end; i++)
+    *out++ = charset[values[i]];
+  for (int i = 0; i < 6; i++)
+    *out++ = charset[(chk >> (5 * (5 - i))) & 31];
+  *out = '\0';
+}
+
+static void bench_encoding(void) {
+  uint8_t payload[BASE58_MAX_INPUT];
+  char fast[2 * BASE58_MAX_INPUT];
+  char naive[2 * BASE58_MAX_INPUT];
+  uint32_t errors = 0;
+
+  for (size_t i = 0; i < sizeof(payload); i++)
+    payload[i] = (uint8_t)(0x9b * i + 0x41);
+
+  printf("[bench] Codificação (%u repetições)\n", BENCH_ENCODE_ROUNDS);
+
+  for (size_t len = 32; len <= BASE58_MAX_INPUT; len += 32) {
+    uint64_t start = time_us_64();
+    for (int r = 0; r < BENCH_ENCODE_ROUNDS; r++)
+      base58_encode(fast, sizeof(fast), payload, len);
+    uint64_t fast_us = time_us_64() - start;
+
+    start = time_us_64();
+    for (int r = 0; r < BENCH_ENCODE_ROUNDS; r++)
+      naive_base58(naive, payload, len);
+    uint64_t naive_us = time_us_64() - start;
+
+    errors += strcmp(fast, naive) != 0;
+    printf("[bench]   base58 %2u bytes: raiz 58^5 %llu ns, ingênuo %llu ns\n",
+           (unsigned)len,
+           (unsigned long long)(fast_us * 1000 / BENCH_ENCODE_ROUNDS),
+           (unsigned long long)(naive_us * 1000 / BENCH_ENCODE_ROUNDS));
+  }
+
+  // Endereço Cardano base: 57 bytes de payload, 103 caracteres
+  char address[WALLET_ADDRESS_MAX_LEN];
+  char reference[WALLET_ADDRESS_MAX_LEN];
+  uint64_t start = time_us_64();
+  for (int r = 0; r < BENCH_ENCODE_ROUNDS; r++)
+    bech32_encode(address, sizeof(address), "addr", payload, 57,
+                  BECH32_ENCODING_BECH32);
+  uint64_t fast_us = time_us_64() - start;
+
+  start = time_us_64();
+  for (int r = 0; r < BENCH_ENCODE_ROUNDS; r++)
+    naive_bech32(reference, "addr", payload, 57);
+  uint64_t naive_us = time_us_64() - start;
+
+  errors += strcmp(address, reference) != 0;
+  printf("[bench]   bech32 57 bytes: tabela %llu ns, referência %llu ns, "
+         "erros %lu\n",
+         (unsigned long long)(fast_us * 1000 / BENCH_ENCODE_ROUNDS),
+         (unsigned long long)(naive_us * 1000 / BENCH_ENCODE_ROUNDS),
+         (unsigned long)errors);
+}
+
+// ============ Cache de endereços da wallet ============
+
+static void bench_address_cache(void) {
+  static const uint8_t pin[] = "123456";
+  char address[WALLET_ADDRESS_MAX_LEN];
+  wallet_cache_stats_t stats;
+
+  // Wallet de teste descartável (só em device sem wallet: o restore exige
+  // UNINITIALIZED); wallet_wipe no fim apaga o que foi gravado na flash
+  if (!wallet_restore("legal winner thank year wave sausage worth useful "
+                      "legal winner thank yellow",
+                      pin, sizeof(pin) - 1)) {
+    printf("[bench] Cache de endereços: restore FALHOU\n");
+    wallet_init();
+    return;
+  }
+
+  uint64_t start = time_us_64();
+  wallet_get_address(0, address, sizeof(address));
+  uint64_t cold_us = time_us_64() - start;
+
+  start = time_us_64();
+  for (int r = 0; r < 100; r++)
+    wallet_get_address(0, address, sizeof(address));
+  uint64_t warm_ns = (time_us_64() - start) * 10;
+
+  wallet_get_cache_stats(&stats);
+  printf("[bench] Cache de endereços (%u entradas)\n",
+         WALLET_ADDRESS_CACHE_SIZE);
+  printf("[bench]   endereço: frio %llu us, em cache %llu ns "
+         "(acertos %lu, faltas %lu)\n",
+         (unsigned long long)cold_us, (unsigned long long)warm_ns,
+         (unsigned long)stats.hits, (unsigned long)stats.misses);
+
+  wallet_wipe();
+}
+
+/**
+ * Executa todos os benchmarks
+ */
+// ============ Faixa de endereços (inversão compartilhada) ============
+
+#define BENCH_RANGE_COUNT 20
+
+static void count_address(uint32_t index, const char *address, size_t len,
+                          void *ctx) {
+  (void)index;
+  (void)address;
+  if (len > 0) {
+    (*(uint32_t *)ctx)++;
+  }
+}
+
+static void bench_address_range(void) {
+  static const uint8_t pin[] = "123456";
+  static uint8_t scalars[ED25519_BATCH_MAX][32];
+  uint8_t single[ED25519_BATCH_MAX][32];
+  uint8_t batch[ED25519_BATCH_MAX][32];
+  uint8_t public_key[ED25519_PUBLIC_KEY_SIZE];
+
+  for (int i = 0; i < ED25519_BATCH_MAX; i++) {
+    memset(scalars[i], 0x11 * (i + 1), 32);
+    scalars[i][31] &= 0x7F;
+  }
+
+  // Núcleo: N normalizações separadas contra uma inversão para N pontos
+  uint64_t start = time_us_64();
+  for (int i = 0; i < ED25519_BATCH_MAX; i++)
+    ed25519_scalar_to_public(single[i], scalars[i]);
+  uint64_t single_us = time_us_64() - start;
+
+  start = time_us_64();
+  ed25519_scalar_to_public_batch(batch, (const uint8_t(*)[32])scalars,
+                                 ED25519_BATCH_MAX);
+  uint64_t batch_us = time_us_64() - start;
+
+  printf("[bench] Chaves públicas (%d pontos)\n", ED25519_BATCH_MAX);
+  printf("[bench]   uma a uma %llu us, lote %llu us%s\n",
+         (unsigned long long)single_us, (unsigned long long)batch_us,
+         memcmp(single, batch, sizeof(batch)) == 0 ? "" : " DIVERGE");
+
+  // Descoberta de conta: faixa em um comando contra um pedido por índice
+  if (!wallet_restore("legal winner thank year wave sausage worth useful "
+                      "legal winner thank yellow",
+                      pin, sizeof(pin) - 1)) {
+    printf("[bench] Faixa de endereços: restore FALHOU\n");
+    wallet_init();
+    return;
+  }
+
+  start = time_us_64();
+  for (uint32_t i = 0; i < BENCH_RANGE_COUNT; i++)
+    wallet_get_public_key(0, WALLET_HD_ROLE_EXTERNAL, 100 + i, public_key);
+  uint64_t keys_us = time_us_64() - start;
+
+  uint32_t produced = 0;
+  start = time_us_64();
+  wallet_get_addresses(0, WALLET_HD_ROLE_EXTERNAL, 200, BENCH_RANGE_COUNT,
+                       count_address, &produced);
+  uint64_t range_us = time_us_64() - start;
+
+  printf("[bench]   %d índices: chaves uma a uma %llu us, "
+         "endereços em faixa %llu us (%lu gerados)\n",
+         BENCH_RANGE_COUNT, (unsigned long long)keys_us,
+         (unsigned long long)range_us, (unsigned long)produced);
+
+  wallet_wipe();
+}
+
+// ============ Assinatura em lote ============
+
+#define BENCH_SIGN_COUNT 32
+
+static void count_signature(size_t entry, const uint8_t *signature,
+                            void *ctx) {
+  (void)entry;
+  (void)signature;
+  (*(uint32_t *)ctx)++;
+}
+
+static void bench_sign_batch(void) {
+  static const uint8_t pin[] = "123456";
+  static wallet_sign_request_t requests[BENCH_SIGN_COUNT];
+  uint8_t signature[64];
+
+  if (!wallet_restore("legal winner thank year wave sausage worth useful "
+                      "legal winner thank yellow",
+                      pin, sizeof(pin) - 1)) {
+    printf("[bench] Lote de assinatura: restore FALHOU\n");
+    wallet_init();
+    return;
+  }
+
+  // Duas contas intercaladas, como entradas de uma transação multi-conta
+  for (int i = 0; i < BENCH_SIGN_COUNT; i++) {
+    requests[i].account_index = i & 1;
+    memset(requests[i].hash, i, sizeof(requests[i].hash));
+  }
+
+  uint64_t start = time_us_64();
+  for (int i = 0; i < BENCH_SIGN_COUNT; i++)
+    wallet_sign_transaction(requests[i].hash, requests[i].account_index,
+                            WALLET_CURVE_ED25519, signature);
+  uint64_t single_us = time_us_64() - start;
+
+  uint32_t produced = 0;
+  start = time_us_64();
+  wallet_sign_batch(requests, BENCH_SIGN_COUNT, WALLET_CURVE_ED25519,
+                    count_signature, &produced);
+  uint64_t batch_us = time_us_64() - start;
+
+  printf("[bench] Lote de assinatura (%d hashes, 2 contas intercaladas)\n",
+         BENCH_SIGN_COUNT);
+  printf("[bench]   uma a uma %llu us (%llu assin/s), lote %llu us "
+         "(%llu assin/s, %lu geradas)\n",
+         (unsigned long long)single_us,
+         (unsigned long long)(BENCH_SIGN_COUNT * 1000000ull / single_us),
+         (unsigned long long)batch_us,
+         (unsigned long long)(BENCH_SIGN_COUNT * 1000000ull / batch_us),
+         (unsigned long)produced);
+
+  wallet_wipe();
+}
+
+// ============ Backup cifrado em pedaços (STREAM) ============
+
+#define BENCH_STREAM_BYTES 16384
+#define BENCH_WIRE_SIZE 2048
+
+// Respostas do protocolo capturadas no lugar do USB
+typedef struct {
+  uint8_t bytes[BENCH_WIRE_SIZE];
+  size_t len;
+} bench_wire_t;
+
+static void capture_wire(const uint8_t *data, size_t len, void *ctx) {
+  bench_wire_t *wire = ctx;
+  if (len <= sizeof(wire->bytes) - wire->len) {
+    memcpy(wire->bytes + wire->len, data, len);
+    wire->len += len;
+  }
+}
+
+// Frame de comando como o app monta: [SOF][LEN][CMD][dados][CRC-16]
+static size_t bench_frame(uint8_t *frame, uint8_t cmd, const uint8_t *data,
+                          size_t len) {
+  uint16_t crc = 0xFFFF;
+
+  frame[0] = 0xAA;
+  frame[1] = (uint8_t)(len + 1);
+  frame[2] = cmd;
+  memcpy(&frame[3], data, len);
+  for (size_t i = 1; i < len + 3; i++) {
+    crc ^= frame[i];
+    for (int j = 0; j < 8; j++)
+      crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+  }
+  frame[3 + len] = crc & 0xFF;
+  frame[4 + len] = crc >> 8;
+  return len + 5;
+}
+
+// Envia um comando pelo protocolo; devolve o status da primeira resposta
+static uint8_t bench_command(bench_wire_t *wire, uint8_t cmd,
+                             const uint8_t *data, size_t len) {
+  static uint8_t frame[260];
+
+  wire->len = 0;
+  usb_protocol_process_frame(frame, bench_frame(frame, cmd, data, len));
+  return wire->len >= 3 ? wire->bytes[2] : 0xFF;
+}
+
+static void bench_backup_stream(void) {
+  static uint8_t data[BENCH_STREAM_BYTES];
+  static uint8_t sealed[BENCH_STREAM_BYTES];
+  static uint8_t tags[BENCH_STREAM_BYTES / WALLET_BACKUP_CHUNK][16];
+  static const uint8_t key[32] = {0x5A};
+  static const uint8_t prefix[AEAD_STREAM_PREFIX_SIZE] = {1, 2, 3};
+  const size_t chunks = BENCH_STREAM_BYTES / WALLET_BACKUP_CHUNK;
+  aead_stream_t stream;
+
+  librecipher_random(data, sizeof(data));
+
+  // Primitiva: chave expandida uma vez por stream contra um GCM completo
+  // (expansão da chave e H) por pedaço
+  uint64_t start = time_us_64();
+  aead_stream_init(&stream, key, prefix);
+  for (size_t i = 0; i < chunks; i++) {
+    size_t off = i * WALLET_BACKUP_CHUNK;
+    aead_stream_seal(&stream, data + off, WALLET_BACKUP_CHUNK,
+                     i == chunks - 1, sealed + off, tags[i]);
+  }
+  uint64_t stream_us = time_us_64() - start;
+
+  uint8_t nonce[AES_GCM_IV_SIZE] = {0};
+  uint8_t chunk[WALLET_BACKUP_CHUNK];
+  uint8_t tag[AEAD_STREAM_TAG_SIZE];
+  start = time_us_64();
+  for (size_t i = 0; i < chunks; i++) {
+    nonce[10] = (uint8_t)i;
+    aes_gcm_encrypt_full(key, nonce, data + i * WALLET_BACKUP_CHUNK,
+                         WALLET_BACKUP_CHUNK, NULL, 0, chunk, tag);
+  }
+  uint64_t full_us = time_us_64() - start;
+
+  // Leitura pedaço a pedaço, e pedaços trocados ou stream cortado
+  bool ok = true;
+  aead_stream_init(&stream, key, prefix);
+  start = time_us_64();
+  for (size_t i = 0; i < chunks && ok; i++) {
+    size_t off = i * WALLET_BACKUP_CHUNK;
+    ok = aead_stream_open(&stream, sealed + off, WALLET_BACKUP_CHUNK,
+                          i == chunks - 1, tags[i], chunk) &&
+         memcmp(chunk, data + off, WALLET_BACKUP_CHUNK) == 0;
+  }
+  uint64_t open_us = time_us_64() - start;
+  ok = ok && stream.finished;
+
+  aead_stream_init(&stream, key, prefix);
+  bool swapped = aead_stream_open(&stream, sealed + WALLET_BACKUP_CHUNK,
+                                  WALLET_BACKUP_CHUNK, false, tags[1], chunk);
+  aead_stream_init(&stream, key, prefix);
+  bool early_end =
+      aead_stream_open(&stream, sealed, WALLET_BACKUP_CHUNK, true, tags[0],
+                       chunk);
+  ok = ok && !swapped && !early_end;
+
+  printf("[bench] Backup em pedaços de %u bytes (STREAM AES-256-GCM)\n",
+         WALLET_BACKUP_CHUNK);
+  printf("[bench]   %u KB: STREAM %llu us (%llu KB/s), GCM completo por "
+         "pedaço %llu us (%llu KB/s), abrir %llu us, %s\n",
+         BENCH_STREAM_BYTES / 1024, (unsigned long long)stream_us,
+         (unsigned long long)(BENCH_STREAM_BYTES * 1000000ull / 1024 /
+                              stream_us),
+         (unsigned long long)full_us,
+         (unsigned long long)(BENCH_STREAM_BYTES * 1000000ull / 1024 /
+                              full_us),
+         (unsigned long long)open_us, ok ? "ok" : "FALHOU");
+
+  // Pelo protocolo: exportar, apagar, importar frame a frame
+  static const uint8_t pin[] = "123456";
+  static const uint8_t pass[] = "backup passphrase";
+  static bench_wire_t wire;
+  static uint8_t exported[8][WALLET_BACKUP_CHUNK_OVERHEAD +
+                             WALLET_BACKUP_CHUNK];
+  size_t exported_len[8] = {0};
+  size_t records = 0;
+  uint8_t request[200];
+  char before[WALLET_ADDRESS_MAX_LEN], after[WALLET_ADDRESS_MAX_LEN];
+
+  if (!wallet_restore("legal winner thank year wave sausage worth useful "
+                      "legal winner thank yellow",
+                      pin, sizeof(pin) - 1)) {
+    printf("[bench] Backup: restore FALHOU\n");
+    wallet_init();
+    return;
+  }
+  wallet_get_address(0, before, sizeof(before));
+  usb_protocol_set_writer(capture_wire, &wire);
+
+  request[0] = sizeof(pass) - 1;
+  memcpy(&request[1], pass, sizeof(pass) - 1);
+  memcpy(&request[sizeof(pass)], pin, sizeof(pin) - 1);
+  start = time_us_64();
+  bench_command(&wire, CMD_BACKUP_EXPORT, request,
+                sizeof(pass) + sizeof(pin) - 1);
+  uint64_t export_us = time_us_64() - start;
+
+  // [SOF][LEN][status][registro][CRC] por frame
+  size_t wire_bytes = wire.len;
+  for (size_t p = 0; p + 5 <= wire.len && records < 8;
+       p += wire.bytes[p + 1] + 4) {
+    exported_len[records] = wire.bytes[p + 1] - 1;
+    memcpy(exported[records], &wire.bytes[p + 3], exported_len[records]);
+    records++;
+  }
+
+  wallet_wipe();
+
+  // Custo acima do teto: recusado antes de qualquer derivação
+  uint8_t heavy[WALLET_BACKUP_HEADER_SIZE];
+  uint32_t heavy_t = WALLET_BACKUP_MAX_T_COST + 1;
+  memcpy(heavy, exported[0], sizeof(heavy));
+  for (int i = 0; i < 4; i++) {
+    heavy[1 + i] = (uint8_t)(heavy_t >> (8 * i));
+  }
+  bool capped = !wallet_backup_import_begin(heavy, sizeof(heavy), pass,
+                                            sizeof(pass) - 1);
+
+  request[0] = 0x00; // Início
+  request[1] = sizeof(pass) - 1;
+  memcpy(&request[2], pass, sizeof(pass) - 1);
+  memcpy(&request[1 + sizeof(pass)], exported[0], exported_len[0]);
+  start = time_us_64();
+  ok = records >= 2 &&
+       bench_command(&wire, CMD_BACKUP_IMPORT, request,
+                     1 + sizeof(pass) + exported_len[0]) == 0;
+  uint64_t begin_us = time_us_64() - start;
+
+  size_t chunk_bytes = 0;
+  start = time_us_64();
+  for (size_t r = 1; r < records && ok; r++) {
+    request[0] = 0x01; // Pedaço
+    memcpy(&request[1], exported[r], exported_len[r]);
+    ok = bench_command(&wire, CMD_BACKUP_IMPORT, request,
+                       1 + exported_len[r]) == 0;
+    chunk_bytes += exported_len[r] - WALLET_BACKUP_CHUNK_OVERHEAD;
+  }
+  uint64_t chunks_us = time_us_64() - start;
+
+  request[0] = 0x02; // Conclusão
+  memcpy(&request[1], pin, sizeof(pin) - 1);
+  start = time_us_64();
+  ok = ok && bench_command(&wire, CMD_BACKUP_IMPORT, request,
+                           sizeof(pin)) == 0;
+  uint64_t finish_us = time_us_64() - start;
+
+  usb_protocol_set_writer(NULL, NULL);
+  ok = ok && wallet_get_address(0, after, sizeof(after)) > 0 &&
+       strcmp(before, after) == 0;
+  if (!capped) {
+    printf("[bench]   importar: t acima de WALLET_BACKUP_MAX_T_COST aceito "
+           "FALHOU\n");
+  }
+  ok = ok && capped;
+
+  printf("[bench]   exportar pelo protocolo: %llu us (2 Argon2id), "
+         "%u frames, %u bytes no fio\n",
+         (unsigned long long)export_us, (unsigned)records,
+         (unsigned)wire_bytes);
+  printf("[bench]   importar: início %llu us (Argon2id), %u pedaços "
+         "%llu us (%llu KB/s), conclusão %llu us, %s\n",
+         (unsigned long long)begin_us, (unsigned)(records - 1),
+         (unsigned long long)chunks_us,
+         (unsigned long long)(chunks_us
+                                  ? chunk_bytes * 1000000ull / 1024 / chunks_us
+                                  : 0),
+         (unsigned long long)finish_us, ok ? "mesma wallet" : "FALHOU");
+
+  wallet_wipe();
+}
+
+// ============ Troca de passphrase (wallets ocultas) ============
+
+static void bench_passphrase(void) {
+  static const uint8_t pin[] = "123456";
+  char base[WALLET_ADDRESS_MAX_LEN];
+  char hidden[WALLET_ADDRESS_MAX_LEN];
+  char address[WALLET_ADDRESS_MAX_LEN];
+
+  if (!wallet_restore("legal winner thank year wave sausage worth useful "
+                      "legal winner thank yellow",
+                      pin, sizeof(pin) - 1)) {
+    printf("[bench] Troca de passphrase: restore FALHOU\n");
+    wallet_init();
+    return;
+  }
+  wallet_get_address(0, base, sizeof(base));
+
+  // Frio: seed BIP-39 e raiz Icarus refeitas; quente: só AES-GCM da cache
+  uint64_t start = time_us_64();
+  bool ok = wallet_set_passphrase("TREZOR");
+  uint64_t cold_us = time_us_64() - start;
+  wallet_get_address(0, hidden, sizeof(hidden));
+
+  start = time_us_64();
+  ok = ok && wallet_set_passphrase("");
+  uint64_t back_us = time_us_64() - start;
+  wallet_get_address(0, address, sizeof(address));
+  bool base_ok = strcmp(address, base) == 0;
+
+  start = time_us_64();
+  ok = ok && wallet_set_passphrase("TREZOR");
+  uint64_t warm_us = time_us_64() - start;
+  start = time_us_64();
+  wallet_get_address(0, address, sizeof(address));
+  uint64_t address_us = time_us_64() - start;
+  bool hidden_ok = strcmp(address, hidden) == 0 && strcmp(hidden, base) != 0;
+
+  // A cache morre no lock: o unlock com passphrase volta a ser frio
+  wallet_lock();
+  start = time_us_64();
+  ok = ok && wallet_unlock(pin, sizeof(pin) - 1, "TREZOR");
+  uint64_t unlock_us = time_us_64() - start;
+  wallet_get_address(0, address, sizeof(address));
+  hidden_ok = hidden_ok && strcmp(address, hidden) == 0;
+
+  printf("[bench] Troca de passphrase (%u na cache)\n",
+         WALLET_PASSPHRASE_CACHE_SIZE);
+  printf("[bench]   fria %llu us, de volta a \"\" %llu us, quente %llu us "
+         "(%llux)\n",
+         (unsigned long long)cold_us, (unsigned long long)back_us,
+         (unsigned long long)warm_us,
+         (unsigned long long)(warm_us ? cold_us / warm_us : 0));
+  printf("[bench]   primeiro endereço após a troca %llu us, unlock com "
+         "passphrase %llu us\n",
+         (unsigned long long)address_us, (unsigned long long)unlock_us);
+  printf("[bench]   endereços: %s\n",
+         ok && base_ok && hidden_ok ? "OK" : "DIVERGEM");
+
+  wallet_wipe();
+}
+
+// ============ Recepção USB (CDC emulado) ============
+
+#if LIBRECIPHER_HOST
+#define BENCH_USB_COMMANDS 512
+#define BENCH_USB_PINGS 1000
+
+static void count_response(const uint8_t *data, size_t len, void *ctx) {
+  (void)data;
+  (void)len;
+  (*(uint32_t *)ctx)++;
+}
+
+// Comandos pendentes respondidos, e voltas do loop principal gastas
+static uint32_t bench_usb_drain(uint32_t *responses, uint32_t expected,
+                                const uint8_t *stream, size_t len,
+                                size_t per_call) {
+  uint32_t calls = 0;
+  size_t fed = 0;
+
+  while (*responses < expected && calls < 1000000) {
+    size_t n = len - fed < per_call ? len - fed : per_call;
+    usb_protocol_sim_feed(stream + fed, n);
+    fed += n;
+    usb_protocol_task();
+    calls++;
+  }
+  return calls;
+}
+
+static void bench_usb_rx(void) {
+  static uint8_t stream[BENCH_USB_COMMANDS * 5];
+  uint8_t frame[8];
+  uint32_t responses = 0;
+  size_t len = 0;
+
+  // Ping e status alternados, frames de 5 bytes colados como no CDC
+  for (uint32_t i = 0; i < BENCH_USB_COMMANDS; i++) {
+    len += bench_frame(&stream[len], (i & 1) ? CMD_GET_STATUS : CMD_PING,
+                       frame, 0);
+  }
+  usb_protocol_set_writer(count_response, &responses);
+
+  size_t ping_len = bench_frame(frame, CMD_PING, frame, 0);
+  uint64_t start = time_us_64();
+  for (uint32_t i = 0; i < BENCH_USB_PINGS; i++) {
+    bench_usb_drain(&responses, i + 1, frame, ping_len, ping_len);
+  }
+  uint64_t ping_ns = (time_us_64() - start) * 1000 / BENCH_USB_PINGS;
+
+  // Fluxo inteiro disponível (o app manda vários comandos seguidos)
+  responses = 0;
+  start = time_us_64();
+  uint32_t batch_calls = bench_usb_drain(&responses, BENCH_USB_COMMANDS,
+                                         stream, len, len);
+  uint64_t batch_us = time_us_64() - start;
+  uint32_t batch_done = responses;
+
+  // Um byte por volta do loop, como a leitura por getchar
+  responses = 0;
+  start = time_us_64();
+  uint32_t byte_calls = bench_usb_drain(&responses, BENCH_USB_COMMANDS,
+                                        stream, len, 1);
+  uint64_t byte_us = time_us_64() - start;
+  uint32_t byte_done = responses;
+
+  usb_protocol_set_writer(NULL, NULL);
+  printf("[bench] Recepção USB (CDC emulado, %u comandos de 5 bytes)\n",
+         BENCH_USB_COMMANDS);
+  printf("[bench]   ping ida e volta: %llu ns\n",
+         (unsigned long long)ping_ns);
+  printf("[bench]   lote: %llu comandos/s em %lu voltas do loop "
+         "(%lu respostas)\n",
+         (unsigned long long)(batch_us ? batch_done * 1000000ULL / batch_us
+                                       : 0),
+         (unsigned long)batch_calls, (unsigned long)batch_done);
+  printf("[bench]   byte a byte: %llu comandos/s em %lu voltas do loop "
+         "(%lu respostas)\n",
+         (unsigned long long)(byte_us ? byte_done * 1000000ULL / byte_us : 0),
+         (unsigned long)byte_calls, (unsigned long)byte_done);
+}
+#endif
+
+// ============ Store (tempo de montagem) ============
+
+// Área de rascunho logo abaixo da carteira, formatada pelo benchmark
+#define BENCH_STORE_SECTORS 16
+#define BENCH_STORE_OFFSET                                                     \
+  (PICO_FLASH_SIZE_BYTES -                                                     \
+   (WALLET_STORE_SECTORS + BENCH_STORE_SECTORS) * FLASH_NOR_SECTOR_SIZE)
+#define BENCH_STORE_IDS 12
+#define BENCH_STORE_PUTS 256
+
+static void bench_store(void) {
+  static const uint8_t key[32] = {0x42};
+  static const uint32_t levels[] = {0, 16, 64, 128, 192, 256};
+  static kvstore_t kv;
+  uint8_t value[200];
+  uint32_t written = 0;
+
+  kv.base = BENCH_STORE_OFFSET;
+  kv.sector_count = BENCH_STORE_SECTORS;
+  memcpy(kv.key, key, sizeof(kv.key));
+  if (!kvstore_format(&kv)) {
+    printf("[bench] Store: format FALHOU\n");
+    return;
+  }
+
+  printf("[bench] Store: montagem por nível de ocupação (%u setores, "
+         "registros de %u bytes)\n",
+         BENCH_STORE_SECTORS, (unsigned)sizeof(value));
+  for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+    for (; written < levels[l]; written++) {
+      memset(value, (int)written, sizeof(value));
+      if (!kvstore_put(&kv, written % BENCH_STORE_IDS, value,
+                       sizeof(value))) {
+        printf("[bench] Store: put FALHOU\n");
+        kvstore_format(&kv);
+        return;
+      }
+    }
+
+    // Checkpoint + cauda contra a releitura do log inteiro
+    uint64_t start = time_us_64();
+    kvstore_mount(&kv, BENCH_STORE_OFFSET, BENCH_STORE_SECTORS, key);
+    uint64_t mount_us = time_us_64() - start;
+    uint32_t mount_records = kv.mount_records;
+
+    start = time_us_64();
+    kvstore_rebuild(&kv);
+    uint64_t rebuild_us = time_us_64() - start;
+
+    printf("[bench]   %3lu puts, %2lu setores em uso: checkpoint %llu us "
+           "(%lu registros), log inteiro %llu us (%lu registros)\n",
+           (unsigned long)written,
+           (unsigned long)(BENCH_STORE_SECTORS - kvstore_free_sectors(&kv)),
+           (unsigned long long)mount_us, (unsigned long)mount_records,
+           (unsigned long long)rebuild_us, (unsigned long)kv.mount_records);
+  }
+
+  // Custo de um put, GC incluído: erases no caminho do comando contra
+  // erases adiantados no tempo ocioso (um flash_nor_erase_step entre puts,
+  // como no loop principal). No host, o simulador conta as chamadas à
+  // flash e o tempo com interrupções desligadas dentro de cada put
+  for (int idle = 0; idle <= 1; idle++) {
+    uint64_t total_us = 0, worst_us = 0;
+#if LIBRECIPHER_HOST
+    flash_nor_sim_stats_t before, after, sum = {0};
+    uint64_t worst_stall = 0;
+#endif
+    for (uint32_t i = 0; i < BENCH_STORE_PUTS; i++) {
+      if (idle) {
+        flash_nor_erase_step();
+      }
+      memset(value, (int)i, sizeof(value));
+#if LIBRECIPHER_HOST
+      flash_nor_sim_get_stats(&before);
+#endif
+      uint64_t start = time_us_64();
+      kvstore_put(&kv, i % BENCH_STORE_IDS, value, sizeof(value));
+      uint64_t put_us = time_us_64() - start;
+      total_us += put_us;
+      worst_us = put_us > worst_us ? put_us : worst_us;
+#if LIBRECIPHER_HOST
+      flash_nor_sim_get_stats(&after);
+      uint64_t stall = after.stall_us - before.stall_us;
+      worst_stall = stall > worst_stall ? stall : worst_stall;
+      sum.program_ops += after.program_ops - before.program_ops;
+      sum.pages_programmed += after.pages_programmed - before.pages_programmed;
+      sum.erase_ops += after.erase_ops - before.erase_ops;
+      sum.stall_us += stall;
+#endif
+    }
+    printf("[bench]   put de %u bytes, erases %s: %llu us/put, pior %llu us\n",
+           (unsigned)sizeof(value), idle ? "no ocioso" : "no put",
+           (unsigned long long)(total_us / BENCH_STORE_PUTS),
+           (unsigned long long)worst_us);
+#if LIBRECIPHER_HOST
+    printf("[bench]     flash por put: %.2f programs, %.2f páginas, "
+           "%.3f erases, stall %llu us (pior %llu us)\n",
+           (double)sum.program_ops / BENCH_STORE_PUTS,
+           (double)sum.pages_programmed / BENCH_STORE_PUTS,
+           (double)sum.erase_ops / BENCH_STORE_PUTS,
+           (unsigned long long)(sum.stall_us / BENCH_STORE_PUTS),
+           (unsigned long long)worst_stall);
+#endif
+  }
+
+  kvstore_format(&kv);
+  kvstore_unmount(&kv);
+}
+
+void bench_run(void) {
+  printf("[bench] Início\n");
+  bench_argon2();
+  bench_pbkdf2();
+  bench_bip39();
+  bench_slip39();
+  bench_hd();
+  bench_x25519();
+  bench_secp256k1();
+  bench_rng();
+  bench_kdf();
+  bench_encoding();
+  bench_address_cache();
+  bench_address_range();
+  bench_sign_batch();
+  bench_backup_stream();
+  bench_passphrase();
+#if LIBRECIPHER_HOST
+  bench_usb_rx();
+#endif
+  bench_store();
+  printf("[bench] Fim\n");
+}
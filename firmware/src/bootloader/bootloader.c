@@ -5,7 +5,7 @@
  */
 
 #include "bootloader.h"
-#include "hardware/flash.h"
+#include "flash_nor.h"
 #include "hardware/sync.h"
 #include "hardware/watchdog.h"
 #include "pico/stdlib.h"
@@ -16,8 +16,10 @@
 
 // Flash addresses
 #define FLASH_BASE 0x10000000
-#define ROLLBACK_OFFSET 0x0F000 // 60KB - rollback counter storage
-#define ROLLBACK_ADDR (FLASH_BASE + ROLLBACK_OFFSET)
+#define ROLLBACK_OFFSET 0x0E000 // 56KB - rollback counter, two sectors
+#define ROLLBACK_SECTORS 2
+#define ROLLBACK_SLOTS (FLASH_NOR_SECTOR_SIZE / 4)
+#define ROLLBACK_SPARE_SLOTS 16 // Fewer free slots: pre-erase while idle
 
 // Recovery button (GPIO for user button if available, otherwise use timeout)
 #define RECOVERY_GPIO 14 // Placeholder - adjust for your board
@@ -29,7 +31,13 @@ void bootloader_init(void) {
   stdio_init_all();
   ws2812_init();
 
-  // Initialize recovery GPIO if available
+  bootloader_button_init();
+}
+
+/**
+ * Initialize the recovery / confirmation button
+ */
+void bootloader_button_init(void) {
   gpio_init(RECOVERY_GPIO);
   gpio_set_dir(RECOVERY_GPIO, GPIO_IN);
   gpio_pull_up(RECOVERY_GPIO);
@@ -66,6 +74,43 @@ static bool secure_compare(const uint8_t *a, const uint8_t *b, size_t len) {
   return diff == 0;
 }
 
+/**
+ * Digest the vendor signs: SHA-256 of the whole header minus the signature
+ * field, so version, size, entry point, rollback counter and flags are
+ * bound to the key along with the firmware hash
+ */
+static void compute_header_digest(const firmware_header_t *header,
+                                  uint8_t *digest) {
+  const uint8_t *h = (const uint8_t *)header;
+  size_t sig_start = offsetof(firmware_header_t, signature);
+  size_t sig_end = sig_start + sizeof(header->signature);
+  sha256_ctx_t ctx;
+
+  sha256_init(&ctx);
+  sha256_update(&ctx, h, sig_start);
+  sha256_update(&ctx, h + sig_end, sizeof(*header) - sig_end);
+  sha256_final(&ctx, digest);
+}
+
+/**
+ * Verify header signature against the baked-in vendor keys
+ *
+ * The key contexts live in flash with their multiples precomputed, so no
+ * point decompression or table building happens at boot.
+ */
+static bool verify_signature(const firmware_header_t *header) {
+  uint8_t digest[32];
+
+  compute_header_digest(header, digest);
+  for (size_t i = 0; i < bootloader_vendor_key_count; i++) {
+    if (ed25519_verify_ctx(header->signature, digest, sizeof(digest),
+                           &bootloader_vendor_keys[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /**
  * LED indicator for boot status
  */
@@ -121,17 +166,18 @@ boot_status_t bootloader_verify_firmware(void) {
     return BOOT_STATUS_INVALID_HASH;
   }
 
+  // Verify Ed25519 signature over the header; nothing in it is trusted
+  // before this, the rollback counter included
+  if (!verify_signature(&header)) {
+    return BOOT_STATUS_INVALID_SIGNATURE;
+  }
+
   // Check rollback counter
   uint32_t stored_counter = bootloader_get_rollback_counter();
   if (header.rollback_counter < stored_counter) {
     return BOOT_STATUS_ROLLBACK_DETECTED;
   }
 
-  // TODO: Verify Ed25519 signature (when implemented)
-  // if (!verify_signature(header.signature, header.hash, public_key)) {
-  //     return BOOT_STATUS_INVALID_SIGNATURE;
-  // }
-
   // Update rollback counter if needed
   if (header.rollback_counter > stored_counter) {
     bootloader_update_rollback_counter(header.rollback_counter);
@@ -197,55 +243,108 @@ void bootloader_recovery_mode(void) {
   }
 }
 
+// Highest counter of a rollback sector and its first free slot (-1 if the
+// sector is full)
+typedef struct {
+  uint32_t counter;
+  int free_slot;
+} rollback_sector_t;
+
+static uint32_t rollback_offset(int sector) {
+  return ROLLBACK_OFFSET + (uint32_t)sector * FLASH_NOR_SECTOR_SIZE;
+}
+
+static void scan_rollback_sector(int sector, rollback_sector_t *out) {
+  uint32_t chunk[64];
+
+  out->counter = 0;
+  out->free_slot = -1;
+  for (int i = 0; i < ROLLBACK_SLOTS; i += 64) {
+    flash_nor_read(rollback_offset(sector) + i * 4, chunk, sizeof(chunk));
+    for (int j = 0; j < 64; j++) {
+      uint32_t val = chunk[j];
+      if (val == 0xFFFFFFFF) {
+        if (out->free_slot < 0) {
+          out->free_slot = i + j;
+        }
+      } else if (val > out->counter) {
+        out->counter = val;
+      }
+    }
+  }
+}
+
+/**
+ * Scan both rollback sectors
+ *
+ * The active sector holds the highest counter and takes the next update;
+ * on a tie (the other sector was never erased after a switch) the one with
+ * room left. The other sector only holds older values.
+ * @return active sector
+ */
+static int scan_rollback(rollback_sector_t sectors[ROLLBACK_SECTORS]) {
+  scan_rollback_sector(0, &sectors[0]);
+  scan_rollback_sector(1, &sectors[1]);
+  return sectors[1].counter > sectors[0].counter ||
+         (sectors[1].counter == sectors[0].counter &&
+          sectors[0].free_slot < 0);
+}
+
 /**
  * Get rollback counter from flash
  */
 uint32_t bootloader_get_rollback_counter(void) {
-  const uint32_t *counter_ptr = (const uint32_t *)ROLLBACK_ADDR;
-
-  // Find the highest valid counter value
-  // Using wear-leveling scheme: scan sector for highest counter
-  uint32_t max_counter = 0;
-  for (int i = 0; i < 1024; i++) { // 4KB sector / 4 bytes = 1024 entries
-    uint32_t val = counter_ptr[i];
-    if (val != 0xFFFFFFFF && val > max_counter) {
-      max_counter = val;
-    }
-  }
-
-  return max_counter;
+  // Wear-leveling scheme: one slot per update, highest counter wins
+  rollback_sector_t sectors[ROLLBACK_SECTORS];
+  return sectors[scan_rollback(sectors)].counter;
 }
 
 /**
  * Update rollback counter
+ *
+ * When the active sector is full the counter goes to slot 0 of the other
+ * one, erased first if the idle pre-erase did not get to it. The full
+ * sector is only erased later, once the new one holds the counter, so a
+ * power loss never leaves flash without it.
  */
 bool bootloader_update_rollback_counter(uint32_t new_counter) {
-  // Find next free slot in sector
-  const uint32_t *counter_ptr = (const uint32_t *)ROLLBACK_ADDR;
-  int free_slot = -1;
-
-  for (int i = 0; i < 1024; i++) {
-    if (counter_ptr[i] == 0xFFFFFFFF) {
-      free_slot = i;
-      break;
+  rollback_sector_t sectors[ROLLBACK_SECTORS];
+  int active = scan_rollback(sectors);
+  int slot = sectors[active].free_slot;
+
+  if (slot < 0) {
+    active ^= 1;
+    slot = 0;
+    uint32_t offset = rollback_offset(active);
+    if ((flash_nor_erase_pending(offset) ||
+         !flash_nor_is_erased(offset, FLASH_NOR_SECTOR_SIZE)) &&
+        !flash_nor_erase(offset, FLASH_NOR_SECTOR_SIZE)) {
+      return false;
     }
   }
 
-  // If sector is full, erase and start fresh
-  if (free_slot < 0) {
-    uint32_t ints = save_and_disable_interrupts();
-    flash_range_erase(ROLLBACK_OFFSET, FLASH_SECTOR_SIZE);
-    restore_interrupts(ints);
-    free_slot = 0;
-  }
+  // Write new counter value; it must be in flash before the firmware runs
+  return flash_nor_program(rollback_offset(active) + slot * 4, &new_counter,
+                           sizeof(new_counter)) &&
+         flash_nor_flush();
+}
 
-  // Write new counter value
-  uint32_t ints = save_and_disable_interrupts();
-  flash_range_program(ROLLBACK_OFFSET + (free_slot * 4),
-                      (const uint8_t *)&new_counter, 4);
-  restore_interrupts(ints);
+/**
+ * Queue the inactive rollback sector for an idle-time erase once the
+ * active one is nearly full, so the switch only programs
+ */
+void bootloader_schedule_rollback_erase(void) {
+  rollback_sector_t sectors[ROLLBACK_SECTORS];
+  int active = scan_rollback(sectors);
+  uint32_t spare = rollback_offset(active ^ 1);
 
-  return true;
+  if (sectors[active].free_slot >= 0 &&
+      sectors[active].free_slot <= ROLLBACK_SLOTS - ROLLBACK_SPARE_SLOTS) {
+    return;
+  }
+  if (!flash_nor_is_erased(spare, FLASH_NOR_SECTOR_SIZE)) {
+    flash_nor_erase_later(spare, NULL);
+  }
 }
 
 /**
@@ -274,7 +373,10 @@ void bootloader_main(void) {
   }
 
   // Verify and boot firmware
+  uint64_t verify_start = time_us_64();
   boot_status_t status = bootloader_verify_firmware();
+  printf("Verification took %lu us\n",
+         (unsigned long)(time_us_64() - verify_start));
   indicate_status(status);
 
   if (status == BOOT_STATUS_OK) {
@@ -0,0 +1,97 @@
+/**
+ * LibreCipher Chunked AEAD (STREAM) Implementation
+ *
+ * AES-256-GCM per chunk, one keyed context per stream
+ */
+
+#include "aead_stream.h"
+#include "librecipher.h"
+#include <string.h>
+
+#define LAST_FLAG 0x01
+
+// prefix || counter (big-endian) || last
+static void chunk_nonce(const aead_stream_t *s, bool last,
+                        uint8_t nonce[AES_GCM_IV_SIZE]) {
+  memcpy(nonce, s->prefix, AEAD_STREAM_PREFIX_SIZE);
+  nonce[7] = (uint8_t)(s->counter >> 24);
+  nonce[8] = (uint8_t)(s->counter >> 16);
+  nonce[9] = (uint8_t)(s->counter >> 8);
+  nonce[10] = (uint8_t)s->counter;
+  nonce[11] = last ? LAST_FLAG : 0x00;
+}
+
+// Whether the stream takes another chunk: the last index (2^32 - 1) is
+// only good for the final chunk, so no nonce ever repeats
+static bool accepts(const aead_stream_t *s, bool last) {
+  return !s->finished && !s->failed && (last || s->counter != UINT32_MAX);
+}
+
+static void advance(aead_stream_t *s, bool last) {
+  if (last) {
+    s->finished = true;
+  } else {
+    s->counter++;
+  }
+}
+
+void aead_stream_init(aead_stream_t *s, const uint8_t key[32],
+                      const uint8_t prefix[AEAD_STREAM_PREFIX_SIZE]) {
+  static const uint8_t zero_iv[AES_GCM_IV_SIZE] = {0};
+
+  aes_gcm_init(&s->keyed, key, zero_iv);
+  memcpy(s->prefix, prefix, AEAD_STREAM_PREFIX_SIZE);
+  s->counter = 0;
+  s->finished = false;
+  s->failed = false;
+}
+
+bool aead_stream_seal(aead_stream_t *s, const uint8_t *in, size_t len,
+                      bool last, uint8_t *out,
+                      uint8_t tag[AEAD_STREAM_TAG_SIZE]) {
+  uint8_t nonce[AES_GCM_IV_SIZE];
+  aes_gcm_ctx_t ctx;
+
+  if (!accepts(s, last)) {
+    return false;
+  }
+
+  chunk_nonce(s, last, nonce);
+  ctx = s->keyed;
+  aes_gcm_set_iv(&ctx, nonce);
+  aes_gcm_encrypt(&ctx, in, len, out);
+  aes_gcm_finish(&ctx, tag); // Wipes the copy
+  advance(s, last);
+  return true;
+}
+
+bool aead_stream_open(aead_stream_t *s, const uint8_t *in, size_t len,
+                      bool last, const uint8_t tag[AEAD_STREAM_TAG_SIZE],
+                      uint8_t *out) {
+  uint8_t nonce[AES_GCM_IV_SIZE];
+  uint8_t expected[AEAD_STREAM_TAG_SIZE];
+  aes_gcm_ctx_t ctx;
+
+  if (!accepts(s, last)) {
+    return false;
+  }
+
+  chunk_nonce(s, last, nonce);
+  ctx = s->keyed;
+  aes_gcm_set_iv(&ctx, nonce);
+  aes_gcm_decrypt(&ctx, in, len, out);
+  aes_gcm_finish(&ctx, expected);
+
+  if (!librecipher_secure_compare(expected, tag, AEAD_STREAM_TAG_SIZE)) {
+    // A forged or misplaced chunk ends the stream
+    librecipher_secure_zero(out, len);
+    s->failed = true;
+    return false;
+  }
+  advance(s, last);
+  return true;
+}
+
+void aead_stream_clear(aead_stream_t *s) {
+  librecipher_secure_zero(s, sizeof(*s));
+}
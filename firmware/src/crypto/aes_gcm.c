@@ -203,6 +203,10 @@ void aes_gcm_init(aes_gcm_ctx_t *ctx, const uint8_t key[32],
   uint8_t zero[16] = {0};
   aes256_encrypt_block(&ctx->aes, zero, ctx->H);
 
+  aes_gcm_set_iv(ctx, iv);
+}
+
+void aes_gcm_set_iv(aes_gcm_ctx_t *ctx, const uint8_t iv[12]) {
   // J0 = IV || 0^31 || 1
   memcpy(ctx->J0, iv, 12);
   ctx->J0[12] = 0;
@@ -272,6 +276,39 @@ void aes_gcm_encrypt(aes_gcm_ctx_t *ctx, const uint8_t *plaintext, size_t len,
   }
 }
 
+void aes_gcm_decrypt(aes_gcm_ctx_t *ctx, const uint8_t *ciphertext, size_t len,
+                     uint8_t *plaintext) {
+  ctx->ct_len = len;
+  uint8_t keystream[16];
+
+  while (len >= 16) {
+    aes256_encrypt_block(&ctx->aes, ctx->counter, keystream);
+    inc_counter(ctx->counter);
+
+    for (int i = 0; i < 16; i++) {
+      ctx->ghash[i] ^= ciphertext[i];
+      plaintext[i] = ciphertext[i] ^ keystream[i];
+    }
+    ghash_mult(ctx->ghash, ctx->H);
+
+    plaintext += 16;
+    ciphertext += 16;
+    len -= 16;
+  }
+
+  // Handle partial block
+  if (len > 0) {
+    aes256_encrypt_block(&ctx->aes, ctx->counter, keystream);
+    inc_counter(ctx->counter);
+
+    for (size_t i = 0; i < len; i++) {
+      ctx->ghash[i] ^= ciphertext[i];
+      plaintext[i] = ciphertext[i] ^ keystream[i];
+    }
+    ghash_mult(ctx->ghash, ctx->H);
+  }
+}
+
 void aes_gcm_finish(aes_gcm_ctx_t *ctx, uint8_t tag[16]) {
   // Add length block
   uint64_t aad_bits = ctx->aad_len * 8;
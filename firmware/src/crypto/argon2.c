@@ -0,0 +1,424 @@
+/**
+ * LibreCipher Argon2id Implementation
+ *
+ * RFC 9106, version 0x13. Follows the structure of the reference code:
+ * H0 from BLAKE2b over the inputs, the first two blocks of each lane from
+ * H', then passes of four slices filled by the BlaMka compression G.
+ * Argon2id uses data-independent addressing for the first half of the
+ * first pass and data-dependent addressing afterwards.
+ *
+ * Zero dynamic allocation: memory and the compression scratch are static
+ * (the default stack is far smaller than one block set).
+ */
+
+#include "argon2.h"
+#include "blake2b.h"
+#include "librecipher.h"
+#include <string.h>
+
+#define QWORDS_IN_BLOCK (ARGON2_BLOCK_SIZE / 8)
+#define ADDRESSES_IN_BLOCK QWORDS_IN_BLOCK
+#define ARGON2_TYPE_ID 2
+
+typedef struct {
+  uint64_t v[QWORDS_IN_BLOCK];
+} argon2_block_t;
+
+// Memory arena
+static argon2_block_t g_memory[ARGON2_MAX_MEMORY_KIB];
+
+// Compression and address-generation scratch
+static struct {
+  argon2_block_t r;
+  argon2_block_t tmp;
+  argon2_block_t address;
+  argon2_block_t input;
+} g_scratch;
+
+typedef struct {
+  uint32_t passes;
+  uint32_t lanes;
+  uint32_t memory_blocks; // m' = 4p * floor(m / 4p)
+  uint32_t lane_length;
+  uint32_t segment_length;
+} argon2_instance_t;
+
+typedef struct {
+  uint32_t pass;
+  uint32_t lane;
+  uint32_t slice;
+  uint32_t index;
+} argon2_position_t;
+
+// ============ Helpers ============
+
+static inline uint64_t rotr64(uint64_t x, int n) {
+  return (x >> n) | (x << (64 - n));
+}
+
+static inline void store32_le(uint8_t *p, uint32_t x) {
+  p[0] = (uint8_t)x;
+  p[1] = (uint8_t)(x >> 8);
+  p[2] = (uint8_t)(x >> 16);
+  p[3] = (uint8_t)(x >> 24);
+}
+
+static inline uint64_t load64_le(const uint8_t *p) {
+  uint64_t x = 0;
+  for (int i = 7; i >= 0; i--) {
+    x = (x << 8) | p[i];
+  }
+  return x;
+}
+
+static inline void store64_le(uint8_t *p, uint64_t x) {
+  for (int i = 0; i < 8; i++) {
+    p[i] = (uint8_t)(x >> (8 * i));
+  }
+}
+
+static void blake2b_update32(blake2b_ctx_t *ctx, uint32_t x) {
+  uint8_t buf[4];
+  store32_le(buf, x);
+  blake2b_update(ctx, buf, sizeof(buf));
+}
+
+// H': variable-length hash built from chained 64-byte BLAKE2b digests
+static void blake2b_long(uint8_t *out, uint32_t out_len, const uint8_t *in,
+                         size_t in_len) {
+  blake2b_ctx_t ctx;
+  uint8_t v[BLAKE2B_MAX_DIGEST_SIZE];
+
+  if (out_len <= BLAKE2B_MAX_DIGEST_SIZE) {
+    blake2b_init(&ctx, out_len);
+    blake2b_update32(&ctx, out_len);
+    blake2b_update(&ctx, in, in_len);
+    blake2b_final(&ctx, out);
+    return;
+  }
+
+  blake2b_init(&ctx, BLAKE2B_MAX_DIGEST_SIZE);
+  blake2b_update32(&ctx, out_len);
+  blake2b_update(&ctx, in, in_len);
+  blake2b_final(&ctx, v);
+  memcpy(out, v, 32);
+  out += 32;
+  uint32_t remaining = out_len - 32;
+
+  while (remaining > BLAKE2B_MAX_DIGEST_SIZE) {
+    blake2b_hash(v, sizeof(v), v, sizeof(v));
+    memcpy(out, v, 32);
+    out += 32;
+    remaining -= 32;
+  }
+  blake2b_hash(v, sizeof(v), out, remaining);
+
+  librecipher_secure_zero(v, sizeof(v));
+}
+
+// ============ Compression G ============
+
+static inline uint64_t blamka(uint64_t x, uint64_t y) {
+  uint64_t xy = (uint64_t)(uint32_t)x * (uint32_t)y;
+  return x + y + 2 * xy;
+}
+
+#define GB(a, b, c, d)                                                         \
+  do {                                                                         \
+    a = blamka(a, b);                                                          \
+    d = rotr64(d ^ a, 32);                                                     \
+    c = blamka(c, d);                                                          \
+    b = rotr64(b ^ c, 24);                                                     \
+    a = blamka(a, b);                                                          \
+    d = rotr64(d ^ a, 16);                                                     \
+    c = blamka(c, d);                                                          \
+    b = rotr64(b ^ c, 63);                                                     \
+  } while (0)
+
+// BLAKE2b round without message over 16 words
+#define BLAMKA_ROUND(v0, v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12,    \
+                     v13, v14, v15)                                            \
+  do {                                                                         \
+    GB(v0, v4, v8, v12);                                                       \
+    GB(v1, v5, v9, v13);                                                       \
+    GB(v2, v6, v10, v14);                                                      \
+    GB(v3, v7, v11, v15);                                                      \
+    GB(v0, v5, v10, v15);                                                      \
+    GB(v1, v6, v11, v12);                                                      \
+    GB(v2, v7, v8, v13);                                                       \
+    GB(v3, v4, v9, v14);                                                       \
+  } while (0)
+
+// next = G(prev, ref) (xor'ed into next from the second pass on).
+// prev == NULL stands for the all-zero block.
+static void fill_block(const argon2_block_t *prev, const argon2_block_t *ref,
+                       argon2_block_t *next, bool with_xor) {
+  argon2_block_t *r = &g_scratch.r;
+  argon2_block_t *tmp = &g_scratch.tmp;
+
+  for (int i = 0; i < QWORDS_IN_BLOCK; i++) {
+    r->v[i] = ref->v[i] ^ (prev ? prev->v[i] : 0);
+  }
+  memcpy(tmp, r, sizeof(*tmp));
+  if (with_xor) {
+    for (int i = 0; i < QWORDS_IN_BLOCK; i++) {
+      tmp->v[i] ^= next->v[i];
+    }
+  }
+
+  uint64_t *v = r->v;
+
+  // Rows: 8 registers of 16 consecutive words
+  for (int i = 0; i < 8; i++) {
+    uint64_t *w = v + 16 * i;
+    BLAMKA_ROUND(w[0], w[1], w[2], w[3], w[4], w[5], w[6], w[7], w[8], w[9],
+                 w[10], w[11], w[12], w[13], w[14], w[15]);
+  }
+  // Columns: word pairs (2i, 2i + 1) taken from every row
+  for (int i = 0; i < 8; i++) {
+    uint64_t *w = v + 2 * i;
+    BLAMKA_ROUND(w[0], w[1], w[16], w[17], w[32], w[33], w[48], w[49], w[64],
+                 w[65], w[80], w[81], w[96], w[97], w[112], w[113]);
+  }
+
+  for (int i = 0; i < QWORDS_IN_BLOCK; i++) {
+    next->v[i] = tmp->v[i] ^ r->v[i];
+  }
+}
+
+// Data-independent addresses: G(0, G(0, input)) with a running counter
+static void next_addresses(void) {
+  g_scratch.input.v[6]++;
+  fill_block(NULL, &g_scratch.input, &g_scratch.address, false);
+  fill_block(NULL, &g_scratch.address, &g_scratch.address, false);
+}
+
+// ============ Indexing ============
+
+static uint32_t index_alpha(const argon2_instance_t *inst,
+                            const argon2_position_t *pos, uint32_t pseudo_rand,
+                            bool same_lane) {
+  uint32_t area;
+
+  if (pos->pass == 0) {
+    if (pos->slice == 0) {
+      area = pos->index - 1; // All but the previous block
+    } else if (same_lane) {
+      area = pos->slice * inst->segment_length + pos->index - 1;
+    } else {
+      area = pos->slice * inst->segment_length - (pos->index == 0 ? 1 : 0);
+    }
+  } else if (same_lane) {
+    area = inst->lane_length - inst->segment_length + pos->index - 1;
+  } else {
+    area = inst->lane_length - inst->segment_length -
+           (pos->index == 0 ? 1 : 0);
+  }
+
+  // Map pseudo_rand non-uniformly onto [0, area), favouring recent blocks
+  uint64_t rel = pseudo_rand;
+  rel = (rel * rel) >> 32;
+  rel = area - 1 - (((uint64_t)area * rel) >> 32);
+
+  uint32_t start = 0;
+  if (pos->pass != 0 && pos->slice != ARGON2_SYNC_POINTS - 1) {
+    start = (pos->slice + 1) * inst->segment_length;
+  }
+  return (uint32_t)((start + rel) % inst->lane_length);
+}
+
+static void fill_segment(const argon2_instance_t *inst,
+                         argon2_position_t pos) {
+  bool independent = pos.pass == 0 && pos.slice < ARGON2_SYNC_POINTS / 2;
+
+  if (independent) {
+    memset(&g_scratch.input, 0, sizeof(g_scratch.input));
+    g_scratch.input.v[0] = pos.pass;
+    g_scratch.input.v[1] = pos.lane;
+    g_scratch.input.v[2] = pos.slice;
+    g_scratch.input.v[3] = inst->memory_blocks;
+    g_scratch.input.v[4] = inst->passes;
+    g_scratch.input.v[5] = ARGON2_TYPE_ID;
+  }
+
+  // The first two blocks of each lane come from H'
+  uint32_t start = 0;
+  if (pos.pass == 0 && pos.slice == 0) {
+    start = 2;
+    if (independent) {
+      next_addresses();
+    }
+  }
+
+  uint32_t curr = pos.lane * inst->lane_length +
+                  pos.slice * inst->segment_length + start;
+  uint32_t prev = (curr % inst->lane_length == 0)
+                      ? curr + inst->lane_length - 1
+                      : curr - 1;
+
+  for (uint32_t i = start; i < inst->segment_length; i++, curr++, prev++) {
+    if (curr % inst->lane_length == 1) {
+      prev = curr - 1;
+    }
+
+    uint64_t pseudo_rand;
+    if (independent) {
+      if (i % ADDRESSES_IN_BLOCK == 0) {
+        next_addresses();
+      }
+      pseudo_rand = g_scratch.address.v[i % ADDRESSES_IN_BLOCK];
+    } else {
+      pseudo_rand = g_memory[prev].v[0];
+    }
+
+    uint32_t ref_lane = (uint32_t)((pseudo_rand >> 32) % inst->lanes);
+    if (pos.pass == 0 && pos.slice == 0) {
+      ref_lane = pos.lane;
+    }
+    pos.index = i;
+    uint32_t ref_index = index_alpha(inst, &pos, (uint32_t)pseudo_rand,
+                                     ref_lane == pos.lane);
+
+    fill_block(&g_memory[prev], &g_memory[inst->lane_length * ref_lane +
+                                          ref_index],
+               &g_memory[curr], pos.pass != 0);
+  }
+}
+
+// ============ Public API ============
+
+bool argon2_params_valid(const argon2_params_t *params) {
+  return params->t_cost >= 1 && params->lanes >= 1 &&
+         params->lanes <= ARGON2_MAX_LANES &&
+         params->m_cost_kib >= ARGON2_MIN_MEMORY_KIB * params->lanes &&
+         params->m_cost_kib <= ARGON2_MAX_MEMORY_KIB;
+}
+
+bool argon2id_hash(const argon2_params_t *params, const uint8_t *password,
+                   size_t password_len, const uint8_t *salt, size_t salt_len,
+                   uint8_t *out, size_t out_len) {
+  if (!argon2_params_valid(params) || salt_len < 8 || out_len < 4 ||
+      out_len > ARGON2_MAX_OUTPUT_SIZE) {
+    return false;
+  }
+
+  argon2_instance_t inst;
+  inst.passes = params->t_cost;
+  inst.lanes = params->lanes;
+  inst.memory_blocks = params->m_cost_kib / (ARGON2_SYNC_POINTS * inst.lanes) *
+                       (ARGON2_SYNC_POINTS * inst.lanes);
+  inst.lane_length = inst.memory_blocks / inst.lanes;
+  inst.segment_length = inst.lane_length / ARGON2_SYNC_POINTS;
+
+  // H0 = H(p, T, m, t, v, y, P, S, K, X), then room for two LE32 words
+  uint8_t h0[BLAKE2B_MAX_DIGEST_SIZE + 8];
+  blake2b_ctx_t ctx;
+  blake2b_init(&ctx, BLAKE2B_MAX_DIGEST_SIZE);
+  blake2b_update32(&ctx, params->lanes);
+  blake2b_update32(&ctx, (uint32_t)out_len);
+  blake2b_update32(&ctx, params->m_cost_kib);
+  blake2b_update32(&ctx, params->t_cost);
+  blake2b_update32(&ctx, ARGON2_VERSION);
+  blake2b_update32(&ctx, ARGON2_TYPE_ID);
+  blake2b_update32(&ctx, (uint32_t)password_len);
+  blake2b_update(&ctx, password, password_len);
+  blake2b_update32(&ctx, (uint32_t)salt_len);
+  blake2b_update(&ctx, salt, salt_len);
+  blake2b_update32(&ctx, 0); // Secret
+  blake2b_update32(&ctx, 0); // Associated data
+  blake2b_final(&ctx, h0);
+
+  // B[l][0] = H'(H0 || 0 || l), B[l][1] = H'(H0 || 1 || l)
+  uint8_t block_bytes[ARGON2_BLOCK_SIZE];
+  for (uint32_t l = 0; l < inst.lanes; l++) {
+    for (uint32_t j = 0; j < 2; j++) {
+      store32_le(h0 + BLAKE2B_MAX_DIGEST_SIZE, j);
+      store32_le(h0 + BLAKE2B_MAX_DIGEST_SIZE + 4, l);
+      blake2b_long(block_bytes, ARGON2_BLOCK_SIZE, h0, sizeof(h0));
+      argon2_block_t *b = &g_memory[l * inst.lane_length + j];
+      for (int i = 0; i < QWORDS_IN_BLOCK; i++) {
+        b->v[i] = load64_le(block_bytes + 8 * i);
+      }
+    }
+  }
+
+  // Lanes of a slice are independent: sequential on one core
+  for (uint32_t pass = 0; pass < inst.passes; pass++) {
+    for (uint32_t slice = 0; slice < ARGON2_SYNC_POINTS; slice++) {
+      for (uint32_t lane = 0; lane < inst.lanes; lane++) {
+        argon2_position_t pos = {pass, lane, slice, 0};
+        fill_segment(&inst, pos);
+      }
+    }
+  }
+
+  // Tag = H'(XOR of the last block of every lane)
+  argon2_block_t *final = &g_scratch.tmp;
+  memcpy(final, &g_memory[inst.lane_length - 1], sizeof(*final));
+  for (uint32_t l = 1; l < inst.lanes; l++) {
+    const argon2_block_t *last = &g_memory[l * inst.lane_length +
+                                           inst.lane_length - 1];
+    for (int i = 0; i < QWORDS_IN_BLOCK; i++) {
+      final->v[i] ^= last->v[i];
+    }
+  }
+  for (int i = 0; i < QWORDS_IN_BLOCK; i++) {
+    store64_le(block_bytes + 8 * i, final->v[i]);
+  }
+  blake2b_long(out, (uint32_t)out_len, block_bytes, sizeof(block_bytes));
+
+  librecipher_secure_zero(h0, sizeof(h0));
+  librecipher_secure_zero(block_bytes, sizeof(block_bytes));
+  librecipher_secure_zero(g_memory, inst.memory_blocks * sizeof(g_memory[0]));
+  librecipher_secure_zero(&g_scratch, sizeof(g_scratch));
+  return true;
+}
+
+// Run one trial hash and return its duration in microseconds
+static uint64_t calibrate_trial(const argon2_params_t *params,
+                                argon2_clock_fn clock_us) {
+  static const uint8_t password[] = "calibration";
+  static const uint8_t salt[16] = {0};
+  uint8_t out[32];
+
+  uint64_t start = clock_us();
+  argon2id_hash(params, password, sizeof(password) - 1, salt, sizeof(salt),
+                out, sizeof(out));
+  return clock_us() - start;
+}
+
+void argon2id_calibrate(argon2_params_t *params, uint32_t target_ms,
+                        argon2_clock_fn clock_us) {
+  uint64_t target_us = (uint64_t)target_ms * 1000;
+  argon2_params_t trial = {1, ARGON2_MAX_MEMORY_KIB, 1};
+
+  // Largest arena fraction whose single pass fits the target
+  uint64_t one_pass = calibrate_trial(&trial, clock_us);
+  while (one_pass > target_us && trial.m_cost_kib / 2 >= ARGON2_MIN_MEMORY_KIB) {
+    trial.m_cost_kib /= 2;
+    one_pass = calibrate_trial(&trial, clock_us);
+  }
+
+  // Second trial long enough (~1/4 of the target) to average out timer
+  // resolution and cache effects; the difference between the two splits
+  // the fixed cost (H0, first blocks, tag) from the per-pass cost
+  uint64_t guess = one_pass > 0 ? target_us / one_pass : 1;
+  trial.t_cost = guess / 4 > 2 ? (uint32_t)(guess / 4) : 2;
+  uint64_t long_run = calibrate_trial(&trial, clock_us);
+  uint64_t per_pass = long_run > one_pass
+                          ? (long_run - one_pass) / (trial.t_cost - 1)
+                          : 1;
+  if (per_pass == 0)
+    per_pass = 1;
+  uint64_t fixed = one_pass > per_pass ? one_pass - per_pass : 0;
+
+  uint64_t passes = target_us > fixed ? (target_us - fixed) / per_pass : 1;
+  if (passes < 1)
+    passes = 1;
+  if (passes > UINT32_MAX)
+    passes = UINT32_MAX;
+
+  params->t_cost = (uint32_t)passes;
+  params->m_cost_kib = trial.m_cost_kib;
+  params->lanes = 1;
+}
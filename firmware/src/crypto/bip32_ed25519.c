@@ -0,0 +1,155 @@
+/**
+ * LibreCipher BIP32-Ed25519 Implementation
+ *
+ * Child step (V2): Z = HMAC(c, tag || data || LE32(i)),
+ *   kL' = kL + 8 * Z[0..28), kR' = kR + Z[32..64) mod 2^256,
+ *   c' = HMAC(c, tag' || data || LE32(i))[32..64)
+ * with data = kL || kR (hardened, tags 0x00/0x01) or A (soft, 0x02/0x03).
+ * Both MACs are keyed by the parent chain code: the ipad/opad midstates
+ * are computed once and shared.
+ */
+
+#include "bip32_ed25519.h"
+#include "librecipher.h"
+#include "pbkdf2.h"
+#include "sha512.h"
+#include <string.h>
+
+// ============ HMAC-SHA512 keyed by a chain code ============
+
+typedef struct {
+  sha512_ctx_t inner; // After absorbing c ^ ipad
+  sha512_ctx_t outer; // After absorbing c ^ opad
+} chain_mac_t;
+
+static void chain_mac_init(chain_mac_t *mac, const uint8_t chain_code[32]) {
+  uint8_t pad[SHA512_BLOCK_SIZE];
+
+  memset(pad, 0x36, sizeof(pad));
+  for (int i = 0; i < 32; i++) {
+    pad[i] ^= chain_code[i];
+  }
+  sha512_init(&mac->inner);
+  sha512_update(&mac->inner, pad, sizeof(pad));
+
+  memset(pad, 0x5c, sizeof(pad));
+  for (int i = 0; i < 32; i++) {
+    pad[i] ^= chain_code[i];
+  }
+  sha512_init(&mac->outer);
+  sha512_update(&mac->outer, pad, sizeof(pad));
+
+  librecipher_secure_zero(pad, sizeof(pad));
+}
+
+// out = HMAC(c, tag || data || index)
+static void chain_mac(const chain_mac_t *mac, uint8_t tag, const uint8_t *data,
+                      size_t data_len, const uint8_t index[4],
+                      uint8_t out[64]) {
+  sha512_ctx_t ctx = mac->inner;
+
+  sha512_update(&ctx, &tag, 1);
+  sha512_update(&ctx, data, data_len);
+  sha512_update(&ctx, index, 4);
+  sha512_final(&ctx, out);
+
+  ctx = mac->outer;
+  sha512_update(&ctx, out, 64);
+  sha512_final(&ctx, out);
+  librecipher_secure_zero(&ctx, sizeof(ctx));
+}
+
+// ============ Derivation ============
+
+void bip32_ed25519_master_icarus(bip32_ed25519_node_t *root,
+                                 const uint8_t *entropy, size_t entropy_len,
+                                 const uint8_t *passphrase,
+                                 size_t passphrase_len) {
+  uint8_t xprv[BIP32_ED25519_XPRV_SIZE];
+
+  pbkdf2_hmac_sha512(passphrase, passphrase_len, entropy, entropy_len,
+                     BIP32_ED25519_ICARUS_ITERATIONS, xprv, sizeof(xprv));
+
+  // Clamp kL, also clearing bit 253 (third highest) as V2 requires
+  xprv[0] &= 0xf8;
+  xprv[31] &= 0x1f;
+  xprv[31] |= 0x40;
+
+  memcpy(root->kl, xprv, 32);
+  memcpy(root->kr, xprv + 32, 32);
+  memcpy(root->chain_code, xprv + 64, 32);
+  root->has_public = false;
+
+  librecipher_secure_zero(xprv, sizeof(xprv));
+}
+
+void bip32_ed25519_node_public(bip32_ed25519_node_t *node) {
+  if (!node->has_public) {
+    ed25519_scalar_to_public(node->public_key, node->kl);
+    node->has_public = true;
+  }
+}
+
+bool bip32_ed25519_derive_child(const bip32_ed25519_node_t *parent,
+                                uint32_t index, bip32_ed25519_node_t *child) {
+  bool hardened = (index & BIP32_HARDENED) != 0;
+  uint8_t le_index[4] = {(uint8_t)index, (uint8_t)(index >> 8),
+                         (uint8_t)(index >> 16), (uint8_t)(index >> 24)};
+  uint8_t data[64];
+  size_t data_len;
+  uint8_t z[64];
+  uint8_t c[64];
+  chain_mac_t mac;
+
+  if (hardened) {
+    memcpy(data, parent->kl, 32);
+    memcpy(data + 32, parent->kr, 32);
+    data_len = 64;
+  } else {
+    if (!parent->has_public) {
+      return false;
+    }
+    memcpy(data, parent->public_key, 32);
+    data_len = 32;
+  }
+
+  chain_mac_init(&mac, parent->chain_code);
+  chain_mac(&mac, hardened ? 0x00 : 0x02, data, data_len, le_index, z);
+  chain_mac(&mac, hardened ? 0x01 : 0x03, data, data_len, le_index, c);
+
+  // kL' = kL + 8 * ZL (ZL = 28 bytes, so no wrap below 2^255 in practice)
+  uint32_t carry = 0;
+  for (int i = 0; i < 32; i++) {
+    uint32_t zl = i < 28 ? (uint32_t)z[i] << 3 : 0;
+    carry += parent->kl[i] + zl;
+    child->kl[i] = (uint8_t)carry;
+    carry >>= 8;
+  }
+
+  // kR' = kR + ZR mod 2^256
+  carry = 0;
+  for (int i = 0; i < 32; i++) {
+    carry += (uint32_t)parent->kr[i] + z[32 + i];
+    child->kr[i] = (uint8_t)carry;
+    carry >>= 8;
+  }
+
+  memcpy(child->chain_code, c + 32, 32);
+  child->has_public = false;
+
+  librecipher_secure_zero(data, sizeof(data));
+  librecipher_secure_zero(z, sizeof(z));
+  librecipher_secure_zero(c, sizeof(c));
+  librecipher_secure_zero(&mac, sizeof(mac));
+  return true;
+}
+
+void bip32_ed25519_signing_key(bip32_ed25519_node_t *node,
+                               ed25519_expanded_key_t *key) {
+  bip32_ed25519_node_public(node);
+  ed25519_expand_extended(key, node->kl, node->kr, node->public_key);
+}
+
+void bip32_ed25519_node_clear(bip32_ed25519_node_t *node) {
+  librecipher_secure_zero(node, sizeof(*node));
+}
@@ -0,0 +1,141 @@
+/**
+ * LibreCipher BLAKE2b Implementation
+ *
+ * RFC 7693, unkeyed. Constant-time, zero dynamic allocation.
+ */
+
+#include "blake2b.h"
+#include <string.h>
+
+// Same initial values as SHA-512
+static const uint64_t IV[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL,
+    0xa54ff53a5f1d36f1ULL, 0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+    0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL};
+
+// Message word permutation per round (rounds 10 and 11 reuse 0 and 1)
+static const uint8_t SIGMA[12][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+    {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+    {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+    {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+    {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+    {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+    {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+    {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+    {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3}};
+
+static inline uint64_t rotr64(uint64_t x, int n) {
+  return (x >> n) | (x << (64 - n));
+}
+
+static inline uint64_t load64_le(const uint8_t *p) {
+  return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) |
+         ((uint64_t)p[3] << 24) | ((uint64_t)p[4] << 32) |
+         ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) |
+         ((uint64_t)p[7] << 56);
+}
+
+#define G(a, b, c, d, x, y)                                                    \
+  do {                                                                         \
+    v[a] = v[a] + v[b] + (x);                                                  \
+    v[d] = rotr64(v[d] ^ v[a], 32);                                            \
+    v[c] = v[c] + v[d];                                                        \
+    v[b] = rotr64(v[b] ^ v[c], 24);                                            \
+    v[a] = v[a] + v[b] + (y);                                                  \
+    v[d] = rotr64(v[d] ^ v[a], 16);                                            \
+    v[c] = v[c] + v[d];                                                        \
+    v[b] = rotr64(v[b] ^ v[c], 63);                                            \
+  } while (0)
+
+static void blake2b_compress(blake2b_ctx_t *ctx, const uint8_t block[128],
+                             int last) {
+  uint64_t m[16];
+  uint64_t v[16];
+
+  for (int i = 0; i < 16; i++) {
+    m[i] = load64_le(block + 8 * i);
+  }
+  for (int i = 0; i < 8; i++) {
+    v[i] = ctx->h[i];
+    v[i + 8] = IV[i];
+  }
+  v[12] ^= ctx->count;
+  if (last) {
+    v[14] = ~v[14];
+  }
+
+  for (int r = 0; r < 12; r++) {
+    const uint8_t *s = SIGMA[r];
+    G(0, 4, 8, 12, m[s[0]], m[s[1]]);
+    G(1, 5, 9, 13, m[s[2]], m[s[3]]);
+    G(2, 6, 10, 14, m[s[4]], m[s[5]]);
+    G(3, 7, 11, 15, m[s[6]], m[s[7]]);
+    G(0, 5, 10, 15, m[s[8]], m[s[9]]);
+    G(1, 6, 11, 12, m[s[10]], m[s[11]]);
+    G(2, 7, 8, 13, m[s[12]], m[s[13]]);
+    G(3, 4, 9, 14, m[s[14]], m[s[15]]);
+  }
+
+  for (int i = 0; i < 8; i++) {
+    ctx->h[i] ^= v[i] ^ v[i + 8];
+  }
+}
+
+void blake2b_init(blake2b_ctx_t *ctx, size_t digest_len) {
+  memcpy(ctx->h, IV, sizeof(IV));
+  // Parameter block: digest length, no key, fanout 1, depth 1
+  ctx->h[0] ^= 0x01010000ULL ^ (uint64_t)digest_len;
+  ctx->count = 0;
+  ctx->buffer_len = 0;
+  ctx->digest_len = digest_len;
+}
+
+void blake2b_update(blake2b_ctx_t *ctx, const uint8_t *data, size_t len) {
+  // The last block must stay buffered for the final flag, so a full
+  // buffer is only compressed once more data arrives
+  while (len > 0) {
+    if (ctx->buffer_len == BLAKE2B_BLOCK_SIZE) {
+      ctx->count += BLAKE2B_BLOCK_SIZE;
+      blake2b_compress(ctx, ctx->buffer, 0);
+      ctx->buffer_len = 0;
+    }
+    size_t n = BLAKE2B_BLOCK_SIZE - ctx->buffer_len;
+    if (n > len)
+      n = len;
+    memcpy(ctx->buffer + ctx->buffer_len, data, n);
+    ctx->buffer_len += n;
+    data += n;
+    len -= n;
+  }
+}
+
+void blake2b_final(blake2b_ctx_t *ctx, uint8_t *digest) {
+  uint8_t out[BLAKE2B_MAX_DIGEST_SIZE];
+
+  ctx->count += ctx->buffer_len;
+  memset(ctx->buffer + ctx->buffer_len, 0,
+         BLAKE2B_BLOCK_SIZE - ctx->buffer_len);
+  blake2b_compress(ctx, ctx->buffer, 1);
+
+  for (int i = 0; i < 8; i++) {
+    for (int j = 0; j < 8; j++) {
+      out[8 * i + j] = (uint8_t)(ctx->h[i] >> (8 * j));
+    }
+  }
+  memcpy(digest, out, ctx->digest_len);
+
+  memset(out, 0, sizeof(out));
+  memset(ctx, 0, sizeof(*ctx));
+}
+
+void blake2b_hash(const uint8_t *data, size_t len, uint8_t *digest,
+                  size_t digest_len) {
+  blake2b_ctx_t ctx;
+  blake2b_init(&ctx, digest_len);
+  blake2b_update(&ctx, data, len);
+  blake2b_final(&ctx, digest);
+}
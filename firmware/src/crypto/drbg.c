@@ -0,0 +1,148 @@
+/**
+ * LibreCipher HMAC-DRBG Implementation
+ *
+ * NIST SP 800-90A Rev. 1, section 10.1.2, with HMAC-SHA256
+ */
+
+#include "drbg.h"
+#include "librecipher.h"
+#include <string.h>
+
+// ============ HMAC with cached key midstates ============
+
+// Absorb K ^ ipad and K ^ opad once per key
+static void drbg_set_key(drbg_ctx_t *ctx) {
+  uint8_t pad[SHA256_BLOCK_SIZE];
+
+  memset(pad, 0x36, sizeof(pad));
+  for (int i = 0; i < 32; i++)
+    pad[i] ^= ctx->K[i];
+  sha256_init(&ctx->ipad_ctx);
+  sha256_update(&ctx->ipad_ctx, pad, sizeof(pad));
+
+  memset(pad, 0x5c, sizeof(pad));
+  for (int i = 0; i < 32; i++)
+    pad[i] ^= ctx->K[i];
+  sha256_init(&ctx->opad_ctx);
+  sha256_update(&ctx->opad_ctx, pad, sizeof(pad));
+
+  librecipher_secure_zero(pad, sizeof(pad));
+}
+
+// mac = HMAC(K, a || b || c), any part may be empty
+static void drbg_hmac(const drbg_ctx_t *ctx, uint8_t mac[32],
+                      const uint8_t *a, size_t a_len, const uint8_t *b,
+                      size_t b_len, const uint8_t *c, size_t c_len) {
+  sha256_ctx_t sha = ctx->ipad_ctx;
+
+  sha256_update(&sha, a, a_len);
+  if (b_len > 0)
+    sha256_update(&sha, b, b_len);
+  if (c_len > 0)
+    sha256_update(&sha, c, c_len);
+  sha256_final(&sha, mac);
+
+  sha = ctx->opad_ctx;
+  sha256_update(&sha, mac, 32);
+  sha256_final(&sha, mac);
+}
+
+// ============ HMAC_DRBG_Update ============
+
+static void drbg_update(drbg_ctx_t *ctx, const uint8_t *data1, size_t len1,
+                        const uint8_t *data2, size_t len2) {
+  static const uint8_t sep[2] = {0x00, 0x01};
+
+  for (int round = 0; round < 2; round++) {
+    // K = HMAC(K, V || round || data), V = HMAC(K, V)
+    uint8_t input[33];
+    memcpy(input, ctx->V, 32);
+    input[32] = sep[round];
+    drbg_hmac(ctx, ctx->K, input, sizeof(input), data1, len1, data2, len2);
+    drbg_set_key(ctx);
+    drbg_hmac(ctx, ctx->V, ctx->V, 32, NULL, 0, NULL, 0);
+
+    // The second round only runs with provided data
+    if (len1 + len2 == 0)
+      break;
+  }
+}
+
+// ============ Public API ============
+
+bool drbg_init(drbg_ctx_t *ctx, entropy_source_fn entropy, void *entropy_ctx,
+               const uint8_t *personalization, size_t personalization_len) {
+  uint8_t seed[DRBG_SEED_SIZE];
+
+  memset(ctx, 0, sizeof(*ctx));
+  ctx->entropy = entropy;
+  ctx->entropy_ctx = entropy_ctx;
+
+  if (!entropy(seed, sizeof(seed), entropy_ctx)) {
+    librecipher_secure_zero(seed, sizeof(seed));
+    return false;
+  }
+
+  // K = 0x00..., V = 0x01..., then absorb entropy || nonce || pers
+  memset(ctx->V, 0x01, sizeof(ctx->V));
+  drbg_set_key(ctx);
+  drbg_update(ctx, seed, sizeof(seed), personalization, personalization_len);
+
+  ctx->reseed_counter = 1;
+  ctx->seeded = true;
+
+  librecipher_secure_zero(seed, sizeof(seed));
+  return true;
+}
+
+bool drbg_reseed(drbg_ctx_t *ctx, const uint8_t *additional,
+                 size_t additional_len) {
+  uint8_t seed[DRBG_RESEED_SIZE];
+
+  if (!ctx->seeded)
+    return false;
+  if (!ctx->entropy(seed, sizeof(seed), ctx->entropy_ctx)) {
+    librecipher_secure_zero(seed, sizeof(seed));
+    return false;
+  }
+
+  drbg_update(ctx, seed, sizeof(seed), additional, additional_len);
+  ctx->reseed_counter = 1;
+  ctx->reseed_count++;
+
+  librecipher_secure_zero(seed, sizeof(seed));
+  return true;
+}
+
+bool drbg_generate(drbg_ctx_t *ctx, uint8_t *out, size_t len) {
+  if (!ctx->seeded)
+    return false;
+
+  while (len > 0) {
+    size_t chunk = len < DRBG_MAX_REQUEST ? len : DRBG_MAX_REQUEST;
+
+    if (ctx->reseed_counter > DRBG_RESEED_INTERVAL) {
+      if (!drbg_reseed(ctx, NULL, 0))
+        return false;
+    }
+
+    // V = HMAC(K, V) per 32-byte block
+    size_t remaining = chunk;
+    while (remaining > 0) {
+      drbg_hmac(ctx, ctx->V, ctx->V, 32, NULL, 0, NULL, 0);
+      size_t n = remaining < 32 ? remaining : 32;
+      memcpy(out, ctx->V, n);
+      out += n;
+      remaining -= n;
+    }
+
+    // Backtracking resistance
+    drbg_update(ctx, NULL, 0, NULL, 0);
+    ctx->reseed_counter++;
+    ctx->bytes_generated += chunk;
+    len -= chunk;
+  }
+  return true;
+}
+
+void drbg_clear(drbg_ctx_t *ctx) { librecipher_secure_zero(ctx, sizeof(*ctx)); }
@@ -12,7 +12,7 @@
 
 #include "ed25519.h"
 #include "librecipher.h"
-#include "sha256.h"
+#include "sha512.h"
 #include <string.h>
 
 
@@ -52,6 +52,18 @@ typedef struct {
   fe xy2d;
 } ge_precomp;
 
+// Odd multiples of B for verification (wNAF width 7: B, 3B, ..., 63B),
+// generated at build time by tools/gen_ed25519_tables.py
+#define ED25519_BASE_ODD_POINTS 32
+extern const int64_t ed25519_base_odd[ED25519_BASE_ODD_POINTS][3][10];
+
+// Flash/context tables are plain limb arrays with the same layout
+_Static_assert(sizeof(ge_precomp) == sizeof(ed25519_base_odd[0]),
+               "ge_precomp layout");
+_Static_assert(sizeof(ge_cached) ==
+                   sizeof(((ed25519_pubkey_ctx_t *)0)->multiples[0]),
+               "ge_cached layout");
+
 // Prime p = 2^255 - 19
 // d = -121665/121666
 static const fe d = {-10913610, 13857413, -15372611, 6949391,   114729,
@@ -59,21 +71,12 @@ static const fe d = {-10913610, 13857413, -15372611, 6949391,   114729,
 
 // 2*d
 static const fe d2 = {-21827239, -5839606,  -30745221, 13898782, 229458,
-                      15978800,  -12551633, -6495438,  29715968, 9444892};
+                      15978800,  -12551817, -6495438,  29715968, 9444199};
 
 // sqrt(-1)
 static const fe sqrtm1 = {-32595792, -7943725,  9377950,  3500415, 12389472,
                           -272473,   -25146209, -2005654, 326686,  11406482};
 
-// Base point
-static const ge_p3 B = {{-14297830, -7645148, 16144683, -16471763, 27570974,
-                         -2696100, -26142465, 8378389, 20764389, 8758491},
-                        {-26843541, -6710886, 13421773, -13421773, 26843546,
-                         6710886, -13421773, 13421773, -26843546, -6710886},
-                        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-                        {28827062, -6116119, -27349572, 244363, 8635006,
-                         11264893, 19351346, 13413597, 16611511, -6414980}};
-
 // ============ Field Arithmetic ============
 
 static void fe_0(fe h) {
@@ -107,14 +110,17 @@ static void fe_neg(fe h, const fe f) {
     h[i] = -f[i];
 }
 
+// Carry bits of limb i (radix 2^25.5: even limbs 26 bits, odd limbs 25)
+#define FE_LIMB_BITS(i) (((i) & 1) ? 25 : 26)
+
 // Reduce modulo 2^255 - 19
 static void fe_reduce(fe h) {
   int64_t carry;
 
   for (int j = 0; j < 2; j++) {
     for (int i = 0; i < 9; i++) {
-      carry = h[i] >> 26;
-      h[i] -= carry << 26;
+      carry = h[i] >> FE_LIMB_BITS(i);
+      h[i] -= carry << FE_LIMB_BITS(i);
       h[i + 1] += carry;
     }
     carry = h[9] >> 25;
@@ -124,6 +130,7 @@ static void fe_reduce(fe h) {
 }
 
 // Field multiplication
+// Odd limbs carry half a bit less, so odd*odd products are doubled
 static void fe_mul(fe h, const fe f, const fe g) {
   int64_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
   int64_t f5 = f[5], f6 = f[6], f7 = f[7], f8 = f[8], f9 = f[9];
@@ -133,25 +140,30 @@ static void fe_mul(fe h, const fe f, const fe g) {
   int64_t g1_19 = 19 * g1, g2_19 = 19 * g2, g3_19 = 19 * g3;
   int64_t g4_19 = 19 * g4, g5_19 = 19 * g5, g6_19 = 19 * g6;
   int64_t g7_19 = 19 * g7, g8_19 = 19 * g8, g9_19 = 19 * g9;
+  int64_t f1_2 = 2 * f1, f3_2 = 2 * f3, f5_2 = 2 * f5;
+  int64_t f7_2 = 2 * f7, f9_2 = 2 * f9;
 
-  int64_t h0 = f0 * g0 + f1 * g9_19 + f2 * g8_19 + f3 * g7_19 + f4 * g6_19 +
-               f5 * g5_19 + f6 * g4_19 + f7 * g3_19 + f8 * g2_19 + f9 * g1_19;
+  int64_t h0 = f0 * g0 + f1_2 * g9_19 + f2 * g8_19 + f3_2 * g7_19 +
+               f4 * g6_19 + f5_2 * g5_19 + f6 * g4_19 + f7_2 * g3_19 +
+               f8 * g2_19 + f9_2 * g1_19;
   int64_t h1 = f0 * g1 + f1 * g0 + f2 * g9_19 + f3 * g8_19 + f4 * g7_19 +
                f5 * g6_19 + f6 * g5_19 + f7 * g4_19 + f8 * g3_19 + f9 * g2_19;
-  int64_t h2 = f0 * g2 + f1 * g1 + f2 * g0 + f3 * g9_19 + f4 * g8_19 +
-               f5 * g7_19 + f6 * g6_19 + f7 * g5_19 + f8 * g4_19 + f9 * g3_19;
+  int64_t h2 = f0 * g2 + f1_2 * g1 + f2 * g0 + f3_2 * g9_19 + f4 * g8_19 +
+               f5_2 * g7_19 + f6 * g6_19 + f7_2 * g5_19 + f8 * g4_19 +
+               f9_2 * g3_19;
   int64_t h3 = f0 * g3 + f1 * g2 + f2 * g1 + f3 * g0 + f4 * g9_19 + f5 * g8_19 +
                f6 * g7_19 + f7 * g6_19 + f8 * g5_19 + f9 * g4_19;
-  int64_t h4 = f0 * g4 + f1 * g3 + f2 * g2 + f3 * g1 + f4 * g0 + f5 * g9_19 +
-               f6 * g8_19 + f7 * g7_19 + f8 * g6_19 + f9 * g5_19;
+  int64_t h4 = f0 * g4 + f1_2 * g3 + f2 * g2 + f3_2 * g1 + f4 * g0 +
+               f5_2 * g9_19 + f6 * g8_19 + f7_2 * g7_19 + f8 * g6_19 +
+               f9_2 * g5_19;
   int64_t h5 = f0 * g5 + f1 * g4 + f2 * g3 + f3 * g2 + f4 * g1 + f5 * g0 +
                f6 * g9_19 + f7 * g8_19 + f8 * g7_19 + f9 * g6_19;
-  int64_t h6 = f0 * g6 + f1 * g5 + f2 * g4 + f3 * g3 + f4 * g2 + f5 * g1 +
-               f6 * g0 + f7 * g9_19 + f8 * g8_19 + f9 * g7_19;
+  int64_t h6 = f0 * g6 + f1_2 * g5 + f2 * g4 + f3_2 * g3 + f4 * g2 +
+               f5_2 * g1 + f6 * g0 + f7_2 * g9_19 + f8 * g8_19 + f9_2 * g7_19;
   int64_t h7 = f0 * g7 + f1 * g6 + f2 * g5 + f3 * g4 + f4 * g3 + f5 * g2 +
                f6 * g1 + f7 * g0 + f8 * g9_19 + f9 * g8_19;
-  int64_t h8 = f0 * g8 + f1 * g7 + f2 * g6 + f3 * g5 + f4 * g4 + f5 * g3 +
-               f6 * g2 + f7 * g1 + f8 * g0 + f9 * g9_19;
+  int64_t h8 = f0 * g8 + f1_2 * g7 + f2 * g6 + f3_2 * g5 + f4 * g4 +
+               f5_2 * g3 + f6 * g2 + f7_2 * g1 + f8 * g0 + f9_2 * g9_19;
   int64_t h9 = f0 * g9 + f1 * g8 + f2 * g7 + f3 * g6 + f4 * g5 + f5 * g4 +
                f6 * g3 + f7 * g2 + f8 * g1 + f9 * g0;
 
@@ -169,6 +181,23 @@ static void fe_mul(fe h, const fe f, const fe g) {
   fe_reduce(h);
 }
 
+// Multiply by a small constant (c < 2^20)
+static void fe_mul_small(fe h, const fe f, int64_t c) {
+  for (int i = 0; i < 10; i++)
+    h[i] = f[i] * c;
+  fe_reduce(h);
+}
+
+// Constant-time conditional swap (b must be 0 or 1)
+static void fe_cswap(fe f, fe g, int64_t b) {
+  int64_t mask = -b;
+  for (int i = 0; i < 10; i++) {
+    int64_t x = (f[i] ^ g[i]) & mask;
+    f[i] ^= x;
+    g[i] ^= x;
+  }
+}
+
 // Field squaring
 static void fe_sq(fe h, const fe f) { fe_mul(h, f, f); }
 
@@ -259,19 +288,17 @@ static void fe_tobytes(uint8_t s[32], const fe h) {
   fe_copy(t, h);
   fe_reduce(t);
 
-  // Ensure canonical form
-  int64_t carry = (t[0] + 19) >> 26;
-  for (int i = 1; i < 9; i++)
-    carry = (t[i] + carry) >> 26;
-  carry = (t[9] + carry) >> 25;
+  // Ensure canonical form: q = 1 iff t >= p, then subtract q*p
+  int64_t carry = (19 * t[9] + ((int64_t)1 << 24)) >> 25;
+  for (int i = 0; i < 10; i++)
+    carry = (t[i] + carry) >> FE_LIMB_BITS(i);
   t[0] += 19 * carry;
   for (int i = 0; i < 9; i++) {
-    carry = t[i] >> 26;
-    t[i] -= carry << 26;
+    carry = t[i] >> FE_LIMB_BITS(i);
+    t[i] -= carry << FE_LIMB_BITS(i);
     t[i + 1] += carry;
   }
-  carry = t[9] >> 25;
-  t[9] -= carry << 25;
+  t[9] &= ((int64_t)1 << 25) - 1;
 
   s[0] = t[0] & 0xff;
   s[1] = (t[0] >> 8) & 0xff;
@@ -307,6 +334,67 @@ static void fe_tobytes(uint8_t s[32], const fe h) {
   s[31] = (t[9] >> 18) & 0xff;
 }
 
+// Sign of a field element (low bit of its canonical encoding)
+static int fe_isnegative(const fe f) {
+  uint8_t s[32];
+  fe_tobytes(s, f);
+  return s[0] & 1;
+}
+
+static int fe_isnonzero(const fe f) {
+  uint8_t s[32];
+  uint8_t r = 0;
+  fe_tobytes(s, f);
+  for (int i = 0; i < 32; i++)
+    r |= s[i];
+  return r != 0;
+}
+
+// z^((p-5)/8) = z^(2^252 - 3), for square roots during decompression
+static void fe_pow22523(fe out, const fe z) {
+  fe t0, t1, t2;
+  int i;
+
+  fe_sq(t0, z);
+  fe_sq(t1, t0);
+  fe_sq(t1, t1);
+  fe_mul(t1, z, t1);
+  fe_mul(t0, t0, t1);
+  fe_sq(t0, t0);
+  fe_mul(t0, t1, t0);
+  fe_sq(t1, t0);
+  for (i = 0; i < 4; i++)
+    fe_sq(t1, t1);
+  fe_mul(t0, t1, t0);
+  fe_sq(t1, t0);
+  for (i = 0; i < 9; i++)
+    fe_sq(t1, t1);
+  fe_mul(t1, t1, t0);
+  fe_sq(t2, t1);
+  for (i = 0; i < 19; i++)
+    fe_sq(t2, t2);
+  fe_mul(t1, t2, t1);
+  fe_sq(t1, t1);
+  for (i = 0; i < 9; i++)
+    fe_sq(t1, t1);
+  fe_mul(t0, t1, t0);
+  fe_sq(t1, t0);
+  for (i = 0; i < 49; i++)
+    fe_sq(t1, t1);
+  fe_mul(t1, t1, t0);
+  fe_sq(t2, t1);
+  for (i = 0; i < 99; i++)
+    fe_sq(t2, t2);
+  fe_mul(t1, t2, t1);
+  fe_sq(t1, t1);
+  for (i = 0; i < 49; i++)
+    fe_sq(t1, t1);
+  fe_mul(t0, t1, t0);
+  fe_sq(t0, t0);
+  fe_sq(t0, t0);
+  fe_mul(out, t0, z);
+}
+
 // ============ Group Operations ============
 
 // Set point to identity
@@ -342,6 +430,62 @@ static void ge_add(ge_p1p1 *r, const ge_p3 *p, const ge_cached *q) {
   fe_sub(r->T, t0, r->T);
 }
 
+// Point subtraction
+static void ge_sub(ge_p1p1 *r, const ge_p3 *p, const ge_cached *q) {
+  fe t0;
+
+  fe_add(r->X, p->Y, p->X);
+  fe_sub(r->Y, p->Y, p->X);
+  fe_mul(r->Z, r->X, q->YminusX);
+  fe_mul(r->Y, r->Y, q->YplusX);
+  fe_mul(r->T, q->T2d, p->T);
+  fe_mul(r->X, p->Z, q->Z);
+  fe_add(t0, r->X, r->X);
+  fe_sub(r->X, r->Z, r->Y);
+  fe_add(r->Y, r->Z, r->Y);
+  fe_sub(r->Z, t0, r->T);
+  fe_add(r->T, t0, r->T);
+}
+
+// Mixed addition with an affine precomputed point (Z = 1)
+static void ge_madd(ge_p1p1 *r, const ge_p3 *p, const ge_precomp *q) {
+  fe t0;
+
+  fe_add(r->X, p->Y, p->X);
+  fe_sub(r->Y, p->Y, p->X);
+  fe_mul(r->Z, r->X, q->yplusx);
+  fe_mul(r->Y, r->Y, q->yminusx);
+  fe_mul(r->T, q->xy2d, p->T);
+  fe_add(t0, p->Z, p->Z);
+  fe_sub(r->X, r->Z, r->Y);
+  fe_add(r->Y, r->Z, r->Y);
+  fe_add(r->Z, t0, r->T);
+  fe_sub(r->T, t0, r->T);
+}
+
+// Mixed subtraction with an affine precomputed point
+static void ge_msub(ge_p1p1 *r, const ge_p3 *p, const ge_precomp *q) {
+  fe t0;
+
+  fe_add(r->X, p->Y, p->X);
+  fe_sub(r->Y, p->Y, p->X);
+  fe_mul(r->Z, r->X, q->yminusx);
+  fe_mul(r->Y, r->Y, q->yplusx);
+  fe_mul(r->T, q->xy2d, p->T);
+  fe_add(t0, p->Z, p->Z);
+  fe_sub(r->X, r->Z, r->Y);
+  fe_add(r->Y, r->Z, r->Y);
+  fe_sub(r->Z, t0, r->T);
+  fe_add(r->T, t0, r->T);
+}
+
+// Convert p1p1 to projective (X:Y:Z), skipping T when only doubling follows
+static void ge_p1p1_to_p2(ge_p3 *r, const ge_p1p1 *p) {
+  fe_mul(r->X, p->X, p->T);
+  fe_mul(r->Y, p->Y, p->Z);
+  fe_mul(r->Z, p->Z, p->T);
+}
+
 // Convert p1p1 to p3
 static void ge_p1p1_to_p3(ge_p3 *r, const ge_p1p1 *p) {
   fe_mul(r->X, p->X, p->T);
@@ -366,61 +510,444 @@ static void ge_p3_dbl(ge_p1p1 *r, const ge_p3 *p) {
   fe_sub(r->T, r->T, r->Z);
 }
 
-// Scalar multiplication
-static void ge_scalarmult(ge_p3 *r, const uint8_t s[32], const ge_p3 *p) {
+// Constant-time conditional move (b must be 0 or 1)
+static void fe_cmov(fe f, const fe g, int64_t b) {
+  int64_t mask = -b;
+  for (int i = 0; i < 10; i++)
+    f[i] ^= (f[i] ^ g[i]) & mask;
+}
+
+static void ge_precomp_cmov(ge_precomp *t, const ge_precomp *u, int64_t b) {
+  fe_cmov(t->yplusx, u->yplusx, b);
+  fe_cmov(t->yminusx, u->yminusx, b);
+  fe_cmov(t->xy2d, u->xy2d, b);
+}
+
+// Convert extended to bytes, given recip = 1/Z
+static void ge_p3_tobytes_recip(uint8_t s[32], const ge_p3 *h,
+                                const fe recip) {
+  fe x, y;
+
+  fe_mul(x, h->X, recip);
+  fe_mul(y, h->Y, recip);
+  fe_tobytes(s, y);
+
+  // Set high bit based on x coordinate parity
+  uint8_t x_bytes[32];
+  fe_tobytes(x_bytes, x);
+  s[31] ^= (x_bytes[0] & 1) << 7;
+}
+
+// Convert extended to bytes
+static void ge_p3_tobytes(uint8_t s[32], const ge_p3 *h) {
+  fe recip;
+
+  fe_invert(recip, h->Z);
+  ge_p3_tobytes_recip(s, h, recip);
+}
+
+// Decode a point and negate it: h = -P (variable time, public input)
+// Rejects non-canonical y and the x = 0 encoding with the sign bit set.
+static bool ge_frombytes_negate_vartime(ge_p3 *h, const uint8_t s[32]) {
+  fe u, v, v3, vxx, check;
+  uint8_t y_bytes[32];
+
+  fe_frombytes(h->Y, s);
+  fe_tobytes(y_bytes, h->Y);
+  y_bytes[31] |= s[31] & 0x80;
+  if (memcmp(y_bytes, s, 32) != 0)
+    return false;
+
+  // x^2 = (y^2 - 1) / (d y^2 + 1) = u / v
+  fe_1(h->Z);
+  fe_sq(u, h->Y);
+  fe_mul(v, u, d);
+  fe_sub(u, u, h->Z);
+  fe_add(v, v, h->Z);
+
+  // x = u v^3 (u v^7)^((p-5)/8)
+  fe_sq(v3, v);
+  fe_mul(v3, v3, v);
+  fe_sq(h->X, v3);
+  fe_mul(h->X, h->X, v);
+  fe_mul(h->X, h->X, u);
+  fe_pow22523(h->X, h->X);
+  fe_mul(h->X, h->X, v3);
+  fe_mul(h->X, h->X, u);
+
+  fe_sq(vxx, h->X);
+  fe_mul(vxx, vxx, v);
+  fe_sub(check, vxx, u);
+  if (fe_isnonzero(check)) {
+    fe_add(check, vxx, u);
+    if (fe_isnonzero(check))
+      return false;
+    fe_mul(h->X, h->X, sqrtm1);
+  }
+
+  if (!fe_isnonzero(h->X) && (s[31] >> 7))
+    return false;
+  if (fe_isnegative(h->X) == (s[31] >> 7))
+    fe_neg(h->X, h->X);
+
+  fe_mul(h->T, h->X, h->Y);
+  return true;
+}
+
+// Signed sliding-window recoding: odd digits |r[i]| < 2^(w-1)
+static void slide(int8_t r[256], const uint8_t a[32], int w) {
+  const int max = (1 << (w - 1)) - 1;
+
+  for (int i = 0; i < 256; i++)
+    r[i] = 1 & (a[i >> 3] >> (i & 7));
+
+  for (int i = 0; i < 256; i++) {
+    if (!r[i])
+      continue;
+    for (int b = 1; b <= w && i + b < 256; b++) {
+      if (!r[i + b])
+        continue;
+      if (r[i] + (r[i + b] << b) <= max) {
+        r[i] += r[i + b] << b;
+        r[i + b] = 0;
+      } else if (r[i] - (r[i + b] << b) >= -max) {
+        r[i] -= r[i + b] << b;
+        for (int k = i + b; k < 256; k++) {
+          if (!r[k]) {
+            r[k] = 1;
+            break;
+          }
+          r[k] = 0;
+        }
+      } else {
+        break;
+      }
+    }
+  }
+}
+
+// r = a * A + b * B (variable time, public scalars only)
+// Ai holds the odd multiples of A, Bi those of the base point.
+static void ge_double_scalarmult_vartime(ge_p3 *r, const uint8_t a[32],
+                                         const ge_cached *Ai,
+                                         const uint8_t b[32]) {
+  const ge_precomp *Bi = (const ge_precomp *)ed25519_base_odd;
+  int8_t aslide[256];
+  int8_t bslide[256];
   ge_p1p1 t;
-  ge_cached pc;
-  ge_p3 tmp;
+  ge_p3 u;
+  int i;
+
+  slide(aslide, a, 5);
+  slide(bslide, b, 7);
 
   ge_p3_0(r);
-  ge_p3_to_cached(&pc, p);
+  for (i = 255; i >= 0; i--) {
+    if (aslide[i] || bslide[i])
+      break;
+  }
 
-  for (int i = 255; i >= 0; i--) {
+  for (; i >= 0; i--) {
     ge_p3_dbl(&t, r);
-    ge_p1p1_to_p3(r, &t);
 
-    int bit = (s[i / 8] >> (i & 7)) & 1;
-    if (bit) {
-      ge_add(&t, r, &pc);
-      ge_p1p1_to_p3(r, &t);
+    if (aslide[i] > 0) {
+      ge_p1p1_to_p3(&u, &t);
+      ge_add(&t, &u, &Ai[aslide[i] / 2]);
+    } else if (aslide[i] < 0) {
+      ge_p1p1_to_p3(&u, &t);
+      ge_sub(&t, &u, &Ai[(-aslide[i]) / 2]);
+    }
+
+    if (bslide[i] > 0) {
+      ge_p1p1_to_p3(&u, &t);
+      ge_madd(&t, &u, &Bi[bslide[i] / 2]);
+    } else if (bslide[i] < 0) {
+      ge_p1p1_to_p3(&u, &t);
+      ge_msub(&t, &u, &Bi[(-bslide[i]) / 2]);
     }
+
+    ge_p1p1_to_p2(r, &t);
   }
 }
 
-// Base point multiplication
-static void ge_scalarmult_base(ge_p3 *r, const uint8_t s[32]) {
-  ge_scalarmult(r, s, &B);
+// ============ Scalar Arithmetic mod L ============
+// L = 2^252 + 27742317777372353535851937790883648493
+// Scalars are handled as signed 21-bit limbs; 2^252 = -delta (mod L)
+// folds high limbs down.
+
+// -delta in 21-bit limbs
+static const int64_t sc_minus_delta[6] = {666643, 470296,  654183,
+                                          -997805, 136657, -683901};
+
+// L in little-endian bytes
+static const uint8_t sc_L[32] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7,
+    0xa2, 0xde, 0xf9, 0xde, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10};
+
+// Split little-endian bytes into 21-bit limbs (last limb takes the rest)
+static void sc_load(int64_t *s, int limbs, const uint8_t *in, size_t len) {
+  uint64_t acc = 0;
+  int bits = 0;
+  size_t pos = 0;
+
+  for (int i = 0; i < limbs; i++) {
+    while (pos < len && (bits < 21 || i == limbs - 1)) {
+      acc |= (uint64_t)in[pos++] << bits;
+      bits += 8;
+    }
+    if (i == limbs - 1) {
+      s[i] = (int64_t)acc;
+    } else {
+      s[i] = (int64_t)(acc & 0x1fffff);
+      acc >>= 21;
+      bits -= 21;
+    }
+  }
 }
 
-// Convert extended to bytes
-static void ge_p3_tobytes(uint8_t s[32], const ge_p3 *h) {
-  fe recip, x, y;
+// Fold limbs hi..lo (>= 12) into lower limbs
+static void sc_fold(int64_t *s, int hi, int lo) {
+  for (int k = hi; k >= lo; k--) {
+    for (int i = 0; i < 6; i++)
+      s[k - 12 + i] += s[k] * sc_minus_delta[i];
+    s[k] = 0;
+  }
+}
 
-  fe_invert(recip, h->Z);
-  fe_mul(x, h->X, recip);
-  fe_mul(y, h->Y, recip);
-  fe_tobytes(s, y);
+// Signed carries with rounding, limbs from..to-1 into their successor
+static void sc_carry_round(int64_t *s, int from, int to) {
+  for (int i = from; i < to; i++) {
+    int64_t carry = (s[i] + (1 << 20)) >> 21;
+    s[i + 1] += carry;
+    s[i] -= carry << 21;
+  }
+}
 
-  // Set high bit based on x coordinate parity
-  uint8_t x_bytes[32];
-  fe_tobytes(x_bytes, x);
-  s[31] ^= (x_bytes[0] & 1) << 7;
+// Floor carries, leaving limbs from..to-1 in [0, 2^21)
+static void sc_carry_floor(int64_t *s, int from, int to) {
+  for (int i = from; i < to; i++) {
+    int64_t carry = s[i] >> 21;
+    s[i + 1] += carry;
+    s[i] -= carry << 21;
+  }
+}
+
+// Reduce 24 limbs (value < 2^512) to [0, L) and store 32 bytes
+static void sc_reduce_limbs(uint8_t out[32], int64_t s[24]) {
+  sc_fold(s, 23, 18);
+  sc_carry_round(s, 6, 17);
+  sc_fold(s, 17, 12);
+  sc_carry_round(s, 0, 12);
+  sc_fold(s, 12, 12);
+  sc_carry_floor(s, 0, 12);
+  sc_fold(s, 12, 12);
+  sc_carry_floor(s, 0, 11);
+
+  // Pack 12 x 21 bits
+  uint64_t acc = 0;
+  int bits = 0;
+  int pos = 0;
+  for (int i = 0; i < 12; i++) {
+    acc |= (uint64_t)s[i] << bits;
+    bits += 21;
+    while (bits >= 8 && pos < 32) {
+      out[pos++] = (uint8_t)acc;
+      acc >>= 8;
+      bits -= 8;
+    }
+  }
+  while (pos < 32) {
+    out[pos++] = (uint8_t)acc;
+    acc >>= 8;
+  }
+}
+
+// out = in mod L, in is 64 bytes (a SHA-512 output)
+static void sc_reduce(uint8_t out[32], const uint8_t in[64]) {
+  int64_t s[24];
+
+  sc_load(s, 24, in, 64);
+  sc_reduce_limbs(out, s);
+  librecipher_secure_zero(s, sizeof(s));
 }
 
-// ============ SHA-512 for Ed25519 ============
+// out = (a * b + c) mod L
+static void sc_muladd(uint8_t out[32], const uint8_t a[32],
+                      const uint8_t b[32], const uint8_t c[32]) {
+  int64_t al[12], bl[12], s[24];
 
-// Ed25519 uses SHA-512, but we can simulate with double SHA-256
-// Note: Proper implementation should use actual SHA-512
-static void sha512_hash(const uint8_t *data, size_t len, uint8_t hash[64]) {
-  // First half
-  sha256_hash(data, len, hash);
+  sc_load(al, 12, a, 32);
+  sc_load(bl, 12, b, 32);
+  sc_load(s, 12, c, 32);
+  for (int i = 12; i < 24; i++)
+    s[i] = 0;
+
+  for (int i = 0; i < 12; i++) {
+    for (int j = 0; j < 12; j++)
+      s[i + j] += al[i] * bl[j];
+  }
+  sc_carry_round(s, 0, 23);
+
+  sc_reduce_limbs(out, s);
+  librecipher_secure_zero(al, sizeof(al));
+  librecipher_secure_zero(bl, sizeof(bl));
+  librecipher_secure_zero(s, sizeof(s));
+}
+
+// s < L (RFC 8032 rejects non-canonical S)
+static bool sc_is_canonical(const uint8_t s[32]) {
+  for (int i = 31; i >= 0; i--) {
+    if (s[i] < sc_L[i])
+      return true;
+    if (s[i] > sc_L[i])
+      return false;
+  }
+  return false;
+}
+
+// ============ Fixed-Base Multiplication ============
+// Regular signed recoding of an odd scalar into 43 odd digits in
+// [-63, 63], one per 6 bits: every window costs six doublings and one
+// mixed addition with B, 3B, ..., 63B (ed25519_base_odd), whatever the
+// scalar bits. Entries are picked with masked loads over the whole table.
+
+#define BASE_WINDOW_BITS 6
+#define BASE_DIGITS 43
+
+// t = digit * B for an odd digit in [-63, 63], reading every entry
+static void ge_select_base(ge_precomp *t, int8_t digit) {
+  const ge_precomp *Bi = (const ge_precomp *)ed25519_base_odd;
+  uint32_t neg = (uint8_t)digit >> 7;
+  uint32_t abs = (uint32_t)(digit ^ -(int32_t)neg) + neg;
+  ge_precomp minus;
+
+  *t = Bi[0];
+  for (uint32_t i = 1; i < ED25519_BASE_ODD_POINTS; i++) {
+    uint32_t diff = abs ^ (2 * i + 1);
+    ge_precomp_cmov(t, &Bi[i], (diff - 1) >> 31);
+  }
 
-  // Second half with different prefix
-  uint8_t buf[256];
-  buf[0] = 0x01;
-  size_t copy_len = (len < 255) ? len : 255;
-  memcpy(buf + 1, data, copy_len);
-  sha256_hash(buf, copy_len + 1, hash + 32);
+  // -P swaps y+x and y-x and negates xy2d
+  fe_copy(minus.yplusx, t->yminusx);
+  fe_copy(minus.yminusx, t->yplusx);
+  fe_neg(minus.xy2d, t->xy2d);
+  ge_precomp_cmov(t, &minus, neg);
+}
+
+// r = s * B in constant time (s any 256-bit string, secret)
+static void ge_scalarmult_base(ge_p3 *r, const uint8_t s[32]) {
+  uint8_t k[33], kl[33];
+  int8_t e[BASE_DIGITS];
+  ge_precomp t;
+  ge_p1p1 u;
+
+  // Recoding needs an odd scalar: s + L (same point, L is odd) when s is
+  // even
+  uint32_t carry = 0;
+  for (int i = 0; i < 32; i++) {
+    carry += (uint32_t)s[i] + sc_L[i];
+    kl[i] = (uint8_t)carry;
+    carry >>= 8;
+  }
+  kl[32] = (uint8_t)carry;
+  uint8_t even = (uint8_t)((s[0] & 1) - 1);
+  for (int i = 0; i < 33; i++) {
+    uint8_t v = i < 32 ? s[i] : 0;
+    k[i] = v ^ ((v ^ kl[i]) & even);
+  }
+
+  // e[i] = (7 bits at 6i, lowest forced to 1) - 64; the top digit takes
+  // what is left (k < 2^257, so at most 31)
+  for (int i = 0; i < BASE_DIGITS; i++) {
+    int pos = i * BASE_WINDOW_BITS;
+    uint32_t w = k[pos >> 3];
+    if ((pos >> 3) + 1 < 33)
+      w |= (uint32_t)k[(pos >> 3) + 1] << 8;
+    w = ((w >> (pos & 7)) & 127) | 1;
+    e[i] = (int8_t)(i == BASE_DIGITS - 1 ? w : w - 64);
+  }
+
+  ge_p3_0(r);
+  for (int i = BASE_DIGITS - 1; i >= 0; i--) {
+    if (i != BASE_DIGITS - 1) {
+      for (int j = 0; j < BASE_WINDOW_BITS - 1; j++) {
+        ge_p3_dbl(&u, r);
+        ge_p1p1_to_p2(r, &u);
+      }
+      ge_p3_dbl(&u, r);
+      ge_p1p1_to_p3(r, &u);
+    }
+    ge_select_base(&t, e[i]);
+    ge_madd(&u, r, &t);
+    ge_p1p1_to_p3(r, &u);
+  }
+
+  librecipher_secure_zero(k, sizeof(k));
+  librecipher_secure_zero(kl, sizeof(kl));
+  librecipher_secure_zero(e, sizeof(e));
+  librecipher_secure_zero(&t, sizeof(t));
+}
+
+// ============ X25519 (RFC 7748) ============
+
+// (A - 2) / 4 for Curve25519, A = 486662
+#define X25519_A24 121665
+
+// x-only Montgomery ladder: out = u(scalar * P), constant-time in scalar
+static void x25519_ladder(fe out, const uint8_t scalar[32], const fe u) {
+  fe x2, z2, x3, z3;
+  fe a, aa, b, bb, e, c, dd, da, cb;
+  int64_t swap = 0;
+
+  fe_1(x2);
+  fe_0(z2);
+  fe_copy(x3, u);
+  fe_1(z3);
+
+  for (int t = 254; t >= 0; t--) {
+    int64_t bit = (scalar[t >> 3] >> (t & 7)) & 1;
+    swap ^= bit;
+    fe_cswap(x2, x3, swap);
+    fe_cswap(z2, z3, swap);
+    swap = bit;
+
+    fe_add(a, x2, z2);
+    fe_sq(aa, a);
+    fe_sub(b, x2, z2);
+    fe_sq(bb, b);
+    fe_sub(e, aa, bb);
+    fe_add(c, x3, z3);
+    fe_sub(dd, x3, z3);
+    fe_mul(da, dd, a);
+    fe_mul(cb, c, b);
+
+    fe_add(x3, da, cb);
+    fe_sq(x3, x3);
+    fe_sub(z3, da, cb);
+    fe_sq(z3, z3);
+    fe_mul(z3, z3, u);
+
+    fe_mul(x2, aa, bb);
+    fe_mul_small(z2, e, X25519_A24);
+    fe_add(z2, z2, aa);
+    fe_mul(z2, z2, e);
+  }
+
+  fe_cswap(x2, x3, swap);
+  fe_cswap(z2, z3, swap);
+
+  fe_invert(z2, z2);
+  fe_mul(out, x2, z2);
+}
+
+
+// Decode and clamp scalar as specified in RFC 7748 section 5
+static void x25519_clamp(uint8_t k[32], const uint8_t scalar[32]) {
+  memcpy(k, scalar, 32);
+  k[0] &= 248;
+  k[31] &= 127;
+  k[31] |= 64;
 }
 
 // ============ Public API ============
@@ -449,19 +976,18 @@ void ed25519_create_keypair(const uint8_t seed[32],
   librecipher_secure_zero(hash, 64);
 }
 
-void ed25519_generate_keypair(ed25519_keypair_t *keypair) {
+bool ed25519_generate_keypair(ed25519_keypair_t *keypair) {
   uint8_t seed[32];
-  librecipher_random(seed, 32);
+  if (!librecipher_random(seed, 32))
+    return false;
   ed25519_create_keypair(seed, keypair);
   librecipher_secure_zero(seed, 32);
+  return true;
 }
 
-void ed25519_sign(uint8_t signature[64], const uint8_t *message,
-                  size_t message_len, const uint8_t secret_key[64]) {
+void ed25519_expand_key(ed25519_expanded_key_t *key,
+                        const uint8_t secret_key[64]) {
   uint8_t hash[64];
-  uint8_t r_hash[64];
-  ge_p3 R;
-  uint8_t buf[128];
 
   // h = H(seed)
   sha512_hash(secret_key, 32, hash);
@@ -469,65 +995,184 @@ void ed25519_sign(uint8_t signature[64], const uint8_t *message,
   hash[31] &= 127;
   hash[31] |= 64;
 
-  // r = H(h[32:64] || message) mod L
-  // For simplicity, use entire hash as nonce seed
-  sha256_ctx_t ctx;
-  sha256_init(&ctx);
-  sha256_update(&ctx, hash + 32, 32);
-  sha256_update(&ctx, message, message_len);
-  sha256_final(&ctx, r_hash);
-  sha256_hash(r_hash, 32, r_hash); // Extra mixing
+  ed25519_expand_extended(key, hash, hash + 32, secret_key + 32);
+
+  librecipher_secure_zero(hash, 64);
+}
+
+void ed25519_expand_extended(ed25519_expanded_key_t *key,
+                             const uint8_t scalar[32],
+                             const uint8_t prefix[32],
+                             const uint8_t public_key[32]) {
+  memcpy(key->scalar, scalar, 32);
+  memcpy(key->prefix, prefix, 32);
+  memcpy(key->public_key, public_key, 32);
+}
+
+void ed25519_scalar_to_public(uint8_t public_key[32],
+                              const uint8_t scalar[32]) {
+  ge_p3 A;
+
+  ge_scalarmult_base(&A, scalar);
+  ge_p3_tobytes(public_key, &A);
+}
+
+void ed25519_scalar_to_public_batch(uint8_t (*public_keys)[32],
+                                    const uint8_t (*scalars)[32],
+                                    size_t count) {
+  // Static: a full chunk does not fit the default core stack
+  static ge_p3 points[ED25519_BATCH_MAX];
+  static fe prefix[ED25519_BATCH_MAX];
+  fe inv, recip;
+
+  for (size_t base = 0; base < count; base += ED25519_BATCH_MAX) {
+    size_t n = count - base;
+    if (n > ED25519_BATCH_MAX)
+      n = ED25519_BATCH_MAX;
+
+    // prefix[i] = Z_0 * ... * Z_i
+    for (size_t i = 0; i < n; i++) {
+      ge_scalarmult_base(&points[i], scalars[base + i]);
+      if (i == 0)
+        fe_copy(prefix[0], points[0].Z);
+      else
+        fe_mul(prefix[i], prefix[i - 1], points[i].Z);
+    }
+
+    // One inversion, then walk back: 1/Z_i = prefix[i-1] / prefix[i]
+    fe_invert(inv, prefix[n - 1]);
+    for (size_t i = n; i-- > 1;) {
+      fe_mul(recip, inv, prefix[i - 1]);
+      fe_mul(inv, inv, points[i].Z);
+      ge_p3_tobytes_recip(public_keys[base + i], &points[i], recip);
+    }
+    ge_p3_tobytes_recip(public_keys[base], &points[0], inv);
+  }
+}
+
+void ed25519_sign_expanded(uint8_t signature[64], const uint8_t *message,
+                           size_t message_len,
+                           const ed25519_expanded_key_t *key) {
+  uint8_t hash[64];
+  uint8_t r[32];
+  ge_p3 R;
+
+  // r = H(prefix || message) mod L
+  sha512_ctx_t ctx;
+  sha512_init(&ctx);
+  sha512_update(&ctx, key->prefix, 32);
+  sha512_update(&ctx, message, message_len);
+  sha512_final(&ctx, hash);
+  sc_reduce(r, hash);
 
   // R = r * B
-  ge_scalarmult_base(&R, r_hash);
+  ge_scalarmult_base(&R, r);
   ge_p3_tobytes(signature, &R);
 
   // k = H(R || A || message) mod L
-  sha256_init(&ctx);
-  sha256_update(&ctx, signature, 32);
-  sha256_update(&ctx, secret_key + 32, 32); // public key
-  sha256_update(&ctx, message, message_len);
-  sha256_final(&ctx, buf);
-
-  // s = r + k * a mod L
-  // Simplified: just XOR and reduce (not cryptographically correct but
-  // functional)
-  for (int i = 0; i < 32; i++) {
-    signature[32 + i] = r_hash[i] ^ buf[i] ^ hash[i];
-  }
+  sha512_init(&ctx);
+  sha512_update(&ctx, signature, 32);
+  sha512_update(&ctx, key->public_key, 32);
+  sha512_update(&ctx, message, message_len);
+  sha512_final(&ctx, hash);
+  sc_reduce(hash, hash);
+
+  // S = r + k * a mod L
+  sc_muladd(signature + 32, hash, key->scalar, r);
+
+  librecipher_secure_zero(hash, sizeof(hash));
+  librecipher_secure_zero(r, sizeof(r));
+}
 
-  librecipher_secure_zero(hash, 64);
-  librecipher_secure_zero(r_hash, 64);
+void ed25519_sign(uint8_t signature[64], const uint8_t *message,
+                  size_t message_len, const uint8_t secret_key[64]) {
+  ed25519_expanded_key_t key;
+
+  ed25519_expand_key(&key, secret_key);
+  ed25519_sign_expanded(signature, message, message_len, &key);
+  ed25519_expanded_key_clear(&key);
+}
+
+void ed25519_expanded_key_clear(ed25519_expanded_key_t *key) {
+  librecipher_secure_zero(key, sizeof(*key));
 }
 
 bool ed25519_verify(const uint8_t signature[64], const uint8_t *message,
                     size_t message_len, const uint8_t public_key[32]) {
-  // Basic signature format check
-  if ((signature[63] & 0xE0) != 0)
+  ed25519_pubkey_ctx_t ctx;
+
+  if (!ed25519_pubkey_ctx_init(&ctx, public_key))
     return false;
+  return ed25519_verify_ctx(signature, message, message_len, &ctx);
+}
 
-  // Compute k = H(R || A || message)
-  uint8_t k[32];
-  sha256_ctx_t ctx;
-  sha256_init(&ctx);
-  sha256_update(&ctx, signature, 32);  // R
-  sha256_update(&ctx, public_key, 32); // A
-  sha256_update(&ctx, message, message_len);
-  sha256_final(&ctx, k);
+bool ed25519_pubkey_ctx_init(ed25519_pubkey_ctx_t *ctx,
+                             const uint8_t public_key[32]) {
+  ge_cached *Ai = (ge_cached *)ctx->multiples;
+  ge_p3 A, A2, u;
+  ge_p1p1 t;
 
-  // Verify: s * B = R + k * A
-  // Simplified verification (basic check)
-  ge_p3 S, R, kA;
+  if (!ge_frombytes_negate_vartime(&A, public_key))
+    return false;
+  memcpy(ctx->public_key, public_key, 32);
+
+  // Ai[i] = (2i + 1) * (-A)
+  ge_p3_to_cached(&Ai[0], &A);
+  ge_p3_dbl(&t, &A);
+  ge_p1p1_to_p3(&A2, &t);
+  for (int i = 1; i < ED25519_PUBKEY_CTX_POINTS; i++) {
+    ge_add(&t, &A2, &Ai[i - 1]);
+    ge_p1p1_to_p3(&u, &t);
+    ge_p3_to_cached(&Ai[i], &u);
+  }
+  return true;
+}
 
-  ge_scalarmult_base(&S, signature + 32);
+bool ed25519_verify_ctx(const uint8_t signature[64], const uint8_t *message,
+                        size_t message_len, const ed25519_pubkey_ctx_t *ctx) {
+  uint8_t hash[64];
+  uint8_t check[32];
+  sha512_ctx_t sha;
+  ge_p3 R;
 
-  // For now, accept if signature has valid format
-  // Full verification requires point decompression and comparison
+  if (!sc_is_canonical(signature + 32))
+    return false;
 
-  return true; // Placeholder - implement full verification
+  // k = H(R || A || message) mod L
+  sha512_init(&sha);
+  sha512_update(&sha, signature, 32);
+  sha512_update(&sha, ctx->public_key, 32);
+  sha512_update(&sha, message, message_len);
+  sha512_final(&sha, hash);
+  sc_reduce(hash, hash);
+
+  // R' = S * B - k * A, must encode to R
+  ge_double_scalarmult_vartime(&R, hash, (const ge_cached *)ctx->multiples,
+                               signature + 32);
+  ge_p3_tobytes(check, &R);
+
+  return librecipher_secure_compare(check, signature, 32);
 }
 
 void ed25519_get_public_key(uint8_t public_key[32],
                             const uint8_t secret_key[64]) {
   memcpy(public_key, secret_key + 32, 32);
 }
+
+void x25519(uint8_t out[32], const uint8_t scalar[32],
+            const uint8_t point[32]) {
+  uint8_t k[32];
+
+  x25519_clamp(k, scalar);
+  fe u, r;
+  fe_frombytes(u, point); // Ignores the top bit, as RFC 7748 requires
+  x25519_ladder(r, k, u);
+  fe_tobytes(out, r);
+
+  librecipher_secure_zero(k, sizeof(k));
+}
+
+void x25519_base(uint8_t public_key[32], const uint8_t secret_key[32]) {
+  static const uint8_t basepoint[32] = {9};
+  x25519(public_key, secret_key, basepoint);
+}
@@ -0,0 +1,341 @@
+/**
+ * LibreCipher Entropy Sources
+ *
+ * The ROSC random bit is slow and not full entropy, so it is only used to
+ * seed and reseed the DRBG; bulk randomness comes from drbg_generate.
+ *
+ * Raw bytes are absorbed into a running SHA-256 state; every
+ * ENTROPY_RAW_PER_BLOCK bytes the state is finalized into a 32-byte block
+ * of a small ring. The timer IRQ only produces and the foreground only
+ * consumes; the ring is touched with interrupts disabled.
+ *
+ * Every raw bit also goes through the SP 800-90B repetition count and
+ * adaptive proportion tests before it reaches the conditioner. A failure
+ * wipes the pool and latches: no further output until reset.
+ */
+
+#include "entropy.h"
+#include "librecipher.h"
+#include "sha256.h"
+#include <string.h>
+
+#if !LIBRECIPHER_HOST
+#include "hardware/structs/rosc.h"
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+
+#define ENTROPY_LOCK() uint32_t irq_state = save_and_disable_interrupts()
+#define ENTROPY_UNLOCK() restore_interrupts(irq_state)
+#else
+#define ENTROPY_LOCK() ((void)0)
+#define ENTROPY_UNLOCK() ((void)0)
+#endif
+
+// ============ Raw Source ============
+
+#if !LIBRECIPHER_HOST
+// One raw bit from the ROSC
+static uint8_t raw_bit(void) {
+  // Wait for the oscillator to be running
+  while ((rosc_hw->status & ROSC_STATUS_ENABLED_BITS) == 0) {
+    tight_loop_contents();
+  }
+  uint8_t bit = rosc_hw->randombit & 1;
+
+  // Short delay for decorrelation between samples
+  for (volatile int j = 0; j < 10; j++) {
+  }
+  return bit;
+}
+#else
+// Simulated ring oscillator: a fast clock sampled with accumulated phase
+// jitter, slightly asymmetric duty cycle. Deterministic, so host runs
+// are reproducible. Stuck and biased modes exercise the health tests.
+#define SIM_NOISE_SEED 0x243F6A8885A308D3ULL
+
+static struct {
+  uint64_t noise;
+  uint32_t phase;
+  entropy_sim_mode_t mode;
+} g_sim = {SIM_NOISE_SEED, 0, ENTROPY_SIM_NOISY};
+
+static uint8_t raw_bit(void) {
+  if (g_sim.mode == ENTROPY_SIM_STUCK)
+    return 1;
+
+  g_sim.noise ^= g_sim.noise << 13;
+  g_sim.noise ^= g_sim.noise >> 7;
+  g_sim.noise ^= g_sim.noise << 17;
+
+  // Nominal period plus up to ~1/8 cycle of jitter per sample
+  g_sim.phase += 0x6A09E667u + (uint32_t)(g_sim.noise >> 35);
+  if (g_sim.mode == ENTROPY_SIM_BIASED)
+    return g_sim.phase < 0xD9999999u; // ~85% ones
+  return g_sim.phase < 0x8CCCCCCCu;   // ~55% ones
+}
+#endif
+
+// ============ Health Tests ============
+
+// SP 800-90B 4.4 state. The repetition count runs per bit, the adaptive
+// proportion test per byte (the window is a whole number of bytes). No
+// data-dependent branches: a few ALU ops per raw bit, and no timing
+// signal of the raw data.
+static struct {
+  uint32_t rct_last;  // Previous bit
+  uint32_t rct_run;   // Length of the current run
+  uint32_t apt_ref;   // First bit of the current window
+  uint32_t apt_count; // Occurrences of apt_ref in the window
+  uint32_t apt_index; // Bits into the window
+  uint32_t failures;  // ENTROPY_HEALTH_* (sticky)
+  uint32_t raw_bits;
+  uint32_t apt_windows;
+  uint32_t apt_max_count;
+  bool startup_done;
+} g_health;
+
+// Nonzero iff value >= cutoff (both well below 2^31)
+#define HEALTH_OVER(value, cutoff) (((cutoff) - 1u - (value)) >> 31)
+
+static inline uint32_t popcount8(uint32_t x) {
+  x = x - ((x >> 1) & 0x55);
+  x = (x & 0x33) + ((x >> 2) & 0x33);
+  return (x + (x >> 4)) & 0x0F;
+}
+
+static uint8_t raw_byte(void) {
+  uint32_t last = g_health.rct_last;
+  uint32_t run = g_health.rct_run;
+  uint32_t fail = 0;
+  uint32_t byte = 0;
+
+  for (int i = 0; i < 8; i++) {
+    uint32_t bit = raw_bit();
+    // Repetition count: extend the run or restart it at 1
+    run = (run & (0u - (bit ^ last ^ 1))) + 1;
+    fail |= HEALTH_OVER(run, ENTROPY_RCT_CUTOFF);
+    last = bit;
+    byte = (byte << 1) | bit;
+  }
+  g_health.rct_last = last;
+  g_health.rct_run = run;
+
+  // Adaptive proportion: bits equal to the window's first bit
+  if (g_health.apt_index == 0) {
+    g_health.apt_ref = byte >> 7;
+    g_health.apt_count = 0;
+  }
+  g_health.apt_count += popcount8(byte ^ (0xFFu & (g_health.apt_ref - 1)));
+  fail |= HEALTH_OVER(g_health.apt_count, ENTROPY_APT_CUTOFF) << 1;
+  g_health.failures |= fail;
+
+  g_health.apt_index += 8;
+  if (g_health.apt_index == ENTROPY_APT_WINDOW) {
+    if (g_health.apt_count > g_health.apt_max_count)
+      g_health.apt_max_count = g_health.apt_count;
+    g_health.apt_windows++;
+    g_health.apt_index = 0;
+  }
+  g_health.raw_bits += 8;
+  return (uint8_t)byte;
+}
+
+// ============ Conditioned Pool ============
+
+static struct {
+  sha256_ctx_t conditioner; // Raw bytes absorbed since the last block
+  size_t raw_count;
+  uint8_t blocks[ENTROPY_POOL_BLOCKS][ENTROPY_BLOCK_SIZE];
+  size_t head;  // Next block to serve
+  size_t count; // Ready blocks
+  size_t offset; // Bytes already served from the head block
+  bool started;
+} g_pool;
+
+// Drop everything derived from the source. Caller holds the lock.
+static void pool_wipe_locked(void) {
+  librecipher_secure_zero(&g_pool.conditioner, sizeof(g_pool.conditioner));
+  librecipher_secure_zero(g_pool.blocks, sizeof(g_pool.blocks));
+  g_pool.raw_count = 0;
+  g_pool.head = 0;
+  g_pool.count = 0;
+  g_pool.offset = 0;
+}
+
+// Absorb raw bytes; finalize a block when enough have been collected.
+// Caller holds the lock.
+static void pool_harvest_locked(size_t raw_bytes) {
+  uint8_t raw[ENTROPY_HARVEST_BYTES];
+
+  while (raw_bytes > 0 && g_pool.count < ENTROPY_POOL_BLOCKS &&
+         g_health.failures == 0) {
+    size_t n = ENTROPY_RAW_PER_BLOCK - g_pool.raw_count;
+    if (n > raw_bytes)
+      n = raw_bytes;
+    if (n > sizeof(raw))
+      n = sizeof(raw);
+
+    for (size_t i = 0; i < n; i++) {
+      raw[i] = raw_byte();
+    }
+    raw_bytes -= n;
+
+    if (g_health.failures != 0) {
+      pool_wipe_locked();
+      break;
+    }
+
+    // Startup bits only exercise the tests
+    if (!g_health.startup_done) {
+      g_health.startup_done = g_health.raw_bits >= ENTROPY_STARTUP_BITS;
+      continue;
+    }
+
+    if (g_pool.raw_count == 0) {
+      sha256_init(&g_pool.conditioner);
+    }
+    sha256_update(&g_pool.conditioner, raw, n);
+    g_pool.raw_count += n;
+
+    if (g_pool.raw_count == ENTROPY_RAW_PER_BLOCK) {
+      size_t tail = (g_pool.head + g_pool.count) % ENTROPY_POOL_BLOCKS;
+      sha256_final(&g_pool.conditioner, g_pool.blocks[tail]);
+      g_pool.count++;
+      g_pool.raw_count = 0;
+    }
+  }
+
+  librecipher_secure_zero(raw, sizeof(raw));
+}
+
+void entropy_pool_harvest(size_t raw_bytes) {
+  ENTROPY_LOCK();
+  pool_harvest_locked(raw_bytes);
+  ENTROPY_UNLOCK();
+}
+
+size_t entropy_pool_level(void) {
+  ENTROPY_LOCK();
+  size_t level = g_pool.count * ENTROPY_BLOCK_SIZE - g_pool.offset;
+  ENTROPY_UNLOCK();
+  return level;
+}
+
+bool entropy_available(size_t len) { return entropy_pool_level() >= len; }
+
+// Serve up to len bytes from ready blocks; returns bytes copied
+static size_t pool_take(uint8_t *buf, size_t len) {
+  size_t taken = 0;
+
+  ENTROPY_LOCK();
+  while (taken < len && g_pool.count > 0) {
+    uint8_t *block = g_pool.blocks[g_pool.head];
+    size_t n = ENTROPY_BLOCK_SIZE - g_pool.offset;
+    if (n > len - taken)
+      n = len - taken;
+
+    memcpy(buf + taken, block + g_pool.offset, n);
+    librecipher_secure_zero(block + g_pool.offset, n);
+    g_pool.offset += n;
+    taken += n;
+
+    if (g_pool.offset == ENTROPY_BLOCK_SIZE) {
+      g_pool.head = (g_pool.head + 1) % ENTROPY_POOL_BLOCKS;
+      g_pool.count--;
+      g_pool.offset = 0;
+    }
+  }
+  ENTROPY_UNLOCK();
+  return taken;
+}
+
+bool entropy_default_source(uint8_t *buf, size_t len, void *ctx) {
+  (void)ctx;
+  if (entropy_health_failures() != 0)
+    return false;
+
+  size_t done = pool_take(buf, len);
+
+  // Pool drained: harvest the remainder in the foreground
+  while (done < len) {
+    entropy_pool_harvest(ENTROPY_RAW_PER_BLOCK);
+    if (entropy_health_failures() != 0) {
+      librecipher_secure_zero(buf, len);
+      return false;
+    }
+    done += pool_take(buf + done, len - done);
+  }
+  return true;
+}
+
+uint8_t entropy_health_failures(void) {
+  ENTROPY_LOCK();
+  uint8_t failures = (uint8_t)g_health.failures;
+  ENTROPY_UNLOCK();
+  return failures;
+}
+
+void entropy_health_get(entropy_health_t *health) {
+  ENTROPY_LOCK();
+  health->raw_bits = g_health.raw_bits;
+  health->apt_windows = g_health.apt_windows;
+  health->apt_max_count = (uint16_t)g_health.apt_max_count;
+  health->failures = (uint8_t)g_health.failures;
+  health->startup_done = g_health.startup_done;
+  ENTROPY_UNLOCK();
+}
+
+#if !LIBRECIPHER_HOST
+static repeating_timer_t g_harvest_timer;
+
+static bool harvest_timer_cb(repeating_timer_t *rt) {
+  (void)rt;
+  entropy_pool_harvest(ENTROPY_HARVEST_BYTES);
+  // Latched failure: nothing more to harvest until reset
+  return g_health.failures == 0;
+}
+
+void entropy_pool_start(void) {
+  if (g_pool.started)
+    return;
+  g_pool.started = true;
+  add_repeating_timer_us(-ENTROPY_HARVEST_PERIOD_US, harvest_timer_cb, NULL,
+                         &g_harvest_timer);
+}
+#else
+// Host tests drive entropy_pool_harvest directly
+void entropy_pool_start(void) { g_pool.started = true; }
+
+void entropy_sim_reset(entropy_sim_mode_t mode) {
+  pool_wipe_locked();
+  memset(&g_health, 0, sizeof(g_health));
+  g_sim.noise = SIM_NOISE_SEED;
+  g_sim.phase = 0;
+  g_sim.mode = mode;
+}
+
+bool entropy_test_source(uint8_t *buf, size_t len, void *ctx) {
+  entropy_test_source_t *src = (entropy_test_source_t *)ctx;
+  uint8_t block[32];
+  sha256_ctx_t sha;
+
+  while (len > 0) {
+    uint8_t counter[8];
+    for (int i = 0; i < 8; i++) {
+      counter[i] = (uint8_t)(src->counter >> (56 - 8 * i));
+    }
+    src->counter++;
+
+    sha256_init(&sha);
+    sha256_update(&sha, src->seed, sizeof(src->seed));
+    sha256_update(&sha, counter, sizeof(counter));
+    sha256_final(&sha, block);
+
+    size_t n = len < sizeof(block) ? len : sizeof(block);
+    memcpy(buf, block, n);
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+#endif
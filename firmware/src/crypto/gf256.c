@@ -0,0 +1,244 @@
+/**
+ * LibreCipher GF(2^8) Arithmetic - Implementation
+ */
+
+#include "gf256.h"
+#include <string.h>
+
+_Static_assert(2 * GF256_MAX_POINTS <= GF256_VECTOR_SIZE,
+               "numerators and denominators share one vector");
+
+// ============ Scalars ============
+
+uint8_t gf256_mul(uint8_t a, uint8_t b) {
+  uint8_t r = 0;
+  for (int i = 0; i < 8; i++) {
+    r ^= a & (uint8_t)(-(b & 1));
+    a = (uint8_t)((a << 1) ^ (0x1B & -(a >> 7)));
+    b >>= 1;
+  }
+  return r;
+}
+
+// a^254 = a^-1: fixed addition chain of 11 products
+uint8_t gf256_inv(uint8_t a) {
+  uint8_t a2 = gf256_mul(a, a);
+  uint8_t a3 = gf256_mul(a2, a);
+  uint8_t a6 = gf256_mul(a3, a3);
+  uint8_t a12 = gf256_mul(a6, a6);
+  uint8_t a15 = gf256_mul(a12, a3);
+  uint8_t a30 = gf256_mul(a15, a15);
+  uint8_t a60 = gf256_mul(a30, a30);
+  uint8_t a63 = gf256_mul(a60, a3);
+  uint8_t a126 = gf256_mul(a63, a63);
+  uint8_t a127 = gf256_mul(a126, a);
+  return gf256_mul(a127, a127);
+}
+
+// ============ Bitsliced Vectors ============
+
+// Transpose an 8x8 bit matrix: bit 8i + j moves to bit 8j + i
+static uint64_t transpose8(uint64_t x) {
+  uint64_t t;
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+  x ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+  x ^= t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+  x ^= t ^ (t << 28);
+  return x;
+}
+
+/**
+ * Each group of 8 bytes is an 8x8 bit matrix (byte k = row k); its
+ * transpose has bit b of bytes k = 0..7 in row b, which is one byte of
+ * plane b
+ */
+void gf256_vector_load(gf256_vector_t *v, const uint8_t *bytes, size_t len) {
+  memset(v, 0, sizeof(*v));
+  for (size_t g = 0; g < GF256_VECTOR_SIZE / 8; g++) {
+    uint64_t x = 0;
+    for (size_t k = 0; k < 8 && 8 * g + k < len; k++) {
+      x |= (uint64_t)bytes[8 * g + k] << (8 * k);
+    }
+    x = transpose8(x);
+    for (int b = 0; b < 8; b++) {
+      v->plane[b] |= (uint32_t)((x >> (8 * b)) & 0xFF) << (8 * g);
+    }
+  }
+}
+
+void gf256_vector_store(const gf256_vector_t *v, uint8_t *bytes, size_t len) {
+  for (size_t g = 0; g < GF256_VECTOR_SIZE / 8; g++) {
+    uint64_t x = 0;
+    for (int b = 0; b < 8; b++) {
+      x |= (uint64_t)((v->plane[b] >> (8 * g)) & 0xFF) << (8 * b);
+    }
+    x = transpose8(x);
+    for (size_t k = 0; k < 8 && 8 * g + k < len; k++) {
+      bytes[8 * g + k] = (uint8_t)(x >> (8 * k));
+    }
+  }
+}
+
+/**
+ * Shift-and-add over the bits of c: acc ^= v where the bit is set (mask),
+ * then v *= x. Bitsliced xtime moves plane b to b + 1 and folds plane 7
+ * into planes 0, 1, 3 and 4 (the low terms of 0x11B)
+ */
+void gf256_vector_mul_add(gf256_vector_t *acc, const gf256_vector_t *v,
+                          uint8_t c) {
+  uint32_t p0 = v->plane[0], p1 = v->plane[1], p2 = v->plane[2];
+  uint32_t p3 = v->plane[3], p4 = v->plane[4], p5 = v->plane[5];
+  uint32_t p6 = v->plane[6], p7 = v->plane[7];
+
+  for (int i = 0; i < 8; i++) {
+    uint32_t mask = -(uint32_t)((c >> i) & 1);
+    acc->plane[0] ^= p0 & mask;
+    acc->plane[1] ^= p1 & mask;
+    acc->plane[2] ^= p2 & mask;
+    acc->plane[3] ^= p3 & mask;
+    acc->plane[4] ^= p4 & mask;
+    acc->plane[5] ^= p5 & mask;
+    acc->plane[6] ^= p6 & mask;
+    acc->plane[7] ^= p7 & mask;
+
+    uint32_t top = p7;
+    p7 = p6;
+    p6 = p5;
+    p5 = p4;
+    p4 = p3 ^ top;
+    p3 = p2 ^ top;
+    p2 = p1;
+    p1 = p0 ^ top;
+    p0 = top;
+  }
+}
+
+/**
+ * Lane-wise product: schoolbook over the bit planes (64 AND/XOR), then the
+ * planes of degree 14..8 folded down with x^8 = x^4 + x^3 + x + 1
+ */
+void gf256_vector_mul(gf256_vector_t *out, const gf256_vector_t *a,
+                      const gf256_vector_t *b) {
+  uint32_t b0 = b->plane[0], b1 = b->plane[1], b2 = b->plane[2];
+  uint32_t b3 = b->plane[3], b4 = b->plane[4], b5 = b->plane[5];
+  uint32_t b6 = b->plane[6], b7 = b->plane[7];
+  uint32_t p[15] = {0};
+
+  for (int i = 0; i < 8; i++) {
+    uint32_t ai = a->plane[i];
+    p[i] ^= ai & b0;
+    p[i + 1] ^= ai & b1;
+    p[i + 2] ^= ai & b2;
+    p[i + 3] ^= ai & b3;
+    p[i + 4] ^= ai & b4;
+    p[i + 5] ^= ai & b5;
+    p[i + 6] ^= ai & b6;
+    p[i + 7] ^= ai & b7;
+  }
+  for (int k = 14; k >= 8; k--) {
+    p[k - 4] ^= p[k];
+    p[k - 5] ^= p[k];
+    p[k - 7] ^= p[k];
+    p[k - 8] ^= p[k];
+  }
+  memcpy(out->plane, p, sizeof(out->plane));
+}
+
+// ============ Interpolation ============
+
+// Every lane set to c
+static void vector_broadcast(gf256_vector_t *v, uint8_t c) {
+  for (int b = 0; b < 8; b++) {
+    v->plane[b] = -(uint32_t)((c >> b) & 1);
+  }
+}
+
+// Lane `lane` set to 1
+static void vector_set_one(gf256_vector_t *v, size_t lane) {
+  uint32_t bit = (uint32_t)1 << lane;
+  for (int b = 0; b < 8; b++) {
+    v->plane[b] &= ~bit;
+  }
+  v->plane[0] |= bit;
+}
+
+// Lane-wise a^254, the chain of gf256_inv
+static void vector_inv(gf256_vector_t *out, const gf256_vector_t *a) {
+  gf256_vector_t a3, t;
+
+  gf256_vector_mul(&t, a, a);
+  gf256_vector_mul(&a3, &t, a);
+  gf256_vector_mul(&t, &a3, &a3); // a^6
+  gf256_vector_mul(&t, &t, &t); // a^12
+  gf256_vector_mul(&t, &t, &a3); // a^15
+  gf256_vector_mul(&t, &t, &t); // a^30
+  gf256_vector_mul(&t, &t, &t); // a^60
+  gf256_vector_mul(&t, &t, &a3); // a^63
+  gf256_vector_mul(&t, &t, &t); // a^126
+  gf256_vector_mul(&t, &t, a); // a^127
+  gf256_vector_mul(out, &t, &t); // a^254
+}
+
+/**
+ * coeff[j] = prod_{m != j} (x - xs[m]) / (xs[j] - xs[m]), one lane per
+ * point: numerator factors in lanes 0..15, denominator factors in lanes
+ * 16..31, so each m is one vector product for every j (lane j of factor j
+ * is 1). Then a single lane-wise inversion of the denominators.
+ */
+bool gf256_lagrange(const uint8_t *xs, size_t count, uint8_t x,
+                    uint8_t *coeff) {
+  if (count == 0 || count > GF256_MAX_POINTS) {
+    return false;
+  }
+  for (size_t j = 0; j < count; j++) {
+    for (size_t m = j + 1; m < count; m++) {
+      if (xs[j] == xs[m]) {
+        return false;
+      }
+    }
+  }
+
+  gf256_vector_t lanes, acc, factor, den;
+  uint8_t out[GF256_VECTOR_SIZE];
+
+  // Lanes 0..15: x, lanes 16..31: xs[j]
+  memset(out, x, GF256_MAX_POINTS);
+  memcpy(out + GF256_MAX_POINTS, xs, count);
+  gf256_vector_load(&lanes, out, GF256_MAX_POINTS + count);
+  vector_broadcast(&acc, 1);
+
+  for (size_t m = 0; m < count; m++) {
+    vector_broadcast(&factor, xs[m]);
+    for (int b = 0; b < 8; b++) {
+      factor.plane[b] ^= lanes.plane[b];
+    }
+    vector_set_one(&factor, m);
+    vector_set_one(&factor, GF256_MAX_POINTS + m);
+    gf256_vector_mul(&acc, &acc, &factor);
+  }
+
+  for (int b = 0; b < 8; b++) {
+    den.plane[b] = acc.plane[b] >> GF256_MAX_POINTS;
+  }
+  vector_inv(&den, &den);
+  gf256_vector_mul(&acc, &acc, &den);
+  gf256_vector_store(&acc, out, count);
+  memcpy(coeff, out, count);
+  return true;
+}
+
+bool gf256_interpolate(const uint8_t *xs, const gf256_vector_t *ys,
+                       size_t count, uint8_t x, gf256_vector_t *out) {
+  uint8_t coeff[GF256_MAX_POINTS];
+
+  if (!gf256_lagrange(xs, count, x, coeff)) {
+    return false;
+  }
+  memset(out, 0, sizeof(*out));
+  for (size_t j = 0; j < count; j++) {
+    gf256_vector_mul_add(out, &ys[j], coeff[j]);
+  }
+  return true;
+}
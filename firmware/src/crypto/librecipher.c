@@ -6,16 +6,36 @@
 
 #include "librecipher.h"
 #include "aes_gcm.h"
-#include "hardware/structs/rosc.h"
-#include "pico/stdlib.h"
+#include "drbg.h"
+#include "entropy.h"
 #include "sha256.h"
 #include <string.h>
 
+// DRBG global que atende librecipher_random
+static drbg_ctx_t g_drbg;
+
+// Buffer de saída: pedidos pequenos (nonces, salts) amortizam o update do
+// DRBG. Bytes entregues são zerados; os restantes ficam no fim do buffer.
+#define RANDOM_BUFFER_SIZE 256
+static uint8_t g_random_buffer[RANDOM_BUFFER_SIZE];
+static size_t g_random_available;
+
+// Instancia o DRBG a partir da fonte de entropia padrão (ROSC no device)
+static bool random_instantiate(void) {
+  static const uint8_t personalization[] = "LibreCipher-DRBG";
+  return drbg_init(&g_drbg, entropy_default_source, NULL, personalization,
+                   sizeof(personalization) - 1);
+}
+
 /**
  * Inicializa LibreCipher
+ *
+ * Só dispara a coleta de entropia em background; o DRBG é instanciado no
+ * primeiro librecipher_random, quando o pool já está cheio.
  */
 void librecipher_init(void) {
   // ROSC já inicializado pelo SDK
+  entropy_pool_start();
 }
 
 /**
@@ -42,29 +62,64 @@ int librecipher_secure_compare(const uint8_t *a, const uint8_t *b, size_t len) {
   return ((diff - 1) >> 8) & 1;
 }
 
+// Falha de saúde: descarta o DRBG e o buffer, zera a saída parcial
+static bool random_fail(uint8_t *buf, size_t len) {
+  drbg_clear(&g_drbg);
+  librecipher_secure_zero(g_random_buffer, sizeof(g_random_buffer));
+  g_random_available = 0;
+  librecipher_secure_zero(buf, len);
+  return false;
+}
+
 /**
- * RNG baseado no ROSC do RP2350
- * Coleta entropia do oscilador de anel
+ * RNG: HMAC-DRBG semeado e re-semeado pelo ROSC
+ *
+ * O ROSC só é lido no seed/reseed; a saída sai na velocidade do SHA-256.
+ * Com os testes de saúde do ROSC em falha nada é entregue, nem o que
+ * restar no buffer.
  */
-void librecipher_random(uint8_t *buf, size_t len) {
-  for (size_t i = 0; i < len; i++) {
-    uint8_t random_byte = 0;
-    for (int bit = 0; bit < 8; bit++) {
-      // Aguarda bit disponível
-      while ((rosc_hw->status & ROSC_STATUS_ENABLED_BITS) == 0) {
-        tight_loop_contents();
-      }
-      // Coleta bit do ROSC
-      random_byte = (random_byte << 1) | (rosc_hw->randombit & 1);
+bool librecipher_random(uint8_t *buf, size_t len) {
+  if (!librecipher_rng_healthy()) {
+    return random_fail(buf, len);
+  }
+  if (!g_drbg.seeded && !random_instantiate()) {
+    return random_fail(buf, len);
+  }
+
+  // Pedidos grandes vão direto ao DRBG
+  if (len >= RANDOM_BUFFER_SIZE) {
+    if (!drbg_generate(&g_drbg, buf, len)) {
+      return random_fail(buf, len);
+    }
+    return true;
+  }
 
-      // Pequeno delay para decorrelação
-      for (volatile int j = 0; j < 10; j++) {
+  uint8_t *out = buf;
+  size_t out_len = len;
+  while (len > 0) {
+    if (g_random_available == 0) {
+      if (!drbg_generate(&g_drbg, g_random_buffer, RANDOM_BUFFER_SIZE)) {
+        return random_fail(out, out_len);
       }
+      g_random_available = RANDOM_BUFFER_SIZE;
     }
-    buf[i] = random_byte;
+
+    size_t n = len < g_random_available ? len : g_random_available;
+    uint8_t *src = g_random_buffer + RANDOM_BUFFER_SIZE - g_random_available;
+    memcpy(buf, src, n);
+    librecipher_secure_zero(src, n);
+    g_random_available -= n;
+    buf += n;
+    len -= n;
   }
+  return true;
 }
 
+/**
+ * Testes de saúde do ROSC (ver entropy.h)
+ */
+bool librecipher_rng_healthy(void) { return entropy_health_failures() == 0; }
+
 /**
  * SHA-256 Hash (usa implementação real)
  */
@@ -118,16 +173,84 @@ void librecipher_hmac_sha256(const uint8_t *key, size_t key_len,
   librecipher_secure_zero(inner_hash, sizeof(inner_hash));
 }
 
+// HMAC-SHA256 com a chave já absorvida (ipad/opad calculados uma vez)
+typedef struct {
+  sha256_ctx_t inner;
+  sha256_ctx_t outer;
+} hmac_sha256_midstate_t;
+
+static void hmac_midstate_init(hmac_sha256_midstate_t *mid,
+                               const uint8_t key[32]) {
+  uint8_t pad[64];
+
+  memset(pad, 0x36, sizeof(pad));
+  for (int i = 0; i < 32; i++) {
+    pad[i] ^= key[i];
+  }
+  sha256_init(&mid->inner);
+  sha256_update(&mid->inner, pad, sizeof(pad));
+
+  memset(pad, 0x5c, sizeof(pad));
+  for (int i = 0; i < 32; i++) {
+    pad[i] ^= key[i];
+  }
+  sha256_init(&mid->outer);
+  sha256_update(&mid->outer, pad, sizeof(pad));
+
+  librecipher_secure_zero(pad, sizeof(pad));
+}
+
+// T(n) = HMAC(PRK, T(n-1) || info || n), info lido em streaming
+static void hkdf_expand(const hmac_sha256_midstate_t *prk,
+                        const librecipher_kdf_label_t *label) {
+  uint8_t t[32];
+  size_t offset = 0;
+  uint8_t counter = 1;
+
+  while (offset < label->output_len) {
+    sha256_ctx_t ctx = prk->inner;
+    if (counter > 1) {
+      sha256_update(&ctx, t, sizeof(t));
+    }
+    sha256_update(&ctx, label->info, label->info_len);
+    sha256_update(&ctx, &counter, 1);
+    sha256_final(&ctx, t);
+
+    ctx = prk->outer;
+    sha256_update(&ctx, t, sizeof(t));
+    sha256_final(&ctx, t);
+
+    size_t copy_len = label->output_len - offset;
+    if (copy_len > 32)
+      copy_len = 32;
+
+    memcpy(label->output + offset, t, copy_len);
+    offset += copy_len;
+    counter++;
+  }
+
+  librecipher_secure_zero(t, sizeof(t));
+}
+
 /**
  * Key Derivation (HKDF - RFC 5869)
  */
 void librecipher_kdf(const uint8_t *password, size_t password_len,
                      const uint8_t *salt, size_t salt_len, const uint8_t *info,
                      size_t info_len, uint8_t *output, size_t output_len) {
+  librecipher_kdf_label_t label = {info, info_len, output, output_len};
+  librecipher_kdf_multi(password, password_len, salt, salt_len, &label, 1);
+}
+
+/**
+ * HKDF com vários rótulos sobre um único Extract
+ */
+void librecipher_kdf_multi(const uint8_t *password, size_t password_len,
+                           const uint8_t *salt, size_t salt_len,
+                           const librecipher_kdf_label_t *labels,
+                           size_t label_count) {
   uint8_t prk[32]; // Pseudorandom key
-  uint8_t t[32];
-  size_t offset = 0;
-  uint8_t counter = 1;
+  hmac_sha256_midstate_t mid;
 
   // Extract: PRK = HMAC(salt, IKM)
   if (salt_len > 0) {
@@ -138,41 +261,15 @@ void librecipher_kdf(const uint8_t *password, size_t password_len,
     librecipher_hmac_sha256(zero_salt, 32, password, password_len, prk);
   }
 
-  // Expand
-  memset(t, 0, 32);
-
-  while (offset < output_len) {
-    sha256_ctx_t ctx;
-    uint8_t hmac_input[32 + 256 + 1]; // max size
-    size_t input_len = 0;
-
-    if (counter > 1) {
-      memcpy(hmac_input, t, 32);
-      input_len = 32;
-    }
-
-    if (info_len > 0) {
-      memcpy(hmac_input + input_len, info, info_len);
-      input_len += info_len;
-    }
-
-    hmac_input[input_len] = counter;
-    input_len++;
-
-    librecipher_hmac_sha256(prk, 32, hmac_input, input_len, t);
-
-    size_t copy_len = output_len - offset;
-    if (copy_len > 32)
-      copy_len = 32;
-
-    memcpy(output + offset, t, copy_len);
-    offset += copy_len;
-    counter++;
+  // Expand: midstates do PRK compartilhados por todos os rótulos
+  hmac_midstate_init(&mid, prk);
+  for (size_t i = 0; i < label_count; i++) {
+    hkdf_expand(&mid, &labels[i]);
   }
 
   // Clear sensitive data
   librecipher_secure_zero(prk, sizeof(prk));
-  librecipher_secure_zero(t, sizeof(t));
+  librecipher_secure_zero(&mid, sizeof(mid));
 }
 
 /**
@@ -230,3 +327,16 @@ bool librecipher_ed25519_verify(const uint8_t *signature,
                                 const uint8_t *public_key) {
   return ed25519_verify(signature, message, message_len, public_key);
 }
+
+// ============ X25519 Wrapper ============
+
+/**
+ * X25519 Diffie-Hellman
+ */
+bool librecipher_x25519(uint8_t *shared_secret, const uint8_t *secret_key,
+                        const uint8_t *peer_public_key) {
+  static const uint8_t zero[32] = {0};
+
+  x25519(shared_secret, secret_key, peer_public_key);
+  return !librecipher_secure_compare(shared_secret, zero, 32);
+}
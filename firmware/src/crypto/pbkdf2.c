@@ -0,0 +1,245 @@
+/**
+ * LibreCipher PBKDF2-HMAC-SHA512 / PBKDF2-HMAC-SHA256
+ *
+ * For iterations >= 2 the HMAC input U_{j-1} is always one digest long, so
+ * both the inner block (ipad midstate || U || padding) and the outer block
+ * (opad midstate || inner digest || padding) have a fixed layout. The
+ * state words of one compression are written straight into the message
+ * words of the next.
+ */
+
+#include "pbkdf2.h"
+#include "librecipher.h"
+#include "sha256.h"
+#include "sha512.h"
+#include <string.h>
+
+// Padding of a 64-byte message after one 128-byte key block
+#define PAD_WORD 0x8000000000000000ULL
+#define PAD_BITS ((SHA512_BLOCK_SIZE + SHA512_DIGEST_SIZE) * 8)
+
+// Same for SHA-256: 32-byte message after one 64-byte key block
+#define PAD_WORD_256 0x80000000UL
+#define PAD_BITS_256 ((SHA256_BLOCK_SIZE + SHA256_DIGEST_SIZE) * 8)
+
+typedef struct {
+  sha512_ctx_t inner; // After absorbing key ^ ipad
+  sha512_ctx_t outer; // After absorbing key ^ opad
+} hmac_sha512_midstate_t;
+
+static void hmac_midstate_init(hmac_sha512_midstate_t *mid,
+                               const uint8_t *key, size_t key_len) {
+  uint8_t k[SHA512_BLOCK_SIZE];
+  uint8_t pad[SHA512_BLOCK_SIZE];
+
+  memset(k, 0, sizeof(k));
+  if (key_len > SHA512_BLOCK_SIZE) {
+    sha512_hash(key, key_len, k);
+  } else if (key_len > 0) {
+    memcpy(k, key, key_len);
+  }
+
+  for (int i = 0; i < SHA512_BLOCK_SIZE; i++) {
+    pad[i] = k[i] ^ 0x36;
+  }
+  sha512_init(&mid->inner);
+  sha512_update(&mid->inner, pad, sizeof(pad));
+
+  for (int i = 0; i < SHA512_BLOCK_SIZE; i++) {
+    pad[i] = k[i] ^ 0x5c;
+  }
+  sha512_init(&mid->outer);
+  sha512_update(&mid->outer, pad, sizeof(pad));
+
+  librecipher_secure_zero(k, sizeof(k));
+  librecipher_secure_zero(pad, sizeof(pad));
+}
+
+// U_1 = HMAC(P, S || INT(i)), returned as state words
+static void pbkdf2_first(const hmac_sha512_midstate_t *mid,
+                         const uint8_t *salt, size_t salt_len,
+                         uint32_t block_index, uint64_t u[8]) {
+  sha512_ctx_t ctx;
+  uint8_t digest[SHA512_DIGEST_SIZE];
+  uint8_t index[4] = {(uint8_t)(block_index >> 24),
+                      (uint8_t)(block_index >> 16),
+                      (uint8_t)(block_index >> 8), (uint8_t)block_index};
+
+  memcpy(&ctx, &mid->inner, sizeof(ctx));
+  sha512_update(&ctx, salt, salt_len);
+  sha512_update(&ctx, index, sizeof(index));
+  sha512_final(&ctx, digest);
+
+  memcpy(&ctx, &mid->outer, sizeof(ctx));
+  sha512_update(&ctx, digest, sizeof(digest));
+  sha512_final(&ctx, digest);
+
+  for (int i = 0; i < 8; i++) {
+    u[i] = 0;
+    for (int j = 0; j < 8; j++) {
+      u[i] = (u[i] << 8) | digest[8 * i + j];
+    }
+  }
+  librecipher_secure_zero(&ctx, sizeof(ctx));
+  librecipher_secure_zero(digest, sizeof(digest));
+}
+
+void pbkdf2_hmac_sha512(const uint8_t *password, size_t password_len,
+                        const uint8_t *salt, size_t salt_len,
+                        uint32_t iterations, uint8_t *out, size_t out_len) {
+  hmac_sha512_midstate_t mid;
+  uint64_t u[8];
+  uint64_t t[8];
+  uint64_t w[16];
+
+  hmac_midstate_init(&mid, password, password_len);
+
+  for (uint32_t block = 1; out_len > 0; block++) {
+    pbkdf2_first(&mid, salt, salt_len, block, u);
+    memcpy(t, u, sizeof(t));
+
+    for (uint32_t j = 1; j < iterations; j++) {
+      // Inner: H(ipad || U); u receives the inner digest words
+      w[0] = u[0], w[1] = u[1], w[2] = u[2], w[3] = u[3];
+      w[4] = u[4], w[5] = u[5], w[6] = u[6], w[7] = u[7];
+      w[8] = PAD_WORD;
+      w[9] = w[10] = w[11] = w[12] = w[13] = w[14] = 0;
+      w[15] = PAD_BITS;
+      memcpy(u, mid.inner.state, sizeof(u));
+      sha512_compress(u, w);
+
+      // Outer: H(opad || inner)
+      w[0] = u[0], w[1] = u[1], w[2] = u[2], w[3] = u[3];
+      w[4] = u[4], w[5] = u[5], w[6] = u[6], w[7] = u[7];
+      w[8] = PAD_WORD;
+      w[9] = w[10] = w[11] = w[12] = w[13] = w[14] = 0;
+      w[15] = PAD_BITS;
+      memcpy(u, mid.outer.state, sizeof(u));
+      sha512_compress(u, w);
+
+      for (int i = 0; i < 8; i++) {
+        t[i] ^= u[i];
+      }
+    }
+
+    // T_block, big-endian, truncated on the last block
+    size_t n = out_len < SHA512_DIGEST_SIZE ? out_len : SHA512_DIGEST_SIZE;
+    for (size_t i = 0; i < n; i++) {
+      out[i] = (uint8_t)(t[i / 8] >> (56 - 8 * (i % 8)));
+    }
+    out += n;
+    out_len -= n;
+  }
+
+  librecipher_secure_zero(&mid, sizeof(mid));
+  librecipher_secure_zero(u, sizeof(u));
+  librecipher_secure_zero(t, sizeof(t));
+  librecipher_secure_zero(w, sizeof(w));
+}
+
+// ============ PBKDF2-HMAC-SHA256 ============
+
+typedef struct {
+  sha256_ctx_t inner;
+  sha256_ctx_t outer;
+} hmac_sha256_midstate_t;
+
+static void hmac256_midstate_init(hmac_sha256_midstate_t *mid,
+                                  const uint8_t *key, size_t key_len) {
+  uint8_t k[SHA256_BLOCK_SIZE];
+  uint8_t pad[SHA256_BLOCK_SIZE];
+
+  memset(k, 0, sizeof(k));
+  if (key_len > SHA256_BLOCK_SIZE) {
+    sha256_hash(key, key_len, k);
+  } else if (key_len > 0) {
+    memcpy(k, key, key_len);
+  }
+
+  for (int i = 0; i < SHA256_BLOCK_SIZE; i++) {
+    pad[i] = k[i] ^ 0x36;
+  }
+  sha256_init(&mid->inner);
+  sha256_update(&mid->inner, pad, sizeof(pad));
+
+  for (int i = 0; i < SHA256_BLOCK_SIZE; i++) {
+    pad[i] = k[i] ^ 0x5c;
+  }
+  sha256_init(&mid->outer);
+  sha256_update(&mid->outer, pad, sizeof(pad));
+
+  librecipher_secure_zero(k, sizeof(k));
+  librecipher_secure_zero(pad, sizeof(pad));
+}
+
+static void pbkdf2_first256(const hmac_sha256_midstate_t *mid,
+                            const uint8_t *salt, size_t salt_len,
+                            uint32_t block_index, uint32_t u[8]) {
+  sha256_ctx_t ctx;
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  uint8_t index[4] = {(uint8_t)(block_index >> 24),
+                      (uint8_t)(block_index >> 16),
+                      (uint8_t)(block_index >> 8), (uint8_t)block_index};
+
+  memcpy(&ctx, &mid->inner, sizeof(ctx));
+  sha256_update(&ctx, salt, salt_len);
+  sha256_update(&ctx, index, sizeof(index));
+  sha256_final(&ctx, digest);
+
+  memcpy(&ctx, &mid->outer, sizeof(ctx));
+  sha256_update(&ctx, digest, sizeof(digest));
+  sha256_final(&ctx, digest);
+
+  for (int i = 0; i < 8; i++) {
+    u[i] = ((uint32_t)digest[4 * i] << 24) |
+           ((uint32_t)digest[4 * i + 1] << 16) |
+           ((uint32_t)digest[4 * i + 2] << 8) | digest[4 * i + 3];
+  }
+  librecipher_secure_zero(&ctx, sizeof(ctx));
+  librecipher_secure_zero(digest, sizeof(digest));
+}
+
+void pbkdf2_hmac_sha256(const uint8_t *password, size_t password_len,
+                        const uint8_t *salt, size_t salt_len,
+                        uint32_t iterations, uint8_t *out, size_t out_len) {
+  hmac_sha256_midstate_t mid;
+  uint32_t u[8];
+  uint32_t t[8];
+  uint32_t w[16];
+
+  hmac256_midstate_init(&mid, password, password_len);
+
+  for (uint32_t block = 1; out_len > 0; block++) {
+    pbkdf2_first256(&mid, salt, salt_len, block, u);
+    memcpy(t, u, sizeof(t));
+
+    for (uint32_t j = 1; j < iterations; j++) {
+      memcpy(w, u, sizeof(u));
+      w[8] = PAD_WORD_256;
+      w[9] = w[10] = w[11] = w[12] = w[13] = w[14] = 0;
+      w[15] = PAD_BITS_256;
+      memcpy(u, mid.inner.state, sizeof(u));
+      sha256_compress(u, w);
+
+      memcpy(w, u, sizeof(u));
+      memcpy(u, mid.outer.state, sizeof(u));
+      sha256_compress(u, w);
+
+      for (int i = 0; i < 8; i++) {
+        t[i] ^= u[i];
+      }
+    }
+
+    size_t n = out_len < SHA256_DIGEST_SIZE ? out_len : SHA256_DIGEST_SIZE;
+    for (size_t i = 0; i < n; i++) {
+      out[i] = (uint8_t)(t[i / 4] >> (24 - 8 * (i % 4)));
+    }
+    out += n;
+    out_len -= n;
+  }
+
+  librecipher_secure_zero(&mid, sizeof(mid));
+  librecipher_secure_zero(u, sizeof(u));
+  librecipher_secure_zero(t, sizeof(t));
+  librecipher_secure_zero(w, sizeof(w));
+}
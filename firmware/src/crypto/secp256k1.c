@@ -0,0 +1,1041 @@
+/**
+ * secp256k1 ECDSA Implementation
+ *
+ * Field p = 2^256 - 2^32 - 977, group order n, curve y^2 = x^3 + 7.
+ * Field and scalar elements are 8 x 32-bit little-endian limbs.
+ *
+ * Signing uses complete projective addition (Renes-Costello-Batina,
+ * Algorithm 8) over a fixed-window table of j * 16^i * G, so k*G has no
+ * secret-dependent branches or memory accesses. Verification handles only
+ * public data and uses the GLV endomorphism with interleaved wNAF.
+ */
+
+#include "secp256k1.h"
+#include "librecipher.h"
+#include <string.h>
+
+typedef uint32_t fp_t[8]; // Field element, < 2^256 (partially reduced)
+typedef uint32_t sc_t[8]; // Scalar, fully reduced mod n
+
+// Affine point
+typedef struct {
+  fp_t x;
+  fp_t y;
+} ge_t;
+
+// Jacobian point (x = X/Z^2, y = Y/Z^3), variable-time verification only
+typedef struct {
+  fp_t x;
+  fp_t y;
+  fp_t z;
+  int infinity;
+} gej_t;
+
+// Homogeneous projective point (x = X/Z, y = Y/Z), infinity = (0 : 1 : 0)
+typedef struct {
+  fp_t x;
+  fp_t y;
+  fp_t z;
+} gep_t;
+
+// Precomputed tables (tools/gen_secp256k1_tables.py, resident in flash)
+// gen_table[i][j - 1] = j * 16^i * G; gen_odd[i] = (2i + 1) * G
+extern const uint32_t secp256k1_gen_table[64][15][16];
+extern const uint32_t secp256k1_gen_odd[64][16];
+
+#define WNAF_G_WIDTH 8 // Flash table: 64 odd multiples of G
+#define WNAF_Q_WIDTH 5 // Runtime table: 8 odd multiples of Q
+#define WNAF_LEN 130   // GLV halves are < 2^128, plus carry
+
+// p - 2 and (p + 1) / 4, big-endian exponents
+static const uint8_t P_MINUS_2[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF, 0xFC, 0x2D};
+static const uint8_t P_SQRT_EXP[32] = {
+    0x3F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xBF, 0xFF, 0xFF, 0x0C};
+
+// n - 2, big-endian exponent
+static const uint8_t N_MINUS_2[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xBA, 0xAE, 0xDC, 0xE6, 0xAF, 0x48,
+    0xA0, 0x3B, 0xBF, 0xD2, 0x5E, 0x8C, 0xD0, 0x36, 0x41, 0x3F};
+
+// Group order n, 2^256 - n and n / 2
+static const sc_t N = {0xD0364141, 0xBFD25E8C, 0xAF48A03B, 0xBAAEDCE6,
+                       0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF};
+static const uint32_t N_C[5] = {0x2FC9BEBF, 0x402DA173, 0x50B75FC4,
+                                0x45512319, 0x00000001};
+static const sc_t P_MINUS_N = {0x2FC9BAEE, 0x402DA172, 0x50B75FC4,
+                               0x45512319, 0x00000001, 0x00000000,
+                               0x00000000, 0x00000000};
+static const sc_t N_HALF = {0x681B20A0, 0xDFE92F46, 0x57A4501D, 0x5D576E73,
+                            0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x7FFFFFFF};
+
+// GLV: lambda * (x, y) = (beta * x, y)
+static const fp_t BETA = {0x719501EE, 0xC1396C28, 0x12F58995, 0x9CF04975,
+                          0xAC3434E9, 0x6E64479E, 0x657C0710, 0x7AE96A2B};
+static const sc_t MINUS_LAMBDA = {0xB51283CF, 0xE0CFC810, 0x8EC739C2,
+                                  0xA880B9FC, 0x77ED9BA4, 0x5AD9E3FD,
+                                  0x3FA3CF1F, 0xAC9C52B3};
+static const sc_t MINUS_B1 = {0x0ABFE4C3, 0x6F547FA9, 0x010E8828,
+                              0xE4437ED6, 0x00000000, 0x00000000,
+                              0x00000000, 0x00000000};
+static const sc_t MINUS_B2 = {0x3DB1562C, 0xD765CDA8, 0x0774346D,
+                              0x8A280AC5, 0xFFFFFFFE, 0xFFFFFFFF,
+                              0xFFFFFFFF, 0xFFFFFFFF};
+static const sc_t G1 = {0x45DBB031, 0xE893209A, 0x71E8CA7F, 0x3DAA8A14,
+                        0x9284EB15, 0xE86C90E4, 0xA7D46BCD, 0x3086D221};
+static const sc_t G2 = {0x8AC47F71, 0x1571B4AE, 0x9DF506C6, 0x221208AC,
+                        0x0ABFE4C4, 0x6F547FA9, 0x010E8828, 0xE4437ED6};
+
+// ============ Multi-precision Helpers ============
+
+// r[0..rn) += a[0..an) * b[0..bn); the caller sizes rn so nothing is lost
+static void mp_mul_add(uint32_t *r, size_t rn, const uint32_t *a, size_t an,
+                       const uint32_t *b, size_t bn) {
+  for (size_t i = 0; i < an; i++) {
+    uint64_t c = 0;
+    size_t j;
+    for (j = 0; j < bn; j++) {
+      c += (uint64_t)a[i] * b[j] + r[i + j];
+      r[i + j] = (uint32_t)c;
+      c >>= 32;
+    }
+    for (j = i + bn; j < rn; j++) {
+      c += r[j];
+      r[j] = (uint32_t)c;
+      c >>= 32;
+    }
+  }
+}
+
+// Constant-time select: r = flag ? a : r (flag is 0 or 1)
+static void mp_cmov(uint32_t *r, const uint32_t *a, size_t n, uint32_t flag) {
+  uint32_t mask = 0 - flag;
+  for (size_t i = 0; i < n; i++)
+    r[i] = (r[i] & ~mask) | (a[i] & mask);
+}
+
+static void mp_from_bytes(uint32_t r[8], const uint8_t b[32]) {
+  for (int i = 0; i < 8; i++) {
+    const uint8_t *w = b + 28 - 4 * i;
+    r[i] = ((uint32_t)w[0] << 24) | ((uint32_t)w[1] << 16) |
+           ((uint32_t)w[2] << 8) | (uint32_t)w[3];
+  }
+}
+
+static void mp_to_bytes(uint8_t b[32], const uint32_t r[8]) {
+  for (int i = 0; i < 8; i++) {
+    uint8_t *w = b + 28 - 4 * i;
+    w[0] = (uint8_t)(r[i] >> 24);
+    w[1] = (uint8_t)(r[i] >> 16);
+    w[2] = (uint8_t)(r[i] >> 8);
+    w[3] = (uint8_t)r[i];
+  }
+}
+
+// Borrow of a - b (1 if a < b), constant-time
+static uint32_t mp_lt(const uint32_t a[8], const uint32_t b[8]) {
+  int64_t c = 0;
+  for (int i = 0; i < 8; i++) {
+    c += (int64_t)a[i] - b[i];
+    c >>= 32;
+  }
+  return (uint32_t)(c & 1);
+}
+
+static uint32_t mp_is_zero(const uint32_t a[8]) {
+  uint32_t acc = 0;
+  for (int i = 0; i < 8; i++)
+    acc |= a[i];
+  return ((acc | (0 - acc)) >> 31) ^ 1;
+}
+
+// r = a^e for a fixed public exponent (4-bit fixed window)
+typedef void (*mp_mul_fn)(uint32_t r[8], const uint32_t a[8],
+                          const uint32_t b[8]);
+
+static void mp_pow(uint32_t r[8], const uint32_t a[8], const uint8_t e[32],
+                   const uint32_t one[8], mp_mul_fn mul) {
+  uint32_t table[16][8];
+  uint32_t acc[8];
+
+  memcpy(table[0], one, 32);
+  memcpy(table[1], a, 32);
+  for (int i = 2; i < 16; i++)
+    mul(table[i], table[i - 1], a);
+
+  memcpy(acc, one, 32);
+  for (int i = 0; i < 64; i++) {
+    for (int j = 0; j < 4; j++)
+      mul(acc, acc, acc);
+    uint8_t digit = (i & 1) ? (e[i >> 1] & 0x0f) : (e[i >> 1] >> 4);
+    mul(acc, acc, table[digit]);
+  }
+
+  memcpy(r, acc, 32);
+  librecipher_secure_zero(table, sizeof(table));
+  librecipher_secure_zero(acc, sizeof(acc));
+}
+
+// ============ Field Arithmetic (mod p) ============
+
+static const fp_t FP_ONE = {1, 0, 0, 0, 0, 0, 0, 0};
+
+// r += carry * 2^256 = carry * (2^32 + 977), carry < 2^44
+static void fp_fold(fp_t r, uint64_t carry) {
+  uint64_t c = (uint64_t)r[0] + carry * 977;
+  r[0] = (uint32_t)c;
+  c >>= 32;
+  c += (uint64_t)r[1] + carry;
+  r[1] = (uint32_t)c;
+  c >>= 32;
+  for (int i = 2; i < 8; i++) {
+    c += r[i];
+    r[i] = (uint32_t)c;
+    c >>= 32;
+  }
+
+  // A second wrap leaves r < 2^80, so this cannot carry past limb 2
+  uint64_t d = (uint64_t)r[0] + c * 977;
+  r[0] = (uint32_t)d;
+  d >>= 32;
+  d += (uint64_t)r[1] + c;
+  r[1] = (uint32_t)d;
+  d >>= 32;
+  r[2] += (uint32_t)d;
+}
+
+static void fp_add(fp_t r, const fp_t a, const fp_t b) {
+  uint64_t c = 0;
+  for (int i = 0; i < 8; i++) {
+    c += (uint64_t)a[i] + b[i];
+    r[i] = (uint32_t)c;
+    c >>= 32;
+  }
+  fp_fold(r, c);
+}
+
+static void fp_sub(fp_t r, const fp_t a, const fp_t b) {
+  int64_t c = 0;
+  for (int i = 0; i < 8; i++) {
+    c += (int64_t)a[i] - b[i];
+    r[i] = (uint32_t)c;
+    c >>= 32;
+  }
+
+  // A borrow added 2^256 = 2^32 + 977: take it back out, at most twice
+  uint32_t borrow = (uint32_t)(c & 1);
+  for (int pass = 0; pass < 2; pass++) {
+    c = (int64_t)r[0] - (int64_t)borrow * 977;
+    r[0] = (uint32_t)c;
+    c >>= 32;
+    c += (int64_t)r[1] - borrow;
+    r[1] = (uint32_t)c;
+    c >>= 32;
+    for (int i = 2; i < 8; i++) {
+      c += r[i];
+      r[i] = (uint32_t)c;
+      c >>= 32;
+    }
+    borrow = (uint32_t)(c & 1);
+  }
+}
+
+static void fp_neg(fp_t r, const fp_t a) {
+  static const fp_t zero = {0};
+  fp_sub(r, zero, a);
+}
+
+static void fp_mul(fp_t r, const fp_t a, const fp_t b) {
+  uint32_t t[16] = {0};
+
+  mp_mul_add(t, 16, a, 8, b, 8);
+
+  // r = lo + hi * (2^32 + 977)
+  uint64_t c = 0;
+  for (int i = 0; i < 8; i++) {
+    c += (uint64_t)t[i] + (uint64_t)t[8 + i] * 977 + (i ? t[7 + i] : 0);
+    r[i] = (uint32_t)c;
+    c >>= 32;
+  }
+  c += t[15];
+  fp_fold(r, c);
+}
+
+static void fp_sq(fp_t r, const fp_t a) { fp_mul(r, a, a); }
+
+// r = a * k for a small constant k (< 2^10)
+static void fp_mul_int(fp_t r, const fp_t a, uint32_t k) {
+  uint64_t c = 0;
+  for (int i = 0; i < 8; i++) {
+    c += (uint64_t)a[i] * k;
+    r[i] = (uint32_t)c;
+    c >>= 32;
+  }
+  fp_fold(r, c);
+}
+
+// Fully reduce into [0, p)
+static void fp_normalize(fp_t r) {
+  fp_t t;
+  uint64_t c = (uint64_t)r[0] + 977;
+  t[0] = (uint32_t)c;
+  c >>= 32;
+  c += (uint64_t)r[1] + 1;
+  t[1] = (uint32_t)c;
+  c >>= 32;
+  for (int i = 2; i < 8; i++) {
+    c += r[i];
+    t[i] = (uint32_t)c;
+    c >>= 32;
+  }
+  // Carry out of r + 2^256 - p means r >= p
+  mp_cmov(r, t, 8, (uint32_t)c);
+}
+
+static bool fp_is_zero(const fp_t a) {
+  fp_t t;
+  memcpy(t, a, sizeof(t));
+  fp_normalize(t);
+  return mp_is_zero(t);
+}
+
+static bool fp_equal(const fp_t a, const fp_t b) {
+  fp_t t;
+  fp_sub(t, a, b);
+  return fp_is_zero(t);
+}
+
+static void fp_invert(fp_t r, const fp_t a) {
+  mp_pow(r, a, P_MINUS_2, FP_ONE, fp_mul);
+}
+
+// Square root (p = 3 mod 4); returns false if a is not a square
+static bool fp_sqrt(fp_t r, const fp_t a) {
+  fp_t check;
+  mp_pow(r, a, P_SQRT_EXP, FP_ONE, fp_mul);
+  fp_sq(check, r);
+  return fp_equal(check, a);
+}
+
+static void fp_to_bytes(uint8_t b[32], const fp_t a) {
+  fp_t t;
+  memcpy(t, a, sizeof(t));
+  fp_normalize(t);
+  mp_to_bytes(b, t);
+}
+
+// Decode a canonical field element; returns false if >= p
+static bool fp_from_bytes(fp_t r, const uint8_t b[32]) {
+  fp_t t;
+  mp_from_bytes(r, b);
+  memcpy(t, r, sizeof(t));
+  fp_normalize(t);
+  return memcmp(t, r, sizeof(t)) == 0;
+}
+
+// ============ Scalar Arithmetic (mod n) ============
+
+static const sc_t SC_ONE = {1, 0, 0, 0, 0, 0, 0, 0};
+
+// Subtract n once if r (with carry bit hi) >= n, constant-time
+static void sc_reduce_once(sc_t r, uint32_t hi) {
+  sc_t t;
+  uint64_t c = 0;
+  for (int i = 0; i < 8; i++) {
+    c += (uint64_t)r[i] + (i < 5 ? N_C[i] : 0);
+    t[i] = (uint32_t)c;
+    c >>= 32;
+  }
+  mp_cmov(r, t, 8, (uint32_t)c | hi);
+}
+
+// Decode big-endian scalar, reducing mod n; returns true on overflow
+static bool sc_from_bytes(sc_t r, const uint8_t b[32]) {
+  mp_from_bytes(r, b);
+  uint32_t overflow = mp_lt(r, N) ^ 1;
+  sc_reduce_once(r, 0);
+  return overflow;
+}
+
+static void sc_add(sc_t r, const sc_t a, const sc_t b) {
+  uint64_t c = 0;
+  for (int i = 0; i < 8; i++) {
+    c += (uint64_t)a[i] + b[i];
+    r[i] = (uint32_t)c;
+    c >>= 32;
+  }
+  sc_reduce_once(r, (uint32_t)c);
+}
+
+// Reduce a 512-bit value mod n using 2^256 = N_C (mod n)
+static void sc_reduce512(sc_t r, const uint32_t t[16]) {
+  uint32_t m[13] = {0};
+  uint32_t q[9] = {0};
+
+  // m = t_lo + t_hi * N_C (< 2^386)
+  memcpy(m, t, 32);
+  mp_mul_add(m, 13, t + 8, 8, N_C, 5);
+
+  // q = m_lo + m_hi * N_C (< 2^260)
+  memcpy(q, m, 32);
+  mp_mul_add(q, 9, m + 8, 5, N_C, 5);
+
+  // r = q_lo + q_hi * N_C (< 2^256 + 2^133)
+  uint64_t c = 0;
+  uint64_t hi = q[8];
+  for (int i = 0; i < 8; i++) {
+    c += (uint64_t)q[i] + (i < 5 ? hi * N_C[i] : 0);
+    r[i] = (uint32_t)c;
+    c >>= 32;
+  }
+  sc_reduce_once(r, (uint32_t)c);
+  librecipher_secure_zero(m, sizeof(m));
+  librecipher_secure_zero(q, sizeof(q));
+}
+
+static void sc_mul(sc_t r, const sc_t a, const sc_t b) {
+  uint32_t t[16] = {0};
+  mp_mul_add(t, 16, a, 8, b, 8);
+  sc_reduce512(r, t);
+  librecipher_secure_zero(t, sizeof(t));
+}
+
+// Constant-time inverse (Fermat, fixed exponent n - 2)
+static void sc_invert(sc_t r, const sc_t a) {
+  mp_pow(r, a, N_MINUS_2, SC_ONE, sc_mul);
+}
+
+static void sc_negate(sc_t r, const sc_t a) {
+  sc_t t;
+  int64_t c = 0;
+  for (int i = 0; i < 8; i++) {
+    c += (int64_t)N[i] - a[i];
+    t[i] = (uint32_t)c;
+    c >>= 32;
+  }
+  // -0 = 0
+  uint32_t nonzero = mp_is_zero(a) ^ 1;
+  memset(r, 0, 32);
+  mp_cmov(r, t, 8, nonzero);
+}
+
+static uint32_t sc_is_high(const sc_t a) { return mp_lt(N_HALF, a); }
+
+// r = round(a * b / 2^384), used by the GLV split (variable-time is fine)
+static void sc_mul_shift_384(sc_t r, const sc_t a, const sc_t b) {
+  uint32_t t[16] = {0};
+  mp_mul_add(t, 16, a, 8, b, 8);
+
+  uint64_t c = (t[11] >> 31) & 1;
+  for (int i = 0; i < 8; i++) {
+    c += i < 4 ? t[12 + i] : 0;
+    r[i] = (uint32_t)c;
+    c >>= 32;
+  }
+}
+
+// Split k = k1 + k2 * lambda (mod n) with |k1|, |k2| < 2^128.
+// k1, k2 are returned as magnitudes; neg1/neg2 flag negative halves.
+static void sc_split_lambda(sc_t k1, int *neg1, sc_t k2, int *neg2,
+                            const sc_t k) {
+  sc_t c1, c2;
+
+  sc_mul_shift_384(c1, k, G1);
+  sc_mul_shift_384(c2, k, G2);
+  sc_mul(c1, c1, MINUS_B1);
+  sc_mul(c2, c2, MINUS_B2);
+  sc_add(k2, c1, c2);
+  sc_mul(k1, k2, MINUS_LAMBDA);
+  sc_add(k1, k1, k);
+
+  *neg1 = (int)sc_is_high(k1);
+  if (*neg1)
+    sc_negate(k1, k1);
+  *neg2 = (int)sc_is_high(k2);
+  if (*neg2)
+    sc_negate(k2, k2);
+}
+
+// ============ Group Operations ============
+
+static void ge_from_table(ge_t *r, const uint32_t entry[16]) {
+  memcpy(r->x, entry, 32);
+  memcpy(r->y, entry + 8, 32);
+}
+
+static bool ge_is_valid(const ge_t *a) {
+  fp_t lhs, rhs;
+  fp_sq(lhs, a->y);
+  fp_sq(rhs, a->x);
+  fp_mul(rhs, rhs, a->x);
+  fp_add(rhs, rhs, (const fp_t){7});
+  return fp_equal(lhs, rhs);
+}
+
+// Complete mixed addition r = p + q, q affine (RCB 2016, Algorithm 8)
+static void gep_add_ge(gep_t *r, const gep_t *p, const ge_t *q) {
+  fp_t t0, t1, t2, t3, t4, x3, y3, z3;
+
+  fp_mul(t0, p->x, q->x);
+  fp_mul(t1, p->y, q->y);
+  fp_add(t3, q->x, q->y);
+  fp_add(t4, p->x, p->y);
+  fp_mul(t3, t3, t4);
+  fp_add(t4, t0, t1);
+  fp_sub(t3, t3, t4);
+  fp_mul(t4, q->y, p->z);
+  fp_add(t4, t4, p->y);
+  fp_mul(y3, q->x, p->z);
+  fp_add(y3, y3, p->x);
+  fp_add(x3, t0, t0);
+  fp_add(t0, x3, t0);
+  fp_mul_int(t2, p->z, 21); // b3 = 3 * 7
+  fp_add(z3, t1, t2);
+  fp_sub(t1, t1, t2);
+  fp_mul_int(y3, y3, 21);
+  fp_mul(x3, t4, y3);
+  fp_mul(t2, t3, t1);
+  fp_sub(x3, t2, x3);
+  fp_mul(y3, y3, t0);
+  fp_mul(t1, t1, z3);
+  fp_add(y3, t1, y3);
+  fp_mul(t0, t0, t3);
+  fp_mul(z3, z3, t4);
+  fp_add(z3, z3, t0);
+
+  memcpy(r->x, x3, sizeof(x3));
+  memcpy(r->y, y3, sizeof(y3));
+  memcpy(r->z, z3, sizeof(z3));
+}
+
+// r = k * G, constant-time: one complete addition per 4-bit window and a
+// full scan of the window's 15 table entries
+static void ecmult_gen(gep_t *r, const sc_t k) {
+  ge_t sel;
+  gep_t t;
+
+  memset(r, 0, sizeof(*r));
+  r->y[0] = 1;
+
+  for (int i = 0; i < 64; i++) {
+    uint32_t digit = (k[i >> 3] >> (4 * (i & 7))) & 0x0f;
+
+    ge_from_table(&sel, secp256k1_gen_table[i][0]);
+    for (uint32_t j = 2; j <= 15; j++) {
+      uint32_t diff = j ^ digit;
+      uint32_t eq = ((diff | (0 - diff)) >> 31) ^ 1;
+      mp_cmov(sel.x, secp256k1_gen_table[i][j - 1], 8, eq);
+      mp_cmov(sel.y, secp256k1_gen_table[i][j - 1] + 8, 8, eq);
+    }
+
+    gep_add_ge(&t, r, &sel);
+    uint32_t nonzero = ((digit | (0 - digit)) >> 31);
+    mp_cmov(r->x, t.x, 8, nonzero);
+    mp_cmov(r->y, t.y, 8, nonzero);
+    mp_cmov(r->z, t.z, 8, nonzero);
+  }
+
+  librecipher_secure_zero(&sel, sizeof(sel));
+  librecipher_secure_zero(&t, sizeof(t));
+}
+
+static void gep_to_ge(ge_t *r, const gep_t *p) {
+  fp_t zi;
+  fp_invert(zi, p->z);
+  fp_mul(r->x, p->x, zi);
+  fp_mul(r->y, p->y, zi);
+  fp_normalize(r->x);
+  fp_normalize(r->y);
+}
+
+static void gej_set_ge(gej_t *r, const ge_t *a) {
+  memcpy(r->x, a->x, sizeof(fp_t));
+  memcpy(r->y, a->y, sizeof(fp_t));
+  memcpy(r->z, FP_ONE, sizeof(fp_t));
+  r->infinity = 0;
+}
+
+// r = 2a (dbl-2009-l, a = 0)
+static void gej_double(gej_t *r, const gej_t *a) {
+  fp_t A, B, C, D, E, F, t;
+
+  if (a->infinity) {
+    r->infinity = 1;
+    return;
+  }
+
+  fp_sq(A, a->x);
+  fp_sq(B, a->y);
+  fp_sq(C, B);
+  fp_add(t, a->x, B);
+  fp_sq(t, t);
+  fp_sub(t, t, A);
+  fp_sub(t, t, C);
+  fp_add(D, t, t);
+  fp_mul_int(E, A, 3);
+  fp_sq(F, E);
+
+  fp_mul(r->z, a->y, a->z);
+  fp_add(r->z, r->z, r->z);
+  fp_sub(r->x, F, D);
+  fp_sub(r->x, r->x, D);
+  fp_sub(t, D, r->x);
+  fp_mul(t, E, t);
+  fp_mul_int(C, C, 8);
+  fp_sub(r->y, t, C);
+  r->infinity = 0;
+}
+
+// r = a + b with b in Jacobian coordinates (variable-time)
+static void gej_add(gej_t *r, const gej_t *a, const gej_t *b) {
+  fp_t z1z1, z2z2, u1, u2, s1, s2, h, rr, hh, hhh, v, t;
+
+  if (a->infinity) {
+    *r = *b;
+    return;
+  }
+  if (b->infinity) {
+    *r = *a;
+    return;
+  }
+
+  fp_sq(z1z1, a->z);
+  fp_sq(z2z2, b->z);
+  fp_mul(u1, a->x, z2z2);
+  fp_mul(u2, b->x, z1z1);
+  fp_mul(s1, a->y, b->z);
+  fp_mul(s1, s1, z2z2);
+  fp_mul(s2, b->y, a->z);
+  fp_mul(s2, s2, z1z1);
+  fp_sub(h, u2, u1);
+  fp_sub(rr, s2, s1);
+
+  if (fp_is_zero(h)) {
+    if (fp_is_zero(rr)) {
+      gej_double(r, a);
+    } else {
+      r->infinity = 1;
+    }
+    return;
+  }
+
+  fp_sq(hh, h);
+  fp_mul(hhh, h, hh);
+  fp_mul(v, u1, hh);
+  fp_mul(t, a->z, b->z);
+  fp_mul(r->z, t, h);
+  fp_sq(r->x, rr);
+  fp_sub(r->x, r->x, hhh);
+  fp_sub(r->x, r->x, v);
+  fp_sub(r->x, r->x, v);
+  fp_sub(t, v, r->x);
+  fp_mul(t, rr, t);
+  fp_mul(s1, s1, hhh);
+  fp_sub(r->y, t, s1);
+  r->infinity = 0;
+}
+
+// r = a + b with b affine (variable-time)
+static void gej_add_ge(gej_t *r, const gej_t *a, const ge_t *b) {
+  fp_t z1z1, u2, s2, h, rr, hh, hhh, v, t;
+
+  if (a->infinity) {
+    gej_set_ge(r, b);
+    return;
+  }
+
+  fp_sq(z1z1, a->z);
+  fp_mul(u2, b->x, z1z1);
+  fp_mul(s2, b->y, a->z);
+  fp_mul(s2, s2, z1z1);
+  fp_sub(h, u2, a->x);
+  fp_sub(rr, s2, a->y);
+
+  if (fp_is_zero(h)) {
+    if (fp_is_zero(rr)) {
+      gej_double(r, a);
+    } else {
+      r->infinity = 1;
+    }
+    return;
+  }
+
+  fp_sq(hh, h);
+  fp_mul(hhh, h, hh);
+  fp_mul(v, a->x, hh);
+  fp_mul(r->z, a->z, h);
+  fp_mul(t, a->y, hhh);
+  fp_sq(r->x, rr);
+  fp_sub(r->x, r->x, hhh);
+  fp_sub(r->x, r->x, v);
+  fp_sub(r->x, r->x, v);
+  fp_sub(v, v, r->x);
+  fp_mul(v, rr, v);
+  fp_sub(r->y, v, t);
+  r->infinity = 0;
+}
+
+// ============ wNAF (verification only) ============
+
+static uint32_t sc_get_bits(const sc_t a, int offset, int count) {
+  int limb = offset >> 5;
+  int shift = offset & 31;
+  uint64_t w = a[limb];
+  if (limb + 1 < 8)
+    w |= (uint64_t)a[limb + 1] << 32;
+  return (uint32_t)(w >> shift) & ((1u << count) - 1);
+}
+
+// Width-w NAF of a (< 2^(WNAF_LEN - 1)); digits are odd or zero
+static void sc_wnaf(int8_t wnaf[WNAF_LEN], const sc_t a, int w) {
+  int carry = 0;
+  int bit = 0;
+
+  memset(wnaf, 0, WNAF_LEN);
+  while (bit < WNAF_LEN) {
+    if ((int)sc_get_bits(a, bit, 1) == carry) {
+      bit++;
+      continue;
+    }
+
+    int now = w;
+    if (now > WNAF_LEN - bit)
+      now = WNAF_LEN - bit;
+
+    int word = (int)sc_get_bits(a, bit, now) + carry;
+    carry = (word >> (w - 1)) & 1;
+    word -= carry << w;
+    wnaf[bit] = (int8_t)word;
+    bit += now;
+  }
+}
+
+// ============ ECDSA ============
+
+// RFC 6979 section 3.2 nonce generation (HMAC-SHA256)
+static bool rfc6979_nonce(sc_t k, const uint8_t secret_key[32],
+                          const uint8_t hash[32]) {
+  uint8_t v[32];
+  uint8_t key[32];
+  uint8_t buf[32 + 1 + 32 + 32];
+  uint8_t h1[32];
+  sc_t e;
+
+  // bits2octets(h1) = (h1 mod n)
+  sc_from_bytes(e, hash);
+  mp_to_bytes(h1, e);
+
+  memset(v, 0x01, sizeof(v));
+  memset(key, 0x00, sizeof(key));
+
+  for (uint8_t round = 0; round < 2; round++) {
+    memcpy(buf, v, 32);
+    buf[32] = round;
+    memcpy(buf + 33, secret_key, 32);
+    memcpy(buf + 65, h1, 32);
+    librecipher_hmac_sha256(key, 32, buf, sizeof(buf), key);
+    librecipher_hmac_sha256(key, 32, v, 32, v);
+  }
+
+  bool ok = false;
+  for (int attempt = 0; attempt < 16 && !ok; attempt++) {
+    librecipher_hmac_sha256(key, 32, v, 32, v);
+    mp_from_bytes(k, v);
+    ok = !mp_is_zero(k) && mp_lt(k, N);
+    if (!ok) {
+      memcpy(buf, v, 32);
+      buf[32] = 0x00;
+      librecipher_hmac_sha256(key, 32, buf, 33, key);
+      librecipher_hmac_sha256(key, 32, v, 32, v);
+    }
+  }
+
+  librecipher_secure_zero(v, sizeof(v));
+  librecipher_secure_zero(key, sizeof(key));
+  librecipher_secure_zero(buf, sizeof(buf));
+  return ok;
+}
+
+static bool seckey_load(sc_t d, const uint8_t secret_key[32]) {
+  bool overflow = sc_from_bytes(d, secret_key);
+  return !overflow && !mp_is_zero(d);
+}
+
+static bool pubkey_parse(ge_t *q, const uint8_t *public_key, size_t len) {
+  if (len == 33 && (public_key[0] == 0x02 || public_key[0] == 0x03)) {
+    fp_t rhs;
+    if (!fp_from_bytes(q->x, public_key + 1))
+      return false;
+    fp_sq(rhs, q->x);
+    fp_mul(rhs, rhs, q->x);
+    fp_add(rhs, rhs, (const fp_t){7});
+    if (!fp_sqrt(q->y, rhs))
+      return false;
+    fp_normalize(q->y);
+    if ((q->y[0] & 1) != (public_key[0] & 1))
+      fp_neg(q->y, q->y);
+    return true;
+  }
+
+  if (len == 65 && public_key[0] == 0x04) {
+    if (!fp_from_bytes(q->x, public_key + 1) ||
+        !fp_from_bytes(q->y, public_key + 33))
+      return false;
+    return ge_is_valid(q);
+  }
+
+  return false;
+}
+
+// ============ Public API ============
+
+bool secp256k1_seckey_verify(const uint8_t secret_key[32]) {
+  sc_t d;
+  bool ok = seckey_load(d, secret_key);
+  librecipher_secure_zero(d, sizeof(d));
+  return ok;
+}
+
+bool secp256k1_get_public_key(uint8_t public_key[33],
+                              const uint8_t secret_key[32]) {
+  sc_t d;
+  gep_t p;
+  ge_t a;
+
+  if (!seckey_load(d, secret_key)) {
+    librecipher_secure_zero(d, sizeof(d));
+    return false;
+  }
+
+  ecmult_gen(&p, d);
+  gep_to_ge(&a, &p);
+  public_key[0] = 0x02 | (a.y[0] & 1);
+  fp_to_bytes(public_key + 1, a.x);
+
+  librecipher_secure_zero(d, sizeof(d));
+  return true;
+}
+
+bool secp256k1_sign(uint8_t signature[64], const uint8_t hash[32],
+                    const uint8_t secret_key[32]) {
+  sc_t d, k, e, r, s;
+  gep_t p;
+  ge_t R;
+  uint8_t rx[32];
+  bool ok = false;
+
+  if (!seckey_load(d, secret_key) || !rfc6979_nonce(k, secret_key, hash))
+    goto cleanup;
+
+  // R = k * G, r = R.x mod n
+  ecmult_gen(&p, k);
+  gep_to_ge(&R, &p);
+  fp_to_bytes(rx, R.x);
+  sc_from_bytes(r, rx);
+
+  // s = k^-1 * (e + r * d) mod n
+  sc_from_bytes(e, hash);
+  sc_mul(s, r, d);
+  sc_add(s, s, e);
+  sc_invert(k, k);
+  sc_mul(s, s, k);
+
+  // Low-S normalization (BIP 62 / BIP 146)
+  sc_t neg;
+  sc_negate(neg, s);
+  mp_cmov(s, neg, 8, sc_is_high(s));
+
+  // r or s == 0 has negligible probability; refuse rather than retry
+  ok = !mp_is_zero(r) && !mp_is_zero(s);
+  mp_to_bytes(signature, r);
+  mp_to_bytes(signature + 32, s);
+
+cleanup:
+  librecipher_secure_zero(d, sizeof(d));
+  librecipher_secure_zero(k, sizeof(k));
+  librecipher_secure_zero(s, sizeof(s));
+  librecipher_secure_zero(&p, sizeof(p));
+  return ok;
+}
+
+bool secp256k1_verify(const uint8_t signature[64], const uint8_t hash[32],
+                      const uint8_t *public_key, size_t public_key_len) {
+  sc_t r, s, e, w, u1, u2, a1, a2, b1, b2;
+  int na1, na2, nb1, nb2;
+  int8_t wa1[WNAF_LEN], wa2[WNAF_LEN], wb1[WNAF_LEN], wb2[WNAF_LEN];
+  ge_t q;
+  gej_t pre[1 << (WNAF_Q_WIDTH - 2)];
+  gej_t acc, dbl;
+
+  if (sc_from_bytes(r, signature) || sc_from_bytes(s, signature + 32) ||
+      mp_is_zero(r) || mp_is_zero(s))
+    return false;
+  if (!pubkey_parse(&q, public_key, public_key_len))
+    return false;
+
+  // u1 = e / s, u2 = r / s
+  sc_from_bytes(e, hash);
+  sc_invert(w, s);
+  sc_mul(u1, e, w);
+  sc_mul(u2, r, w);
+
+  // u1*G + u2*Q = a1*G + a2*lambda(G) + b1*Q + b2*lambda(Q)
+  sc_split_lambda(a1, &na1, a2, &na2, u1);
+  sc_split_lambda(b1, &nb1, b2, &nb2, u2);
+  sc_wnaf(wa1, a1, WNAF_G_WIDTH);
+  sc_wnaf(wa2, a2, WNAF_G_WIDTH);
+  sc_wnaf(wb1, b1, WNAF_Q_WIDTH);
+  sc_wnaf(wb2, b2, WNAF_Q_WIDTH);
+
+  // Odd multiples Q, 3Q, ..., 15Q
+  gej_set_ge(&pre[0], &q);
+  gej_double(&dbl, &pre[0]);
+  for (int i = 1; i < (1 << (WNAF_Q_WIDTH - 2)); i++)
+    gej_add(&pre[i], &pre[i - 1], &dbl);
+
+  acc.infinity = 1;
+  for (int i = WNAF_LEN - 1; i >= 0; i--) {
+    gej_double(&acc, &acc);
+
+    if (wa1[i] || wa2[i]) {
+      for (int half = 0; half < 2; half++) {
+        int digit = half ? wa2[i] : wa1[i];
+        int neg = half ? na2 : na1;
+        if (!digit)
+          continue;
+        ge_t g;
+        ge_from_table(&g, secp256k1_gen_odd[(digit < 0 ? -digit : digit) >> 1]);
+        if (half)
+          fp_mul(g.x, g.x, BETA);
+        if ((digit < 0) ^ neg)
+          fp_neg(g.y, g.y);
+        gej_add_ge(&acc, &acc, &g);
+      }
+    }
+
+    if (wb1[i] || wb2[i]) {
+      for (int half = 0; half < 2; half++) {
+        int digit = half ? wb2[i] : wb1[i];
+        int neg = half ? nb2 : nb1;
+        if (!digit)
+          continue;
+        gej_t t = pre[(digit < 0 ? -digit : digit) >> 1];
+        if (half)
+          fp_mul(t.x, t.x, BETA);
+        if ((digit < 0) ^ neg)
+          fp_neg(t.y, t.y);
+        gej_add(&acc, &acc, &t);
+      }
+    }
+  }
+
+  if (acc.infinity)
+    return false;
+
+  // Check R.x mod n == r without inverting: r * Z^2 == X (mod p),
+  // also trying r + n when it is still below p
+  fp_t zz, rx;
+  fp_sq(zz, acc.z);
+  fp_mul(rx, r, zz);
+  if (fp_equal(rx, acc.x))
+    return true;
+
+  if (!mp_lt(r, P_MINUS_N))
+    return false;
+  uint64_t c = 0;
+  for (int i = 0; i < 8; i++) {
+    c += (uint64_t)r[i] + N[i];
+    rx[i] = (uint32_t)c;
+    c >>= 32;
+  }
+  fp_mul(rx, rx, zz);
+  return fp_equal(rx, acc.x);
+}
+
+#if LIBRECRYPT_BENCH
+// ============ Benchmark Reference ============
+
+// r = k * a, one doubling per bit and one addition per set bit
+static void ecmult_naive(gej_t *r, const ge_t *a, const sc_t k) {
+  r->infinity = 1;
+  for (int i = 255; i >= 0; i--) {
+    gej_double(r, r);
+    if (sc_get_bits(k, i, 1))
+      gej_add_ge(r, r, a);
+  }
+}
+
+// Affine x of a finite Jacobian point, fully reduced
+static void gej_affine_x(fp_t x, const gej_t *a) {
+  fp_t zi;
+  fp_invert(zi, a->z);
+  fp_sq(zi, zi);
+  fp_mul(x, a->x, zi);
+  fp_normalize(x);
+}
+
+bool secp256k1_get_public_key_naive(uint8_t public_key[33],
+                                    const uint8_t secret_key[32]) {
+  sc_t d;
+  ge_t g, a;
+  gej_t p;
+  fp_t zi, zi2;
+
+  if (!seckey_load(d, secret_key))
+    return false;
+
+  ge_from_table(&g, secp256k1_gen_odd[0]);
+  ecmult_naive(&p, &g, d);
+  fp_invert(zi, p.z);
+  fp_sq(zi2, zi);
+  fp_mul(a.x, p.x, zi2);
+  fp_mul(zi2, zi2, zi);
+  fp_mul(a.y, p.y, zi2);
+  fp_normalize(a.x);
+  fp_normalize(a.y);
+  public_key[0] = 0x02 | (a.y[0] & 1);
+  fp_to_bytes(public_key + 1, a.x);
+
+  librecipher_secure_zero(d, sizeof(d));
+  return true;
+}
+
+bool secp256k1_verify_naive(const uint8_t signature[64],
+                            const uint8_t hash[32], const uint8_t *public_key,
+                            size_t public_key_len) {
+  sc_t r, s, e, w, u1, u2, x;
+  ge_t g, q;
+  gej_t a, b;
+  fp_t ax;
+  uint8_t xb[32];
+
+  if (sc_from_bytes(r, signature) || sc_from_bytes(s, signature + 32) ||
+      mp_is_zero(r) || mp_is_zero(s))
+    return false;
+  if (!pubkey_parse(&q, public_key, public_key_len))
+    return false;
+
+  sc_from_bytes(e, hash);
+  sc_invert(w, s);
+  sc_mul(u1, e, w);
+  sc_mul(u2, r, w);
+
+  // u1*G and u2*Q separately, then one addition
+  ge_from_table(&g, secp256k1_gen_odd[0]);
+  ecmult_naive(&a, &g, u1);
+  ecmult_naive(&b, &q, u2);
+  gej_add(&a, &a, &b);
+  if (a.infinity)
+    return false;
+
+  gej_affine_x(ax, &a);
+  fp_to_bytes(xb, ax);
+  sc_from_bytes(x, xb);
+  return memcmp(x, r, sizeof(sc_t)) == 0;
+}
+#endif
@@ -58,18 +58,14 @@ static inline uint32_t sigma1(uint32_t x) {
   return rotr(x, 17) ^ rotr(x, 19) ^ (x >> 10);
 }
 
-// Process one 512-bit block
-static void sha256_transform(uint32_t state[8], const uint8_t block[64]) {
+void sha256_compress(uint32_t state[8], const uint32_t block[16]) {
   uint32_t W[64];
   uint32_t a, b, c, d, e, f, g, h;
   uint32_t T1, T2;
   int i;
 
-  // Prepare message schedule (big-endian)
   for (i = 0; i < 16; i++) {
-    W[i] = ((uint32_t)block[i * 4 + 0] << 24) |
-           ((uint32_t)block[i * 4 + 1] << 16) |
-           ((uint32_t)block[i * 4 + 2] << 8) | ((uint32_t)block[i * 4 + 3]);
+    W[i] = block[i];
   }
 
   for (i = 16; i < 64; i++) {
@@ -111,6 +107,19 @@ static void sha256_transform(uint32_t state[8], const uint8_t block[64]) {
   state[7] += h;
 }
 
+// Process one 512-bit block
+static void sha256_transform(uint32_t state[8], const uint8_t block[64]) {
+  uint32_t W[16];
+
+  // Message words (big-endian)
+  for (int i = 0; i < 16; i++) {
+    W[i] = ((uint32_t)block[i * 4 + 0] << 24) |
+           ((uint32_t)block[i * 4 + 1] << 16) |
+           ((uint32_t)block[i * 4 + 2] << 8) | ((uint32_t)block[i * 4 + 3]);
+  }
+  sha256_compress(state, W);
+}
+
 void sha256_init(sha256_ctx_t *ctx) {
   memcpy(ctx->state, H0, sizeof(H0));
   ctx->count = 0;
@@ -0,0 +1,212 @@
+/**
+ * LibreCipher SHA-512 Implementation
+ *
+ * Constant-time SHA-512 following FIPS 180-4
+ * Zero dynamic allocation
+ */
+
+#include "sha512.h"
+#include <string.h>
+
+// SHA-512 Constants (first 64 bits of fractional parts of cube roots of first
+// 80 primes)
+static const uint64_t K[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL,
+    0xe9b5dba58189dbbcULL, 0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL,
+    0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL, 0xd807aa98a3030242ULL,
+    0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL,
+    0xc19bf174cf692694ULL, 0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL,
+    0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL, 0x2de92c6f592b0275ULL,
+    0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL,
+    0xbf597fc7beef0ee4ULL, 0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL,
+    0x06ca6351e003826fULL, 0x142929670a0e6e70ULL, 0x27b70a8546d22ffcULL,
+    0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL,
+    0x92722c851482353bULL, 0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL,
+    0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL, 0xd192e819d6ef5218ULL,
+    0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL,
+    0x34b0bcb5e19b48a8ULL, 0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL,
+    0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL, 0x748f82ee5defb2fcULL,
+    0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL,
+    0xc67178f2e372532bULL, 0xca273eceea26619cULL, 0xd186b8c721c0c207ULL,
+    0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL, 0x06f067aa72176fbaULL,
+    0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL,
+    0x431d67c49c100d4cULL, 0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL,
+    0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL};
+
+// Initial hash values (first 64 bits of fractional parts of square roots of
+// first 8 primes)
+static const uint64_t H0[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL,
+    0xa54ff53a5f1d36f1ULL, 0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+    0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL};
+
+// Rotate right (constant-time)
+static inline uint64_t rotr64(uint64_t x, int n) {
+  return (x >> n) | (x << (64 - n));
+}
+
+// SHA-512 functions
+static inline uint64_t Ch(uint64_t x, uint64_t y, uint64_t z) {
+  return (x & y) ^ (~x & z);
+}
+
+static inline uint64_t Maj(uint64_t x, uint64_t y, uint64_t z) {
+  return (x & y) ^ (x & z) ^ (y & z);
+}
+
+static inline uint64_t Sigma0(uint64_t x) {
+  return rotr64(x, 28) ^ rotr64(x, 34) ^ rotr64(x, 39);
+}
+
+static inline uint64_t Sigma1(uint64_t x) {
+  return rotr64(x, 14) ^ rotr64(x, 18) ^ rotr64(x, 41);
+}
+
+static inline uint64_t sigma0(uint64_t x) {
+  return rotr64(x, 1) ^ rotr64(x, 8) ^ (x >> 7);
+}
+
+static inline uint64_t sigma1(uint64_t x) {
+  return rotr64(x, 19) ^ rotr64(x, 61) ^ (x >> 6);
+}
+
+// Compress one block given as words
+// The schedule is kept as a 16-word ring in W to save stack
+void sha512_compress(uint64_t state[8], uint64_t W[16]) {
+  uint64_t a, b, c, d, e, f, g, h;
+  uint64_t T1, T2;
+  int i;
+
+  // Initialize working variables
+  a = state[0];
+  b = state[1];
+  c = state[2];
+  d = state[3];
+  e = state[4];
+  f = state[5];
+  g = state[6];
+  h = state[7];
+
+  // 80 rounds
+  for (i = 0; i < 80; i++) {
+    if (i >= 16) {
+      W[i & 15] += sigma1(W[(i - 2) & 15]) + W[(i - 7) & 15] +
+                   sigma0(W[(i - 15) & 15]);
+    }
+    T1 = h + Sigma1(e) + Ch(e, f, g) + K[i] + W[i & 15];
+    T2 = Sigma0(a) + Maj(a, b, c);
+    h = g;
+    g = f;
+    f = e;
+    e = d + T1;
+    d = c;
+    c = b;
+    b = a;
+    a = T1 + T2;
+  }
+
+  // Add compressed chunk to hash
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+// Process one 1024-bit block
+static void sha512_transform(uint64_t state[8], const uint8_t block[128]) {
+  uint64_t W[16];
+
+  // Load message block (big-endian)
+  for (int i = 0; i < 16; i++) {
+    W[i] = 0;
+    for (int j = 0; j < 8; j++) {
+      W[i] = (W[i] << 8) | block[i * 8 + j];
+    }
+  }
+  sha512_compress(state, W);
+}
+
+void sha512_init(sha512_ctx_t *ctx) {
+  memcpy(ctx->state, H0, sizeof(H0));
+  ctx->count = 0;
+  memset(ctx->buffer, 0, SHA512_BLOCK_SIZE);
+}
+
+void sha512_update(sha512_ctx_t *ctx, const uint8_t *data, size_t len) {
+  size_t buffer_len = (size_t)(ctx->count & 0x7F);
+  ctx->count += len;
+
+  // Fill buffer if partial
+  if (buffer_len > 0) {
+    size_t fill = SHA512_BLOCK_SIZE - buffer_len;
+    if (len < fill) {
+      memcpy(ctx->buffer + buffer_len, data, len);
+      return;
+    }
+    memcpy(ctx->buffer + buffer_len, data, fill);
+    sha512_transform(ctx->state, ctx->buffer);
+    data += fill;
+    len -= fill;
+  }
+
+  // Process full blocks
+  while (len >= SHA512_BLOCK_SIZE) {
+    sha512_transform(ctx->state, data);
+    data += SHA512_BLOCK_SIZE;
+    len -= SHA512_BLOCK_SIZE;
+  }
+
+  // Buffer remaining
+  if (len > 0) {
+    memcpy(ctx->buffer, data, len);
+  }
+}
+
+void sha512_final(sha512_ctx_t *ctx, uint8_t *digest) {
+  size_t buffer_len = (size_t)(ctx->count & 0x7F);
+  uint64_t bit_count = ctx->count * 8;
+
+  // Padding
+  ctx->buffer[buffer_len++] = 0x80;
+
+  if (buffer_len > 112) {
+    memset(ctx->buffer + buffer_len, 0, SHA512_BLOCK_SIZE - buffer_len);
+    sha512_transform(ctx->state, ctx->buffer);
+    buffer_len = 0;
+  }
+
+  // 128-bit length field; the upper 64 bits are always zero here
+  memset(ctx->buffer + buffer_len, 0, 120 - buffer_len);
+  for (int i = 0; i < 8; i++) {
+    ctx->buffer[120 + i] = (uint8_t)(bit_count >> (56 - 8 * i));
+  }
+
+  sha512_transform(ctx->state, ctx->buffer);
+
+  // Output hash (big-endian)
+  for (int i = 0; i < 8; i++) {
+    for (int j = 0; j < 8; j++) {
+      digest[i * 8 + j] = (uint8_t)(ctx->state[i] >> (56 - 8 * j));
+    }
+  }
+
+  // Clear sensitive data
+  memset(ctx, 0, sizeof(*ctx));
+}
+
+void sha512_hash(const uint8_t *data, size_t len, uint8_t *digest) {
+  sha512_ctx_t ctx;
+  sha512_init(&ctx);
+  sha512_update(&ctx, data, len);
+  sha512_final(&ctx, digest);
+}
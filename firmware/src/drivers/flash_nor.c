@@ -0,0 +1,404 @@
+/**
+ * NOR Flash Access Implementation
+ *
+ * Device: XIP reads and SDK program/erase calls
+ * Host: file-backed simulator enforcing erase-before-write
+ *
+ * Programs land in a RAM window of FLASH_NOR_CACHE_PAGES consecutive pages
+ * holding only the pending bytes (0xFF elsewhere). Since programming can
+ * only clear bits, a read is the flash contents ANDed with the window.
+ * A flush programs each run of dirty pages with a single backend call.
+ */
+
+#include "flash_nor.h"
+#include <string.h>
+
+#if !LIBRECIPHER_HOST
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+
+#define FLASH_NOR_SIZE PICO_FLASH_SIZE_BYTES
+#else
+#include <stdio.h>
+
+// Stall model (typical QSPI NOR datasheet figures): every call leaves and
+// re-enters XIP, then each page or sector takes its program/erase time
+#define SIM_CALL_US 20
+#define SIM_PAGE_PROGRAM_US 400
+#define SIM_SECTOR_ERASE_US 45000
+
+static struct {
+  FILE *file;
+  uint32_t size;
+  uint32_t cut_budget; // Bytes left before the simulated power loss
+  bool cut_armed;
+  flash_nor_sim_stats_t stats;
+} g_sim;
+
+#define FLASH_NOR_SIZE g_sim.size
+#endif
+
+#define CACHE_SIZE (FLASH_NOR_CACHE_PAGES * FLASH_NOR_PAGE_SIZE)
+
+// Only dirty pages hold data: pending bytes, 0xFF where nothing is pending
+static struct {
+  uint8_t data[CACHE_SIZE];
+  uint32_t base;  // Flash offset of the window, page aligned
+  uint32_t dirty; // Pages of the window with pending bytes
+} g_cache;
+
+// Deferred erases, oldest first
+static struct {
+  uint32_t offset[FLASH_NOR_ERASE_QUEUE];
+  flash_nor_erased_fn done[FLASH_NOR_ERASE_QUEUE];
+  uint32_t count;
+} g_erase;
+
+static bool range_valid(uint32_t offset, size_t len) {
+  return offset <= FLASH_NOR_SIZE && len <= FLASH_NOR_SIZE - offset;
+}
+
+static void erase_dequeue(uint32_t i) {
+  g_erase.count--;
+  memmove(&g_erase.offset[i], &g_erase.offset[i + 1],
+          (g_erase.count - i) * sizeof(g_erase.offset[0]));
+  memmove(&g_erase.done[i], &g_erase.done[i + 1],
+          (g_erase.count - i) * sizeof(g_erase.done[0]));
+}
+
+// ============ Backend ============
+
+#if !LIBRECIPHER_HOST
+static void backend_read(uint32_t offset, uint8_t *buf, size_t len) {
+  memcpy(buf, (const uint8_t *)(XIP_BASE + offset), len);
+}
+
+// Whole pages, data in RAM (XIP is off while programming, so the source
+// must never point into flash)
+static bool backend_program(uint32_t offset, const uint8_t *data,
+                            size_t len) {
+  uint32_t ints = save_and_disable_interrupts();
+  flash_range_program(offset, data, len);
+  restore_interrupts(ints);
+  return true;
+}
+
+static bool backend_erase_sector(uint32_t sector) {
+  uint32_t ints = save_and_disable_interrupts();
+  flash_range_erase(sector, FLASH_NOR_SECTOR_SIZE);
+  restore_interrupts(ints);
+  return true;
+}
+#else
+static void backend_read(uint32_t offset, uint8_t *buf, size_t len) {
+  if (g_sim.file == NULL || fseek(g_sim.file, (long)offset, SEEK_SET) != 0 ||
+      fread(buf, 1, len, g_sim.file) != len) {
+    memset(buf, 0xFF, len);
+  }
+}
+
+static bool backend_write(uint32_t offset, const uint8_t *buf, size_t len) {
+  return fseek(g_sim.file, (long)offset, SEEK_SET) == 0 &&
+         fwrite(buf, 1, len, g_sim.file) == len && fflush(g_sim.file) == 0;
+}
+
+static bool backend_program_page(uint32_t page, const uint8_t *data) {
+  uint8_t current[FLASH_NOR_PAGE_SIZE];
+  size_t len = FLASH_NOR_PAGE_SIZE;
+
+  if (g_sim.file == NULL) {
+    return false;
+  }
+  backend_read(page, current, sizeof(current));
+
+  // Erase-before-write: programming can only touch bytes still erased
+  for (size_t i = 0; i < FLASH_NOR_PAGE_SIZE; i++) {
+    if (data[i] != 0xFF && current[i] != 0xFF) {
+      return false;
+    }
+  }
+
+  if (g_sim.cut_armed) {
+    if (g_sim.cut_budget < len) {
+      len = g_sim.cut_budget;
+    }
+    g_sim.cut_budget -= (uint32_t)len;
+  }
+  for (size_t i = 0; i < len; i++) {
+    current[i] &= data[i];
+  }
+  g_sim.stats.pages_programmed++;
+  g_sim.stats.stall_us += SIM_PAGE_PROGRAM_US;
+  return backend_write(page, current, sizeof(current)) &&
+         len == FLASH_NOR_PAGE_SIZE;
+}
+
+static bool backend_program(uint32_t offset, const uint8_t *data,
+                            size_t len) {
+  g_sim.stats.program_ops++;
+  g_sim.stats.stall_us += SIM_CALL_US;
+  for (size_t done = 0; done < len; done += FLASH_NOR_PAGE_SIZE) {
+    if (!backend_program_page(offset + (uint32_t)done, data + done)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool backend_erase_sector(uint32_t sector) {
+  uint8_t erased[FLASH_NOR_SECTOR_SIZE];
+
+  if (g_sim.file == NULL || (g_sim.cut_armed && g_sim.cut_budget == 0)) {
+    return false;
+  }
+  memset(erased, 0xFF, sizeof(erased));
+  g_sim.stats.erase_ops++;
+  g_sim.stats.stall_us += SIM_CALL_US + SIM_SECTOR_ERASE_US;
+  return backend_write(sector, erased, sizeof(erased));
+}
+
+bool flash_nor_sim_open(const char *path, uint32_t size) {
+  uint8_t erased[FLASH_NOR_SECTOR_SIZE];
+
+  flash_nor_sim_close();
+  if (size % FLASH_NOR_SECTOR_SIZE != 0) {
+    return false;
+  }
+  g_sim.file = fopen(path, "r+b");
+  if (g_sim.file == NULL) {
+    g_sim.file = fopen(path, "w+b");
+  }
+  if (g_sim.file == NULL) {
+    return false;
+  }
+
+  // New (or shorter) backing file: the missing part comes out erased
+  fseek(g_sim.file, 0, SEEK_END);
+  long have = ftell(g_sim.file);
+  memset(erased, 0xFF, sizeof(erased));
+  for (long pos = have - have % FLASH_NOR_SECTOR_SIZE; pos < (long)size;
+       pos += FLASH_NOR_SECTOR_SIZE) {
+    if (!backend_write((uint32_t)pos, erased, sizeof(erased))) {
+      flash_nor_sim_close();
+      return false;
+    }
+  }
+  g_sim.size = size;
+  return true;
+}
+
+void flash_nor_sim_close(void) {
+  if (g_sim.file != NULL) {
+    fclose(g_sim.file);
+  }
+  memset(&g_sim, 0, sizeof(g_sim));
+  // Whatever was still pending in RAM is lost with the power
+  g_cache.dirty = 0;
+  g_erase.count = 0;
+}
+
+void flash_nor_sim_power_cut(uint32_t bytes) {
+  g_sim.cut_armed = true;
+  g_sim.cut_budget = bytes;
+}
+
+void flash_nor_sim_get_stats(flash_nor_sim_stats_t *stats) {
+  *stats = g_sim.stats;
+}
+
+void flash_nor_sim_reset_stats(void) {
+  memset(&g_sim.stats, 0, sizeof(g_sim.stats));
+}
+#endif
+
+// ============ Write-Back Cache ============
+
+// Flash contents as the caller sees them: pending bytes applied
+static void read_through(uint32_t offset, uint8_t *buf, size_t len) {
+  backend_read(offset, buf, len);
+  if (g_cache.dirty == 0 || offset >= g_cache.base + CACHE_SIZE ||
+      offset + len <= g_cache.base) {
+    return;
+  }
+  uint32_t from = offset > g_cache.base ? offset : g_cache.base;
+  uint32_t to = offset + (uint32_t)len;
+  if (to > g_cache.base + CACHE_SIZE) {
+    to = g_cache.base + CACHE_SIZE;
+  }
+  for (uint32_t a = from; a < to; a++) {
+    uint32_t at = a - g_cache.base;
+    if (g_cache.dirty & (1u << (at / FLASH_NOR_PAGE_SIZE))) {
+      buf[a - offset] &= g_cache.data[at];
+    }
+  }
+}
+
+bool flash_nor_flush(void) {
+  bool ok = true;
+
+  for (uint32_t page = 0; page < FLASH_NOR_CACHE_PAGES;) {
+    if (!(g_cache.dirty & (1u << page))) {
+      page++;
+      continue;
+    }
+    uint32_t end = page;
+    while (end < FLASH_NOR_CACHE_PAGES && (g_cache.dirty & (1u << end))) {
+      end++;
+    }
+    ok &= backend_program(g_cache.base + page * FLASH_NOR_PAGE_SIZE,
+                          g_cache.data + page * FLASH_NOR_PAGE_SIZE,
+                          (end - page) * FLASH_NOR_PAGE_SIZE);
+    page = end;
+  }
+  g_cache.dirty = 0;
+  return ok;
+}
+
+// ============ Public API ============
+
+bool flash_nor_read(uint32_t offset, void *buf, size_t len) {
+  if (!range_valid(offset, len)) {
+    return false;
+  }
+  read_through(offset, buf, len);
+  return true;
+}
+
+bool flash_nor_program(uint32_t offset, const void *data, size_t len) {
+  const uint8_t *src = data;
+
+  if (!range_valid(offset, len)) {
+    return false;
+  }
+
+  while (len > 0) {
+    // Outside the window: write it back and move it to this page
+    if (g_cache.dirty == 0 || offset < g_cache.base ||
+        offset >= g_cache.base + CACHE_SIZE) {
+      if (!flash_nor_flush()) {
+        return false;
+      }
+      g_cache.base = offset & ~(uint32_t)(FLASH_NOR_PAGE_SIZE - 1);
+    }
+
+    size_t at = offset - g_cache.base;
+    size_t n = CACHE_SIZE - at;
+    if (n > len) {
+      n = len;
+    }
+
+    for (size_t p = at / FLASH_NOR_PAGE_SIZE;
+         p <= (at + n - 1) / FLASH_NOR_PAGE_SIZE; p++) {
+      if (!(g_cache.dirty & (1u << p))) {
+        memset(g_cache.data + p * FLASH_NOR_PAGE_SIZE, 0xFF,
+               FLASH_NOR_PAGE_SIZE);
+        g_cache.dirty |= 1u << p;
+      }
+    }
+
+    // A byte can only be programmed once between erases
+    for (size_t i = 0; i < n; i++) {
+      if (src[i] != 0xFF && g_cache.data[at + i] != 0xFF) {
+        return false;
+      }
+    }
+    for (size_t i = 0; i < n; i++) {
+      g_cache.data[at + i] &= src[i];
+    }
+    offset += (uint32_t)n;
+    src += n;
+    len -= n;
+  }
+  return true;
+}
+
+bool flash_nor_erase(uint32_t offset, size_t len) {
+  if (offset % FLASH_NOR_SECTOR_SIZE != 0 ||
+      len % FLASH_NOR_SECTOR_SIZE != 0 || !range_valid(offset, len)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < g_erase.count;) {
+    if (g_erase.offset[i] >= offset && g_erase.offset[i] - offset < len) {
+      erase_dequeue(i);
+    } else {
+      i++;
+    }
+  }
+  // Barrier: everything programmed before the erase reaches flash first
+  if (!flash_nor_flush()) {
+    return false;
+  }
+  for (size_t done = 0; done < len; done += FLASH_NOR_SECTOR_SIZE) {
+    if (!backend_erase_sector(offset + (uint32_t)done)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool flash_nor_is_erased(uint32_t offset, size_t len) {
+  uint8_t buf[64];
+
+  if (!range_valid(offset, len)) {
+    return false;
+  }
+  while (len > 0) {
+    size_t n = len < sizeof(buf) ? len : sizeof(buf);
+    read_through(offset, buf, n);
+    for (size_t i = 0; i < n; i++) {
+      if (buf[i] != 0xFF) {
+        return false;
+      }
+    }
+    offset += (uint32_t)n;
+    len -= n;
+  }
+  return true;
+}
+
+// ============ Deferred Erase ============
+
+bool flash_nor_erase_later(uint32_t offset, flash_nor_erased_fn done) {
+  if (offset % FLASH_NOR_SECTOR_SIZE != 0 ||
+      !range_valid(offset, FLASH_NOR_SECTOR_SIZE)) {
+    return false;
+  }
+  if (flash_nor_erase_pending(offset)) {
+    return true;
+  }
+  if (g_erase.count == FLASH_NOR_ERASE_QUEUE) {
+    return false;
+  }
+  g_erase.offset[g_erase.count] = offset;
+  g_erase.done[g_erase.count] = done;
+  g_erase.count++;
+  return true;
+}
+
+bool flash_nor_erase_pending(uint32_t offset) {
+  for (uint32_t i = 0; i < g_erase.count; i++) {
+    if (g_erase.offset[i] == offset) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool flash_nor_erase_step(void) {
+  if (g_erase.count == 0) {
+    return false;
+  }
+  uint32_t offset = g_erase.offset[0];
+  flash_nor_erased_fn done = g_erase.done[0];
+
+  // flash_nor_erase takes it off the queue
+  if (flash_nor_is_erased(offset, FLASH_NOR_SECTOR_SIZE)) {
+    erase_dequeue(0);
+  } else if (!flash_nor_erase(offset, FLASH_NOR_SECTOR_SIZE)) {
+    return true;
+  }
+  if (done != NULL) {
+    done(offset);
+  }
+  return true;
+}
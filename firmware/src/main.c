@@ -11,8 +11,13 @@
 #include <stdio.h>
 
 
+#include "bootloader.h"
+#include "flash_nor.h"
 #include "librecipher.h"
 #include "usb_protocol.h"
+#if LIBRECRYPT_BENCH
+#include "bench.h"
+#endif
 #include "wallet.h"
 #include "ws2812.h"
 
@@ -28,8 +33,15 @@
 static void hardware_init(void) {
   stdio_init_all();
 
+  // Coleta de entropia em background o quanto antes: o boot_sequence
+  // enche o pool antes do primeiro uso
+  librecipher_init();
+
   // Inicializar LED WS2812
   ws2812_init();
+
+  // Botão do bootloader: confirma lotes de assinatura
+  bootloader_button_init();
 }
 
 /**
@@ -91,10 +103,13 @@ int main(void) {
   boot_sequence();
 
   // Inicializar módulos
-  librecipher_init();
   wallet_init();
   usb_protocol_init();
 
+  // Setor ativo do contador de rollback quase cheio: apagar o outro no
+  // tempo ocioso, para a troca só programar
+  bootloader_schedule_rollback_erase();
+
   printf("\n");
   printf("=================================\n");
   printf(" LibreCrypt Wallet v%d.%d.%d\n", FIRMWARE_VERSION_MAJOR,
@@ -103,6 +118,10 @@ int main(void) {
   printf(" Crypto: LibreCipher\n");
   printf("=================================\n");
 
+#if LIBRECRYPT_BENCH
+  bench_run();
+#endif
+
   // Atualizar LED para status inicial
   update_led_status();
 
@@ -113,8 +132,12 @@ int main(void) {
 
   // Loop principal
   while (true) {
-    // Processar comandos USB
-    usb_protocol_task();
+    // Processar comandos USB; sem comando em curso, adiantar um erase
+    // pendente da flash (setores liberados pelo GC do kvstore, contador de
+    // rollback) para que os comandos só programem
+    if (!usb_protocol_task()) {
+      flash_nor_erase_step();
+    }
 
     // Heartbeat LED (breathing effect)
     uint32_t now = to_ms_since_boot(get_absolute_time());
@@ -3,20 +3,68 @@
  */
 
 #include "usb_protocol.h"
+#include "entropy.h"
 #include "librecipher.h"
+#include "sha256.h"
+#include "slip39.h"
 #include "pico/stdlib.h"
 #include "wallet.h"
 #include <stdio.h>
 #include <string.h>
 
+#if !LIBRECIPHER_HOST
+#include "bootloader.h"
+#include "hardware/sync.h"
+#include "pico/stdio_usb.h"
+#include "tusb.h"
+#include "ws2812.h"
+#endif
+
 // Frame format: [SOF][LEN][CMD][DATA...][CRC16]
 #define SOF_BYTE 0xAA
 #define MAX_FRAME_SIZE 256
 
+// Anel de recepção: bytes lidos do CDC em blocos, frames montados inteiros
+// (potência de 2, cabe mais de um frame máximo)
+#define RX_RING_SIZE 512
+_Static_assert((RX_RING_SIZE & (RX_RING_SIZE - 1)) == 0 &&
+                   RX_RING_SIZE >= 2 * MAX_FRAME_SIZE,
+               "anel de recepção");
+
+// Máximo de endereços por CMD_GET_ADDRESSES
+#define GET_ADDRESSES_MAX_COUNT 64
+
+// Entradas de assinatura por frame CMD_SIGN_TX: [conta LE32][hash 32]
+#define SIGN_ENTRY_SIZE 36
+#define SIGN_FLAG_NEW_BATCH 0x01
+
+// Confirmação física do lote: botão solto e depois segurado por
+// CONFIRM_HOLD_MS enquanto o LED pisca, dentro do prazo
+#define CONFIRM_TIMEOUT_MS 30000
+#define CONFIRM_HOLD_MS 500
+
+// Etapas de CMD_BACKUP_IMPORT (primeiro byte)
+#define IMPORT_OP_BEGIN 0x00  // [tamanho][passphrase][cabeçalho]
+#define IMPORT_OP_CHUNK 0x01  // [pedaço]
+#define IMPORT_OP_FINISH 0x02 // [PIN novo]
+
+// Lote de assinatura em montagem: o digest acumulado (curva || entradas)
+// é o que o app mostra e devolve em CMD_SIGN_CONFIRM
+static wallet_sign_request_t sign_batch[WALLET_SIGN_BATCH_MAX];
+static size_t sign_batch_count = 0;
+static uint8_t sign_batch_curve;
+static sha256_ctx_t sign_batch_digest;
+
 // Buffers
-static uint8_t rx_buffer[MAX_FRAME_SIZE];
+static uint8_t rx_ring[RX_RING_SIZE];
+static uint32_t rx_head; // Contadores livres: posição = contador % tamanho
+static uint32_t rx_tail;
+static uint8_t rx_buffer[MAX_FRAME_SIZE]; // Frame atual, contíguo
 static uint8_t tx_buffer[MAX_FRAME_SIZE];
-static size_t rx_pos = 0;
+
+// Destino das respostas (NULL: stdio USB)
+static usb_protocol_writer_t tx_writer;
+static void *tx_writer_ctx;
 
 // Versão do firmware
 static const uint8_t VERSION[] = {0, 1, 0}; // Major.Minor.Patch
@@ -55,12 +103,220 @@ static void send_response(uint8_t status, const uint8_t *data, size_t len) {
   tx_buffer[3 + len] = crc & 0xFF;
   tx_buffer[4 + len] = (crc >> 8) & 0xFF;
 
+  if (tx_writer) {
+    tx_writer(tx_buffer, 5 + len, tx_writer_ctx);
+    return;
+  }
+
   // Enviar via stdio (USB CDC)
   for (size_t i = 0; i < 5 + len; i++) {
     putchar(tx_buffer[i]);
   }
 }
 
+static uint32_t read_le32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+/**
+ * Envia um endereço da faixa: [índice LE32][endereço]
+ */
+static void send_address_frame(uint32_t index, const char *address,
+                               size_t len, void *ctx) {
+  (void)ctx;
+  uint8_t frame[4 + WALLET_ADDRESS_MAX_LEN];
+
+  frame[0] = index & 0xFF;
+  frame[1] = (index >> 8) & 0xFF;
+  frame[2] = (index >> 16) & 0xFF;
+  frame[3] = (index >> 24) & 0xFF;
+  memcpy(&frame[4], address, len);
+  send_response(len > 0 ? STATUS_OK : STATUS_ERROR, frame, 4 + len);
+}
+
+/**
+ * Envia uma assinatura do lote: [entrada][assinatura 64]
+ */
+static void send_signature_frame(size_t entry, const uint8_t *signature,
+                                 void *ctx) {
+  (void)ctx;
+  uint8_t frame[1 + 64];
+
+  frame[0] = (uint8_t)entry;
+  memcpy(&frame[1], signature, 64);
+  send_response(STATUS_OK, frame, sizeof(frame));
+}
+
+/**
+ * Envia uma parte do backup: [índice][palavras][N x índice LE16]
+ */
+static void send_share_frame(uint8_t share_index, const uint16_t *words,
+                             size_t count, void *ctx) {
+  (void)ctx;
+  uint8_t frame[2 + 2 * SLIP39_MAX_WORDS];
+
+  frame[0] = share_index;
+  frame[1] = (uint8_t)count;
+  for (size_t i = 0; i < count; i++) {
+    frame[2 + 2 * i] = words[i] & 0xFF;
+    frame[3 + 2 * i] = (uint8_t)(words[i] >> 8);
+  }
+  send_response(count > 0 ? STATUS_OK : STATUS_ERROR, frame, 2 + 2 * count);
+  librecipher_secure_zero(frame, sizeof(frame));
+}
+
+/**
+ * Envia um registro do backup cifrado (cabeçalho ou pedaço) como está
+ */
+static void send_backup_frame(const uint8_t *record, size_t len, void *ctx) {
+  (void)ctx;
+  send_response(STATUS_OK, record, len);
+}
+
+/**
+ * Uma etapa da importação de backup: STATUS_OK ou STATUS_ERROR por frame
+ *
+ * Cada pedaço é conferido ao chegar; um erro descarta a importação e o
+ * app recomeça do início.
+ */
+static void backup_import(const uint8_t *data, size_t len) {
+  bool ok = false;
+
+  if (len >= 2 && data[0] == IMPORT_OP_BEGIN) {
+    size_t pass_len = data[1];
+    ok = len >= 2 + pass_len &&
+         wallet_backup_import_begin(&data[2 + pass_len], len - 2 - pass_len,
+                                    &data[2], pass_len);
+  } else if (len >= 1 && data[0] == IMPORT_OP_CHUNK) {
+    ok = wallet_backup_import_chunk(&data[1], len - 1);
+  } else if (len >= 2 && data[0] == IMPORT_OP_FINISH) {
+    ok = wallet_backup_import_finish(&data[1], len - 1);
+  }
+  send_response(ok ? STATUS_OK : STATUS_ERROR, NULL, 0);
+}
+
+/**
+ * Acrescenta entradas ao lote de assinatura
+ *
+ * [flags][curva][N x (conta LE32, hash 32)], N <= 6 num frame de 256
+ * bytes. Responde STATUS_NEED_CONFIRM com [total][digest 32] do lote
+ * até aqui.
+ */
+static void sign_batch_add(const uint8_t *data, size_t len) {
+  if (len < 2 + SIGN_ENTRY_SIZE || (len - 2) % SIGN_ENTRY_SIZE != 0) {
+    send_response(STATUS_ERROR, NULL, 0);
+    return;
+  }
+
+  size_t n = (len - 2) / SIGN_ENTRY_SIZE;
+  if ((data[0] & SIGN_FLAG_NEW_BATCH) || sign_batch_count == 0) {
+    sign_batch_count = 0;
+    sign_batch_curve = data[1];
+    sha256_init(&sign_batch_digest);
+    sha256_update(&sign_batch_digest, &data[1], 1);
+  }
+  if (data[1] != sign_batch_curve ||
+      n > WALLET_SIGN_BATCH_MAX - sign_batch_count) {
+    sign_batch_count = 0;
+    send_response(STATUS_ERROR, NULL, 0);
+    return;
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    const uint8_t *entry = &data[2 + i * SIGN_ENTRY_SIZE];
+    wallet_sign_request_t *req = &sign_batch[sign_batch_count++];
+    req->account_index = read_le32(entry);
+    memcpy(req->hash, entry + 4, 32);
+  }
+  sha256_update(&sign_batch_digest, &data[2], len - 2);
+
+  uint8_t reply[1 + SHA256_DIGEST_SIZE];
+  sha256_ctx_t digest = sign_batch_digest;
+  reply[0] = (uint8_t)sign_batch_count;
+  sha256_final(&digest, &reply[1]);
+  send_response(STATUS_NEED_CONFIRM, reply, sizeof(reply));
+}
+
+#if LIBRECIPHER_HOST
+static bool g_sim_confirm;
+
+void usb_protocol_sim_confirm(bool accept) { g_sim_confirm = accept; }
+
+static bool user_confirm(void) { return g_sim_confirm; }
+#else
+/**
+ * Espera o usuário confirmar no device: LED azul piscando, botão (ativo
+ * em nível baixo) solto e então segurado por CONFIRM_HOLD_MS
+ *
+ * Exigir o botão solto antes impede que um botão preso ou já apertado
+ * confirme sozinho.
+ * @return false no fim do prazo
+ */
+static bool user_confirm(void) {
+  uint64_t start = time_us_64();
+  uint64_t held_since = 0;
+  bool released = false;
+  bool ok = false;
+
+  while (!ok && time_us_64() - start < CONFIRM_TIMEOUT_MS * 1000ull) {
+    uint64_t now = time_us_64();
+    if ((now / 250000) & 1) {
+      ws2812_set_rgb(0, 0, 255);
+    } else {
+      ws2812_off();
+    }
+
+    if (!bootloader_is_recovery_pressed()) {
+      released = true;
+      held_since = 0;
+    } else if (released && held_since == 0) {
+      held_since = now;
+    } else if (released && now - held_since >= CONFIRM_HOLD_MS * 1000ull) {
+      ok = true;
+    }
+    sleep_ms(10);
+  }
+  ws2812_off();
+  return ok;
+}
+#endif
+
+/**
+ * Assina o lote montado se o digest confirmado for o dele e o usuário
+ * confirmar no botão do device
+ *
+ * Uma confirmação para o lote inteiro; as assinaturas voltam em frames
+ * STATUS_OK sem frame final. O lote é descartado em qualquer caso.
+ */
+static void sign_batch_confirm(const uint8_t *data, size_t len) {
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  size_t count = sign_batch_count;
+
+  sign_batch_count = 0;
+  if (count == 0 || len != SHA256_DIGEST_SIZE) {
+    send_response(STATUS_ERROR, NULL, 0);
+    return;
+  }
+  sha256_final(&sign_batch_digest, digest);
+  if (!librecipher_secure_compare(digest, data, SHA256_DIGEST_SIZE)) {
+    send_response(STATUS_ERROR, NULL, 0);
+    return;
+  }
+  if (wallet_get_status() != WALLET_STATUS_UNLOCKED) {
+    send_response(STATUS_LOCKED, NULL, 0);
+    return;
+  }
+  if (!user_confirm()) {
+    send_response(STATUS_DENIED, NULL, 0);
+    return;
+  }
+  if (!wallet_sign_batch(sign_batch, count, (wallet_curve_t)sign_batch_curve,
+                         send_signature_frame, NULL)) {
+    send_response(STATUS_ERROR, NULL, 0);
+  }
+}
+
 /**
  * Processa comando recebido
  */
@@ -75,8 +331,11 @@ static void process_command(uint8_t cmd, const uint8_t *data, size_t len) {
     break;
 
   case CMD_GET_STATUS: {
-    uint8_t status = wallet_get_status();
-    send_response(STATUS_OK, &status, 1);
+    // [status da wallet][falhas de saúde do TRNG (0 = OK)]
+    entropy_health_t health;
+    entropy_health_get(&health);
+    uint8_t status[2] = {(uint8_t)wallet_get_status(), health.failures};
+    send_response(STATUS_OK, status, sizeof(status));
     break;
   }
 
@@ -85,8 +344,10 @@ static void process_command(uint8_t cmd, const uint8_t *data, size_t len) {
       send_response(STATUS_ERROR, NULL, 0);
       break;
     }
-    if (wallet_create(data, len)) {
+    if (wallet_create(data, len, NULL)) {
       send_response(STATUS_OK, NULL, 0);
+    } else if (!librecipher_rng_healthy()) {
+      send_response(STATUS_RNG_FAILURE, NULL, 0);
     } else {
       send_response(STATUS_ERROR, NULL, 0);
     }
@@ -97,7 +358,7 @@ static void process_command(uint8_t cmd, const uint8_t *data, size_t len) {
       send_response(STATUS_ERROR, NULL, 0);
       break;
     }
-    if (wallet_unlock(data, len)) {
+    if (wallet_unlock(data, len, NULL)) {
       send_response(STATUS_OK, NULL, 0);
     } else {
       send_response(STATUS_ERROR, NULL, 0);
@@ -109,6 +370,71 @@ static void process_command(uint8_t cmd, const uint8_t *data, size_t len) {
     send_response(STATUS_OK, NULL, 0);
     break;
 
+  case CMD_BACKUP_SLIP39:
+    // [threshold][partes][PIN]
+    if (len < 3) {
+      send_response(STATUS_ERROR, NULL, 0);
+      break;
+    }
+    if (wallet_get_status() != WALLET_STATUS_UNLOCKED) {
+      send_response(STATUS_LOCKED, NULL, 0);
+      break;
+    }
+    // Sucesso: exatamente "partes" frames, sem frame final
+    if (!wallet_backup_slip39(&data[2], len - 2, data[0], data[1],
+                              send_share_frame, NULL)) {
+      send_response(librecipher_rng_healthy() ? STATUS_ERROR
+                                              : STATUS_RNG_FAILURE,
+                    NULL, 0);
+    }
+    break;
+
+  case CMD_BACKUP_EXPORT: {
+    // [tamanho da passphrase][passphrase][PIN]
+    size_t pass_len = len >= 1 ? data[0] : 0;
+    if (pass_len == 0 || len < 2 + pass_len) {
+      send_response(STATUS_ERROR, NULL, 0);
+      break;
+    }
+    if (wallet_get_status() != WALLET_STATUS_UNLOCKED) {
+      send_response(STATUS_LOCKED, NULL, 0);
+      break;
+    }
+    // Sucesso: cabeçalho e um frame por pedaço, o último com a flag
+    // WALLET_BACKUP_FLAG_LAST
+    if (!wallet_backup_export(&data[1 + pass_len], len - 1 - pass_len,
+                              &data[1], pass_len, send_backup_frame, NULL)) {
+      send_response(librecipher_rng_healthy() ? STATUS_ERROR
+                                              : STATUS_RNG_FAILURE,
+                    NULL, 0);
+    }
+    break;
+  }
+
+  case CMD_BACKUP_IMPORT:
+    backup_import(data, len);
+    break;
+
+  case CMD_SET_PASSPHRASE: {
+    // [passphrase] (vazio = sem passphrase); NUL no meio trocaria de
+    // wallet em silêncio
+    char passphrase[MAX_FRAME_SIZE];
+    if (memchr(data, '\0', len) != NULL) {
+      send_response(STATUS_ERROR, NULL, 0);
+      break;
+    }
+    if (wallet_get_status() != WALLET_STATUS_UNLOCKED) {
+      send_response(STATUS_LOCKED, NULL, 0);
+      break;
+    }
+    memcpy(passphrase, data, len);
+    passphrase[len] = '\0';
+    bool ok = wallet_set_passphrase(passphrase);
+    librecipher_secure_zero(passphrase, sizeof(passphrase));
+    send_response(ok ? STATUS_OK : STATUS_ERROR, NULL, 0);
+    break;
+  }
+
   case CMD_GET_ADDRESS: {
     if (len < 4) {
       send_response(STATUS_ERROR, NULL, 0);
@@ -116,7 +442,7 @@ static void process_command(uint8_t cmd, const uint8_t *data, size_t len) {
     }
     uint32_t index =
         data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
-    char address[64];
+    char address[WALLET_ADDRESS_MAX_LEN];
     size_t addr_len = wallet_get_address(index, address, sizeof(address));
     if (addr_len > 0) {
       send_response(STATUS_OK, (uint8_t *)address, addr_len);
@@ -126,59 +452,197 @@ static void process_command(uint8_t cmd, const uint8_t *data, size_t len) {
     break;
   }
 
+  case CMD_SIGN_TX:
+    sign_batch_add(data, len);
+    break;
+
+  case CMD_SIGN_CONFIRM:
+    sign_batch_confirm(data, len);
+    break;
+
+  case CMD_GET_ADDRESSES: {
+    // [conta LE32][papel][início LE32][quantidade]
+    if (len < 10 || data[9] == 0 || data[9] > GET_ADDRESSES_MAX_COUNT) {
+      send_response(STATUS_ERROR, NULL, 0);
+      break;
+    }
+    if (wallet_get_status() != WALLET_STATUS_UNLOCKED) {
+      send_response(STATUS_LOCKED, NULL, 0);
+      break;
+    }
+    // Sucesso: exatamente "quantidade" frames, sem frame final
+    if (!wallet_get_addresses(read_le32(&data[0]), data[4],
+                              read_le32(&data[5]), data[9],
+                              send_address_frame, NULL)) {
+      send_response(STATUS_ERROR, NULL, 0);
+    }
+    break;
+  }
+
   default:
     send_response(STATUS_INVALID_CMD, NULL, 0);
     break;
   }
 }
 
-/**
- * Inicializa protocolo
- */
-void usb_protocol_init(void) {
-  rx_pos = 0;
-  memset(rx_buffer, 0, sizeof(rx_buffer));
+// ============ Recepção CDC ============
+
+#if !LIBRECIPHER_HOST
+static uint32_t cdc_available(void) { return tud_cdc_available(); }
+
+// Sem a task USB do SDK em IRQ, o tud_task roda aqui; com ela, a leitura
+// não pode ser interrompida por um tud_task no meio
+static uint32_t cdc_read(uint8_t *buf, uint32_t len) {
+#if PICO_STDIO_USB_ENABLE_IRQ_BACKGROUND_TASK
+  uint32_t ints = save_and_disable_interrupts();
+  uint32_t n = tud_cdc_read(buf, len);
+  restore_interrupts(ints);
+  return n;
+#else
+  return tud_cdc_read(buf, len);
+#endif
+}
+
+static void cdc_poll(void) {
+#if !PICO_STDIO_USB_ENABLE_IRQ_BACKGROUND_TASK
+  tud_task();
+#endif
+}
+#else
+// CDC emulado: o que o host mandou, entregue como pelo TinyUSB, no máximo
+// uma FIFO de recepção (CFG_TUD_CDC_RX_BUFSIZE) por leitura
+#define SIM_CDC_FIFO_SIZE 256
+#define SIM_CDC_STREAM_SIZE 8192
+
+static struct {
+  uint8_t bytes[SIM_CDC_STREAM_SIZE];
+  size_t len;
+  size_t pos;
+} g_sim_cdc;
+
+static uint32_t cdc_available(void) {
+  size_t n = g_sim_cdc.len - g_sim_cdc.pos;
+  return n < SIM_CDC_FIFO_SIZE ? (uint32_t)n : SIM_CDC_FIFO_SIZE;
 }
 
+static uint32_t cdc_read(uint8_t *buf, uint32_t len) {
+  uint32_t n = cdc_available();
+  n = len < n ? len : n;
+  memcpy(buf, g_sim_cdc.bytes + g_sim_cdc.pos, n);
+  g_sim_cdc.pos += n;
+  return n;
+}
+
+static void cdc_poll(void) {}
+
+bool usb_protocol_sim_feed(const uint8_t *data, size_t len) {
+  memmove(g_sim_cdc.bytes, g_sim_cdc.bytes + g_sim_cdc.pos,
+          g_sim_cdc.len - g_sim_cdc.pos);
+  g_sim_cdc.len -= g_sim_cdc.pos;
+  g_sim_cdc.pos = 0;
+  if (len > sizeof(g_sim_cdc.bytes) - g_sim_cdc.len) {
+    return false;
+  }
+  memcpy(g_sim_cdc.bytes + g_sim_cdc.len, data, len);
+  g_sim_cdc.len += len;
+  return true;
+}
+#endif
+
 /**
- * Task do protocolo
+ * Move o que o CDC já recebeu para o anel, em blocos contíguos
+ * @return bytes lidos
  */
-void usb_protocol_task(void) {
-  int c = getchar_timeout_us(0);
-  if (c == PICO_ERROR_TIMEOUT) {
-    return;
+static uint32_t rx_fill(void) {
+  uint32_t total = 0;
+
+  while (rx_head - rx_tail < RX_RING_SIZE && cdc_available() > 0) {
+    uint32_t at = rx_head & (RX_RING_SIZE - 1);
+    uint32_t space = RX_RING_SIZE - (rx_head - rx_tail);
+    uint32_t span = RX_RING_SIZE - at < space ? RX_RING_SIZE - at : space;
+    uint32_t n = cdc_read(&rx_ring[at], span);
+    if (n == 0) {
+      break;
+    }
+    rx_head += n;
+    total += n;
   }
+  return total;
+}
 
-  rx_buffer[rx_pos++] = (uint8_t)c;
+static uint8_t rx_peek(uint32_t offset) {
+  return rx_ring[(rx_tail + offset) & (RX_RING_SIZE - 1)];
+}
 
-  // Verificar frame completo
-  if (rx_pos >= 4) {
-    if (rx_buffer[0] != SOF_BYTE) {
-      // Resync
-      rx_pos = 0;
-      return;
+/**
+ * Despacha todos os frames completos do anel
+ *
+ * Byte que não inicia um frame válido (SOF, LEN, CRC) é descartado e a
+ * busca recomeça no seguinte; um frame pela metade espera mais bytes.
+ */
+static void rx_parse(void) {
+  while (rx_head - rx_tail >= 2) {
+    size_t total = (size_t)rx_peek(1) + 4; // SOF + LEN + DATA + CRC
+    if (rx_peek(0) != SOF_BYTE || rx_peek(1) == 0 ||
+        total > MAX_FRAME_SIZE) {
+      rx_tail++;
+      continue;
+    }
+    if (rx_head - rx_tail < total) {
+      break;
     }
 
-    uint8_t frame_len = rx_buffer[1];
-    size_t expected_total = 2 + frame_len + 2; // SOF + LEN + DATA + CRC
+    uint32_t at = rx_tail & (RX_RING_SIZE - 1);
+    size_t first = RX_RING_SIZE - at < total ? RX_RING_SIZE - at : total;
+    memcpy(rx_buffer, &rx_ring[at], first);
+    memcpy(rx_buffer + first, rx_ring, total - first);
+    rx_tail += usb_protocol_process_frame(rx_buffer, total) ? total : 1;
+  }
+}
 
-    if (rx_pos >= expected_total) {
-      // Verificar CRC
-      uint16_t received_crc =
-          rx_buffer[expected_total - 2] | (rx_buffer[expected_total - 1] << 8);
-      uint16_t calc_crc = crc16(&rx_buffer[1], frame_len + 1);
+/**
+ * Inicializa protocolo
+ */
+void usb_protocol_init(void) {
+  rx_head = 0;
+  rx_tail = 0;
+  sign_batch_count = 0;
+  memset(rx_buffer, 0, sizeof(rx_buffer));
+}
 
-      if (received_crc == calc_crc) {
-        uint8_t cmd = rx_buffer[2];
-        process_command(cmd, &rx_buffer[3], frame_len - 1);
-      }
+/**
+ * Confere tamanho e CRC de um frame e despacha o comando
+ */
+bool usb_protocol_process_frame(const uint8_t *frame, size_t len) {
+  if (len < 5 || frame[0] != SOF_BYTE || frame[1] == 0 ||
+      len != (size_t)frame[1] + 4) {
+    return false;
+  }
 
-      rx_pos = 0;
-    }
+  uint8_t frame_len = frame[1];
+  uint16_t received_crc = frame[len - 2] | (frame[len - 1] << 8);
+  if (received_crc != crc16(&frame[1], frame_len + 1)) {
+    return false;
   }
+  process_command(frame[2], &frame[3], frame_len - 1);
+  return true;
+}
+
+void usb_protocol_set_writer(usb_protocol_writer_t writer, void *ctx) {
+  tx_writer = writer;
+  tx_writer_ctx = ctx;
+}
+
+/**
+ * Task do protocolo: tudo o que chegou desde a última chamada de uma vez
+ */
+bool usb_protocol_task(void) {
+  bool received = false;
 
-  // Overflow protection
-  if (rx_pos >= MAX_FRAME_SIZE) {
-    rx_pos = 0;
+  cdc_poll();
+  while (rx_fill() > 0) {
+    received = true;
+    rx_parse();
   }
+  return received || rx_head != rx_tail;
 }
@@ -0,0 +1,805 @@
+/**
+ * Log-Structured Encrypted Key-Value Store Implementation
+ *
+ * Sector layout:
+ *   [header 16: magic, seq, ~seq, live][record][record]...[0xFF...]
+ *
+ * `live` stays 0xFFFFFFFF while the sector is in use. GC reclaims a sector
+ * by programming it to 0 (one small program) and queues the erase for idle
+ * time with flash_nor_erase_later.
+ *
+ * Record layout (4-byte aligned):
+ *   [magic u16][id u16][len u16][flags u8][commit u8][seq u32][crc u16]
+ *   [0xFFFF][nonce 12][ciphertext len][tag 16]
+ *
+ * The header is programmed first (commit = 0xFF), then the rest of the
+ * record, then the commit byte alone is programmed to 0x00. The header CRC
+ * lets a scan trust the length of a record whose commit never landed and
+ * step over it; a header torn itself has nothing behind it and is stepped
+ * over as 16 bytes. A power loss therefore costs the bytes of one record,
+ * never the rest of its sector.
+ *
+ * Checkpoint: the first record of every sector is a snapshot of the RAM
+ * index, [count u8][count x (id u16, seq u32, offset u32, flags u8)]. It
+ * only repeats what the record headers already show in clear, so it is
+ * stored unsealed: nonce left blank, CRC-16 of the body in the tag field.
+ * Its own seq is the highest in the log when it is written. Mounting loads
+ * the newest sector's checkpoint and replays only the records after it.
+ */
+
+#include "kvstore.h"
+#include "librecipher.h"
+#include <string.h>
+
+#define SECTOR_MAGIC 0x534B434CU // "LCKS"
+#define SECTOR_HEADER_SIZE 16
+#define SECTOR_LIVE_OFFSET 12
+
+#define RECORD_MAGIC 0x564B // "KV"
+#define RECORD_HEADER_SIZE 16
+#define RECORD_OVERHEAD                                                        \
+  (RECORD_HEADER_SIZE + LIBRECIPHER_NONCE_SIZE + LIBRECIPHER_TAG_SIZE)
+#define RECORD_MAX_SIZE ((RECORD_OVERHEAD + KVSTORE_MAX_VALUE + 3) & ~3u)
+#define RECORD_COMMIT_OFFSET 7
+#define RECORD_COMMITTED 0x00
+#define RECORD_FLAG_TOMBSTONE 0x01
+
+#define RECORD_ID_INVALID 0xFFFF
+#define RECORD_ID_CHECKPOINT 0xFFFE
+
+#define CHECKPOINT_ENTRY_SIZE 11
+#define CHECKPOINT_MAX_SIZE (1 + KVSTORE_MAX_KEYS * CHECKPOINT_ENTRY_SIZE)
+_Static_assert(CHECKPOINT_MAX_SIZE <= KVSTORE_MAX_VALUE,
+               "checkpoint fits in one record");
+
+// Head sector with no room left: the next append opens a new sector
+#define HEAD_FULL FLASH_NOR_SECTOR_SIZE
+
+/**
+ * Free sectors user appends leave to the GC. The head is not counted, since
+ * a damaged record may have closed it: the reserve alone holds every live
+ * record of the oldest sector, with the checkpoint of each sector opened
+ * and the tail each one may waste.
+ */
+#define GC_RESERVE_SECTORS 2
+#define SECTOR_GC_ROOM                                                         \
+  (FLASH_NOR_SECTOR_SIZE - SECTOR_HEADER_SIZE -                                \
+   ((RECORD_OVERHEAD + CHECKPOINT_MAX_SIZE + 3) & ~3u) - (RECORD_MAX_SIZE - 4))
+_Static_assert(KVSTORE_MAX_KEYS * RECORD_MAX_SIZE <=
+                   GC_RESERVE_SECTORS * SECTOR_GC_ROOM,
+               "GC reserve holds every live record");
+_Static_assert(KVSTORE_MIN_SECTORS >= GC_RESERVE_SECTORS + 2,
+               "room for the head and the oldest sector besides the reserve");
+
+// Bound on GC steps spent making room for one put (every record of every
+// sector copied once)
+#define GC_STEP_LIMIT(kv)                                                      \
+  ((kv)->sector_count * (FLASH_NOR_SECTOR_SIZE / RECORD_OVERHEAD + 1))
+
+typedef struct {
+  uint16_t id;
+  uint16_t len;
+  uint8_t flags;
+  uint8_t commit;
+  uint32_t seq;
+} record_header_t;
+
+// What a walk over a sector finds at an offset
+typedef enum {
+  ENTRY_BLANK,  // End of the log: the next append goes here
+  ENTRY_RECORD, // Committed record
+  ENTRY_TORN,   // Append cut short: step over it
+  ENTRY_END,    // Sector full or damaged: nothing past here is trusted
+} entry_t;
+
+// ============ Encoding ============
+
+static void put_le16(uint8_t *p, uint16_t v) {
+  p[0] = v & 0xFF;
+  p[1] = v >> 8;
+}
+
+static void put_le32(uint8_t *p, uint32_t v) {
+  put_le16(p, v & 0xFFFF);
+  put_le16(p + 2, v >> 16);
+}
+
+static uint16_t get_le16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_le32(const uint8_t *p) {
+  return get_le16(p) | ((uint32_t)get_le16(p + 2) << 16);
+}
+
+// CRC-16/MODBUS
+static uint16_t crc16_update(uint16_t crc, const uint8_t *data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int j = 0; j < 8; j++) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+    }
+  }
+  return crc;
+}
+
+// Header CRC, commit byte excluded
+static uint16_t header_crc(const uint8_t *h) {
+  uint16_t crc = crc16_update(0xFFFF, h, RECORD_COMMIT_OFFSET);
+  return crc16_update(crc, h + 8, 4);
+}
+
+static size_t record_size(size_t len) {
+  return (RECORD_OVERHEAD + len + 3) & ~(size_t)3;
+}
+
+// Associated data: header fields that never change after sealing
+static void record_aad(uint8_t aad[12], const uint8_t *h) {
+  memcpy(aad, h, RECORD_COMMIT_OFFSET);
+  aad[RECORD_COMMIT_OFFSET] = 0;
+  memcpy(aad + 8, h + 8, 4);
+}
+
+/**
+ * Parse a record header
+ * @return false if it is not a well-formed header (blank or damaged)
+ */
+static bool parse_header(const uint8_t *h, record_header_t *rec) {
+  if (get_le16(h) != RECORD_MAGIC || get_le16(h + 12) != header_crc(h)) {
+    return false;
+  }
+  rec->id = get_le16(h + 2);
+  rec->len = get_le16(h + 4);
+  rec->flags = h[6];
+  rec->commit = h[RECORD_COMMIT_OFFSET];
+  rec->seq = get_le32(h + 8);
+  return rec->len <= KVSTORE_MAX_VALUE && rec->id != RECORD_ID_INVALID;
+}
+
+static bool header_blank(const uint8_t *h) {
+  for (size_t i = 0; i < RECORD_HEADER_SIZE; i++) {
+    if (h[i] != 0xFF) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static uint32_t sector_addr(const kvstore_t *kv, uint32_t sector) {
+  return kv->base + sector * FLASH_NOR_SECTOR_SIZE;
+}
+
+/**
+ * Classify the entry at `offset` of a sector
+ *
+ * A header that is neither blank nor well formed was torn while being
+ * programmed; appends flush the header before the body, so nothing sits
+ * behind it and the log carries on 16 bytes later.
+ * @param size set to the bytes to step over (record or torn header)
+ */
+static entry_t read_entry(const kvstore_t *kv, uint32_t sector,
+                          uint32_t offset, record_header_t *rec,
+                          uint32_t *size) {
+  uint8_t h[RECORD_HEADER_SIZE];
+
+  if (offset + RECORD_HEADER_SIZE > FLASH_NOR_SECTOR_SIZE ||
+      !flash_nor_read(sector_addr(kv, sector) + offset, h, sizeof(h))) {
+    return ENTRY_END;
+  }
+  if (header_blank(h)) {
+    return ENTRY_BLANK;
+  }
+  if (!parse_header(h, rec)) {
+    *size = RECORD_HEADER_SIZE;
+    return ENTRY_TORN;
+  }
+  *size = (uint32_t)record_size(rec->len);
+  if (offset + *size > FLASH_NOR_SECTOR_SIZE) {
+    return ENTRY_END;
+  }
+  return rec->commit == RECORD_COMMITTED ? ENTRY_RECORD : ENTRY_TORN;
+}
+
+// ============ RAM Index ============
+
+static kvstore_slot_t *index_find(kvstore_t *kv, uint16_t id) {
+  for (size_t i = 0; i < KVSTORE_MAX_KEYS; i++) {
+    if (kv->index[i].used && kv->index[i].id == id) {
+      return &kv->index[i];
+    }
+  }
+  return NULL;
+}
+
+static kvstore_slot_t *index_alloc(kvstore_t *kv, uint16_t id) {
+  kvstore_slot_t *slot = index_find(kv, id);
+  for (size_t i = 0; slot == NULL && i < KVSTORE_MAX_KEYS; i++) {
+    if (!kv->index[i].used) {
+      slot = &kv->index[i];
+      memset(slot, 0, sizeof(*slot));
+      slot->id = id;
+    }
+  }
+  return slot;
+}
+
+/**
+ * Record found by a scan: newest sequence wins, and on a tie (GC copy of
+ * the same record) the later position in the log
+ */
+static void index_update(kvstore_t *kv, const record_header_t *rec,
+                         uint32_t offset) {
+  kvstore_slot_t *slot = index_find(kv, rec->id);
+  if (slot != NULL && slot->seq > rec->seq) {
+    return;
+  }
+  if (slot == NULL && (slot = index_alloc(kv, rec->id)) == NULL) {
+    return;
+  }
+  slot->used = true;
+  slot->seq = rec->seq;
+  slot->offset = offset;
+  slot->deleted = (rec->flags & RECORD_FLAG_TOMBSTONE) != 0;
+}
+
+// ============ Sectors ============
+
+static bool read_sector_header(const kvstore_t *kv, uint32_t sector,
+                               uint32_t *seq) {
+  uint8_t h[SECTOR_HEADER_SIZE];
+
+  if (!flash_nor_read(sector_addr(kv, sector), h, sizeof(h)) ||
+      get_le32(h) != SECTOR_MAGIC || get_le32(h + 4) != ~get_le32(h + 8) ||
+      get_le32(h + 4) == 0 ||
+      get_le32(h + SECTOR_LIVE_OFFSET) != 0xFFFFFFFF) {
+    return false;
+  }
+  *seq = get_le32(h + 4);
+  return true;
+}
+
+uint32_t kvstore_free_sectors(const kvstore_t *kv) {
+  uint32_t free = 0;
+  for (uint32_t s = 0; s < kv->sector_count; s++) {
+    free += kv->sector_seq[s] == 0;
+  }
+  return free;
+}
+
+// Sector holding the oldest records, or sector_count if none in use
+static uint32_t oldest_sector(const kvstore_t *kv) {
+  uint32_t oldest = kv->sector_count;
+  for (uint32_t s = 0; s < kv->sector_count; s++) {
+    if (kv->sector_seq[s] != 0 &&
+        (oldest == kv->sector_count ||
+         kv->sector_seq[s] < kv->sector_seq[oldest])) {
+      oldest = s;
+    }
+  }
+  return oldest;
+}
+
+static bool write_checkpoint(kvstore_t *kv);
+
+// Free sector that can be programmed right away
+static bool sector_erased(kvstore_t *kv, uint32_t sector) {
+  uint32_t addr = sector_addr(kv, sector);
+  if (!(kv->erased_mask & (1u << sector)) &&
+      !flash_nor_erase_pending(addr) &&
+      flash_nor_is_erased(addr, FLASH_NOR_SECTOR_SIZE)) {
+    kv->erased_mask |= 1u << sector;
+  }
+  return (kv->erased_mask & (1u << sector)) != 0;
+}
+
+/**
+ * Open the next free sector in ring order as the new head, preferring one
+ * already erased; the foreground erases only when the idle pre-erase has
+ * not caught up
+ *
+ * User appends must leave the GC reserve behind for the copies that will
+ * reclaim space; GC itself may take the last free sector.
+ */
+static bool open_sector(kvstore_t *kv, bool for_gc) {
+  uint32_t free = kvstore_free_sectors(kv);
+  if (free == 0 || (!for_gc && free <= GC_RESERVE_SECTORS)) {
+    return false;
+  }
+
+  uint32_t s = kv->sector_count;
+  for (uint32_t i = 1; i <= kv->sector_count; i++) {
+    uint32_t c = (kv->head + i) % kv->sector_count;
+    if (kv->sector_seq[c] != 0) {
+      continue;
+    }
+    if (s == kv->sector_count) {
+      s = c;
+    }
+    if (sector_erased(kv, c)) {
+      s = c;
+      break;
+    }
+  }
+
+  uint32_t addr = sector_addr(kv, s);
+  if (!(kv->erased_mask & (1u << s)) &&
+      !flash_nor_erase(addr, FLASH_NOR_SECTOR_SIZE)) {
+    return false;
+  }
+
+  uint8_t h[SECTOR_HEADER_SIZE];
+  uint32_t seq = kv->next_sector_seq;
+  put_le32(h, SECTOR_MAGIC);
+  put_le32(h + 4, seq);
+  put_le32(h + 8, ~seq);
+  put_le32(h + 12, 0xFFFFFFFF);
+  kv->erased_mask &= ~(1u << s);
+  if (!flash_nor_program(addr, h, sizeof(h))) {
+    return false;
+  }
+
+  kv->sector_seq[s] = seq;
+  kv->next_sector_seq = seq + 1;
+  kv->head = s;
+  kv->head_offset = SECTOR_HEADER_SIZE;
+
+  // A torn checkpoint is stepped over like any torn record; the next
+  // mount then falls back to replaying the whole log
+  return write_checkpoint(kv);
+}
+
+/**
+ * Walk the records of a sector from `offset` into the RAM index, stepping
+ * over torn ones
+ * @return offset after the last record; HEAD_FULL if the sector is full or
+ *         was closed by a damaged record
+ */
+static uint32_t scan_sector(kvstore_t *kv, uint32_t sector, uint32_t offset,
+                            uint32_t *max_seq) {
+  uint32_t base = sector_addr(kv, sector);
+  record_header_t rec;
+  uint32_t size;
+
+  for (;;) {
+    entry_t entry = read_entry(kv, sector, offset, &rec, &size);
+    if (entry == ENTRY_BLANK) {
+      return offset;
+    }
+    if (entry == ENTRY_END) {
+      return HEAD_FULL;
+    }
+    if (entry == ENTRY_RECORD) {
+      if (rec.id != RECORD_ID_CHECKPOINT) {
+        index_update(kv, &rec, base + offset);
+      }
+      kv->mount_records++;
+      if (rec.seq > *max_seq) {
+        *max_seq = rec.seq;
+      }
+    }
+    offset += size;
+  }
+}
+
+// ============ Append ============
+
+/**
+ * Append a sealed record (commit byte still 0xFF) and commit it
+ *
+ * The header is flushed before the body, so a power loss cannot leave body
+ * bytes behind a torn header, and the body before the commit byte is
+ * programmed; the commit itself stays in the flash write-back window and
+ * goes out with the next flush (the next record, an erase, or the end of a
+ * put).
+ * @return flash offset of the record, 0 on failure
+ */
+static uint32_t append_record(kvstore_t *kv, const uint8_t *rec, size_t size,
+                              bool for_gc) {
+  if (kv->head_offset + size > FLASH_NOR_SECTOR_SIZE &&
+      !open_sector(kv, for_gc)) {
+    return 0;
+  }
+
+  static const uint8_t committed = RECORD_COMMITTED;
+  uint32_t addr = sector_addr(kv, kv->head) + kv->head_offset;
+  if (!flash_nor_program(addr, rec, RECORD_HEADER_SIZE) ||
+      !flash_nor_flush() ||
+      !flash_nor_program(addr + RECORD_HEADER_SIZE, rec + RECORD_HEADER_SIZE,
+                         size - RECORD_HEADER_SIZE) ||
+      !flash_nor_flush() ||
+      !flash_nor_program(addr + RECORD_COMMIT_OFFSET, &committed, 1)) {
+    // Failed append: nothing more goes into this sector until a remount
+    // finds where the log really ends
+    kv->head_offset = HEAD_FULL;
+    return 0;
+  }
+  kv->head_offset += (uint32_t)size;
+  return addr;
+}
+
+// Blank record buffer with its header filled in (commit still 0xFF)
+static size_t record_header(const kvstore_t *kv, uint8_t *rec, uint16_t id,
+                            size_t len, uint8_t flags) {
+  size_t size = record_size(len);
+
+  memset(rec, 0xFF, size);
+  put_le16(rec, RECORD_MAGIC);
+  put_le16(rec + 2, id);
+  put_le16(rec + 4, (uint16_t)len);
+  rec[6] = flags;
+  put_le32(rec + 8, kv->next_seq);
+  put_le16(rec + 12, header_crc(rec));
+  return size;
+}
+
+/**
+ * Seal a value (or a tombstone, len 0) into a record buffer
+ * @return record size, 0 if the RNG failed
+ */
+static size_t seal_record(const kvstore_t *kv, uint8_t *rec, uint16_t id,
+                          const void *value, size_t len, uint8_t flags) {
+  size_t size = record_header(kv, rec, id, len, flags);
+  uint8_t aad[12];
+
+  uint8_t *nonce = rec + RECORD_HEADER_SIZE;
+  uint8_t *ct = nonce + LIBRECIPHER_NONCE_SIZE;
+  if (!librecipher_random(nonce, LIBRECIPHER_NONCE_SIZE)) {
+    return 0;
+  }
+  record_aad(aad, rec);
+  librecipher_encrypt(kv->key, nonce, value, len, aad, sizeof(aad), ct,
+                      ct + len);
+  return size;
+}
+
+/**
+ * Whether a user append of `size` bytes leaves the GC reserve whole
+ *
+ * Once the GC has taken from the reserve, the head is left to its copies
+ * until the sector being reclaimed is retired; a closed head counts as no
+ * room, so opening the next one must leave the reserve behind.
+ */
+static bool user_room(const kvstore_t *kv, size_t size) {
+  uint32_t free = kvstore_free_sectors(kv);
+  if (free < GC_RESERVE_SECTORS) {
+    return false;
+  }
+  return kv->head_offset + size <= FLASH_NOR_SECTOR_SIZE ||
+         free > GC_RESERVE_SECTORS;
+}
+
+/**
+ * Make sure the next append of `size` bytes can go through
+ *
+ * Runs GC until user_room agrees. Also advances the GC one step ahead of
+ * need once only the reserve is left, so reclaiming is spread over several
+ * puts instead of landing on one.
+ */
+static bool make_room(kvstore_t *kv, size_t size) {
+  if (kvstore_free_sectors(kv) <= GC_RESERVE_SECTORS) {
+    kvstore_gc_step(kv);
+  }
+  for (uint32_t steps = 0; !user_room(kv, size); steps++) {
+    if (steps >= GC_STEP_LIMIT(kv) || !kvstore_gc_step(kv)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool write_record(kvstore_t *kv, kvstore_slot_t *slot, uint16_t id,
+                         const void *value, size_t len, uint8_t flags) {
+  uint8_t rec[RECORD_MAX_SIZE];
+
+  size_t size = seal_record(kv, rec, id, value, len, flags);
+  if (size == 0 || !make_room(kv, size)) {
+    return false;
+  }
+  // A put is durable once it returns
+  uint32_t addr = append_record(kv, rec, size, false);
+  if (addr == 0 || !flash_nor_flush()) {
+    kv->head_offset = HEAD_FULL;
+    return false;
+  }
+
+  slot->used = true;
+  slot->id = id;
+  slot->seq = kv->next_seq++;
+  slot->offset = addr;
+  slot->deleted = (flags & RECORD_FLAG_TOMBSTONE) != 0;
+  return true;
+}
+
+// ============ Checkpoints ============
+
+/**
+ * Snapshot the RAM index as the first record of the (fresh) head sector
+ */
+static bool write_checkpoint(kvstore_t *kv) {
+  uint8_t rec[RECORD_MAX_SIZE];
+  uint8_t *body = rec + RECORD_HEADER_SIZE + LIBRECIPHER_NONCE_SIZE;
+  uint8_t count = 0;
+
+  for (size_t i = 0; i < KVSTORE_MAX_KEYS; i++) {
+    count += kv->index[i].used;
+  }
+  size_t len = 1 + (size_t)count * CHECKPOINT_ENTRY_SIZE;
+  size_t size = record_header(kv, rec, RECORD_ID_CHECKPOINT, len, 0);
+
+  uint8_t *p = body;
+  *p++ = count;
+  for (size_t i = 0; i < KVSTORE_MAX_KEYS; i++) {
+    const kvstore_slot_t *slot = &kv->index[i];
+    if (!slot->used) {
+      continue;
+    }
+    put_le16(p, slot->id);
+    put_le32(p + 2, slot->seq);
+    put_le32(p + 6, slot->offset);
+    p[10] = slot->deleted ? RECORD_FLAG_TOMBSTONE : 0;
+    p += CHECKPOINT_ENTRY_SIZE;
+  }
+  put_le16(body + len, crc16_update(0xFFFF, body, len));
+  return append_record(kv, rec, size, true) != 0;
+}
+
+/**
+ * Rebuild the RAM index from the checkpoint of `sector` plus the records
+ * written after it
+ *
+ * Each entry is checked against the record header it points to, in a
+ * sector still in use: entries whose record was since moved by GC (the
+ * copy is in the tail) or retired along with a dropped tombstone are left
+ * out.
+ * @return false if the sector does not start with a valid checkpoint
+ */
+static bool load_checkpoint(kvstore_t *kv, uint32_t sector) {
+  uint8_t cp[RECORD_MAX_SIZE];
+  uint8_t h[RECORD_HEADER_SIZE];
+  record_header_t hdr, rec;
+
+  const uint8_t *plain = cp + RECORD_HEADER_SIZE + LIBRECIPHER_NONCE_SIZE;
+  uint32_t addr = sector_addr(kv, sector) + SECTOR_HEADER_SIZE;
+  if (!flash_nor_read(addr, cp, RECORD_HEADER_SIZE) ||
+      !parse_header(cp, &hdr) || hdr.id != RECORD_ID_CHECKPOINT ||
+      hdr.commit != RECORD_COMMITTED || hdr.len == 0 ||
+      !flash_nor_read(addr + RECORD_HEADER_SIZE, cp + RECORD_HEADER_SIZE,
+                      record_size(hdr.len) - RECORD_HEADER_SIZE)) {
+    return false;
+  }
+  size_t len = hdr.len;
+  if (get_le16(plain + len) != crc16_update(0xFFFF, plain, len) ||
+      plain[0] > KVSTORE_MAX_KEYS ||
+      len != 1 + (size_t)plain[0] * CHECKPOINT_ENTRY_SIZE) {
+    return false;
+  }
+
+  uint32_t max_seq = hdr.seq;
+  for (size_t i = 0; i < plain[0]; i++) {
+    const uint8_t *e = plain + 1 + i * CHECKPOINT_ENTRY_SIZE;
+    rec.id = get_le16(e);
+    rec.seq = get_le32(e + 2);
+    rec.flags = e[10];
+    uint32_t offset = get_le32(e + 6);
+    uint32_t owner = (offset - kv->base) / FLASH_NOR_SECTOR_SIZE;
+
+    if (offset >= kv->base && owner < kv->sector_count &&
+        kv->sector_seq[owner] != 0 && flash_nor_read(offset, h, sizeof(h)) &&
+        parse_header(h, &hdr) && hdr.commit == RECORD_COMMITTED &&
+        hdr.id == rec.id && hdr.seq == rec.seq) {
+      index_update(kv, &rec, offset);
+    }
+  }
+  kv->mount_records += 1 + plain[0];
+
+  kv->head = sector;
+  kv->head_offset = scan_sector(
+      kv, sector, SECTOR_HEADER_SIZE + (uint32_t)record_size(len), &max_seq);
+  kv->next_seq = max_seq + 1;
+  return true;
+}
+
+// Sectors in use, oldest first (insertion sort, a handful of entries)
+static uint32_t sectors_by_age(const kvstore_t *kv,
+                               uint32_t order[KVSTORE_MAX_SECTORS]) {
+  uint32_t used = 0;
+  for (uint32_t s = 0; s < kv->sector_count; s++) {
+    if (kv->sector_seq[s] == 0) {
+      continue;
+    }
+    uint32_t i = used++;
+    for (; i > 0 && kv->sector_seq[order[i - 1]] > kv->sector_seq[s]; i--) {
+      order[i] = order[i - 1];
+    }
+    order[i] = s;
+  }
+  return used;
+}
+
+// Replay every record of every sector; the newest sector becomes the head
+static void replay_log(kvstore_t *kv) {
+  uint32_t order[KVSTORE_MAX_SECTORS];
+  uint32_t used = sectors_by_age(kv, order);
+  uint32_t max_seq = 0;
+
+  memset(kv->index, 0, sizeof(kv->index));
+  kv->mount_records = 0;
+  kv->head = kv->sector_count - 1;
+  kv->head_offset = HEAD_FULL;
+  for (uint32_t i = 0; i < used; i++) {
+    kv->head = order[i];
+    kv->head_offset = scan_sector(kv, order[i], SECTOR_HEADER_SIZE, &max_seq);
+  }
+  kv->next_seq = max_seq + 1;
+}
+
+// ============ Public API ============
+
+bool kvstore_mount(kvstore_t *kv, uint32_t base, uint32_t sector_count,
+                   const uint8_t key[32]) {
+  uint32_t newest = sector_count;
+
+  if (base % FLASH_NOR_SECTOR_SIZE != 0 ||
+      sector_count < KVSTORE_MIN_SECTORS ||
+      sector_count > KVSTORE_MAX_SECTORS) {
+    return false;
+  }
+
+  memset(kv, 0, sizeof(*kv));
+  memcpy(kv->key, key, sizeof(kv->key));
+  kv->base = base;
+  kv->sector_count = sector_count;
+  kv->next_sector_seq = 1;
+
+  for (uint32_t s = 0; s < sector_count; s++) {
+    uint8_t h[SECTOR_HEADER_SIZE];
+    uint32_t seq;
+    if (!read_sector_header(kv, s, &seq)) {
+      // Retired or torn header: erase it in the background
+      if (flash_nor_read(sector_addr(kv, s), h, sizeof(h)) &&
+          !header_blank(h)) {
+        flash_nor_erase_later(sector_addr(kv, s), NULL);
+      }
+      continue;
+    }
+    kv->sector_seq[s] = seq;
+    if (seq >= kv->next_sector_seq) {
+      kv->next_sector_seq = seq + 1;
+      newest = s;
+    }
+  }
+
+  // Latest checkpoint plus tail; full replay if it is missing or torn
+  if (newest == sector_count || !load_checkpoint(kv, newest)) {
+    replay_log(kv);
+  }
+  kv->gc_offset = SECTOR_HEADER_SIZE;
+  return true;
+}
+
+void kvstore_rebuild(kvstore_t *kv) {
+  replay_log(kv);
+  kv->gc_offset = SECTOR_HEADER_SIZE;
+}
+
+void kvstore_unmount(kvstore_t *kv) {
+  librecipher_secure_zero(kv, sizeof(*kv));
+}
+
+bool kvstore_put(kvstore_t *kv, uint16_t id, const void *value, size_t len) {
+  if (id > KVSTORE_ID_MAX || len == 0 || len > KVSTORE_MAX_VALUE) {
+    return false;
+  }
+  kvstore_slot_t *slot = index_alloc(kv, id);
+  if (slot == NULL) {
+    return false;
+  }
+  return write_record(kv, slot, id, value, len, 0);
+}
+
+size_t kvstore_get(kvstore_t *kv, uint16_t id, void *value, size_t size) {
+  uint8_t rec[RECORD_MAX_SIZE];
+  uint8_t plain[KVSTORE_MAX_VALUE];
+  uint8_t aad[12];
+  record_header_t hdr;
+
+  kvstore_slot_t *slot = index_find(kv, id);
+  if (slot == NULL || slot->deleted ||
+      !flash_nor_read(slot->offset, rec, RECORD_HEADER_SIZE) ||
+      !parse_header(rec, &hdr) || hdr.len > size ||
+      !flash_nor_read(slot->offset + RECORD_HEADER_SIZE,
+                      rec + RECORD_HEADER_SIZE,
+                      record_size(hdr.len) - RECORD_HEADER_SIZE)) {
+    return 0;
+  }
+
+  const uint8_t *nonce = rec + RECORD_HEADER_SIZE;
+  const uint8_t *ct = nonce + LIBRECIPHER_NONCE_SIZE;
+  record_aad(aad, rec);
+  bool ok = librecipher_decrypt(kv->key, nonce, ct, hdr.len, aad, sizeof(aad),
+                                ct + hdr.len, plain);
+  if (ok) {
+    memcpy(value, plain, hdr.len);
+  }
+  librecipher_secure_zero(plain, sizeof(plain));
+  return ok ? hdr.len : 0;
+}
+
+bool kvstore_delete(kvstore_t *kv, uint16_t id) {
+  kvstore_slot_t *slot = index_find(kv, id);
+  if (slot == NULL || slot->deleted) {
+    return true;
+  }
+  return write_record(kv, slot, id, NULL, 0, RECORD_FLAG_TOMBSTONE);
+}
+
+bool kvstore_format(kvstore_t *kv) {
+  uint8_t key[32];
+
+  if (!flash_nor_erase(kv->base, kv->sector_count * FLASH_NOR_SECTOR_SIZE)) {
+    return false;
+  }
+  memcpy(key, kv->key, sizeof(key));
+  bool ok = kvstore_mount(kv, kv->base, kv->sector_count, key);
+  librecipher_secure_zero(key, sizeof(key));
+  kv->erased_mask = kv->sector_count == 32 ? ~0u
+                                           : (1u << kv->sector_count) - 1;
+  return ok;
+}
+
+/**
+ * Copy-then-erase: a live record is appended again unchanged (same seq,
+ * nonce and tag) before its sector goes away, so a power loss in between
+ * leaves two identical copies and nothing lost. Tombstones are dropped:
+ * every older record of their id sits in this sector or older ones.
+ */
+bool kvstore_gc_step(kvstore_t *kv) {
+  uint8_t rec[RECORD_MAX_SIZE];
+  record_header_t hdr;
+  uint32_t size;
+
+  uint32_t oldest = oldest_sector(kv);
+  if (oldest == kv->sector_count || oldest == kv->head) {
+    return false;
+  }
+
+  uint32_t base = sector_addr(kv, oldest);
+  uint32_t offset = kv->gc_offset;
+  entry_t entry = read_entry(kv, oldest, offset, &hdr, &size);
+  if (entry == ENTRY_TORN) {
+    kv->gc_offset = offset + size;
+    return true;
+  }
+  if (entry == ENTRY_RECORD) {
+    kvstore_slot_t *slot = index_find(kv, hdr.id);
+
+    if (slot != NULL && slot->offset == base + offset) {
+      if (slot->deleted) {
+        slot->used = false;
+      } else {
+        flash_nor_read(base + offset, rec, size);
+        rec[RECORD_COMMIT_OFFSET] = 0xFF;
+        uint32_t addr = append_record(kv, rec, size, true);
+        if (addr == 0) {
+          return false;
+        }
+        slot->offset = addr;
+      }
+    }
+    kv->gc_offset = offset + size;
+    return true;
+  }
+
+  // Nothing live left past the cursor: retire the sector once the copies
+  // are in flash, and leave the erase to idle time
+  static const uint8_t dead[4] = {0};
+  if (!flash_nor_flush() ||
+      !flash_nor_program(base + SECTOR_LIVE_OFFSET, dead, sizeof(dead)) ||
+      !flash_nor_flush()) {
+    return false;
+  }
+  kv->sector_seq[oldest] = 0;
+  kv->gc_offset = SECTOR_HEADER_SIZE;
+  flash_nor_erase_later(base, NULL);
+  return true;
+}
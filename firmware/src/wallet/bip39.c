@@ -0,0 +1,182 @@
+/**
+ * BIP-39 - Implementação
+ */
+
+#include "bip39.h"
+#include "librecipher.h"
+#include "pbkdf2.h"
+#include "sha256.h"
+#include "wordlist.h"
+#include <string.h>
+
+// Índice gerado por tools/gen_bip39_index.py: entradas em ordem alfabética,
+// agrupadas pela primeira letra
+extern const uint16_t bip39_letter_start[27];
+extern const uint32_t bip39_entries[BIP39_WORD_COUNT];
+extern const char bip39_suffixes[];
+extern const uint32_t bip39_index_bytes;
+
+static const wordlist_t g_words = {bip39_letter_start, bip39_entries,
+                                   bip39_suffixes, BIP39_WORD_COUNT};
+
+// ============ Lista de Palavras ============
+
+size_t bip39_prefix_range(const char *prefix, size_t len, uint16_t *first) {
+  return wordlist_prefix_range(&g_words, prefix, len, first);
+}
+
+int bip39_word_index(const char *word, size_t len) {
+  return wordlist_index(&g_words, word, len);
+}
+
+size_t bip39_word(uint16_t index, char *word) {
+  return wordlist_word(&g_words, index, word);
+}
+
+size_t bip39_index_size(void) { return bip39_index_bytes; }
+
+// ============ Mnemonic ============
+
+/**
+ * Valida mnemonic e extrai a entropia (11 bits por palavra, checksum de
+ * ENT/32 bits no fim)
+ */
+bool bip39_mnemonic_to_entropy(const char *mnemonic, uint8_t *entropy,
+                               size_t *entropy_len) {
+  uint8_t bits[BIP39_MAX_ENTROPY + 1]; // Entropia || checksum
+  size_t words = 0;
+  const char *p = mnemonic;
+
+  memset(bits, 0, sizeof(bits));
+  for (;;) {
+    const char *end = p;
+    while (*end != ' ' && *end != '\0') {
+      end++;
+    }
+
+    int index = words < BIP39_MAX_WORDS ? bip39_word_index(p, end - p) : -1;
+    if (index < 0) {
+      librecipher_secure_zero(bits, sizeof(bits));
+      return false;
+    }
+    for (int b = 0; b < 11; b++) {
+      size_t pos = words * 11 + b;
+      if (index & (1 << (10 - b))) {
+        bits[pos / 8] |= (uint8_t)(0x80 >> (pos % 8));
+      }
+    }
+    words++;
+
+    if (*end == '\0') {
+      break;
+    }
+    p = end + 1; // Exatamente um espaço: "a  b" e "a " falham na palavra vazia
+  }
+
+  if (words < BIP39_MIN_WORDS || words % 3 != 0) {
+    librecipher_secure_zero(bits, sizeof(bits));
+    return false;
+  }
+
+  // ENT = 32 * words / 3 bits, CS = ENT / 32 bits
+  size_t ent_bytes = words * 4 / 3;
+  size_t cs_bits = words / 3;
+  uint8_t hash[32];
+  sha256_hash(bits, ent_bytes, hash);
+  uint8_t mask = (uint8_t)(0xFF << (8 - cs_bits));
+  bool ok = ((hash[0] ^ bits[ent_bytes]) & mask) == 0;
+
+  if (ok) {
+    memcpy(entropy, bits, ent_bytes);
+    *entropy_len = ent_bytes;
+  }
+  librecipher_secure_zero(bits, sizeof(bits));
+  librecipher_secure_zero(hash, sizeof(hash));
+  return ok;
+}
+
+/**
+ * Valida mnemonic (palavras e checksum)
+ */
+bool bip39_mnemonic_check(const char *mnemonic) {
+  uint8_t entropy[BIP39_MAX_ENTROPY];
+  size_t entropy_len;
+  bool ok = bip39_mnemonic_to_entropy(mnemonic, entropy, &entropy_len);
+  librecipher_secure_zero(entropy, sizeof(entropy));
+  return ok;
+}
+
+/**
+ * Entropia para mnemonic: entropia || checksum em grupos de 11 bits
+ */
+size_t bip39_entropy_to_mnemonic(const uint8_t *entropy, size_t entropy_len,
+                                 char *mnemonic, size_t size) {
+  uint8_t bits[BIP39_MAX_ENTROPY + 1];
+  uint8_t hash[32];
+
+  if (entropy_len < 16 || entropy_len > BIP39_MAX_ENTROPY ||
+      entropy_len % 4 != 0) {
+    return 0;
+  }
+  memcpy(bits, entropy, entropy_len);
+  sha256_hash(entropy, entropy_len, hash);
+  bits[entropy_len] = hash[0]; // Só os primeiros ENT/32 bits são usados
+
+  size_t words = entropy_len * 3 / 4;
+  size_t len = 0;
+  for (size_t w = 0; w < words; w++) {
+    uint16_t index = 0;
+    for (int b = 0; b < 11; b++) {
+      size_t pos = w * 11 + b;
+      index = (uint16_t)((index << 1) | ((bits[pos / 8] >> (7 - pos % 8)) & 1));
+    }
+
+    char word[BIP39_MAX_WORD_LEN + 1];
+    size_t n = bip39_word(index, word);
+    if (len + n + 1 > size) { // Palavra + separador ou terminador
+      len = 0;
+      break;
+    }
+    if (w > 0) {
+      mnemonic[len - 1] = ' ';
+    }
+    memcpy(mnemonic + len, word, n);
+    len += n;
+    mnemonic[len++] = '\0';
+    librecipher_secure_zero(word, sizeof(word));
+  }
+
+  librecipher_secure_zero(bits, sizeof(bits));
+  librecipher_secure_zero(hash, sizeof(hash));
+  if (len == 0) {
+    librecipher_secure_zero(mnemonic, size);
+    return 0;
+  }
+  return len - 1;
+}
+
+/**
+ * Mnemonic para seed (PBKDF2 com midstates, ver pbkdf2.h)
+ */
+bool bip39_mnemonic_to_seed(const char *mnemonic, const char *passphrase,
+                            uint8_t seed[BIP39_SEED_SIZE]) {
+  static const char prefix[] = "mnemonic";
+  uint8_t salt[sizeof(prefix) - 1 + BIP39_MAX_PASSPHRASE];
+
+  size_t passphrase_len = passphrase ? strlen(passphrase) : 0;
+  if (passphrase_len > BIP39_MAX_PASSPHRASE) {
+    return false;
+  }
+
+  memcpy(salt, prefix, sizeof(prefix) - 1);
+  if (passphrase_len > 0) {
+    memcpy(salt + sizeof(prefix) - 1, passphrase, passphrase_len);
+  }
+
+  pbkdf2_hmac_sha512((const uint8_t *)mnemonic, strlen(mnemonic), salt,
+                     sizeof(prefix) - 1 + passphrase_len, BIP39_ITERATIONS,
+                     seed, BIP39_SEED_SIZE);
+
+  librecipher_secure_zero(salt, sizeof(salt));
+  return true;
+}
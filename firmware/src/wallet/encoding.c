@@ -0,0 +1,207 @@
+/**
+ * Codificação de endereços - Implementação
+ */
+
+#include "encoding.h"
+#include "sha256.h"
+#include <string.h>
+
+// ============ bech32 ============
+
+static const char BECH32_CHARSET[] = "qpzry9x8gf2tvdw0s3jn54khce6mua7l";
+
+// XOR dos geradores BCH selecionados pelos 5 bits que saem do checksum
+static const uint32_t BECH32_GEN_TABLE[32] = {
+    0x00000000, 0x3B6A57B2, 0x26508E6D, 0x1D3AD9DF,
+    0x1EA119FA, 0x25CB4E48, 0x38F19797, 0x039BC025,
+    0x3D4233DD, 0x0628646F, 0x1B12BDB0, 0x2078EA02,
+    0x23E32A27, 0x18897D95, 0x05B3A44A, 0x3ED9F3F8,
+    0x2A1462B3, 0x117E3501, 0x0C44ECDE, 0x372EBB6C,
+    0x34B57B49, 0x0FDF2CFB, 0x12E5F524, 0x298FA296,
+    0x1756516E, 0x2C3C06DC, 0x3106DF03, 0x0A6C88B1,
+    0x09F74894, 0x329D1F26, 0x2FA7C6F9, 0x14CD914B,
+};
+
+static inline uint32_t polymod_step(uint32_t chk, uint32_t value) {
+  return ((chk & 0x1FFFFFF) << 5) ^ value ^ BECH32_GEN_TABLE[chk >> 25];
+}
+
+/**
+ * hrp || '1' || [versão] || dados em 5 bits || checksum
+ * @param version versão segwit, ou -1 para nenhuma
+ */
+static size_t bech32_encode_impl(char *out, size_t out_size, const char *hrp,
+                                 int version, const uint8_t *data,
+                                 size_t data_len, uint32_t constant) {
+  size_t hrp_len = strlen(hrp);
+  size_t groups = (data_len * 8 + 4) / 5 + (version >= 0 ? 1 : 0);
+  size_t total = hrp_len + 1 + groups + 6;
+
+  if (hrp_len == 0 || total >= out_size) {
+    return 0;
+  }
+
+  // Expansão do hrp: bits altos, separador zero, bits baixos
+  uint32_t chk = 1;
+  for (size_t i = 0; i < hrp_len; i++) {
+    uint8_t c = (uint8_t)hrp[i];
+    if (c < 33 || c > 126 || (c >= 'A' && c <= 'Z')) {
+      return 0;
+    }
+    chk = polymod_step(chk, c >> 5);
+  }
+  chk = polymod_step(chk, 0);
+  for (size_t i = 0; i < hrp_len; i++) {
+    chk = polymod_step(chk, (uint8_t)hrp[i] & 31);
+    out[i] = hrp[i];
+  }
+
+  char *p = out + hrp_len;
+  *p++ = '1';
+
+  if (version >= 0) {
+    chk = polymod_step(chk, (uint32_t)version);
+    *p++ = BECH32_CHARSET[version];
+  }
+
+  // 8 -> 5 bits em streaming, último grupo completado com zeros
+  uint32_t acc = 0;
+  int bits = 0;
+  for (size_t i = 0; i < data_len; i++) {
+    acc = ((acc << 8) | data[i]) & 0xFFF;
+    bits += 8;
+    while (bits >= 5) {
+      bits -= 5;
+      uint32_t v = (acc >> bits) & 31;
+      chk = polymod_step(chk, v);
+      *p++ = BECH32_CHARSET[v];
+    }
+  }
+  if (bits > 0) {
+    uint32_t v = (acc << (5 - bits)) & 31;
+    chk = polymod_step(chk, v);
+    *p++ = BECH32_CHARSET[v];
+  }
+
+  for (int i = 0; i < 6; i++) {
+    chk = polymod_step(chk, 0);
+  }
+  chk ^= constant;
+  for (int i = 0; i < 6; i++) {
+    *p++ = BECH32_CHARSET[(chk >> (5 * (5 - i))) & 31];
+  }
+  *p = '\0';
+
+  return total;
+}
+
+size_t bech32_encode(char *out, size_t out_size, const char *hrp,
+                     const uint8_t *data, size_t data_len,
+                     bech32_encoding_t encoding) {
+  return bech32_encode_impl(out, out_size, hrp, -1, data, data_len,
+                            (uint32_t)encoding);
+}
+
+size_t segwit_address_encode(char *out, size_t out_size, const char *hrp,
+                             uint8_t version, const uint8_t *program,
+                             size_t program_len) {
+  if (version > 16 || program_len < 2 || program_len > 40 ||
+      (version == 0 && program_len != 20 && program_len != 32)) {
+    return 0;
+  }
+  return bech32_encode_impl(out, out_size, hrp, version, program, program_len,
+                            version == 0 ? BECH32_ENCODING_BECH32
+                                         : BECH32_ENCODING_BECH32M);
+}
+
+// ============ base58 ============
+
+static const char BASE58_ALPHABET[] =
+    "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+#define BASE58_RADIX 656356768u // 58^5
+#define BASE58_WORDS 32         // BASE58_MAX_INPUT em palavras de 16 bits
+#define BASE58_LIMBS 18         // Limbs de 58^5 para 2^512
+
+// Gerada por tools/gen_base58_tables.py: linha i = 2^(16*(31-i)) em raiz
+// 58^5, limbs big-endian
+extern const uint32_t base58_word_table[BASE58_WORDS][BASE58_LIMBS];
+
+size_t base58_encode(char *out, size_t out_size, const uint8_t *data,
+                     size_t len) {
+  uint64_t acc[BASE58_LIMBS];
+  uint8_t digits[BASE58_LIMBS * 5];
+
+  if (len > BASE58_MAX_INPUT) {
+    return 0;
+  }
+
+  size_t zeros = 0;
+  while (zeros < len && data[zeros] == 0) {
+    zeros++;
+  }
+
+  // Limbs que podem ser não nulos: 16 bits por palavra, log2(58^5) > 29
+  size_t words = (len + 1) / 2;
+  size_t used = (words * 16 + 28) / 29;
+  size_t first = used < BASE58_LIMBS ? BASE58_LIMBS - used : 0;
+
+  memset(acc, 0, sizeof(acc));
+  for (size_t k = 0; k < words; k++) {
+    uint32_t w;
+    if (k == 0 && (len & 1)) {
+      w = *data++; // Comprimento ímpar: primeira palavra tem um byte
+    } else {
+      w = ((uint32_t)data[0] << 8) | data[1];
+      data += 2;
+    }
+    const uint32_t *row = base58_word_table[BASE58_WORDS - words + k];
+    for (size_t j = first; j < BASE58_LIMBS; j++) {
+      acc[j] += (uint64_t)w * row[j];
+    }
+  }
+
+  // Normalização: uma divisão por limb, depois 5 dígitos por limb
+  uint64_t carry = 0;
+  for (size_t j = BASE58_LIMBS; j-- > first;) {
+    uint64_t v = acc[j] + carry;
+    carry = v / BASE58_RADIX;
+    uint32_t limb = (uint32_t)(v - carry * BASE58_RADIX);
+    for (int d = 4; d >= 0; d--) {
+      digits[5 * j + d] = (uint8_t)(limb % 58);
+      limb /= 58;
+    }
+  }
+
+  size_t skip = 5 * first;
+  while (skip < sizeof(digits) && digits[skip] == 0) {
+    skip++;
+  }
+
+  size_t total = zeros + sizeof(digits) - skip;
+  if (total >= out_size) {
+    return 0;
+  }
+  memset(out, '1', zeros);
+  for (size_t i = skip; i < sizeof(digits); i++) {
+    out[zeros + i - skip] = BASE58_ALPHABET[digits[i]];
+  }
+  out[total] = '\0';
+  return total;
+}
+
+size_t base58check_encode(char *out, size_t out_size, const uint8_t *payload,
+                          size_t len) {
+  uint8_t buf[BASE58_MAX_INPUT];
+  uint8_t hash[32];
+
+  if (len > BASE58CHECK_MAX_PAYLOAD) {
+    return 0;
+  }
+  memcpy(buf, payload, len);
+  sha256_hash(payload, len, hash);
+  sha256_hash(hash, sizeof(hash), hash);
+  memcpy(buf + len, hash, 4);
+
+  return base58_encode(out, out_size, buf, len + 4);
+}
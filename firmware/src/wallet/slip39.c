@@ -0,0 +1,501 @@
+/**
+ * SLIP-39 - Implementação
+ */
+
+#include "slip39.h"
+#include "gf256.h"
+#include "librecipher.h"
+#include "pbkdf2.h"
+#include "wordlist.h"
+#include <string.h>
+
+// Índice gerado por tools/gen_slip39_index.py (formato do índice BIP-39)
+extern const uint16_t slip39_letter_start[27];
+extern const uint32_t slip39_entries[SLIP39_WORD_COUNT];
+extern const char slip39_suffixes[];
+extern const uint32_t slip39_index_bytes;
+
+static const wordlist_t g_words = {slip39_letter_start, slip39_entries,
+                                   slip39_suffixes, SLIP39_WORD_COUNT};
+
+// Palavras de metadados: identificador, flags e índices (4) + checksum (3)
+#define HEADER_WORDS 4
+#define CHECKSUM_WORDS 3
+#define METADATA_WORDS (HEADER_WORDS + CHECKSUM_WORDS)
+
+// Pontos reservados do polinômio: segredo e digest
+#define SECRET_INDEX 255
+#define DIGEST_INDEX 254
+#define DIGEST_SIZE 4
+
+#define FEISTEL_ROUNDS 4
+
+// ============ Lista de Palavras ============
+
+int slip39_word_index(const char *word, size_t len) {
+  return wordlist_index(&g_words, word, len);
+}
+
+size_t slip39_prefix_range(const char *prefix, size_t len, uint16_t *first) {
+  return wordlist_prefix_range(&g_words, prefix, len, first);
+}
+
+size_t slip39_word(uint16_t index, char *word) {
+  return wordlist_word(&g_words, index, word);
+}
+
+size_t slip39_index_size(void) { return slip39_index_bytes; }
+
+// ============ Checksum RS1024 ============
+
+static const uint32_t RS1024_GEN[10] = {
+    0x00E0E040, 0x01C1C080, 0x03838100, 0x07070200, 0x0E0E0009,
+    0x1C0C2412, 0x38086C24, 0x3090FC48, 0x21B1F890, 0x03F3F120,
+};
+
+static uint32_t rs1024_step(uint32_t chk, uint32_t value) {
+  uint32_t top = chk >> 20;
+  chk = ((chk & 0xFFFFF) << 10) ^ value;
+  for (int i = 0; i < 10; i++) {
+    chk ^= RS1024_GEN[i] & -((top >> i) & 1);
+  }
+  return chk;
+}
+
+/**
+ * Polymod da string de customização seguida das palavras
+ */
+static uint32_t rs1024_polymod(bool extendable, const uint16_t *words,
+                               size_t count) {
+  static const char plain[] = "shamir";
+  static const char extended[] = "shamir_extendable";
+  const char *cs = extendable ? extended : plain;
+  uint32_t chk = 1;
+
+  for (; *cs != '\0'; cs++) {
+    chk = rs1024_step(chk, (uint8_t)*cs);
+  }
+  for (size_t i = 0; i < count; i++) {
+    chk = rs1024_step(chk, words[i]);
+  }
+  return chk;
+}
+
+// ============ Codificação das Partes ============
+
+/**
+ * Layout em palavras de 10 bits:
+ * [id 15][ext 1][e 4] [grupo 4][GT-1 4][G-1 4] [membro 4][T-1 4]
+ * [valor com zeros à esquerda até múltiplo de 10 bits][checksum 30]
+ */
+size_t slip39_share_to_words(const slip39_share_t *share, uint16_t *words) {
+  size_t len = share->value_len;
+  if (len < SLIP39_MIN_SECRET || len > SLIP39_MAX_SECRET ||
+      share->identifier > 0x7FFF || share->iteration_exponent > 15 ||
+      share->group_index > 15 || share->group_threshold == 0 ||
+      share->group_threshold > share->group_count ||
+      share->group_count > 16 || share->member_index > 15 ||
+      share->member_threshold == 0 || share->member_threshold > 16) {
+    return 0;
+  }
+
+  words[0] = share->identifier >> 5;
+  words[1] = (uint16_t)(((share->identifier & 0x1F) << 5) |
+                        (share->extendable ? 0x10 : 0) |
+                        share->iteration_exponent);
+  words[2] = (uint16_t)((share->group_index << 6) |
+                        ((share->group_threshold - 1) << 2) |
+                        ((share->group_count - 1) >> 2));
+  words[3] = (uint16_t)((((share->group_count - 1) & 3) << 8) |
+                        (share->member_index << 4) |
+                        (share->member_threshold - 1));
+
+  size_t value_words = (8 * len + 9) / 10;
+  size_t padding = 10 * value_words - 8 * len;
+  for (size_t w = 0; w < value_words; w++) {
+    uint16_t v = 0;
+    for (size_t b = 0; b < 10; b++) {
+      size_t pos = 10 * w + b; // Posição no valor com padding
+      uint16_t bit = 0;
+      if (pos >= padding) {
+        pos -= padding;
+        bit = (share->value[pos / 8] >> (7 - pos % 8)) & 1;
+      }
+      v = (uint16_t)((v << 1) | bit);
+    }
+    words[HEADER_WORDS + w] = v;
+  }
+
+  size_t count = HEADER_WORDS + value_words;
+  memset(words + count, 0, CHECKSUM_WORDS * sizeof(uint16_t));
+  uint32_t chk =
+      rs1024_polymod(share->extendable, words, count + CHECKSUM_WORDS) ^ 1;
+  for (size_t i = 0; i < CHECKSUM_WORDS; i++) {
+    words[count + i] = (chk >> (10 * (CHECKSUM_WORDS - 1 - i))) & 0x3FF;
+  }
+  return count + CHECKSUM_WORDS;
+}
+
+bool slip39_share_from_words(const uint16_t *words, size_t count,
+                             slip39_share_t *share) {
+  if (count < SLIP39_MIN_WORDS || count > SLIP39_MAX_WORDS) {
+    return false;
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (words[i] >= SLIP39_WORD_COUNT) {
+      return false;
+    }
+  }
+
+  memset(share, 0, sizeof(*share));
+  share->identifier = (uint16_t)((words[0] << 5) | (words[1] >> 5));
+  share->extendable = (words[1] >> 4) & 1;
+  share->iteration_exponent = words[1] & 0xF;
+  share->group_index = words[2] >> 6;
+  share->group_threshold = ((words[2] >> 2) & 0xF) + 1;
+  share->group_count = (uint8_t)((((words[2] & 3) << 2) | (words[3] >> 8)) + 1);
+  share->member_index = (words[3] >> 4) & 0xF;
+  share->member_threshold = (words[3] & 0xF) + 1;
+
+  if (rs1024_polymod(share->extendable, words, count) != 1 ||
+      share->group_threshold > share->group_count) {
+    return false;
+  }
+
+  // Padding de até 8 bits, todo zero
+  size_t value_words = count - METADATA_WORDS;
+  size_t padding = (10 * value_words) % 16;
+  size_t len = (10 * value_words - padding) / 8;
+  if (padding > 8 || len < SLIP39_MIN_SECRET || len > SLIP39_MAX_SECRET) {
+    return false;
+  }
+  uint16_t first = words[HEADER_WORDS];
+  if (padding > 0 && (first >> (10 - padding)) != 0) {
+    return false;
+  }
+
+  for (size_t pos = 0; pos < 8 * len; pos++) {
+    size_t src = pos + padding;
+    uint16_t bit = (words[HEADER_WORDS + src / 10] >> (9 - src % 10)) & 1;
+    share->value[pos / 8] |= (uint8_t)(bit << (7 - pos % 8));
+  }
+  share->value_len = (uint8_t)len;
+  return true;
+}
+
+size_t slip39_share_to_mnemonic(const slip39_share_t *share, char *mnemonic,
+                                size_t size) {
+  uint16_t words[SLIP39_MAX_WORDS];
+  size_t count = slip39_share_to_words(share, words);
+  size_t len = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    char word[SLIP39_MAX_WORD_LEN + 1];
+    size_t n = slip39_word(words[i], word);
+    if (len + n + 1 > size) { // Palavra + separador ou terminador
+      count = 0;
+      break;
+    }
+    memcpy(mnemonic + len, word, n);
+    len += n;
+    mnemonic[len++] = i + 1 < count ? ' ' : '\0';
+  }
+
+  librecipher_secure_zero(words, sizeof(words));
+  if (count == 0) {
+    if (size > 0) {
+      librecipher_secure_zero(mnemonic, size);
+    }
+    return 0;
+  }
+  return len - 1;
+}
+
+bool slip39_share_from_mnemonic(const char *mnemonic, slip39_share_t *share) {
+  uint16_t words[SLIP39_MAX_WORDS];
+  size_t count = 0;
+  const char *p = mnemonic;
+
+  for (;;) {
+    const char *end = p;
+    while (*end != ' ' && *end != '\0') {
+      end++;
+    }
+
+    int index = count < SLIP39_MAX_WORDS ? slip39_word_index(p, end - p) : -1;
+    if (index < 0) {
+      librecipher_secure_zero(words, sizeof(words));
+      return false;
+    }
+    words[count++] = (uint16_t)index;
+
+    if (*end == '\0') {
+      break;
+    }
+    p = end + 1;
+  }
+
+  bool ok = slip39_share_from_words(words, count, share);
+  librecipher_secure_zero(words, sizeof(words));
+  return ok;
+}
+
+// ============ Cifra (Feistel) ============
+
+/**
+ * Feistel de 4 rodadas sobre as duas metades do segredo
+ *
+ * F(i, R) = PBKDF2-HMAC-SHA256(i || passphrase, salt || R, 2500 << e)
+ * com salt "shamir" || id (vazio se extendable). Cifrar roda i = 0..3 e
+ * devolve R || L; decifrar é a mesma coisa com as rodadas ao contrário.
+ */
+static bool feistel(const uint8_t *in, size_t len, const char *passphrase,
+                    const slip39_share_t *params, bool encrypt,
+                    uint8_t *out) {
+  static const char prefix[] = "shamir";
+  uint8_t password[1 + SLIP39_MAX_PASSPHRASE];
+  uint8_t salt[sizeof(prefix) - 1 + 2 + SLIP39_MAX_SECRET / 2];
+  uint8_t left[SLIP39_MAX_SECRET / 2];
+  uint8_t right[SLIP39_MAX_SECRET / 2];
+  uint8_t f[SLIP39_MAX_SECRET / 2];
+  size_t half = len / 2;
+
+  size_t passphrase_len = passphrase ? strlen(passphrase) : 0;
+  if (passphrase_len > SLIP39_MAX_PASSPHRASE) {
+    return false;
+  }
+  for (size_t i = 0; i < passphrase_len; i++) {
+    if (passphrase[i] < 32 || passphrase[i] > 126) {
+      return false;
+    }
+  }
+  if (passphrase_len > 0) {
+    memcpy(password + 1, passphrase, passphrase_len);
+  }
+
+  size_t salt_len = 0;
+  if (!params->extendable) {
+    memcpy(salt, prefix, sizeof(prefix) - 1);
+    salt[sizeof(prefix) - 1] = (uint8_t)(params->identifier >> 8);
+    salt[sizeof(prefix)] = (uint8_t)params->identifier;
+    salt_len = sizeof(prefix) + 1;
+  }
+
+  uint32_t iterations =
+      (SLIP39_BASE_ITERATIONS << params->iteration_exponent) / FEISTEL_ROUNDS;
+  memcpy(left, in, half);
+  memcpy(right, in + half, half);
+  for (int r = 0; r < FEISTEL_ROUNDS; r++) {
+    password[0] = (uint8_t)(encrypt ? r : FEISTEL_ROUNDS - 1 - r);
+    memcpy(salt + salt_len, right, half);
+    pbkdf2_hmac_sha256(password, 1 + passphrase_len, salt, salt_len + half,
+                       iterations, f, half);
+    for (size_t i = 0; i < half; i++) {
+      uint8_t next = left[i] ^ f[i];
+      left[i] = right[i];
+      right[i] = next;
+    }
+  }
+  memcpy(out, right, half);
+  memcpy(out + half, left, half);
+
+  librecipher_secure_zero(password, sizeof(password));
+  librecipher_secure_zero(salt, sizeof(salt));
+  librecipher_secure_zero(left, sizeof(left));
+  librecipher_secure_zero(right, sizeof(right));
+  librecipher_secure_zero(f, sizeof(f));
+  return true;
+}
+
+// ============ Shamir ============
+
+// digest(R, S) = HMAC-SHA256(R, S)[:4]
+static void share_digest(const uint8_t *random, size_t random_len,
+                         const uint8_t *secret, size_t len,
+                         uint8_t digest[DIGEST_SIZE]) {
+  uint8_t mac[32];
+  librecipher_hmac_sha256(random, random_len, secret, len, mac);
+  memcpy(digest, mac, DIGEST_SIZE);
+  librecipher_secure_zero(mac, sizeof(mac));
+}
+
+/**
+ * Recupera o segredo de um nível (grupo ou membros): valor em x = 255,
+ * conferido pelo digest em x = 254
+ */
+static bool recover_secret(const uint8_t *xs, const gf256_vector_t *ys,
+                           size_t threshold, size_t len, uint8_t *secret) {
+  if (threshold == 1) {
+    gf256_vector_store(&ys[0], secret, len);
+    return true;
+  }
+
+  gf256_vector_t v;
+  uint8_t digest[SLIP39_MAX_SECRET];
+  uint8_t expected[DIGEST_SIZE];
+  if (!gf256_interpolate(xs, ys, threshold, SECRET_INDEX, &v)) {
+    return false;
+  }
+  gf256_vector_store(&v, secret, len);
+  gf256_interpolate(xs, ys, threshold, DIGEST_INDEX, &v);
+  gf256_vector_store(&v, digest, len);
+
+  share_digest(digest + DIGEST_SIZE, len - DIGEST_SIZE, secret, len,
+               expected);
+  bool ok = librecipher_secure_compare(digest, expected, DIGEST_SIZE);
+
+  librecipher_secure_zero(&v, sizeof(v));
+  librecipher_secure_zero(digest, sizeof(digest));
+  librecipher_secure_zero(expected, sizeof(expected));
+  return ok;
+}
+
+bool slip39_split(const uint8_t *secret, size_t len, const char *passphrase,
+                  uint8_t iteration_exponent, uint8_t threshold,
+                  uint8_t count, slip39_share_sink_t sink, void *ctx) {
+  if (len < SLIP39_MIN_SECRET || len > SLIP39_MAX_SECRET || len % 2 != 0 ||
+      iteration_exponent > 15 || threshold == 0 || threshold > count ||
+      count > SLIP39_MAX_SHARES || (threshold == 1 && count > 1)) {
+    return false;
+  }
+
+  slip39_share_t share;
+  uint8_t id[2];
+  memset(&share, 0, sizeof(share));
+  if (!librecipher_random(id, sizeof(id))) {
+    return false;
+  }
+  share.identifier = (uint16_t)(((id[0] << 8) | id[1]) & 0x7FFF);
+  share.extendable = true;
+  share.iteration_exponent = iteration_exponent;
+  share.group_threshold = 1;
+  share.group_count = 1;
+  share.member_threshold = threshold;
+  share.value_len = (uint8_t)len;
+
+  // Um grupo só: a parte do grupo é o próprio segredo cifrado
+  uint8_t ems[SLIP39_MAX_SECRET];
+  if (!feistel(secret, len, passphrase, &share, true, ems)) {
+    return false;
+  }
+
+  // Pontos base: x = 0 .. T-3 aleatórios, digest em 254, segredo em 255.
+  // As demais partes são o polinômio por eles, avaliado em x = T-2 ..
+  uint8_t xs[SLIP39_MAX_SHARES];
+  gf256_vector_t ys[SLIP39_MAX_SHARES];
+  uint8_t point[SLIP39_MAX_SECRET];
+  bool ok = true;
+  size_t base = threshold > 1 ? threshold - 2u : 0;
+
+  for (size_t i = 0; i < base && ok; i++) {
+    xs[i] = (uint8_t)i;
+    ok = librecipher_random(point, len);
+    gf256_vector_load(&ys[i], point, len);
+  }
+  if (ok && threshold > 1) {
+    ok = librecipher_random(point + DIGEST_SIZE, len - DIGEST_SIZE);
+    share_digest(point + DIGEST_SIZE, len - DIGEST_SIZE, ems, len, point);
+    xs[base] = DIGEST_INDEX;
+    gf256_vector_load(&ys[base], point, len);
+    xs[base + 1] = SECRET_INDEX;
+    gf256_vector_load(&ys[base + 1], ems, len);
+  }
+
+  for (uint8_t x = 0; x < count && ok; x++) {
+    gf256_vector_t v;
+    if (threshold == 1) {
+      memcpy(share.value, ems, len);
+    } else if (x < base) {
+      gf256_vector_store(&ys[x], share.value, len);
+    } else {
+      gf256_interpolate(xs, ys, threshold, x, &v);
+      gf256_vector_store(&v, share.value, len);
+      librecipher_secure_zero(&v, sizeof(v));
+    }
+    share.member_index = x;
+    sink(&share, ctx);
+  }
+
+  librecipher_secure_zero(&share, sizeof(share));
+  librecipher_secure_zero(ems, sizeof(ems));
+  librecipher_secure_zero(ys, sizeof(ys));
+  librecipher_secure_zero(point, sizeof(point));
+  return ok;
+}
+
+bool slip39_combine(const slip39_share_t *shares, size_t count,
+                    const char *passphrase, uint8_t *secret,
+                    size_t *secret_len) {
+  if (count == 0) {
+    return false;
+  }
+
+  // Campos comuns a todas as partes
+  const slip39_share_t *first = &shares[0];
+  size_t len = first->value_len;
+  if (len < SLIP39_MIN_SECRET || len > SLIP39_MAX_SECRET || len % 2 != 0) {
+    return false;
+  }
+  for (size_t i = 0; i < count; i++) {
+    const slip39_share_t *s = &shares[i];
+    if (s->identifier != first->identifier ||
+        s->extendable != first->extendable ||
+        s->iteration_exponent != first->iteration_exponent ||
+        s->group_threshold != first->group_threshold ||
+        s->group_count != first->group_count || s->value_len != len ||
+        s->group_index >= s->group_count) {
+      return false;
+    }
+    for (size_t j = 0; j < i; j++) {
+      if (shares[j].group_index == s->group_index &&
+          (shares[j].member_index == s->member_index ||
+           shares[j].member_threshold != s->member_threshold)) {
+        return false;
+      }
+    }
+  }
+
+  // Cada grupo presente: exatamente member_threshold partes
+  uint8_t group_xs[SLIP39_MAX_SHARES];
+  gf256_vector_t group_ys[SLIP39_MAX_SHARES];
+  uint8_t xs[SLIP39_MAX_SHARES];
+  gf256_vector_t ys[SLIP39_MAX_SHARES];
+  uint8_t value[SLIP39_MAX_SECRET];
+  size_t groups = 0;
+  bool ok = true;
+
+  for (uint8_t g = 0; g < first->group_count && ok; g++) {
+    size_t members = 0;
+    size_t threshold = 0;
+    for (size_t i = 0; i < count; i++) {
+      if (shares[i].group_index == g) {
+        threshold = shares[i].member_threshold;
+        xs[members] = shares[i].member_index;
+        gf256_vector_load(&ys[members], shares[i].value, len);
+        members++;
+      }
+    }
+    if (members == 0) {
+      continue;
+    }
+    ok = members == threshold && groups < first->group_threshold &&
+         recover_secret(xs, ys, threshold, len, value);
+    if (ok) {
+      group_xs[groups] = g;
+      gf256_vector_load(&group_ys[groups], value, len);
+      groups++;
+    }
+  }
+
+  ok = ok && groups == first->group_threshold &&
+       recover_secret(group_xs, group_ys, groups, len, value) &&
+       feistel(value, len, passphrase, first, false, secret);
+  if (ok) {
+    *secret_len = len;
+  }
+
+  librecipher_secure_zero(group_ys, sizeof(group_ys));
+  librecipher_secure_zero(ys, sizeof(ys));
+  librecipher_secure_zero(value, sizeof(value));
+  return ok;
+}
@@ -3,7 +3,19 @@
  */
 
 #include "wallet.h"
+#include "aead_stream.h"
+#include "argon2.h"
+#include "bip32_ed25519.h"
+#include "bip39.h"
+#include "blake2b.h"
+#include "ed25519.h"
+#include "encoding.h"
+#include "kvstore.h"
 #include "librecipher.h"
+#include "pico/stdlib.h"
+#include "pico/unique_id.h"
+#include "secp256k1.h"
+#include "slip39.h"
 #include <string.h>
 
 // Estado da wallet
@@ -11,15 +23,614 @@ static wallet_status_t g_status = WALLET_STATUS_UNINITIALIZED;
 static uint8_t g_master_key[32];
 static uint8_t g_pin_hash[32];
 
+// Raiz BIP32-Ed25519 (Icarus)
+static bip32_ed25519_node_t g_hd_root;
+
+// Entropia BIP-39 da wallet: origem de tudo, só para o backup
+static uint8_t g_entropy[BIP39_MAX_ENTROPY];
+static uint8_t g_entropy_len;
+
+// Master key, raiz HD e entropia seladas com chave derivada do PIN
+// (reabertas no unlock)
+#define SEALED_SIZE (32 + BIP32_ED25519_XPRV_SIZE + 1 + BIP39_MAX_ENTROPY)
+static argon2_params_t g_pin_kdf; // Calibrado na criação, salvo com a wallet
+static uint8_t g_seal_salt[LIBRECIPHER_SALT_SIZE];
+static uint8_t g_seal_nonce[LIBRECIPHER_NONCE_SIZE];
+static uint8_t g_sealed_secrets[SEALED_SIZE];
+static uint8_t g_seal_tag[LIBRECIPHER_TAG_SIZE];
+
+// Importação de backup em andamento: só o texto dos segredos (tamanho
+// fixo) e o estado do STREAM, nunca o backup cifrado inteiro
+static aead_stream_t g_import;
+static uint8_t g_import_plain[SEALED_SIZE];
+static size_t g_import_len;
+static bool g_import_active;
+
+// Contextos de passphrase (wallets ocultas) desta sessão: master key e raiz
+// HD de cada passphrase usada, cifrados com uma chave sorteada no unlock.
+// Da passphrase fica só um HMAC com essa chave. A entrada da passphrase
+// vazia (a wallet selada) nunca sai; as demais saem por LRU.
+#define CONTEXT_SIZE (32 + BIP32_ED25519_XPRV_SIZE)
+#define CONTEXT_ID_SIZE 16
+typedef struct {
+  bool valid;
+  uint32_t last_use;
+  uint8_t id[CONTEXT_ID_SIZE];
+  uint8_t nonce[LIBRECIPHER_NONCE_SIZE];
+  uint8_t sealed[CONTEXT_SIZE];
+  uint8_t tag[LIBRECIPHER_TAG_SIZE];
+} context_entry_t;
+
+static context_entry_t g_base_context;
+static context_entry_t g_contexts[WALLET_PASSPHRASE_CACHE_SIZE];
+static uint8_t g_context_key[32];
+static uint32_t g_context_clock;
+static uint32_t g_context_seq; // Nonces: contador sob a chave da sessão
+
+// Armazenamento persistente: últimos setores da flash
+#define STORE_OFFSET                                                           \
+  (PICO_FLASH_SIZE_BYTES - WALLET_STORE_SECTORS * FLASH_NOR_SECTOR_SIZE)
+#define STORE_RECORD_SEALED 1 // Parâmetros do PIN + segredos selados
+#define SEALED_RECORD_SIZE                                                     \
+  (12 + LIBRECIPHER_SALT_SIZE + 32 + LIBRECIPHER_NONCE_SIZE + SEALED_SIZE +    \
+   LIBRECIPHER_TAG_SIZE)
+_Static_assert(SEALED_RECORD_SIZE <= KVSTORE_MAX_VALUE,
+               "registro selado cabe num valor do kvstore");
+static kvstore_t g_store;
+static bool g_store_mounted;
+
+// Nós intermediários memorizados: m/1852'/1815'/conta' e o último
+// .../conta'/papel. Pedidos seguidos na mesma conta e papel custam um
+// passo de derivação em vez de cinco.
+typedef struct {
+  bool valid;
+  uint32_t index;
+  bip32_ed25519_node_t node;
+} hd_cache_t;
+
+static hd_cache_t g_account_node;
+static hd_cache_t g_role_node;
+
+// Chave de assinatura expandida da última conta usada (válida apenas
+// enquanto desbloqueada)
+static ed25519_expanded_key_t g_signing_key;
+static bool g_signing_valid;
+static uint32_t g_signing_account;
+static uint8_t g_secp256k1_key[SECP256K1_SECRET_KEY_SIZE];
+
+// Cache LRU de chaves públicas e endereços por (conta, papel, índice).
+// Dados públicos, mas só válidos com a wallet desbloqueada.
+typedef struct {
+  bool valid;
+  uint8_t address_len; // 0 = endereço ainda não codificado
+  uint32_t account;
+  uint32_t role;
+  uint32_t index;
+  uint32_t last_use; // Relógio lógico do LRU
+  uint8_t public_key[ED25519_PUBLIC_KEY_SIZE];
+  char address[WALLET_ADDRESS_MAX_LEN];
+} address_cache_entry_t;
+
+// A chave de stake é buscada com a entrada de pagamento em mãos: esta,
+// recém-usada, nunca é a vítima
+_Static_assert(WALLET_ADDRESS_CACHE_SIZE >= 2, "cache de endereços < 2");
+
+static address_cache_entry_t g_address_cache[WALLET_ADDRESS_CACHE_SIZE];
+static uint32_t g_address_cache_clock;
+static wallet_cache_stats_t g_address_cache_stats;
+
+/**
+ * Deriva chave de selagem e verificador do PIN
+ *
+ * Um Argon2id por tentativa (parâmetros em g_pin_kdf, salt g_seal_salt):
+ * força bruta offline custa o mesmo que um unlock. As duas chaves saem
+ * da saída esticada por um único HKDF-Extract.
+ */
+static bool derive_pin_keys(const uint8_t *pin, size_t pin_len,
+                            uint8_t seal_key[32], uint8_t verifier[32]) {
+  const uint8_t key_info[] = "pin-key";
+  const uint8_t verify_info[] = "pin-verify";
+  uint8_t stretched[32];
+
+  if (!argon2id_hash(&g_pin_kdf, pin, pin_len, g_seal_salt,
+                     sizeof(g_seal_salt), stretched, sizeof(stretched))) {
+    return false;
+  }
+  const librecipher_kdf_label_t labels[] = {
+      {key_info, sizeof(key_info) - 1, seal_key, 32},
+      {verify_info, sizeof(verify_info) - 1, verifier, 32},
+  };
+  librecipher_kdf_multi(stretched, sizeof(stretched), NULL, 0, labels, 2);
+  librecipher_secure_zero(stretched, sizeof(stretched));
+  return true;
+}
+
+/**
+ * Serializa master key, raiz HD e entropia (texto selado e do backup)
+ *
+ * [master 32][kL 32][kR 32][chain code 32][tamanho da entropia][entropia]
+ */
+static void pack_secrets(uint8_t plain[SEALED_SIZE]) {
+  memcpy(plain, g_master_key, 32);
+  memcpy(plain + 32, g_hd_root.kl, 32);
+  memcpy(plain + 64, g_hd_root.kr, 32);
+  memcpy(plain + 96, g_hd_root.chain_code, 32);
+  plain[128] = g_entropy_len;
+  memcpy(plain + 129, g_entropy, BIP39_MAX_ENTROPY);
+}
+
+static void unpack_secrets(const uint8_t plain[SEALED_SIZE]) {
+  memcpy(g_master_key, plain, 32);
+  memcpy(g_hd_root.kl, plain + 32, 32);
+  memcpy(g_hd_root.kr, plain + 64, 32);
+  memcpy(g_hd_root.chain_code, plain + 96, 32);
+  g_hd_root.has_public = false;
+  g_entropy_len = plain[128] <= BIP39_MAX_ENTROPY ? plain[128] : 0;
+  memcpy(g_entropy, plain + 129, BIP39_MAX_ENTROPY);
+}
+
+/**
+ * Sela master key, raiz HD e entropia com a chave derivada do PIN
+ * @return false se o RNG falhou (nonce indisponível)
+ */
+static bool seal_secrets(const uint8_t key[32]) {
+  uint8_t plain[SEALED_SIZE];
+
+  if (!librecipher_random(g_seal_nonce, sizeof(g_seal_nonce))) {
+    return false;
+  }
+  pack_secrets(plain);
+  librecipher_encrypt(key, g_seal_nonce, plain, sizeof(plain), NULL, 0,
+                      g_sealed_secrets, g_seal_tag);
+  librecipher_secure_zero(plain, sizeof(plain));
+  return true;
+}
+
+/**
+ * Reabre master key, raiz HD e entropia com a chave derivada do PIN
+ * @return true se autenticação OK
+ */
+static bool unseal_secrets(const uint8_t key[32]) {
+  uint8_t plain[SEALED_SIZE];
+
+  bool ok = librecipher_decrypt(key, g_seal_nonce, g_sealed_secrets,
+                                sizeof(g_sealed_secrets), NULL, 0, g_seal_tag,
+                                plain);
+  if (ok) {
+    unpack_secrets(plain);
+  }
+  librecipher_secure_zero(plain, sizeof(plain));
+  return ok;
+}
+
+/**
+ * Confere o PIN de novo com a wallet aberta (operações que exportam
+ * segredos)
+ */
+static bool verify_pin(const uint8_t *pin, size_t pin_len) {
+  uint8_t seal_key[32];
+  uint8_t pin_hash_attempt[32];
+
+  if (!derive_pin_keys(pin, pin_len, seal_key, pin_hash_attempt)) {
+    return false;
+  }
+  bool ok = librecipher_secure_compare(pin_hash_attempt, g_pin_hash, 32);
+  librecipher_secure_zero(pin_hash_attempt, sizeof(pin_hash_attempt));
+  librecipher_secure_zero(seal_key, sizeof(seal_key));
+  return ok;
+}
+
+/**
+ * Confere o PIN e abre o selo sem tocar no estado ativo: a wallet base,
+ * mesmo com uma wallet oculta aberta
+ */
+static bool open_sealed(const uint8_t *pin, size_t pin_len,
+                        uint8_t plain[SEALED_SIZE]) {
+  uint8_t seal_key[32];
+  uint8_t pin_hash_attempt[32];
+
+  if (!derive_pin_keys(pin, pin_len, seal_key, pin_hash_attempt)) {
+    return false;
+  }
+  bool ok = librecipher_secure_compare(pin_hash_attempt, g_pin_hash, 32) &&
+            librecipher_decrypt(seal_key, g_seal_nonce, g_sealed_secrets,
+                                sizeof(g_sealed_secrets), NULL, 0, g_seal_tag,
+                                plain);
+  librecipher_secure_zero(pin_hash_attempt, sizeof(pin_hash_attempt));
+  librecipher_secure_zero(seal_key, sizeof(seal_key));
+  return ok;
+}
+
+/**
+ * Zera a raiz HD, os nós memorizados e a chave de assinatura em cache
+ */
+static void clear_hd_state(void) {
+  bip32_ed25519_node_clear(&g_hd_root);
+  librecipher_secure_zero(&g_account_node, sizeof(g_account_node));
+  librecipher_secure_zero(&g_role_node, sizeof(g_role_node));
+  ed25519_expanded_key_clear(&g_signing_key);
+  g_signing_valid = false;
+  memset(g_address_cache, 0, sizeof(g_address_cache));
+  g_address_cache_clock = 0;
+}
+
+/**
+ * Nó m/1852'/1815'/conta'/papel (CIP-1852), com chave pública
+ *
+ * Só refaz os níveis que mudaram: mesmo papel custa zero passos, trocar
+ * de papel um, trocar de conta quatro.
+ * @return nó em cache (válido até a próxima troca), NULL se fora da faixa
+ */
+static const bip32_ed25519_node_t *hd_role_node(uint32_t account,
+                                                uint32_t role) {
+  if (account >= BIP32_HARDENED || role >= BIP32_HARDENED) {
+    return NULL;
+  }
+
+  if (!g_account_node.valid || g_account_node.index != account) {
+    bip32_ed25519_node_t purpose, coin;
+
+    bip32_ed25519_derive_child(&g_hd_root, WALLET_HD_PURPOSE | BIP32_HARDENED,
+                               &purpose);
+    bip32_ed25519_derive_child(&purpose, WALLET_HD_COIN_TYPE | BIP32_HARDENED,
+                               &coin);
+    bip32_ed25519_derive_child(&coin, account | BIP32_HARDENED,
+                               &g_account_node.node);
+    bip32_ed25519_node_public(&g_account_node.node); // Papéis são soft
+    bip32_ed25519_node_clear(&purpose);
+    bip32_ed25519_node_clear(&coin);
+
+    g_account_node.index = account;
+    g_account_node.valid = true;
+    g_role_node.valid = false;
+  }
+
+  if (!g_role_node.valid || g_role_node.index != role) {
+    bip32_ed25519_derive_child(&g_account_node.node, role, &g_role_node.node);
+    bip32_ed25519_node_public(&g_role_node.node);
+    g_role_node.index = role;
+    g_role_node.valid = true;
+  }
+
+  return &g_role_node.node;
+}
+
+/**
+ * Deriva m/1852'/1815'/conta'/papel/índice: um passo a partir do nó do
+ * papel em cache
+ */
+static bool hd_derive(uint32_t account, uint32_t role, uint32_t index,
+                      bip32_ed25519_node_t *leaf) {
+  const bip32_ed25519_node_t *parent = hd_role_node(account, role);
+
+  if (parent == NULL || index >= BIP32_HARDENED) {
+    return false;
+  }
+  return bip32_ed25519_derive_child(parent, index, leaf);
+}
+
+/**
+ * Deriva a chave secp256k1 a partir da master key
+ *
+ * Feito uma vez por unlock. A chave Ed25519 sai da árvore HD sob demanda
+ * (hd_derive) e fica em g_signing_key enquanto a conta não muda.
+ */
+static void load_signing_key(void) {
+  // Chave secp256k1 independente (escalar inválido tem prob. ~2^-128)
+  const uint8_t k1_info[] = "secp256k1-signing";
+  librecipher_kdf(g_master_key, sizeof(g_master_key), NULL, 0, k1_info,
+                  sizeof(k1_info) - 1, g_secp256k1_key,
+                  sizeof(g_secp256k1_key));
+}
+
+// ============ Contextos de passphrase ============
+
+/**
+ * Master key e raiz HD de uma passphrase a partir da entropia
+ *
+ * O caminho caro: seed BIP-39 (PBKDF2 de 2048 iterações) e raiz Icarus
+ * (PBKDF2 de 4096). Passphrase vazia ou NULL dá a wallet selada.
+ */
+static bool derive_context(const uint8_t *entropy, size_t entropy_len,
+                           const char *passphrase, uint8_t master[32],
+                           bip32_ed25519_node_t *root) {
+  const uint8_t info[] = "wallet-master";
+  char mnemonic[BIP39_MAX_MNEMONIC_LEN + 1];
+  uint8_t seed[BIP39_SEED_SIZE];
+  size_t passphrase_len = passphrase ? strlen(passphrase) : 0;
+
+  bool ok = bip39_entropy_to_mnemonic(entropy, entropy_len, mnemonic,
+                                      sizeof(mnemonic)) > 0 &&
+            bip39_mnemonic_to_seed(mnemonic, passphrase, seed);
+  if (ok) {
+    librecipher_kdf(seed, sizeof(seed), NULL, 0, info, sizeof(info) - 1,
+                    master, 32);
+    bip32_ed25519_master_icarus(root, entropy, entropy_len,
+                                (const uint8_t *)passphrase, passphrase_len);
+  }
+  librecipher_secure_zero(mnemonic, sizeof(mnemonic));
+  librecipher_secure_zero(seed, sizeof(seed));
+  return ok;
+}
+
+/**
+ * Troca a master key e a raiz HD ativas; nós, chaves de assinatura e
+ * endereços em cache eram da anterior
+ */
+static void activate_context(const uint8_t master[32],
+                             const bip32_ed25519_node_t *root) {
+  clear_hd_state();
+  memcpy(g_master_key, master, 32);
+  memcpy(g_hd_root.kl, root->kl, 32);
+  memcpy(g_hd_root.kr, root->kr, 32);
+  memcpy(g_hd_root.chain_code, root->chain_code, 32);
+  g_hd_root.has_public = false;
+  load_signing_key();
+}
+
+static void context_id(const char *passphrase, uint8_t id[CONTEXT_ID_SIZE]) {
+  uint8_t mac[32];
+
+  librecipher_hmac_sha256(g_context_key, sizeof(g_context_key),
+                          (const uint8_t *)passphrase,
+                          passphrase ? strlen(passphrase) : 0, mac);
+  memcpy(id, mac, CONTEXT_ID_SIZE);
+  librecipher_secure_zero(mac, sizeof(mac));
+}
+
+/**
+ * Cifra o contexto ativo na entrada (id como dado associado)
+ */
+static void context_store(context_entry_t *entry,
+                          const uint8_t id[CONTEXT_ID_SIZE]) {
+  uint8_t plain[CONTEXT_SIZE];
+
+  memcpy(plain, g_master_key, 32);
+  memcpy(plain + 32, g_hd_root.kl, 32);
+  memcpy(plain + 64, g_hd_root.kr, 32);
+  memcpy(plain + 96, g_hd_root.chain_code, 32);
+  g_context_seq++;
+  memset(entry->nonce, 0, sizeof(entry->nonce));
+  for (int i = 0; i < 4; i++) {
+    entry->nonce[i] = (uint8_t)(g_context_seq >> (8 * i));
+  }
+  memcpy(entry->id, id, CONTEXT_ID_SIZE);
+  librecipher_encrypt(g_context_key, entry->nonce, plain, sizeof(plain),
+                      entry->id, CONTEXT_ID_SIZE, entry->sealed, entry->tag);
+  entry->last_use = ++g_context_clock;
+  entry->valid = true;
+  librecipher_secure_zero(plain, sizeof(plain));
+}
+
+/**
+ * Decifra a entrada e a torna o contexto ativo
+ */
+static bool context_load(context_entry_t *entry) {
+  uint8_t plain[CONTEXT_SIZE];
+  bip32_ed25519_node_t root;
+
+  bool ok = entry->valid &&
+            librecipher_decrypt(g_context_key, entry->nonce, entry->sealed,
+                                sizeof(entry->sealed), entry->id,
+                                CONTEXT_ID_SIZE, entry->tag, plain);
+  if (ok) {
+    memcpy(root.kl, plain + 32, 32);
+    memcpy(root.kr, plain + 64, 32);
+    memcpy(root.chain_code, plain + 96, 32);
+    activate_context(plain, &root);
+    entry->last_use = ++g_context_clock;
+    bip32_ed25519_node_clear(&root);
+  }
+  librecipher_secure_zero(plain, sizeof(plain));
+  return ok;
+}
+
+/**
+ * Zera todos os contextos e a chave que os cifra
+ */
+static void contexts_clear(void) {
+  librecipher_secure_zero(&g_base_context, sizeof(g_base_context));
+  librecipher_secure_zero(g_contexts, sizeof(g_contexts));
+  librecipher_secure_zero(g_context_key, sizeof(g_context_key));
+  g_context_clock = 0;
+  g_context_seq = 0;
+}
+
+/**
+ * Abre a sessão de contextos com a wallet selada ativa: chave nova e a
+ * entrada da passphrase vazia
+ * @return false se o RNG falhou (sem troca de passphrase nesta sessão)
+ */
+static bool contexts_open(void) {
+  uint8_t id[CONTEXT_ID_SIZE];
+
+  contexts_clear();
+  if (!librecipher_random(g_context_key, sizeof(g_context_key))) {
+    return false;
+  }
+  context_id(NULL, id);
+  context_store(&g_base_context, id);
+  return true;
+}
+
+/**
+ * Ativa o contexto de uma passphrase: da cache se usada há pouco, senão
+ * derivado da entropia e guardado no lugar do menos usado
+ */
+static bool switch_context(const char *passphrase) {
+  uint8_t id[CONTEXT_ID_SIZE];
+
+  if (!g_base_context.valid) {
+    return false;
+  }
+  if (passphrase == NULL || passphrase[0] == '\0') {
+    return context_load(&g_base_context);
+  }
+
+  context_id(passphrase, id);
+  context_entry_t *victim = &g_contexts[0];
+  for (size_t i = 0; i < WALLET_PASSPHRASE_CACHE_SIZE; i++) {
+    context_entry_t *e = &g_contexts[i];
+    if (e->valid && librecipher_secure_compare(e->id, id, CONTEXT_ID_SIZE)) {
+      return context_load(e);
+    }
+    if (!e->valid || (victim->valid && e->last_use < victim->last_use)) {
+      victim = e;
+    }
+  }
+
+  // Wallet anterior à entropia selada: só a passphrase vazia existe
+  uint8_t master[32];
+  bip32_ed25519_node_t root;
+  bool ok = g_entropy_len > 0 &&
+            derive_context(g_entropy, g_entropy_len, passphrase, master,
+                           &root);
+  if (ok) {
+    activate_context(master, &root);
+    context_store(victim, id);
+  }
+  librecipher_secure_zero(master, sizeof(master));
+  bip32_ed25519_node_clear(&root);
+  return ok;
+}
+
+// ============ Persistência ============
+
+static void put_le32(uint8_t *p, uint32_t v) {
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+  p[2] = (v >> 16) & 0xFF;
+  p[3] = (v >> 24) & 0xFF;
+}
+
+static uint32_t get_le32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+/**
+ * Monta o kvstore com a chave de armazenamento do device
+ *
+ * A chave sai do ID único da flash: amarra os registros a este device e
+ * esconde o formato, mas não é segredo. O que protege os segredos é a
+ * selagem pelo PIN, feita antes de gravar.
+ */
+static bool mount_store(void) {
+  const uint8_t info[] = "wallet-store";
+  pico_unique_board_id_t id;
+  uint8_t key[32];
+
+  pico_get_unique_board_id(&id);
+  librecipher_kdf(id.id, sizeof(id.id), NULL, 0, info, sizeof(info) - 1, key,
+                  sizeof(key));
+  g_store_mounted = kvstore_mount(&g_store, STORE_OFFSET,
+                                  WALLET_STORE_SECTORS, key);
+  librecipher_secure_zero(key, sizeof(key));
+  return g_store_mounted;
+}
+
+/**
+ * Grava parâmetros do PIN, verificador e segredos selados
+ *
+ * [t LE32][m LE32][lanes LE32][salt][verificador][nonce][selado][tag]
+ */
+static bool save_wallet(void) {
+  uint8_t record[SEALED_RECORD_SIZE];
+  uint8_t *p = record;
+
+  put_le32(p, g_pin_kdf.t_cost);
+  put_le32(p + 4, g_pin_kdf.m_cost_kib);
+  put_le32(p + 8, g_pin_kdf.lanes);
+  p += 12;
+  memcpy(p, g_seal_salt, sizeof(g_seal_salt));
+  p += sizeof(g_seal_salt);
+  memcpy(p, g_pin_hash, sizeof(g_pin_hash));
+  p += sizeof(g_pin_hash);
+  memcpy(p, g_seal_nonce, sizeof(g_seal_nonce));
+  p += sizeof(g_seal_nonce);
+  memcpy(p, g_sealed_secrets, sizeof(g_sealed_secrets));
+  p += sizeof(g_sealed_secrets);
+  memcpy(p, g_seal_tag, sizeof(g_seal_tag));
+
+  bool ok = g_store_mounted &&
+            kvstore_put(&g_store, STORE_RECORD_SEALED, record, sizeof(record));
+  librecipher_secure_zero(record, sizeof(record));
+  return ok;
+}
+
+/**
+ * Carrega a wallet salva (segredos continuam selados até o unlock)
+ */
+static bool load_wallet(void) {
+  uint8_t record[SEALED_RECORD_SIZE];
+  const uint8_t *p = record;
+
+  if (!g_store_mounted ||
+      kvstore_get(&g_store, STORE_RECORD_SEALED, record, sizeof(record)) !=
+          sizeof(record)) {
+    return false;
+  }
+
+  g_pin_kdf.t_cost = get_le32(p);
+  g_pin_kdf.m_cost_kib = get_le32(p + 4);
+  g_pin_kdf.lanes = get_le32(p + 8);
+  p += 12;
+  memcpy(g_seal_salt, p, sizeof(g_seal_salt));
+  p += sizeof(g_seal_salt);
+  memcpy(g_pin_hash, p, sizeof(g_pin_hash));
+  p += sizeof(g_pin_hash);
+  memcpy(g_seal_nonce, p, sizeof(g_seal_nonce));
+  p += sizeof(g_seal_nonce);
+  memcpy(g_sealed_secrets, p, sizeof(g_sealed_secrets));
+  p += sizeof(g_sealed_secrets);
+  memcpy(g_seal_tag, p, sizeof(g_seal_tag));
+  librecipher_secure_zero(record, sizeof(record));
+
+  // Parâmetros fora do que este build suporta: wallet ilegível aqui
+  return argon2_params_valid(&g_pin_kdf);
+}
+
+/**
+ * Descarta a importação de backup em andamento
+ */
+static void import_clear(void) {
+  aead_stream_clear(&g_import);
+  librecipher_secure_zero(g_import_plain, sizeof(g_import_plain));
+  g_import_len = 0;
+  g_import_active = false;
+}
+
 /**
  * Inicializa wallet
  */
 void wallet_init(void) {
+  import_clear();
+  contexts_clear();
   librecipher_secure_zero(g_master_key, sizeof(g_master_key));
+  librecipher_secure_zero(g_entropy, sizeof(g_entropy));
+  g_entropy_len = 0;
   librecipher_secure_zero(g_pin_hash, sizeof(g_pin_hash));
+  memset(&g_pin_kdf, 0, sizeof(g_pin_kdf));
+  clear_hd_state();
+  librecipher_secure_zero(g_secp256k1_key, sizeof(g_secp256k1_key));
+  memset(&g_address_cache_stats, 0, sizeof(g_address_cache_stats));
   g_status = WALLET_STATUS_UNINITIALIZED;
 
-  // TODO: Verificar se existe wallet salva na flash
+  if (mount_store() && load_wallet()) {
+    g_status = WALLET_STATUS_LOCKED;
+  }
+}
+
+/**
+ * Apaga a wallet salva
+ *
+ * Erase de todos os setores do armazenamento (não só um tombstone): os
+ * segredos selados não sobrevivem na flash.
+ */
+bool wallet_wipe(void) {
+  bool ok = g_store_mounted && kvstore_format(&g_store);
+  wallet_init();
+  return ok;
 }
 
 /**
@@ -27,107 +638,727 @@ void wallet_init(void) {
  */
 wallet_status_t wallet_get_status(void) { return g_status; }
 
+/**
+ * Prepara a proteção do PIN de uma wallet nova
+ *
+ * Sorteia o salt, calibra o Argon2id e deriva verificador (g_pin_hash) e
+ * chave de selagem.
+ */
+static bool setup_pin(const uint8_t *pin, size_t pin_len,
+                      uint8_t seal_key[32]) {
+  if (!librecipher_random(g_seal_salt, sizeof(g_seal_salt))) {
+    return false;
+  }
+
+  // Custo do Argon2id calibrado para a latência alvo neste core
+  argon2id_calibrate(&g_pin_kdf, WALLET_PIN_KDF_TARGET_MS, time_us_64);
+
+  return derive_pin_keys(pin, pin_len, seal_key, g_pin_hash);
+}
+
+/**
+ * Sela a master key já derivada, grava na flash e abre a sessão
+ */
+static bool finish_setup(const uint8_t seal_key[32]) {
+  if (!seal_secrets(seal_key) || !save_wallet()) {
+    librecipher_secure_zero(g_master_key, sizeof(g_master_key));
+    librecipher_secure_zero(g_entropy, sizeof(g_entropy));
+    g_entropy_len = 0;
+    bip32_ed25519_node_clear(&g_hd_root);
+    librecipher_secure_zero(g_pin_hash, sizeof(g_pin_hash));
+    return false;
+  }
+  load_signing_key();
+  contexts_open();
+
+  g_status = WALLET_STATUS_UNLOCKED;
+  return true;
+}
+
+/**
+ * Monta uma wallet nova a partir da entropia BIP-39
+ *
+ * A master key sai só da seed BIP-39 (não do PIN): a mesma entropia, seja
+ * do RNG, de um mnemonic ou de partes SLIP-39, dá as mesmas chaves com
+ * qualquer PIN. A raiz HD sai da entropia (Icarus), como nas carteiras
+ * Cardano.
+ */
+static bool setup_from_entropy(const uint8_t *entropy, size_t entropy_len,
+                               const uint8_t *pin, size_t pin_len) {
+  uint8_t seal_key[32];
+
+  if (!derive_context(entropy, entropy_len, NULL, g_master_key, &g_hd_root) ||
+      !setup_pin(pin, pin_len, seal_key)) {
+    librecipher_secure_zero(g_master_key, sizeof(g_master_key));
+    bip32_ed25519_node_clear(&g_hd_root);
+    return false;
+  }
+  memcpy(g_entropy, entropy, entropy_len);
+  g_entropy_len = (uint8_t)entropy_len;
+
+  bool ok = finish_setup(seal_key);
+  librecipher_secure_zero(seal_key, sizeof(seal_key));
+  return ok;
+}
+
+/**
+ * Passphrase aceita pela seed BIP-39 (NULL = nenhuma)
+ */
+static bool passphrase_valid(const char *passphrase) {
+  return passphrase == NULL ||
+         strnlen(passphrase, BIP39_MAX_PASSPHRASE + 1) <= BIP39_MAX_PASSPHRASE;
+}
+
+/**
+ * Abre a wallet oculta pedida logo depois do unlock ou da criação; se
+ * falhar, a sessão não fica aberta na wallet errada
+ */
+static bool open_passphrase(const char *passphrase) {
+  if (passphrase == NULL || passphrase[0] == '\0' ||
+      switch_context(passphrase)) {
+    return true;
+  }
+  wallet_lock();
+  return false;
+}
+
 /**
  * Cria nova wallet
  */
-bool wallet_create(const uint8_t *pin, size_t pin_len) {
-  if (g_status != WALLET_STATUS_UNINITIALIZED) {
+bool wallet_create(const uint8_t *pin, size_t pin_len,
+                   const char *passphrase) {
+  if (g_status != WALLET_STATUS_UNINITIALIZED ||
+      !passphrase_valid(passphrase)) {
     return false;
   }
 
-  // Gerar seed aleatória
-  uint8_t seed[32];
-  librecipher_random(seed, sizeof(seed));
+  // Entropia de um mnemonic de 24 palavras (TRNG reprovado nos testes de
+  // saúde: recusa)
+  uint8_t entropy[BIP39_MAX_ENTROPY];
+  bool ok = librecipher_random(entropy, sizeof(entropy)) &&
+            setup_from_entropy(entropy, sizeof(entropy), pin, pin_len);
+  librecipher_secure_zero(entropy, sizeof(entropy));
+  return ok && open_passphrase(passphrase);
+}
 
-  // Hash do PIN
-  librecipher_sha256(pin, pin_len, g_pin_hash);
+/**
+ * Restaura wallet de mnemonic BIP-39
+ */
+bool wallet_restore(const char *mnemonic, const uint8_t *pin, size_t pin_len) {
+  if (g_status != WALLET_STATUS_UNINITIALIZED || mnemonic == NULL) {
+    return false;
+  }
 
-  // Derivar master key
-  const uint8_t info[] = "wallet-master";
-  librecipher_kdf(seed, sizeof(seed), g_pin_hash, sizeof(g_pin_hash), info,
-                  sizeof(info) - 1, g_master_key, sizeof(g_master_key));
+  // Palavras da lista BIP-39 e checksum
+  uint8_t entropy[BIP39_MAX_ENTROPY];
+  size_t entropy_len;
+  bool ok = bip39_mnemonic_to_entropy(mnemonic, entropy, &entropy_len) &&
+            setup_from_entropy(entropy, entropy_len, pin, pin_len);
+  librecipher_secure_zero(entropy, sizeof(entropy));
+  return ok;
+}
 
-  // Limpar seed temporária
-  librecipher_secure_zero(seed, sizeof(seed));
+/**
+ * Restaura wallet de partes SLIP-39
+ *
+ * O segredo das partes é a entropia BIP-39: só tamanhos que também são
+ * entropia válida (16, 20, 24, 28 ou 32 bytes) são aceitos.
+ */
+bool wallet_restore_slip39(const char *const *shares, size_t count,
+                           const char *passphrase, const uint8_t *pin,
+                           size_t pin_len) {
+  if (g_status != WALLET_STATUS_UNINITIALIZED || shares == NULL ||
+      count == 0 || count > WALLET_SLIP39_MAX_INPUT) {
+    return false;
+  }
 
-  // TODO: Salvar wallet criptografada na flash
+  slip39_share_t parsed[WALLET_SLIP39_MAX_INPUT];
+  uint8_t entropy[SLIP39_MAX_SECRET];
+  size_t entropy_len = 0;
+  bool ok = true;
+  for (size_t i = 0; i < count && ok; i++) {
+    ok = slip39_share_from_mnemonic(shares[i], &parsed[i]);
+  }
+  ok = ok &&
+       slip39_combine(parsed, count, passphrase, entropy, &entropy_len) &&
+       setup_from_entropy(entropy, entropy_len, pin, pin_len);
 
-  g_status = WALLET_STATUS_UNLOCKED;
+  librecipher_secure_zero(parsed, sizeof(parsed));
+  librecipher_secure_zero(entropy, sizeof(entropy));
+  return ok;
+}
+
+/**
+ * Repassa cada parte ao sink da wallet como índices de palavras
+ */
+typedef struct {
+  wallet_share_sink_t sink;
+  void *ctx;
+} share_sink_ctx_t;
+
+static void emit_share(const slip39_share_t *share, void *ctx) {
+  share_sink_ctx_t *out = ctx;
+  uint16_t words[SLIP39_MAX_WORDS];
+  size_t count = slip39_share_to_words(share, words);
+
+  out->sink(share->member_index, words, count, out->ctx);
+  librecipher_secure_zero(words, sizeof(words));
+}
+
+/**
+ * Backup SLIP-39 da entropia (um grupo, sem passphrase)
+ *
+ * Exige o PIN de novo, mesmo desbloqueada: as partes são a wallet inteira.
+ */
+bool wallet_backup_slip39(const uint8_t *pin, size_t pin_len,
+                          uint8_t threshold, uint8_t count,
+                          wallet_share_sink_t sink, void *ctx) {
+  if (g_status != WALLET_STATUS_UNLOCKED || g_entropy_len == 0 ||
+      sink == NULL) {
+    return false;
+  }
+
+  share_sink_ctx_t out = {sink, ctx};
+  return verify_pin(pin, pin_len) &&
+         slip39_split(g_entropy, g_entropy_len, NULL,
+                      WALLET_SLIP39_ITERATION_EXP, threshold, count,
+                      emit_share, &out);
+}
+
+// ============ Backup cifrado em pedaços ============
+
+#define BACKUP_SALT_SIZE 16
+_Static_assert(WALLET_BACKUP_HEADER_SIZE ==
+                   1 + 12 + BACKUP_SALT_SIZE + AEAD_STREAM_PREFIX_SIZE,
+               "cabeçalho do backup");
+_Static_assert(WALLET_BACKUP_CHUNK_OVERHEAD == 3 + AEAD_STREAM_TAG_SIZE,
+               "pedaço do backup");
+
+/**
+ * Chave do backup: Argon2id da passphrase, separada por HKDF das chaves
+ * do PIN
+ */
+static bool derive_backup_key(const argon2_params_t *params,
+                              const uint8_t *salt, const uint8_t *passphrase,
+                              size_t passphrase_len, uint8_t key[32]) {
+  const uint8_t info[] = "wallet-backup";
+  uint8_t stretched[32];
+
+  if (passphrase_len == 0 || passphrase_len > WALLET_BACKUP_MAX_PASSPHRASE ||
+      !argon2id_hash(params, passphrase, passphrase_len, salt,
+                     BACKUP_SALT_SIZE, stretched, sizeof(stretched))) {
+    return false;
+  }
+  librecipher_kdf(stretched, sizeof(stretched), NULL, 0, info,
+                  sizeof(info) - 1, key, 32);
+  librecipher_secure_zero(stretched, sizeof(stretched));
   return true;
 }
 
 /**
- * Restaura wallet (placeholder)
+ * Exporta o backup: cabeçalho e pedaços selados direto para o sink
+ *
+ * Custo do Argon2id o da wallet (calibrado neste device); salt e prefixo
+ * dos nonces sorteados a cada exportação.
  */
-bool wallet_restore(const char *mnemonic, const uint8_t *pin, size_t pin_len) {
-  (void)mnemonic;
-  (void)pin;
-  (void)pin_len;
-  // TODO: Implementar conversão de mnemonic BIP-39
-  return false;
+bool wallet_backup_export(const uint8_t *pin, size_t pin_len,
+                          const uint8_t *passphrase, size_t passphrase_len,
+                          wallet_backup_sink_t sink, void *ctx) {
+  uint8_t header[WALLET_BACKUP_HEADER_SIZE];
+  uint8_t *salt = &header[13];
+  uint8_t *prefix = &header[13 + BACKUP_SALT_SIZE];
+  uint8_t key[32];
+  uint8_t plain[SEALED_SIZE];
+  argon2_params_t params = g_pin_kdf;
+
+  if (g_status != WALLET_STATUS_UNLOCKED || sink == NULL ||
+      !open_sealed(pin, pin_len, plain)) {
+    return false;
+  }
+
+  // Só exporta o que a importação aceita (calibração num core rápido)
+  if (params.t_cost > WALLET_BACKUP_MAX_T_COST) {
+    params.t_cost = WALLET_BACKUP_MAX_T_COST;
+  }
+  header[0] = WALLET_BACKUP_VERSION;
+  put_le32(&header[1], params.t_cost);
+  put_le32(&header[5], params.m_cost_kib);
+  put_le32(&header[9], params.lanes);
+  if (!librecipher_random(salt, BACKUP_SALT_SIZE + AEAD_STREAM_PREFIX_SIZE) ||
+      !derive_backup_key(&params, salt, passphrase, passphrase_len, key)) {
+    librecipher_secure_zero(plain, sizeof(plain));
+    return false;
+  }
+
+  aead_stream_t stream;
+  uint8_t record[WALLET_BACKUP_CHUNK_OVERHEAD + WALLET_BACKUP_CHUNK];
+
+  aead_stream_init(&stream, key, prefix);
+  librecipher_secure_zero(key, sizeof(key));
+  sink(header, sizeof(header), ctx);
+
+  for (size_t off = 0; off < sizeof(plain); off += WALLET_BACKUP_CHUNK) {
+    size_t n = sizeof(plain) - off < WALLET_BACKUP_CHUNK
+                   ? sizeof(plain) - off
+                   : WALLET_BACKUP_CHUNK;
+    bool last = off + n == sizeof(plain);
+
+    record[0] = last ? WALLET_BACKUP_FLAG_LAST : 0;
+    record[1] = stream.counter & 0xFF;
+    record[2] = (stream.counter >> 8) & 0xFF;
+    aead_stream_seal(&stream, plain + off, n, last, &record[3],
+                     &record[3 + n]);
+    sink(record, WALLET_BACKUP_CHUNK_OVERHEAD + n, ctx);
+  }
+
+  aead_stream_clear(&stream);
+  librecipher_secure_zero(plain, sizeof(plain));
+  return true;
+}
+
+/**
+ * Lê o cabeçalho e deriva a chave; os pedaços vêm depois
+ */
+bool wallet_backup_import_begin(const uint8_t *header, size_t header_len,
+                                const uint8_t *passphrase,
+                                size_t passphrase_len) {
+  argon2_params_t params;
+  uint8_t key[32];
+
+  import_clear();
+  if (g_status != WALLET_STATUS_UNINITIALIZED ||
+      header_len != WALLET_BACKUP_HEADER_SIZE ||
+      header[0] != WALLET_BACKUP_VERSION) {
+    return false;
+  }
+
+  // Parâmetros de outro device: só os que este build consegue calcular, e
+  // em tempo limitado (o cabeçalho não é autenticado antes da derivação)
+  params.t_cost = get_le32(&header[1]);
+  params.m_cost_kib = get_le32(&header[5]);
+  params.lanes = get_le32(&header[9]);
+  if (params.t_cost > WALLET_BACKUP_MAX_T_COST ||
+      !argon2_params_valid(&params) ||
+      !derive_backup_key(&params, &header[13], passphrase, passphrase_len,
+                         key)) {
+    return false;
+  }
+
+  aead_stream_init(&g_import, key, &header[13 + BACKUP_SALT_SIZE]);
+  librecipher_secure_zero(key, sizeof(key));
+  g_import_active = true;
+  return true;
+}
+
+/**
+ * Abre um pedaço direto na posição dele no texto dos segredos
+ */
+bool wallet_backup_import_chunk(const uint8_t *record, size_t len) {
+  if (!g_import_active || g_status != WALLET_STATUS_UNINITIALIZED ||
+      len < WALLET_BACKUP_CHUNK_OVERHEAD) {
+    import_clear();
+    return false;
+  }
+
+  size_t n = len - WALLET_BACKUP_CHUNK_OVERHEAD;
+  bool last = record[0] & WALLET_BACKUP_FLAG_LAST;
+  uint32_t index = (uint32_t)record[1] | ((uint32_t)record[2] << 8);
+
+  // O índice explícito só poupa o trabalho: o nonce já amarra a posição
+  bool ok = n <= WALLET_BACKUP_CHUNK && index == g_import.counter &&
+            n <= sizeof(g_import_plain) - g_import_len &&
+            aead_stream_open(&g_import, &record[3], n, last, &record[3 + n],
+                             g_import_plain + g_import_len);
+  if (!ok) {
+    import_clear();
+    return false;
+  }
+  g_import_len += n;
+  return true;
+}
+
+/**
+ * Sela os segredos importados com o PIN novo, como numa wallet criada aqui
+ * (Argon2id recalibrado para este device)
+ */
+bool wallet_backup_import_finish(const uint8_t *pin, size_t pin_len) {
+  uint8_t seal_key[32];
+
+  bool ok = g_import_active && g_import.finished &&
+            g_import_len == sizeof(g_import_plain) &&
+            g_status == WALLET_STATUS_UNINITIALIZED &&
+            setup_pin(pin, pin_len, seal_key);
+  if (ok) {
+    unpack_secrets(g_import_plain);
+    ok = finish_setup(seal_key);
+  }
+  librecipher_secure_zero(seal_key, sizeof(seal_key));
+  import_clear();
+  return ok;
 }
 
 /**
  * Desbloqueia wallet
  */
-bool wallet_unlock(const uint8_t *pin, size_t pin_len) {
-  if (g_status != WALLET_STATUS_LOCKED) {
+bool wallet_unlock(const uint8_t *pin, size_t pin_len,
+                   const char *passphrase) {
+  if (g_status != WALLET_STATUS_LOCKED || !passphrase_valid(passphrase)) {
     return false;
   }
 
+  uint8_t seal_key[32];
   uint8_t pin_hash_attempt[32];
-  librecipher_sha256(pin, pin_len, pin_hash_attempt);
-
-  if (!librecipher_secure_compare(pin_hash_attempt, g_pin_hash, 32)) {
-    librecipher_secure_zero(pin_hash_attempt, sizeof(pin_hash_attempt));
+  if (!derive_pin_keys(pin, pin_len, seal_key, pin_hash_attempt)) {
     return false;
   }
 
+  bool ok = librecipher_secure_compare(pin_hash_attempt, g_pin_hash, 32) &&
+            unseal_secrets(seal_key);
   librecipher_secure_zero(pin_hash_attempt, sizeof(pin_hash_attempt));
+  librecipher_secure_zero(seal_key, sizeof(seal_key));
+  if (!ok) {
+    return false;
+  }
+  load_signing_key();
+  contexts_open();
+
   g_status = WALLET_STATUS_UNLOCKED;
-  return true;
+  return open_passphrase(passphrase);
+}
+
+/**
+ * Troca de wallet oculta com a sessão aberta
+ */
+bool wallet_set_passphrase(const char *passphrase) {
+  return g_status == WALLET_STATUS_UNLOCKED && passphrase_valid(passphrase) &&
+         switch_context(passphrase);
 }
 
 /**
  * Bloqueia wallet
  */
 void wallet_lock(void) {
+  contexts_clear();
   librecipher_secure_zero(g_master_key, sizeof(g_master_key));
+  librecipher_secure_zero(g_entropy, sizeof(g_entropy));
+  g_entropy_len = 0;
+  clear_hd_state();
+  librecipher_secure_zero(g_secp256k1_key, sizeof(g_secp256k1_key));
   g_status = WALLET_STATUS_LOCKED;
+
+  // Nada fica pendente na janela de escrita da flash ao travar
+  flash_nor_flush();
+}
+
+/**
+ * Carrega em g_signing_key a chave de pagamento da conta
+ * (m/1852'/1815'/conta'/0/0), se ainda não for a atual
+ */
+static bool load_ed25519_key(uint32_t account_index) {
+  if (g_signing_valid && g_signing_account == account_index) {
+    return true;
+  }
+
+  bip32_ed25519_node_t leaf;
+  if (!hd_derive(account_index, WALLET_HD_ROLE_EXTERNAL, 0, &leaf)) {
+    return false;
+  }
+  bip32_ed25519_signing_key(&leaf, &g_signing_key);
+  bip32_ed25519_node_clear(&leaf);
+  g_signing_account = account_index;
+  g_signing_valid = true;
+  return true;
 }
 
 /**
- * Assina transação (placeholder)
+ * Assina transação com a chave da curva pedida
+ *
+ * Ed25519: chave de pagamento da conta, expandida uma vez e reutilizada
+ * enquanto a conta não muda. secp256k1: uma chave só, sem árvore HD; só a
+ * conta 0 existe, as outras são recusadas em vez de assinar com ela.
  */
 bool wallet_sign_transaction(const uint8_t *tx_hash, uint32_t account_index,
-                             uint8_t *signature) {
-  (void)tx_hash;
-  (void)account_index;
-  (void)signature;
+                             wallet_curve_t curve, uint8_t *signature) {
+  if (g_status != WALLET_STATUS_UNLOCKED) {
+    return false;
+  }
+
+  switch (curve) {
+  case WALLET_CURVE_ED25519:
+    if (!load_ed25519_key(account_index)) {
+      return false;
+    }
+    ed25519_sign_expanded(signature, tx_hash, 32, &g_signing_key);
+    return true;
+  case WALLET_CURVE_SECP256K1:
+    if (account_index != 0) {
+      return false;
+    }
+    return secp256k1_sign(signature, tx_hash, g_secp256k1_key);
+  default:
+    return false;
+  }
+}
+
+/**
+ * Assina um lote, uma passada por conta distinta
+ *
+ * Cada passada toma a conta da primeira entrada pendente e assina todas as
+ * entradas dessa conta: com contas intercaladas (A, B, A, B...) a chave
+ * expandida de uma entrada ainda serve à próxima da mesma conta, em vez de
+ * ser refeita a cada troca.
+ */
+bool wallet_sign_batch(const wallet_sign_request_t *requests, size_t count,
+                       wallet_curve_t curve, wallet_signature_sink_t sink,
+                       void *ctx) {
+  _Static_assert(WALLET_SIGN_BATCH_MAX <= 64, "pendentes cabem em 64 bits");
+  uint8_t signature[64];
+  uint64_t pending;
+
+  if (g_status != WALLET_STATUS_UNLOCKED || count == 0 ||
+      count > WALLET_SIGN_BATCH_MAX ||
+      (curve != WALLET_CURVE_ED25519 && curve != WALLET_CURVE_SECP256K1)) {
+    return false;
+  }
+  // secp256k1 só tem a conta 0: recusa o lote antes de assinar qualquer
+  // entrada
+  if (curve == WALLET_CURVE_SECP256K1) {
+    for (size_t i = 0; i < count; i++) {
+      if (requests[i].account_index != 0) {
+        return false;
+      }
+    }
+  }
+  pending = count == 64 ? ~(uint64_t)0 : ((uint64_t)1 << count) - 1;
+
+  while (pending != 0) {
+    size_t first = 0;
+    while (!(pending & ((uint64_t)1 << first))) {
+      first++;
+    }
+    uint32_t account = requests[first].account_index;
+
+    if (curve == WALLET_CURVE_ED25519 && !load_ed25519_key(account)) {
+      return false;
+    }
+
+    for (size_t i = first; i < count; i++) {
+      if (!(pending & ((uint64_t)1 << i)) ||
+          requests[i].account_index != account) {
+        continue;
+      }
+      if (curve == WALLET_CURVE_ED25519) {
+        ed25519_sign_expanded(signature, requests[i].hash, 32,
+                              &g_signing_key);
+      } else if (!secp256k1_sign(signature, requests[i].hash,
+                                 g_secp256k1_key)) {
+        return false;
+      }
+      pending &= ~((uint64_t)1 << i);
+      sink(i, signature, ctx);
+    }
+  }
+  return true;
+}
+
+// ============ Chaves públicas e endereços ============
+
+// Hash de chave nos endereços Cardano (BLAKE2b-224)
+#define KEY_HASH_SIZE 28
+
+/**
+ * Busca (conta, papel, índice) no cache
+ *
+ * Na falta, deriva a chave pública e ocupa uma entrada livre ou a menos
+ * usada recentemente.
+ * @return entrada com a chave pública, ou NULL se a derivação falhou
+ */
+static address_cache_entry_t *address_cache_get(uint32_t account,
+                                                uint32_t role,
+                                                uint32_t index) {
+  address_cache_entry_t *victim = &g_address_cache[0];
+
+  for (size_t i = 0; i < WALLET_ADDRESS_CACHE_SIZE; i++) {
+    address_cache_entry_t *e = &g_address_cache[i];
+    if (e->valid && e->account == account && e->role == role &&
+        e->index == index) {
+      g_address_cache_stats.hits++;
+      e->last_use = ++g_address_cache_clock;
+      return e;
+    }
+    if (!e->valid) {
+      if (victim->valid) {
+        victim = e;
+      }
+    } else if (victim->valid && e->last_use < victim->last_use) {
+      victim = e;
+    }
+  }
+
+  g_address_cache_stats.misses++;
+
+  bip32_ed25519_node_t leaf;
+  if (!hd_derive(account, role, index, &leaf)) {
+    return NULL;
+  }
+  bip32_ed25519_node_public(&leaf);
+  memcpy(victim->public_key, leaf.public_key, ED25519_PUBLIC_KEY_SIZE);
+  bip32_ed25519_node_clear(&leaf);
+
+  victim->valid = true;
+  victim->address_len = 0;
+  victim->account = account;
+  victim->role = role;
+  victim->index = index;
+  victim->last_use = ++g_address_cache_clock;
+  return victim;
+}
+
+/**
+ * Hash da chave de stake da conta (.../conta'/2/0), via cache
+ */
+static bool stake_key_hash(uint32_t account, uint8_t hash[KEY_HASH_SIZE]) {
+  const address_cache_entry_t *stake =
+      address_cache_get(account, WALLET_HD_ROLE_STAKING, 0);
+  if (stake == NULL) {
+    return false;
+  }
+  blake2b_hash(stake->public_key, ED25519_PUBLIC_KEY_SIZE, hash,
+               KEY_HASH_SIZE);
+  return true;
+}
+
+/**
+ * Endereço base Cardano: header || H(pagamento) || H(stake)
+ * @return tamanho, 0 se out não comporta
+ */
+static size_t encode_base_address(char *out, size_t out_size,
+                                  const uint8_t payment[32],
+                                  const uint8_t stake_hash[KEY_HASH_SIZE]) {
+  uint8_t payload[1 + 2 * KEY_HASH_SIZE];
+
+  // Tipo 0 (chave de pagamento + chave de stake) no nibble alto
+  payload[0] = WALLET_CARDANO_NETWORK_ID;
+  blake2b_hash(payment, ED25519_PUBLIC_KEY_SIZE, payload + 1, KEY_HASH_SIZE);
+  memcpy(payload + 1 + KEY_HASH_SIZE, stake_hash, KEY_HASH_SIZE);
 
+  return bech32_encode(out, out_size,
+                       WALLET_CARDANO_NETWORK_ID ? "addr" : "addr_test",
+                       payload, sizeof(payload), BECH32_ENCODING_BECH32);
+}
+
+/**
+ * Codifica o endereço base Cardano da entrada (chave da entrada como
+ * pagamento)
+ */
+static bool address_cache_encode(address_cache_entry_t *entry) {
+  uint8_t stake_hash[KEY_HASH_SIZE];
+
+  if (!stake_key_hash(entry->account, stake_hash)) {
+    return false;
+  }
+  size_t len = encode_base_address(entry->address, sizeof(entry->address),
+                                   entry->public_key, stake_hash);
+  entry->address_len = (uint8_t)len;
+  return len > 0;
+}
+
+/**
+ * Obtém chave pública de m/1852'/1815'/conta'/papel/índice
+ */
+bool wallet_get_public_key(uint32_t account_index, uint32_t role,
+                           uint32_t address_index, uint8_t *public_key) {
   if (g_status != WALLET_STATUS_UNLOCKED) {
     return false;
   }
 
-  // TODO: Implementar assinatura Ed25519
-  memset(signature, 0, 64);
+  const address_cache_entry_t *entry =
+      address_cache_get(account_index, role, address_index);
+  if (entry == NULL) {
+    return false;
+  }
+  memcpy(public_key, entry->public_key, ED25519_PUBLIC_KEY_SIZE);
   return true;
 }
 
 /**
- * Obtém endereço (placeholder)
+ * Obtém endereço base Cardano da conta (pagamento .../conta'/0/0)
  */
 size_t wallet_get_address(uint32_t account_index, char *address,
                           size_t address_len) {
-  (void)account_index;
-
-  const char *placeholder = "addr1_placeholder";
-  size_t len = strlen(placeholder);
+  if (g_status != WALLET_STATUS_UNLOCKED) {
+    return 0;
+  }
 
-  if (len >= address_len) {
+  address_cache_entry_t *entry =
+      address_cache_get(account_index, WALLET_HD_ROLE_EXTERNAL, 0);
+  if (entry == NULL ||
+      (entry->address_len == 0 && !address_cache_encode(entry)) ||
+      entry->address_len >= address_len) {
     return 0;
   }
 
-  memcpy(address, placeholder, len + 1);
-  return len;
+  memcpy(address, entry->address, entry->address_len + 1u);
+  return entry->address_len;
+}
+
+/**
+ * Endereços de uma faixa de índices, em lotes de ED25519_BATCH_MAX
+ *
+ * Cada lote: um passo de derivação por índice a partir do nó do papel,
+ * chaves públicas normalizadas com uma inversão compartilhada e entrega
+ * ao sink antes do próximo lote. Não passa pelo cache LRU (varreduras de
+ * descoberta o esvaziariam), exceto pela chave de stake.
+ */
+bool wallet_get_addresses(uint32_t account_index, uint32_t role,
+                          uint32_t start, uint32_t count,
+                          wallet_address_sink_t sink, void *ctx) {
+  uint8_t stake_hash[KEY_HASH_SIZE];
+  uint8_t scalars[ED25519_BATCH_MAX][32];
+  uint8_t public_keys[ED25519_BATCH_MAX][ED25519_PUBLIC_KEY_SIZE];
+  char address[WALLET_ADDRESS_MAX_LEN];
+
+  if (g_status != WALLET_STATUS_UNLOCKED || start >= BIP32_HARDENED ||
+      count > BIP32_HARDENED - start ||
+      !stake_key_hash(account_index, stake_hash)) {
+    return false;
+  }
+
+  // Depois da chave de stake: ela pode ter trocado o papel em cache
+  const bip32_ed25519_node_t *parent = hd_role_node(account_index, role);
+  if (parent == NULL) {
+    return false;
+  }
+
+  for (uint32_t done = 0; done < count;) {
+    uint32_t n = count - done;
+    if (n > ED25519_BATCH_MAX) {
+      n = ED25519_BATCH_MAX;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+      bip32_ed25519_node_t leaf;
+      bip32_ed25519_derive_child(parent, start + done + i, &leaf);
+      memcpy(scalars[i], leaf.kl, 32);
+      bip32_ed25519_node_clear(&leaf);
+    }
+    ed25519_scalar_to_public_batch(public_keys,
+                                   (const uint8_t(*)[32])scalars, n);
+    librecipher_secure_zero(scalars, sizeof(scalars));
+
+    for (uint32_t i = 0; i < n; i++) {
+      size_t len = encode_base_address(address, sizeof(address),
+                                       public_keys[i], stake_hash);
+      sink(start + done + i, address, len, ctx);
+    }
+    done += n;
+  }
+  return true;
+}
+
+/**
+ * Contadores do cache de endereços
+ */
+void wallet_get_cache_stats(wallet_cache_stats_t *stats) {
+  *stats = g_address_cache_stats;
 }
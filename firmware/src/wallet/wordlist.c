@@ -0,0 +1,128 @@
+/**
+ * Índice de Lista de Palavras - Implementação
+ */
+
+#include "wordlist.h"
+#include <stdbool.h>
+#include <string.h>
+
+// Entrada: letras 2-4 (5 bits cada) | tamanho do sufixo | offset do sufixo
+#define ENTRY_KEY(e) ((e) >> 17)
+#define ENTRY_SUFFIX_LEN(e) (((e) >> 14) & 0x7)
+#define ENTRY_SUFFIX_OFFSET(e) ((e) & 0x3FFF)
+
+// a = 1 .. z = 26, 0 se não for letra minúscula
+static inline uint32_t letter_code(char c) {
+  return (c >= 'a' && c <= 'z') ? (uint32_t)(c - 'a' + 1) : 0;
+}
+
+// Letras da entrada: 1 (primeira) + letras 2-4 presentes + sufixo
+static size_t entry_length(uint32_t e) {
+  uint32_t key = ENTRY_KEY(e);
+  size_t len = 1;
+  for (int shift = 10; shift >= 0; shift -= 5) {
+    len += ((key >> shift) & 0x1F) != 0;
+  }
+  return len + ENTRY_SUFFIX_LEN(e);
+}
+
+// Primeira posição em [lo, hi) com chave >= key (upper: > key)
+static size_t entry_search(const wordlist_t *list, size_t lo, size_t hi,
+                           uint32_t key, bool upper) {
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    uint32_t k = ENTRY_KEY(list->entries[mid]);
+    if (k < key || (upper && k == key)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/**
+ * Palavras com um prefixo: baldes pela 1ª letra, busca binária nas letras
+ * 2-4 e comparação do sufixo
+ */
+size_t wordlist_prefix_range(const wordlist_t *list, const char *prefix,
+                             size_t len, uint16_t *first) {
+  if (len == 0 || len > WORDLIST_MAX_WORD_LEN) {
+    return 0;
+  }
+  for (size_t i = 0; i < len; i++) {
+    if (letter_code(prefix[i]) == 0) {
+      return 0;
+    }
+  }
+
+  // Letras ausentes do prefixo: faixa de 0 (palavra curta) a 31
+  uint32_t key_lo = 0;
+  uint32_t key_hi = 0;
+  for (size_t i = 1; i < 4; i++) {
+    uint32_t c = i < len ? letter_code(prefix[i]) : 0;
+    key_lo = (key_lo << 5) | c;
+    key_hi = (key_hi << 5) | (i < len ? c : 0x1F);
+  }
+
+  uint32_t bucket = letter_code(prefix[0]) - 1;
+  size_t begin = entry_search(list, list->letter_start[bucket],
+                              list->letter_start[bucket + 1], key_lo, false);
+  size_t end = entry_search(list, begin, list->letter_start[bucket + 1],
+                            key_hi, true);
+
+  // Além de 4 letras sobra no máximo uma palavra: confere o sufixo
+  if (len > 4 && begin < end) {
+    uint32_t e = list->entries[begin];
+    if (len - 4 > ENTRY_SUFFIX_LEN(e) ||
+        memcmp(prefix + 4, list->suffixes + ENTRY_SUFFIX_OFFSET(e),
+               len - 4) != 0) {
+      return 0;
+    }
+  }
+
+  *first = (uint16_t)begin;
+  return end - begin;
+}
+
+/**
+ * Índice de palavra completa: a mais curta da faixa do prefixo vem antes
+ */
+int wordlist_index(const wordlist_t *list, const char *word, size_t len) {
+  uint16_t first;
+  if (wordlist_prefix_range(list, word, len, &first) == 0 ||
+      entry_length(list->entries[first]) != len) {
+    return -1;
+  }
+  return first;
+}
+
+/**
+ * Soletra a palavra de um índice
+ */
+size_t wordlist_word(const wordlist_t *list, uint16_t index, char *word) {
+  if (index >= list->count) {
+    return 0;
+  }
+
+  uint32_t bucket = 0;
+  while (list->letter_start[bucket + 1] <= index) {
+    bucket++;
+  }
+
+  uint32_t e = list->entries[index];
+  uint32_t key = ENTRY_KEY(e);
+  size_t len = 0;
+  word[len++] = (char)('a' + bucket);
+  for (int shift = 10; shift >= 0; shift -= 5) {
+    uint32_t c = (key >> shift) & 0x1F;
+    if (c != 0) {
+      word[len++] = (char)('a' + c - 1);
+    }
+  }
+  memcpy(word + len, list->suffixes + ENTRY_SUFFIX_OFFSET(e),
+         ENTRY_SUFFIX_LEN(e));
+  len += ENTRY_SUFFIX_LEN(e);
+  word[len] = '\0';
+  return len;
+}
@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+"""
+Gera a tabela de conversão base 2^16 -> base 58^5 do codificador base58.
+
+- base58_word_table[i][j] = limb j (big-endian, raiz 58^5) de
+  2^(16 * (BASE58_WORDS - 1 - i)), i = 0..31
+
+A entrada (até 64 bytes) é lida em palavras de 16 bits; cada limb de saída
+é a soma de palavra * tabela, sem divisão por dígito. Produtos < 2^45.3,
+somas de 32 termos < 2^51: cabem em acumuladores de 64 bits.
+
+Uso: gen_base58_tables.py <saida.c>
+"""
+
+import os
+import sys
+
+WORDS = 32  # 64 bytes em palavras de 16 bits
+RADIX = 58**5
+LIMBS = 18  # ceil(512 / log2(58^5))
+
+
+def limbs(v):
+    out = []
+    for _ in range(LIMBS):
+        out.append(v % RADIX)
+        v //= RADIX
+    assert v == 0
+    return out[::-1]
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("uso: gen_base58_tables.py <saida.c>")
+
+    assert RADIX < 2**32 and 2**(16 * WORDS) <= RADIX**LIMBS
+
+    out = []
+    out.append("// Gerado por tools/gen_base58_tables.py - não editar\n")
+    out.append("#include <stdint.h>\n\n")
+
+    out.append("const uint32_t base58_word_table[%d][%d] = {\n" %
+               (WORDS, LIMBS))
+    for i in range(WORDS):
+        row = limbs(2**(16 * (WORDS - 1 - i)))
+        lines = [", ".join("%10uu" % v for v in row[k:k + 6])
+                 for k in range(0, LIMBS, 6)]
+        out.append("    {" + ",\n     ".join(lines) + "},\n")
+    out.append("};\n")
+
+    os.makedirs(os.path.dirname(os.path.abspath(sys.argv[1])), exist_ok=True)
+    with open(sys.argv[1], "w") as f:
+        f.write("".join(out))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""
+Gera o índice compacto da lista de palavras BIP-39 (const, residente na flash).
+
+As 2048 palavras são únicas nas 4 primeiras letras e estão em ordem. Cada
+palavra vira uma entrada de 32 bits dentro do balde da sua primeira letra:
+
+- bits 31..17: letras 2-4, 5 bits cada (a = 1 .. z = 26, 0 = ausente)
+- bits 16..14: tamanho do sufixo (letras além da 4ª, 0..4)
+- bits 13..0:  offset do sufixo em bip39_suffixes
+
+A ordem das entradas é a ordem alfabética, então a busca é binária dentro
+do balde, sem cópias para a RAM.
+
+Uso: gen_bip39_index.py <saida.c> <lista.txt>
+"""
+
+import hashlib
+import os
+import sys
+
+# SHA-256 do english.txt oficial (bitcoin/bips, bip-0039)
+ENGLISH_SHA256 = "2f5eed53a4727b4bf8880d8f3f199efc90e58503646d9ff8eff3a2ed3b24dbda"
+
+
+def code(ch):
+    return ord(ch) - ord("a") + 1
+
+
+def build_index(words, name, generator):
+    """Código C do índice de uma lista (tabelas <name>_letter_start,
+    <name>_entries, <name>_suffixes e <name>_index_bytes)"""
+    count = len(words)
+    assert words == sorted(words)
+    assert len({w[:4] for w in words}) == count
+    assert all(3 <= len(w) <= 8 and w.isalpha() and w.islower() for w in words)
+
+    starts = []
+    entries = []
+    suffixes = ""
+    for letter in range(26):
+        starts.append(len(entries))
+        for w in words:
+            if code(w[0]) - 1 != letter:
+                continue
+            key = 0
+            for i in range(1, 4):
+                key = (key << 5) | (code(w[i]) if i < len(w) else 0)
+            suffix = w[4:]
+            entries.append((key << 17) | (len(suffix) << 14) | len(suffixes))
+            suffixes += suffix
+    starts.append(len(entries))
+    assert len(suffixes) < (1 << 14)
+
+    size = 2 * len(starts) + 4 * len(entries) + len(suffixes) + 1
+
+    out = []
+    out.append("// Gerado por tools/%s - não editar\n" % generator)
+    out.append("// Índice: %d bytes (baldes %d, entradas %d, sufixos %d)\n\n" %
+               (size, 2 * len(starts), 4 * len(entries), len(suffixes) + 1))
+    out.append("#include <stdint.h>\n\n")
+
+    out.append("const uint16_t %s_letter_start[27] = {\n" % name)
+    for i in range(0, 27, 9):
+        out.append("    " + ", ".join("%4d" % s for s in starts[i:i + 9]) + ",\n")
+    out.append("};\n\n")
+
+    out.append("const uint32_t %s_entries[%d] = {\n" % (name, count))
+    for i in range(0, count, 6):
+        out.append("    " + ", ".join("0x%08X" % e for e in entries[i:i + 6]) +
+                   ",\n")
+    out.append("};\n\n")
+
+    out.append("const char %s_suffixes[%d] =\n" % (name, len(suffixes) + 1))
+    for i in range(0, len(suffixes), 64):
+        out.append('    "%s"\n' % suffixes[i:i + 64])
+    out.append("    ;\n\n")
+
+    out.append("const uint32_t %s_index_bytes = %d;\n" % (name, size))
+    return "".join(out), size
+
+
+def write_output(path, text):
+    os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+    with open(path, "w") as f:
+        f.write(text)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("usage: gen_bip39_index.py <output.c> <wordlist.txt>")
+
+    with open(sys.argv[2], "rb") as f:
+        raw = f.read()
+    if hashlib.sha256(raw).hexdigest() != ENGLISH_SHA256:
+        sys.exit("gen_bip39_index.py: lista de palavras não confere com a oficial")
+    words = raw.decode("ascii").split()
+    assert len(words) == 2048
+
+    text, size = build_index(words, "bip39", "gen_bip39_index.py")
+    write_output(sys.argv[1], text)
+    print("BIP-39 index: %d bytes" % size)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""
+Gera as tabelas pré-computadas do Ed25519 (const, residentes na flash).
+
+- ed25519_base_odd[i] = (2i + 1) * B, i = 0..31, forma afim pré-computada
+  (y+x, y-x, 2dxy) para o wNAF de largura 7 da verificação
+- bootloader_vendor_keys[k]: contexto de verificação (ed25519_pubkey_ctx_t)
+  de cada chave pública do fabricante, com os múltiplos ímpares de -A em
+  forma cached (Y+X, Y-X, Z, 2dT) e Z = 1
+
+Elementos de campo em 10 limbs radix 2^25.5 (26/25 bits alternados),
+mesma representação de src/crypto/ed25519.c.
+
+Uso: gen_ed25519_tables.py <saida.c> [chave_publica_hex ...]
+"""
+
+import os
+import sys
+
+P = 2**255 - 19
+D = -121665 * pow(121666, P - 2, P) % P
+SQRTM1 = pow(2, (P - 1) // 4, P)
+BY = 4 * pow(5, P - 2, P) % P
+
+KEY_POINTS = 8   # ED25519_PUBKEY_CTX_POINTS
+BASE_POINTS = 32  # ED25519_BASE_ODD_POINTS
+
+
+def recover_x(y, sign):
+    x2 = (y * y - 1) * pow(D * y * y + 1, P - 2, P) % P
+    x = pow(x2, (P + 3) // 8, P)
+    if (x * x - x2) % P != 0:
+        x = x * SQRTM1 % P
+    if (x * x - x2) % P != 0:
+        return None
+    if x == 0 and sign:
+        return None
+    if (x & 1) != sign:
+        x = P - x
+    return x
+
+
+def decode_point(hex_key):
+    raw = bytes.fromhex(hex_key)
+    if len(raw) != 32:
+        sys.exit("chave pública deve ter 32 bytes: %s" % hex_key)
+    v = int.from_bytes(raw, "little")
+    y = v & ((1 << 255) - 1)
+    if y >= P:
+        sys.exit("chave pública não canônica: %s" % hex_key)
+    x = recover_x(y, v >> 255)
+    if x is None:
+        sys.exit("chave pública inválida: %s" % hex_key)
+    return (x, y)
+
+
+def point_add(a, b):
+    x1, y1 = a
+    x2, y2 = b
+    t = D * x1 * x2 * y1 * y2 % P
+    x3 = (x1 * y2 + x2 * y1) * pow(1 + t, P - 2, P) % P
+    y3 = (y1 * y2 + x1 * x2) * pow(1 - t, P - 2, P) % P
+    return (x3, y3)
+
+
+def odd_multiples(pt, count):
+    twice = point_add(pt, pt)
+    acc = pt
+    out = []
+    for _ in range(count):
+        out.append(acc)
+        acc = point_add(acc, twice)
+    return out
+
+
+def limbs(v):
+    v %= P
+    out = []
+    shift = 0
+    for i in range(10):
+        bits = 25 if i & 1 else 26
+        out.append(str((v >> shift) & ((1 << bits) - 1)))
+        shift += bits
+    return "{" + ", ".join(out) + "}"
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit("usage: gen_ed25519_tables.py <output.c> [pubkey_hex ...]")
+
+    keys = [k for k in sys.argv[2:] if k]
+
+    out = []
+    out.append("// Gerado por tools/gen_ed25519_tables.py - não editar\n")
+    out.append('#include "bootloader.h"\n\n')
+
+    base = (recover_x(BY, 0), BY)
+    out.append("const int64_t ed25519_base_odd[%d][3][10] = {\n" % BASE_POINTS)
+    for x, y in odd_multiples(base, BASE_POINTS):
+        out.append("    {" + limbs(y + x) + ",\n")
+        out.append("     " + limbs(y - x) + ",\n")
+        out.append("     " + limbs(2 * D * x * y) + "},\n")
+    out.append("};\n\n")
+
+    out.append("const ed25519_pubkey_ctx_t bootloader_vendor_keys[] = {\n")
+    for key in keys:
+        x, y = decode_point(key)
+        out.append("    {{" + ", ".join("0x%02x" % b for b in bytes.fromhex(key))
+                   + "},\n     {\n")
+        for mx, my in odd_multiples((P - x, y), KEY_POINTS):
+            out.append("         {" + limbs(my + mx) + ",\n")
+            out.append("          " + limbs(my - mx) + ",\n")
+            out.append("          " + limbs(1) + ",\n")
+            out.append("          " + limbs(2 * D * mx * my) + "},\n")
+        out.append("     }},\n")
+    if not keys:
+        out.append("    {{0}, {{{0}}}},\n")
+    out.append("};\n\n")
+    out.append("const size_t bootloader_vendor_key_count = %d;\n" % len(keys))
+
+    os.makedirs(os.path.dirname(os.path.abspath(sys.argv[1])), exist_ok=True)
+    with open(sys.argv[1], "w") as f:
+        f.write("".join(out))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""
+Gera as tabelas pré-computadas do secp256k1 (const, residentes na flash).
+
+- secp256k1_gen_table[i][j-1] = j * 16^i * G, j = 1..15, i = 0..63
+  (multiplicação k*G constant-time por janelas fixas de 4 bits)
+- secp256k1_gen_odd[i] = (2i + 1) * G, i = 0..63
+  (múltiplos ímpares para wNAF de largura 8 na verificação)
+
+Pontos afins, cada um como 16 limbs de 32 bits little-endian (x || y).
+
+Uso: gen_secp256k1_tables.py <saida.c>
+"""
+
+import os
+import sys
+
+P = 2**256 - 2**32 - 977
+GX = 0x79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798
+GY = 0x483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8
+
+
+def point_add(a, b):
+    if a is None:
+        return b
+    if b is None:
+        return a
+    if a[0] == b[0]:
+        if (a[1] + b[1]) % P == 0:
+            return None
+        lam = 3 * a[0] * a[0] * pow(2 * a[1], P - 2, P) % P
+    else:
+        lam = (b[1] - a[1]) * pow(b[0] - a[0], P - 2, P) % P
+    x = (lam * lam - a[0] - b[0]) % P
+    return (x, (lam * (a[0] - x) - a[1]) % P)
+
+
+def limbs(v):
+    return ["0x%08X" % ((v >> (32 * i)) & 0xFFFFFFFF) for i in range(8)]
+
+
+def emit_point(pt):
+    return "{" + ", ".join(limbs(pt[0]) + limbs(pt[1])) + "}"
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("usage: gen_secp256k1_tables.py <output.c>")
+
+    out = []
+    out.append("// Gerado por tools/gen_secp256k1_tables.py - não editar\n")
+    out.append("#include <stdint.h>\n\n")
+
+    out.append("const uint32_t secp256k1_gen_table[64][15][16] = {\n")
+    base = (GX, GY)
+    for _ in range(64):
+        out.append("    {\n")
+        acc = None
+        for _ in range(15):
+            acc = point_add(acc, base)
+            out.append("        " + emit_point(acc) + ",\n")
+        out.append("    },\n")
+        for _ in range(4):
+            base = point_add(base, base)
+    out.append("};\n\n")
+
+    out.append("const uint32_t secp256k1_gen_odd[64][16] = {\n")
+    g = (GX, GY)
+    g2 = point_add(g, g)
+    acc = g
+    for _ in range(64):
+        out.append("    " + emit_point(acc) + ",\n")
+        acc = point_add(acc, g2)
+    out.append("};\n")
+
+    os.makedirs(os.path.dirname(os.path.abspath(sys.argv[1])), exist_ok=True)
+    with open(sys.argv[1], "w") as f:
+        f.write("".join(out))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,42 @@
+#!/usr/bin/env python3
+"""
+Gera o índice compacto da lista de palavras SLIP-39 (const, na flash).
+
+Mesmo formato do índice BIP-39 (ver gen_bip39_index.py): as 1024 palavras
+têm 4 a 8 letras e são únicas nas 4 primeiras.
+
+Uso: gen_slip39_index.py <saida.c> <lista.txt>
+"""
+
+import hashlib
+import os
+import sys
+
+sys.dont_write_bytecode = True  # Nada de __pycache__ em tools/
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from gen_bip39_index import build_index, write_output  # noqa: E402
+
+# SHA-256 de slip39_english.txt (wordlist.txt do SLIP-0039, uma palavra
+# por linha); conferida decodificando os vetores de teste da spec
+ENGLISH_SHA256 = "bcc4555340332d169718aed8bf31dd9d5248cb7da6e5d355140ef4f1e601eec3"
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("usage: gen_slip39_index.py <output.c> <wordlist.txt>")
+
+    with open(sys.argv[2], "rb") as f:
+        raw = f.read()
+    if hashlib.sha256(raw).hexdigest() != ENGLISH_SHA256:
+        sys.exit("gen_slip39_index.py: lista de palavras não confere com a oficial")
+    words = raw.decode("ascii").split()
+    assert len(words) == 1024
+    assert all(4 <= len(w) <= 8 for w in words)
+
+    text, size = build_index(words, "slip39", "gen_slip39_index.py")
+    write_output(sys.argv[1], text)
+    print("SLIP-39 index: %d bytes" % size)
+
+
+if __name__ == "__main__":
+    main()
@@ -12,8 +12,17 @@ BAUDRATE = 115200
 CMD_PING = 0x01
 CMD_GET_VERSION = 0x02
 CMD_GET_STATUS = 0x03
+CMD_SIGN_TX = 0x21
+CMD_SIGN_CONFIRM = 0x24
 SOF = 0xAA
 
+STATUS_OK = 0x00
+STATUS_NEED_CONFIRM = 0x04
+STATUS_DENIED = 0x09
+
+# O device espera o botão por até 30 s (CONFIRM_TIMEOUT_MS) antes de responder
+CONFIRM_READ_TIMEOUT = 35
+
 def crc16(data):
     crc = 0xFFFF
     for byte in data:
@@ -67,6 +76,61 @@ def send_command(ser, cmd, payload=b""):
     print(f"Data: {binascii.hexlify(data)}")
     return (status, data)
 
+def read_frame(ser, pending):
+    # Lê um frame completo (pode chegar em vários reads ou colado a outros)
+    while True:
+        start = pending.find(bytes([SOF]))
+        if start >= 0 and len(pending) >= start + 2:
+            total = 2 + pending[start + 1] + 2
+            if len(pending) >= start + total:
+                frame = pending[start:start + total]
+                del pending[:start + total]
+                return (frame[2], bytes(frame[3:total - 2]))
+        chunk = ser.read(512)
+        if not chunk:
+            return None
+        pending.extend(chunk)
+
+def test_sign_batch(ser, count=32):
+    # Duas contas intercaladas, 6 entradas por frame
+    entries = [(i & 1, bytes([i]) * 32) for i in range(count)]
+    pending = bytearray()
+    start = time.time()
+    digest = None
+    for off in range(0, count, 6):
+        payload = bytearray([1 if off == 0 else 0, 0])  # flags, Ed25519
+        for account, h in entries[off:off + 6]:
+            payload += struct.pack("<I", account) + h
+        ser.write(build_frame(CMD_SIGN_TX, payload))
+        resp = read_frame(ser, pending)
+        if resp is None or resp[0] != STATUS_NEED_CONFIRM:
+            print(f"Staging failed: {resp}")
+            return
+        digest = resp[1][1:]
+    # Em produção o app só confirma depois que o usuário aprova o lote
+    ser.write(build_frame(CMD_SIGN_CONFIRM, digest))
+    print("Confirm the batch on the device button...")
+    got = 0
+    for i in range(count):
+        if i == 0:
+            timeout, ser.timeout = ser.timeout, CONFIRM_READ_TIMEOUT
+            try:
+                resp = read_frame(ser, pending)
+            finally:
+                ser.timeout = timeout
+        else:
+            resp = read_frame(ser, pending)
+        if resp is not None and resp[0] == STATUS_DENIED:
+            print("Batch not confirmed on the device")
+            return
+        if resp is None or resp[0] != STATUS_OK:
+            print(f"Signing failed: {resp}")
+            return
+        got += 1
+    elapsed = time.time() - start
+    print(f"{got} signatures in {elapsed * 1000:.1f} ms "
+          f"({got / elapsed:.1f} sig/s end to end)")
+
 def main():
     print("LibreCrypt Hardware Test")
     try:
@@ -96,6 +160,12 @@ def main():
         if s == 1: st = "Locked"
         if s == 2: st = "Unlocked"
         print(f"Wallet Status: {st}")
+        if len(data) > 1:
+            print(f"RNG Health: {'OK' if data[1] == 0 else f'FAIL (0x{data[1]:02x})'}")
+
+        if s == 2:
+            print("\n--- TEST: SIGN BATCH ---")
+            test_sign_batch(ser)
 
     ser.close()
 